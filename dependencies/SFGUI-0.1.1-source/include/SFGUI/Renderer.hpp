@@ -197,6 +197,8 @@ class SFGUI_API Renderer {
 		void Display( sf::Window& target ) const;
 
 		/** Draw the GUI to an sf::RenderWindow.
+		 * States are set through the target's sf::GlStateTracker, so SFML
+		 * drawing before or after the GUI doesn't need resetGLStates().
 		 * @param target sf::RenderWindow to draw to.
 		 */
 		void Display( sf::RenderWindow& target ) const;
@@ -260,13 +262,13 @@ class SFGUI_API Renderer {
 		 */
 		Renderer();
 
-		void DisplayImpl() const;
+		void DisplayImpl( sf::GlStateTracker& states ) const;
 
-		void SetupGL() const;
+		void DrawFBO( sf::GlStateTracker& states ) const;
 
-		void RestoreGL() const;
+		void SetupGL( sf::GlStateTracker& states ) const;
 
-		void WipeStateCache( sf::RenderTarget& target ) const;
+		void RestoreGL( sf::GlStateTracker& states ) const;
 
 		void SortPrimitives();
 
@@ -293,7 +295,7 @@ class SFGUI_API Renderer {
 
 		GLuint m_display_list;
 
-		typedef std::pair<void*, unsigned int> FontID;
+		typedef std::pair<sf::Uint64, unsigned int> FontID;
 
 		std::list<TextureNode> m_textures;
 		std::map<FontID, SharedPtr<Primitive::Texture> > m_fonts;
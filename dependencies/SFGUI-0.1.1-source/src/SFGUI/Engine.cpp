@@ -68,27 +68,12 @@ Engine::~Engine() {
 sf::Vector2f Engine::GetFontHeightProperties( const sf::Font& font, unsigned int font_size ) const {
 	// We want to cache line height values because they are expensive to compute.
 
-	static std::map<std::pair<void*, unsigned int>, sf::Vector2f> height_property_cache;
+	static std::map<std::pair<sf::Uint64, unsigned int>, sf::Vector2f> height_property_cache;
 
-	// Get the font face that Laurent tries to hide from us.
-	struct FontStruct {
-		void* font_face; // Authentic SFML comment: implementation details
-		void* unused1;
-		int* unused2;
+	// The cache id changes whenever the font is (re)loaded, so stale entries are never hit.
+	std::pair<sf::Uint64, unsigned int> id( font.getCacheId(), font_size );
 
-		// Since maps allocate everything non-contiguously on the heap we can use void* instead of Page here.
-		mutable std::map<unsigned int, void*> unused3;
-		mutable std::vector<sf::Uint8> unused4;
-	};
-
-	void* face;
-
-	// All your font face are belong to us too.
-	memcpy( &face, reinterpret_cast<const char*>( &font ) + sizeof( sf::Font ) - sizeof( FontStruct ), sizeof( void* ) );
-
-	std::pair<void*, unsigned int> id( face, font_size );
-
-	std::map<std::pair<void*, unsigned int>, sf::Vector2f>::iterator iter( height_property_cache.find( id ) );
+	std::map<std::pair<sf::Uint64, unsigned int>, sf::Vector2f>::iterator iter( height_property_cache.find( id ) );
 
 	if( iter != height_property_cache.end() ) {
 		return iter->second;
@@ -138,6 +123,7 @@ sf::Vector2f Engine::GetTextMetrics( const std::basic_string<sf::Uint32>& string
 		sf::Uint32 current_character = string[index];
 
 		metrics.x += static_cast<float>( font.getKerning( previous_character, current_character, font_size ) );
+		previous_character = current_character;
 
 		switch( current_character ) {
 			case L' ':
@@ -188,6 +174,7 @@ sf::Vector2f Engine::GetTextMetrics( const sf::String& string, const sf::Font& f
 		sf::Uint32 current_character = string[index];
 
 		metrics.x += static_cast<float>( font.getKerning( previous_character, current_character, font_size ) );
+		previous_character = current_character;
 
 		switch( current_character ) {
 			case L' ':
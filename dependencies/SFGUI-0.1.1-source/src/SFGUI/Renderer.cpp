@@ -455,20 +455,28 @@ void Renderer::Display( sf::Window& target ) const {
 	target.setActive( true );
 
 	glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
-	glPushAttrib( GL_COLOR_BUFFER_BIT | GL_ENABLE_BIT | GL_TEXTURE_BIT );
+	glPushAttrib( GL_COLOR_BUFFER_BIT | GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_TRANSFORM_BIT );
+
+	glMatrixMode( GL_TEXTURE );
+	glPushMatrix();
+	glMatrixMode( GL_PROJECTION );
+	glPushMatrix();
+	glMatrixMode( GL_MODELVIEW );
+	glPushMatrix();
 
 	// Since we have no idea what the attribute environment
-	// of the user looks like, we need to pretend to be SFML
-	// by setting up it's GL attribute environment.
-	glEnable( GL_TEXTURE_2D );
-	glEnable( GL_BLEND );
-	glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+	// of the user looks like, we start with a tracker that
+	// doesn't know any state, so that every state is set.
+	sf::GlStateTracker states;
 
-	glEnableClientState( GL_VERTEX_ARRAY );
-	glEnableClientState( GL_COLOR_ARRAY );
-	glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+	DisplayImpl( states );
 
-	DisplayImpl();
+	glMatrixMode( GL_MODELVIEW );
+	glPopMatrix();
+	glMatrixMode( GL_PROJECTION );
+	glPopMatrix();
+	glMatrixMode( GL_TEXTURE );
+	glPopMatrix();
 
 	glPopAttrib();
 	glPopClientAttrib();
@@ -479,9 +487,9 @@ void Renderer::Display( sf::RenderWindow& target ) const {
 
 	target.setActive( true );
 
-	DisplayImpl();
-
-	WipeStateCache( target );
+	// SFML sets its states through the same tracker, so
+	// neither of us has to save or reset the other's states.
+	DisplayImpl( target.getGlStateTracker() );
 }
 
 void Renderer::Display( sf::RenderTexture& target ) const {
@@ -489,17 +497,15 @@ void Renderer::Display( sf::RenderTexture& target ) const {
 
 	target.setActive( true );
 
-	DisplayImpl();
-
-	WipeStateCache( target );
+	DisplayImpl( target.getGlStateTracker() );
 }
 
-void Renderer::DisplayImpl() const {
+void Renderer::DisplayImpl( sf::GlStateTracker& states ) const {
 	if( !m_vbo_supported ) {
 		return;
 	}
 
-	SetupGL();
+	SetupGL( states );
 
 	if( !m_vbo_synced ) {
 		// Disclaimer:
@@ -535,7 +541,7 @@ void Renderer::DisplayImpl() const {
 
 		glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, m_index_vbo );
 
-		// Not needed, constantly kept enabled by SFML... -_-
+		// Not needed, enabled through the tracker in SetupGL().
 		//glEnableClientState( GL_VERTEX_ARRAY );
 		//glEnableClientState( GL_COLOR_ARRAY );
 		//glEnableClientState( GL_TEXTURE_COORD_ARRAY );
@@ -549,7 +555,7 @@ void Renderer::DisplayImpl() const {
 		}
 
 		if( m_depth_clear_strategy ) {
-			glEnable( GL_DEPTH_TEST );
+			states.setEnabled( GL_DEPTH_TEST, true );
 
 			if( !m_use_fbo && ( m_depth_clear_strategy & CLEAR_DEPTH ) ) {
 				glClear( GL_DEPTH_BUFFER_BIT );
@@ -568,12 +574,12 @@ void Renderer::DisplayImpl() const {
 			}
 		}
 
-		glEnable( GL_SCISSOR_TEST );
+		states.setEnabled( GL_SCISSOR_TEST, true );
 
 		std::size_t current_atlas_page = 0;
 
 		if( !m_texture_atlas.empty() ) {
-			sf::Texture::bind( m_texture_atlas[0] );
+			states.bindTexture( m_texture_atlas[0] );
 		}
 
 		for( std::size_t index = 0; index < scissor_pairs_size; ++index ) {
@@ -585,15 +591,27 @@ void Renderer::DisplayImpl() const {
 				sf::Vector2i destination( viewport->GetDestinationOrigin() );
 				sf::Vector2u size( viewport->GetSize() );
 
-				glViewport( destination.x, m_window_size.y - destination.y - size.y, size.x, size.y );
+				states.setViewport( sf::IntRect( destination.x, m_window_size.y - destination.y - size.y, size.x, size.y ) );
+
+				// Canvases expect the texture matrix to be current.
+				states.setMatrixMode( GL_TEXTURE );
 
 				// Draw canvas.
 				( *batch.custom_draw_callback )();
 
-				glViewport( 0, 0, m_window_size.x, m_window_size.y );
+				// We don't know what the callback did, set everything again.
+				states.invalidate();
+
+				SetupGL( states );
+
+				states.setEnabled( GL_SCISSOR_TEST, true );
+
+				if( m_depth_clear_strategy ) {
+					states.setEnabled( GL_DEPTH_TEST, true );
+				}
 
 				if( !m_texture_atlas.empty() ) {
-					sf::Texture::bind( m_texture_atlas[current_atlas_page] );
+					states.bindTexture( m_texture_atlas[current_atlas_page] );
 				}
 			}
 			else {
@@ -616,7 +634,7 @@ void Renderer::DisplayImpl() const {
 					if( batch.atlas_page != current_atlas_page ) {
 						current_atlas_page = batch.atlas_page;
 
-						sf::Texture::bind( m_texture_atlas[current_atlas_page] );
+						states.bindTexture( m_texture_atlas[current_atlas_page] );
 					}
 
 					glDrawRangeElements(
@@ -631,10 +649,10 @@ void Renderer::DisplayImpl() const {
 			}
 		}
 
-		glDisable( GL_SCISSOR_TEST );
+		states.setEnabled( GL_SCISSOR_TEST, false );
 
 		if( m_depth_clear_strategy ) {
-			glDisable( GL_DEPTH_TEST );
+			states.setEnabled( GL_DEPTH_TEST, false );
 		}
 
 		//glDisableClientState( GL_TEXTURE_COORD_ARRAY );
@@ -645,31 +663,45 @@ void Renderer::DisplayImpl() const {
 		glBindBufferARB( GL_ELEMENT_ARRAY_BUFFER_ARB, 0 );
 		glBindBufferARB( GL_ARRAY_BUFFER_ARB, 0 );
 
+		// The array pointers are offsets into our VBOs.
+		states.invalidate( sf::GlStateTracker::VertexArrays );
+
 		if( m_use_fbo ) {
 			glBindFramebuffer( GL_FRAMEBUFFER, 0 );
 
-			glCallList( m_display_list );
+			DrawFBO( states );
 		}
 
 		m_force_redraw = false;
 	}
 	else {
-		glCallList( m_display_list );
+		DrawFBO( states );
 	}
 
 	m_vbo_synced = true;
 
-	RestoreGL();
+	RestoreGL( states );
 }
 
-void Renderer::SetupGL() const {
-	glMatrixMode( GL_MODELVIEW );
-	glPushMatrix();
-	glLoadIdentity();
+void Renderer::DrawFBO( sf::GlStateTracker& states ) const {
+	// The display list pushes and pops the projection matrix
+	// and leaves no texture bound.
+	states.setMatrixMode( GL_PROJECTION );
 
-	glMatrixMode( GL_PROJECTION );
-	glPushMatrix();
-	glLoadIdentity();
+	glCallList( m_display_list );
+
+	states.invalidate( sf::GlStateTracker::Textures );
+}
+
+void Renderer::SetupGL( sf::GlStateTracker& states ) const {
+	static const float identity[16] = {
+		1.f, 0.f, 0.f, 0.f,
+		0.f, 1.f, 0.f, 0.f,
+		0.f, 0.f, 1.f, 0.f,
+		0.f, 0.f, 0.f, 1.f
+	};
+
+	states.loadMatrix( GL_MODELVIEW, identity );
 
 	// When SFML dies (closes) it sets the window size to 0 for some reason.
 	// That then causes glOrtho errors.
@@ -678,8 +710,6 @@ void Renderer::SetupGL() const {
 	// it's window resizes and nothing is drawn directly through SFML...
 
 	if( m_last_window_size != m_window_size ) {
-		glViewport( 0, 0, static_cast<GLsizei>( m_window_size.x ), static_cast<GLsizei>( m_window_size.y ) );
-
 		m_last_window_size = m_window_size;
 
 		if( m_window_size.x && m_window_size.y ) {
@@ -689,95 +719,53 @@ void Renderer::SetupGL() const {
 		}
 	}
 
-	glOrtho( 0.0f, static_cast<GLdouble>( m_window_size.x ? m_window_size.x : 1 ), static_cast<GLdouble>( m_window_size.y ? m_window_size.y : 1 ), 0.0f, -1.0f, 64.0f );
+	states.setViewport( sf::IntRect( 0, 0, static_cast<int>( m_window_size.x ), static_cast<int>( m_window_size.y ) ) );
 
-	glMatrixMode( GL_TEXTURE );
-	glPushMatrix();
-	glLoadIdentity();
+	// Same as glOrtho( 0, width, height, 0, -1, 64 ).
+	float width = static_cast<float>( m_window_size.x ? m_window_size.x : 1 );
+	float height = static_cast<float>( m_window_size.y ? m_window_size.y : 1 );
 
-	if( m_alpha_threshold > 0.f ) {
-		glAlphaFunc( GL_GREATER, m_alpha_threshold );
-		glEnable( GL_ALPHA_TEST );
-	}
+	const float projection[16] = {
+		2.f / width, 0.f, 0.f, 0.f,
+		0.f, -2.f / height, 0.f, 0.f,
+		0.f, 0.f, -2.f / 65.f, 0.f,
+		-1.f, 1.f, -63.f / 65.f, 1.f
+	};
 
-	glEnable( GL_CULL_FACE );
-}
+	states.loadMatrix( GL_PROJECTION, projection );
+	states.loadMatrix( GL_TEXTURE, identity );
+
+	// The environment SFML sets up, which we rely on. When drawing
+	// after SFML these calls are all skipped.
+	states.setEnabled( GL_TEXTURE_2D, true );
+	states.setEnabled( GL_BLEND, true );
+	states.setBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA );
 
-void Renderer::RestoreGL() const {
-	glDisable( GL_CULL_FACE );
+	states.setClientStateEnabled( GL_VERTEX_ARRAY, true );
+	states.setClientStateEnabled( GL_COLOR_ARRAY, true );
+	states.setClientStateEnabled( GL_TEXTURE_COORD_ARRAY, true );
 
 	if( m_alpha_threshold > 0.f ) {
-		glDisable( GL_ALPHA_TEST );
-		glAlphaFunc( GL_GREATER, 0.f );
+		states.setAlphaFunc( GL_GREATER, m_alpha_threshold );
+		states.setEnabled( GL_ALPHA_TEST, true );
 	}
 
-	glPopMatrix();
-
-	glMatrixMode( GL_PROJECTION );
-	glPopMatrix();
-
-	glMatrixMode( GL_MODELVIEW );
-	glPopMatrix();
+	states.setEnabled( GL_CULL_FACE, true );
 }
 
-void Renderer::WipeStateCache( sf::RenderTarget& target ) const {
-	// Make SFML disable it's **************** vertex cache without us
-	// having to call ResetGLStates() and disturbing OpenGL needlessly.
-	// This would be sooo much easier if we could somehow set
-	// myCache.UseVertexCache = false;
-	// in window by ourself every frame.
-	// SFML doesn't like to play nice with other VBO / Vertex Array
-	// users, that's for sure... It assumes that the array pointers
-	// don't get changed between calls to Draw() unless ResetGLStates()
-	// is explicitly called in between. Why do we need to call OpenGL
-	// 10+ times just to reset something this simple? No logic.
-
-	//static sf::VertexArray resetter_array( sf::TrianglesStrip, 5 );
-	//window.Draw( resetter_array );
-
-	// Or... even more evil... use memset to blank the StatesCache of
-	// the RenderWindow with zeros. Thankfully, because we are using
-	// the data structures directly from the SFML headers, if Laurent
-	// decides to change their size one day we won't even notice.
-	struct StatesCache {
-		bool glStatesSet;
-		bool ViewChanged;
-		sf::BlendMode LastBlendMode;
-		sf::Uint64 LastTextureId;
-		bool UseVertexCache;
-		sf::Vertex VertexCache[4];
-	};
-
-	// All your cache are belong to us.
-	memset( reinterpret_cast<char*>( &target ) + sizeof( sf::RenderTarget ) - sizeof( StatesCache ) + 1, 0, sizeof( StatesCache ) - 1 );
-
-	// This is to make it forget it's cached viewport.
-	// Seriously... caching the viewport? Come on...
-	memset( reinterpret_cast<char*>( &target ) + sizeof( sf::RenderTarget ) - sizeof( StatesCache ) + 1, 1, 1 );
+void Renderer::RestoreGL( sf::GlStateTracker& states ) const {
+	// Leave the capabilities as SFML expects them. The matrices
+	// don't need restoring, SFML loads its own through the tracker.
+	states.setEnabled( GL_CULL_FACE, false );
 
-	// Since we wiped SFML's cache of its bound texture, we
-	// should make sure that it stays coherent with reality :).
-	sf::Texture::bind( 0 );
+	if( m_alpha_threshold > 0.f ) {
+		states.setEnabled( GL_ALPHA_TEST, false );
+	}
 }
 
 sf::Vector2f Renderer::LoadFont( const sf::Font& font, unsigned int size ) {
-	// Get the font face that Laurent tries to hide from us.
-	struct FontStruct {
-		void* font_face; // Authentic SFML comment: implementation details
-		void* unused1;
-		int* unused2;
-
-		// Since maps allocate everything non-contiguously on the heap we can use void* instead of Page here.
-		mutable std::map<unsigned int, void*> unused3;
-		mutable std::vector<sf::Uint8> unused4;
-	};
-
-	void* face;
-
-	// All your font face are belong to us too.
-	memcpy( &face, reinterpret_cast<const char*>( &font ) + sizeof( sf::Font ) - sizeof( FontStruct ), sizeof( void* ) );
-
-	FontID id( face, size );
+	// The cache id changes whenever the font is (re)loaded, so a reloaded font gets a new atlas entry.
+	FontID id( font.getCacheId(), size );
 
 	std::map<FontID, SharedPtr<Primitive::Texture> >::iterator iter( m_fonts.find( id ) );
 
@@ -1304,7 +1292,7 @@ void Renderer::SetupFBO( unsigned int width, unsigned int height ) {
 		// Do not fear the immediate-mode GL here, we only compile this once.
 		glNewList( m_display_list, GL_COMPILE );
 
-		glMatrixMode( GL_PROJECTION );
+		// The projection matrix is made current by DrawFBO().
 		glPushMatrix();
 		glLoadIdentity();
 
@@ -1327,7 +1315,6 @@ void Renderer::SetupFBO( unsigned int width, unsigned int height ) {
 		glBindTexture( GL_TEXTURE_2D, 0 );
 
 		glPopMatrix();
-		glMatrixMode( GL_TEXTURE );
 
 		glEndList();
 	}
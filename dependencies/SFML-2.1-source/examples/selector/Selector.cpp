@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Network.hpp>
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+    #include <sys/select.h>
+#endif
+
+
+namespace
+{
+    // Size of the messages exchanged by the clients and the server
+    const std::size_t messageSize = 16;
+
+    ////////////////////////////////////////////////////////////
+    /// Receive and echo everything available on a server socket
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t echo(sf::TcpSocket& socket, bool untilEmpty)
+    {
+        char buffer[1024];
+        std::size_t total = 0;
+        std::size_t received = 0;
+        while (socket.receive(buffer, sizeof(buffer), received) == sf::Socket::Done)
+        {
+            socket.send(buffer, received);
+            total += received;
+
+            // Level-triggered selectors report the socket again if there's more
+            if (!untilEmpty)
+                break;
+        }
+
+        return total;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Connect many clients to a local server, and measure the
+    /// time the server spends waiting for and finding the few
+    /// clients that send something at each round
+    ///
+    ////////////////////////////////////////////////////////////
+    void runBenchmark(const char* name, sf::SocketSelector::Backend backend, sf::SocketSelector::TriggerMode mode,
+                      unsigned short port, std::size_t connectionCount, std::size_t activeCount, std::size_t roundCount)
+    {
+        sf::TcpListener listener;
+        if (listener.listen(port) != sf::Socket::Done)
+            return;
+
+        sf::SocketSelector selector(backend, mode);
+        std::vector<sf::TcpSocket*> clients;
+        std::vector<sf::TcpSocket*> servers;
+        for (std::size_t i = 0; i < connectionCount; ++i)
+        {
+            sf::TcpSocket* client = new sf::TcpSocket;
+            sf::TcpSocket* server = new sf::TcpSocket;
+            if ((client->connect(sf::IpAddress::LocalHost, port) != sf::Socket::Done) || (listener.accept(*server) != sf::Socket::Done))
+            {
+                std::cout << "Failed to open connection " << i << ", the limit of open files may be too low" << std::endl;
+                delete client;
+                delete server;
+                break;
+            }
+
+            server->setBlocking(false);
+            selector.add(*server);
+            clients.push_back(client);
+            servers.push_back(server);
+        }
+
+        if (clients.size() < activeCount)
+            activeCount = clients.size();
+
+        bool useReadyList = (selector.getBackend() == sf::SocketSelector::EpollBackend);
+        bool untilEmpty = (mode == sf::SocketSelector::EdgeTriggered);
+
+        char message[messageSize];
+        std::memset(message, 'x', sizeof(message));
+
+        sf::Time serverTime;
+        std::size_t waitCount = 0;
+        for (std::size_t round = 0; round < roundCount; ++round)
+        {
+            // A few clients, spread over the whole range, send a message
+            std::size_t first = (round * 7919) % clients.size();
+            for (std::size_t i = 0; i < activeCount; ++i)
+                clients[(first + i * (clients.size() / activeCount)) % clients.size()]->send(message, sizeof(message));
+
+            // The server echoes them back
+            sf::Clock clock;
+            std::size_t expected = activeCount * messageSize;
+            std::size_t received = 0;
+            while (received < expected)
+            {
+                if (!selector.wait(sf::seconds(1)))
+                    break;
+                waitCount++;
+
+                if (useReadyList)
+                {
+                    for (std::size_t i = 0; i < selector.getReadyCount(); ++i)
+                        received += echo(static_cast<sf::TcpSocket&>(selector.getReady(i)), untilEmpty);
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < servers.size(); ++i)
+                    {
+                        if (selector.isReady(*servers[i]))
+                            received += echo(*servers[i], untilEmpty);
+                    }
+                }
+            }
+            serverTime += clock.getElapsedTime();
+
+            // The clients read the answers
+            for (std::size_t i = 0; i < activeCount; ++i)
+            {
+                std::size_t size;
+                clients[(first + i * (clients.size() / activeCount)) % clients.size()]->receive(message, sizeof(message), size);
+            }
+        }
+
+        std::cout << name << ": " << clients.size() << " connections, "
+                  << serverTime.asMicroseconds() / static_cast<float>(roundCount) << " us per round, "
+                  << serverTime.asMicroseconds() / static_cast<float>(waitCount) << " us per wait" << std::endl;
+
+        for (std::size_t i = 0; i < clients.size(); ++i)
+        {
+            delete clients[i];
+            delete servers[i];
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    // Number of connections, and number of clients sending a message at each round
+    std::size_t connectionCount = argc > 1 ? std::atoi(argv[1]) : 400;
+    std::size_t activeCount = argc > 2 ? std::atoi(argv[2]) : 10;
+    std::size_t roundCount = 1000;
+
+    if ((connectionCount == 0) || (activeCount == 0))
+    {
+        std::cout << "usage: selector [connections] [active connections per round]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Each round, " << activeCount << " clients send a message that the server echoes back" << std::endl;
+
+    // The server and the clients both use a socket per connection
+#ifndef _WIN32
+    if (connectionCount * 2 + 16 > FD_SETSIZE)
+        std::cout << "select: skipped, " << connectionCount << " connections exceed FD_SETSIZE (" << FD_SETSIZE << ")" << std::endl;
+    else
+#endif
+        runBenchmark("select", sf::SocketSelector::SelectBackend, sf::SocketSelector::LevelTriggered, 50010, connectionCount, activeCount, roundCount);
+
+    sf::SocketSelector probe;
+    if (probe.getBackend() == sf::SocketSelector::EpollBackend)
+    {
+        runBenchmark("epoll, level-triggered", sf::SocketSelector::EpollBackend, sf::SocketSelector::LevelTriggered, 50011, connectionCount, activeCount, roundCount);
+        runBenchmark("epoll, edge-triggered", sf::SocketSelector::EpollBackend, sf::SocketSelector::EdgeTriggered, 50012, connectionCount, activeCount, roundCount);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -74,6 +74,10 @@ public :
     /// ogg, wav, flac, aiff, au, raw, paf, svx, nist, voc, ircam,
     /// w64, mat4, mat5 pvf, htk, sds, avr, sd2, caf, wve, mpc2k, rf64.
     ///
+    /// The file is decoded through the default sf::SampleCache:
+    /// if it was preloaded, opening and playing it doesn't wait
+    /// for the disk nor the decoder.
+    ///
     /// \param filename Path of the music file to open
     ///
     /// \return True if loading succeeded, false if it failed
@@ -202,6 +206,12 @@ private :
 /// leave the music alone after calling play(), it will manage itself
 /// very well.
 ///
+/// Musics opened from files are decoded in chunks through the
+/// default sf::SampleCache. Positions that were already decoded,
+/// like the beginning of a looping music, are read back from the
+/// cache instead of seeking in the file, and a music can be
+/// preloaded in the background before switching to it.
+///
 /// Usage example:
 /// \code
 /// // Declare a new music
@@ -223,6 +233,6 @@ private :
 /// music.play();
 /// \endcode
 ///
-/// \see sf::Sound, sf::SoundStream
+/// \see sf::Sound, sf::SoundStream, sf::SampleCache
 ///
 ////////////////////////////////////////////////////////////
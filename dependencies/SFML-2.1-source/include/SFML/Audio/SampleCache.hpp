@@ -0,0 +1,330 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_SAMPLECACHE_HPP
+#define SFML_SAMPLECACHE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Audio/Export.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/TaskScheduler.hpp>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace sf
+{
+namespace priv
+{
+    class SoundFile;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Shared cache of decoded audio samples, with a memory budget
+///
+////////////////////////////////////////////////////////////
+class SFML_AUDIO_API SampleCache : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Statistics about the use of the cache
+    ///
+    ////////////////////////////////////////////////////////////
+    struct CacheStats
+    {
+        Uint64 hits;         ///< Number of chunks read from the cache
+        Uint64 misses;       ///< Number of chunks that had to be decoded
+        Uint64 evictions;    ///< Number of chunks removed to stay within the budget
+        Uint64 decodedBytes; ///< Total size of the decoded chunks, in bytes
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// \param byteBudget Maximum size of the cached samples, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit SampleCache(std::size_t byteBudget = 64 * 1024 * 1024);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// The preloads still running are waited for.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~SampleCache();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decode a sound file into the cache in the background
+    ///
+    /// The file is opened and decoded by a task of the default
+    /// scheduler; music and sound buffers opened from the same
+    /// file afterwards don't touch the disk nor the decoder. If
+    /// the file is larger than the budget, only its beginning is
+    /// kept.
+    ///
+    /// Preloading a file which is already being preloaded or
+    /// fully cached does nothing.
+    ///
+    /// \param filename Path of the sound file to preload
+    ///
+    /// \return Handle to the preloading task, which can be waited for
+    ///
+    ////////////////////////////////////////////////////////////
+    TaskScheduler::Task preload(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a sound file is fully decoded in the cache
+    ///
+    /// \param filename Path of the sound file
+    ///
+    /// \return True if all the samples of the file are cached
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isCached(const std::string& filename) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the maximum size of the cached samples
+    ///
+    /// The least recently used chunks are removed if the cache
+    /// is currently larger than the new budget.
+    ///
+    /// \param byteBudget Maximum size of the cached samples, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    void setByteBudget(std::size_t byteBudget);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the maximum size of the cached samples
+    ///
+    /// \return Maximum size of the cached samples, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getByteBudget() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current size of the cached samples
+    ///
+    /// \return Size of the cached samples, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getByteSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the cached samples
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the statistics of the cache
+    ///
+    /// \return Statistics since the creation of the cache or the last reset
+    ///
+    ////////////////////////////////////////////////////////////
+    CacheStats getCacheStats() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset the statistics of the cache
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetCacheStats();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the cache used by sf::Music and sf::SoundBuffer
+    ///
+    /// \return Default cache, with a budget of 64 MB
+    ///
+    ////////////////////////////////////////////////////////////
+    static SampleCache& getDefault();
+
+private :
+
+    friend class priv::SoundFile;
+
+    struct File;
+    struct Preload;
+
+    ////////////////////////////////////////////////////////////
+    // Number of frames in a chunk, the unit of decoding and caching
+    ////////////////////////////////////////////////////////////
+    static const std::size_t ChunkFrameCount = 16384;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decoded samples of a part of a file
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Chunk
+    {
+        File*                       file;        ///< File the chunk belongs to
+        std::size_t                 index;       ///< Position of the chunk in the file
+        std::vector<Int16>          samples;     ///< Decoded samples
+        std::list<Chunk*>::iterator lruPosition; ///< Position in the list of chunks by last use
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Properties and decoded chunks of a file
+    ///
+    ////////////////////////////////////////////////////////////
+    struct File
+    {
+        File();
+
+        std::size_t         sampleCount;  ///< Total number of samples
+        unsigned int        channelCount; ///< Number of channels
+        unsigned int        sampleRate;   ///< Number of samples per second
+        std::vector<Chunk*> chunks;       ///< Chunks by position, NULL if not cached
+        std::size_t         cachedCount;  ///< Number of chunks in the cache
+        bool                isPreloading; ///< Is a preload task decoding the file?
+    };
+
+    typedef std::map<std::string, File> FileTable;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the properties of a file, if it was opened before
+    ///
+    /// \param filename     Path of the sound file
+    /// \param sampleCount  Receives the total number of samples
+    /// \param channelCount Receives the number of channels
+    /// \param sampleRate   Receives the sample rate
+    ///
+    /// \return True if the file is known to the cache
+    ///
+    ////////////////////////////////////////////////////////////
+    bool getInfo(const std::string& filename, std::size_t& sampleCount, unsigned int& channelCount, unsigned int& sampleRate) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Register the properties of a file
+    ///
+    /// \param filename     Path of the sound file
+    /// \param sampleCount  Total number of samples
+    /// \param channelCount Number of channels
+    /// \param sampleRate   Sample rate
+    ///
+    ////////////////////////////////////////////////////////////
+    void setInfo(const std::string& filename, std::size_t sampleCount, unsigned int channelCount, unsigned int sampleRate);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy samples out of a cached chunk
+    ///
+    /// \param filename Path of the sound file
+    /// \param index    Position of the chunk in the file
+    /// \param offset   First sample to copy, relative to the chunk
+    /// \param data     Destination of the samples
+    /// \param count    Maximum number of samples to copy
+    ///
+    /// \return Number of samples copied, or -1 if the chunk is not cached
+    ///
+    ////////////////////////////////////////////////////////////
+    int read(const std::string& filename, std::size_t index, std::size_t offset, Int16* data, std::size_t count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a decoded chunk to the cache
+    ///
+    /// \param filename Path of the sound file
+    /// \param index    Position of the chunk in the file
+    /// \param samples  Decoded samples
+    /// \param count    Number of samples
+    ///
+    ////////////////////////////////////////////////////////////
+    void insert(const std::string& filename, std::size_t index, const Int16* samples, std::size_t count);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove the least recently used chunks until the cache fits a size
+    ///
+    /// \param byteSize Size to fit, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    void evict(std::size_t byteSize);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decode a whole file, in a task
+    ///
+    /// \param preload File to decode, allocated by preload()
+    ///
+    ////////////////////////////////////////////////////////////
+    static void decode(Preload* preload);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    mutable Mutex                    m_mutex;      ///< Mutex protecting the cache
+    FileTable                        m_files;      ///< Known files, by path
+    std::list<Chunk*>                m_lru;        ///< Cached chunks, most recently used first
+    std::size_t                      m_byteBudget; ///< Maximum size of the cached samples
+    std::size_t                      m_byteSize;   ///< Current size of the cached samples
+    std::vector<TaskScheduler::Task> m_preloads;   ///< Preloading tasks
+    CacheStats                       m_stats;      ///< Statistics of the cache
+};
+
+} // namespace sf
+
+
+#endif // SFML_SAMPLECACHE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::SampleCache
+/// \ingroup audio
+///
+/// Audio files are decoded in chunks of a few hundred
+/// milliseconds, and the decoded chunks are kept in a cache
+/// shared by all the sounds and musics opened from a file.
+/// The cache has a memory budget: when it is exceeded, the
+/// chunks used the least recently are removed.
+///
+/// Seeking in a file that is read through the cache costs
+/// nothing until the samples are actually needed: positions
+/// that were already decoded (typically the beginning of a
+/// looping music) are then read from the cache, and the
+/// decoder is only repositioned on a miss.
+///
+/// preload() decodes a file in the background, so that
+/// switching to a new music or loading a sound buffer doesn't
+/// block the program on the disk or the decoder. The cache
+/// only knows files opened by path; musics and sound buffers
+/// loaded from memory or streams don't use it.
+///
+/// Usage example:
+/// \code
+/// sf::SampleCache& cache = sf::SampleCache::getDefault();
+///
+/// // while the current level is running...
+/// cache.preload("level2.ogg");
+///
+/// // ...later, switching music doesn't block
+/// music.openFromFile("level2.ogg");
+/// music.play();
+/// \endcode
+///
+/// \see sf::Music, sf::SoundBuffer
+///
+////////////////////////////////////////////////////////////
@@ -43,6 +43,7 @@ namespace priv
 }
 
 class Sound;
+class SoundMixer;
 class InputStream;
 
 ////////////////////////////////////////////////////////////
@@ -80,6 +81,10 @@ public :
     /// ogg, wav, flac, aiff, au, raw, paf, svx, nist, voc, ircam,
     /// w64, mat4, mat5 pvf, htk, sds, avr, sd2, caf, wve, mpc2k, rf64.
     ///
+    /// The samples are read through the default sf::SampleCache,
+    /// so files preloaded with sf::SampleCache::preload() are not
+    /// decoded again.
+    ///
     /// \param filename Path of the sound file to load
     ///
     /// \return True if loading succeeded, false if it failed
@@ -233,6 +238,7 @@ public :
 private :
 
     friend class Sound;
+    friend class SoundMixer;
 
     ////////////////////////////////////////////////////////////
     /// \brief Initialize the internal state after loading a new sound
@@ -271,10 +277,36 @@ private :
     ////////////////////////////////////////////////////////////
     void detachSound(Sound* sound) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a mixer to the list of mixers that play this buffer
+    ///
+    /// \param mixer Mixer instance to attach
+    ///
+    ////////////////////////////////////////////////////////////
+    void attachMixer(SoundMixer* mixer) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a mixer from the list of mixers that play this buffer
+    ///
+    /// \param mixer Mixer instance to detach
+    ///
+    ////////////////////////////////////////////////////////////
+    void detachMixer(SoundMixer* mixer) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop the mixer voices playing this buffer
+    ///
+    /// Mixer voices read the samples directly, this function
+    /// must be called before they are modified or destroyed.
+    ///
+    ////////////////////////////////////////////////////////////
+    void detachMixers();
+
     ////////////////////////////////////////////////////////////
     // Types
     ////////////////////////////////////////////////////////////
     typedef std::set<Sound*> SoundList; ///< Set of unique sound instances
+    typedef std::set<SoundMixer*> MixerList; ///< Set of unique mixer instances
 
     ////////////////////////////////////////////////////////////
     // Member data
@@ -283,6 +315,7 @@ private :
     std::vector<Int16> m_samples;  ///< Samples buffer
     Time               m_duration; ///< Sound duration
     mutable SoundList  m_sounds;   ///< List of sounds that are using this buffer
+    mutable MixerList  m_mixers;   ///< List of mixers that are playing this buffer
 };
 
 } // namespace sf
@@ -0,0 +1,399 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_SOUNDMIXER_HPP
+#define SFML_SOUNDMIXER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Audio/Export.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+
+namespace sf
+{
+class SoundBuffer;
+class SoundStream;
+
+////////////////////////////////////////////////////////////
+/// \brief Mix many sounds in software into a single output stream
+///
+////////////////////////////////////////////////////////////
+class SFML_AUDIO_API SoundMixer : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Identifier of a playing voice
+    ///
+    /// The value 0 (InvalidVoice) never identifies a voice.
+    /// Once a voice has finished, its identifier becomes
+    /// invalid; it is only reused after its voice has played
+    /// a million other sounds.
+    ///
+    ////////////////////////////////////////////////////////////
+    typedef Uint32 VoiceId;
+
+    static const VoiceId InvalidVoice = 0; ///< Identifier returned when a sound can't be played
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Devices the mixed sound can be sent to
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Device
+    {
+        DefaultDevice, ///< Stream the mix to the OpenAL device
+        NullDevice     ///< No output, the mix is only produced by calling mix()
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Statistics about the mixing
+    ///
+    ////////////////////////////////////////////////////////////
+    struct MixerStats
+    {
+        unsigned int activeVoices;  ///< Number of voices currently playing
+        Uint64       startedVoices; ///< Number of sounds started
+        Uint64       stolenVoices;  ///< Number of voices stopped to play a sound of higher priority
+        Uint64       droppedVoices; ///< Number of sounds not played because all the voices had a higher priority
+        Uint64       mixedFrames;   ///< Number of frames mixed
+        Time         mixTime;       ///< Total time spent mixing
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// The mixer is created closed, call open() to start it.
+    ///
+    /// \param voiceCount Maximum number of sounds playing at the same time (at most 4096)
+    /// \param sampleRate Sample rate of the output, in samples per second
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit SoundMixer(unsigned int voiceCount = 32, unsigned int sampleRate = 44100);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~SoundMixer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start sending the mix to a device
+    ///
+    /// With the default device, the output is played through a
+    /// single OpenAL source as a stereo stream. With the null
+    /// device nothing is played: the owner of the mixer pulls
+    /// the samples with mix(), which makes it possible to test
+    /// and benchmark the mixing without any audio hardware.
+    ///
+    /// \param device Device to send the mix to
+    ///
+    /// \return True if the device was opened
+    ///
+    ////////////////////////////////////////////////////////////
+    bool open(Device device = DefaultDevice);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop sending the mix to the device
+    ///
+    /// The voices are not stopped.
+    ///
+    ////////////////////////////////////////////////////////////
+    void close();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start playing a sound buffer on a free voice
+    ///
+    /// If all the voices are busy, the one playing the sound of
+    /// lowest priority (the oldest one among equals) is stolen,
+    /// unless its priority is higher than \a priority, in which
+    /// case the sound is not played.
+    ///
+    /// The buffer is not copied. If it is modified or destroyed,
+    /// the voices playing it are stopped.
+    ///
+    /// \param buffer   Sound buffer to play, mono or stereo
+    /// \param priority Priority of the sound
+    /// \param volume   Volume of the voice, in the range [0, 100]
+    /// \param pan      Position in the stereo field, from -1 (left) to 1 (right)
+    /// \param pitch    Pitch of the voice, 1 for the original pitch
+    ///
+    /// \return Identifier of the voice, or InvalidVoice if the sound was not played
+    ///
+    ////////////////////////////////////////////////////////////
+    VoiceId play(const SoundBuffer& buffer, int priority = 0, float volume = 100.f, float pan = 0.f, float pitch = 1.f);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop a voice
+    ///
+    /// This function does nothing if the voice has already finished.
+    ///
+    /// \param voice Voice to stop
+    ///
+    ////////////////////////////////////////////////////////////
+    void stop(VoiceId voice);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop all the voices
+    ///
+    ////////////////////////////////////////////////////////////
+    void stopAll();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a voice is still playing
+    ///
+    /// \param voice Voice to check
+    ///
+    /// \return True if the voice hasn't finished yet
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isPlaying(VoiceId voice) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the volume of a voice
+    ///
+    /// \param voice  Voice to modify
+    /// \param volume Volume of the voice, in the range [0, 100]
+    ///
+    ////////////////////////////////////////////////////////////
+    void setVolume(VoiceId voice, float volume);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the position of a voice in the stereo field
+    ///
+    /// Mono sounds are panned with a constant power law, stereo
+    /// sounds by attenuating the opposite channel.
+    ///
+    /// \param voice Voice to modify
+    /// \param pan   Position, from -1 (left) to 1 (right)
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPan(VoiceId voice, float pan);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the pitch of a voice
+    ///
+    /// \param voice Voice to modify
+    /// \param pitch Pitch of the voice, 1 for the original pitch
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPitch(VoiceId voice, float pitch);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the volume applied to the whole mix
+    ///
+    /// \param volume Volume of the mix, in the range [0, 100]
+    ///
+    ////////////////////////////////////////////////////////////
+    void setMasterVolume(float volume);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mix the playing voices
+    ///
+    /// This function is called by the output stream of the
+    /// default device; with the null device it must be called
+    /// by the owner of the mixer.
+    ///
+    /// \param samples    Array receiving frameCount interleaved stereo frames
+    /// \param frameCount Number of frames to mix
+    ///
+    ////////////////////////////////////////////////////////////
+    void mix(Int16* samples, std::size_t frameCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of voices
+    ///
+    /// \return Maximum number of sounds playing at the same time
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getVoiceCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the sample rate of the output
+    ///
+    /// \return Sample rate, in samples per second
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getSampleRate() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the statistics of the mixing
+    ///
+    /// \return Mixing statistics
+    ///
+    ////////////////////////////////////////////////////////////
+    MixerStats getMixerStats() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset the statistics of the mixing
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetMixerStats();
+
+private :
+
+    friend class SoundBuffer;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop the voices playing a sound buffer
+    ///
+    /// This function is called by the buffer before its samples
+    /// are modified or destroyed.
+    ///
+    /// \param buffer Sound buffer to stop
+    ///
+    ////////////////////////////////////////////////////////////
+    void stopBuffer(const SoundBuffer& buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Sound playing in the mixer
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Voice
+    {
+        const SoundBuffer* buffer; ///< Buffer being played
+        const Int16* samples;      ///< Samples of the buffer, NULL if the voice is free
+        std::size_t  frameCount;   ///< Number of frames of the buffer
+        unsigned int channelCount; ///< Number of channels of the buffer (1 or 2)
+        unsigned int sampleRate;   ///< Sample rate of the buffer
+        Uint64       position;     ///< Position in the buffer, in frames, 32.32 fixed point
+        Uint64       step;         ///< Increment of the position per output frame, 32.32 fixed point
+        float        gainLeft;     ///< Gain applied to the left output channel
+        float        gainRight;    ///< Gain applied to the right output channel
+        float        volume;       ///< Volume of the voice, in [0, 1]
+        float        pan;          ///< Position in the stereo field, in [-1, 1]
+        int          priority;     ///< Priority of the sound
+        Uint32       generation;   ///< Incremented each time the voice is reused
+        Uint64       startOrder;   ///< Value of the start counter when the sound started
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the voice bound to an identifier
+    ///
+    /// This function must be called with m_mutex locked.
+    ///
+    /// \param voice Identifier of the voice
+    ///
+    /// \return Pointer to the voice, or NULL if it has finished
+    ///
+    ////////////////////////////////////////////////////////////
+    Voice* findVoice(VoiceId voice);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compute the channel gains of a voice from its volume and pan
+    ///
+    /// \param voice Voice to update
+    ///
+    ////////////////////////////////////////////////////////////
+    static void updateGains(Voice& voice);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a voice to the mix buffer
+    ///
+    /// \param voice      Voice to mix
+    /// \param frameCount Number of frames to mix
+    ///
+    /// \return Number of frames that were mixed before the end of the voice
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t mixVoice(Voice& voice, std::size_t frameCount);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    mutable Mutex      m_mutex;        ///< Protects the voices and the statistics
+    std::vector<Voice> m_voices;       ///< Pool of voices
+    unsigned int       m_sampleRate;   ///< Sample rate of the output
+    float              m_masterVolume; ///< Volume of the mix, in [0, 1]
+    Uint64             m_startCounter; ///< Number of sounds started so far, to find the oldest voice
+    std::vector<float> m_mixBuffer;    ///< Interleaved stereo mix, before conversion to 16 bits
+    std::vector<float> m_voiceBuffer;  ///< Resampled frames of the voice being mixed
+    SoundStream*       m_output;       ///< Stream playing the mix, if the default device is open
+    std::set<const SoundBuffer*> m_buffers; ///< Buffers played so far, which are attached to the mixer
+    MixerStats         m_stats;        ///< Mixing statistics
+};
+
+} // namespace sf
+
+
+#endif // SFML_SOUNDMIXER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::SoundMixer
+/// \ingroup audio
+///
+/// Every sf::Sound owns an OpenAL source, and implementations
+/// only provide a limited number of them (often 32 or 256). A
+/// game that plays lots of short sounds (footsteps, impacts,
+/// clicks) can run out of sources, and pays the overhead of
+/// each one even for sounds that last a few milliseconds.
+///
+/// sf::SoundMixer instead mixes the sounds in software into a
+/// single stereo stream, played through one OpenAL source. It
+/// has a fixed pool of voices; when they are all busy, a new
+/// sound steals the voice of the least important (then oldest)
+/// sound, so that important sounds are never dropped for
+/// incidental ones.
+///
+/// Each voice is resampled to the output rate (which also
+/// implements its pitch), and has its own volume and stereo
+/// position. The inner loops use SSE2 when the processor
+/// supports it.
+///
+/// The mix is delayed by the buffering of the output stream, by
+/// about 60 milliseconds. Music and long sounds that need 3D
+/// spatialization are better played by sf::Music and sf::Sound.
+///
+/// With the null device, nothing is sent to the audio hardware
+/// and the owner calls mix() to get the mixed samples, which is
+/// useful to test or benchmark the mixing, or to render sound
+/// offline.
+///
+/// Usage example:
+/// \code
+/// sf::SoundBuffer step;
+/// step.loadFromFile("step.wav");
+///
+/// sf::SoundMixer mixer(64);
+/// mixer.open();
+///
+/// // quiet, low priority sound slightly to the left
+/// mixer.play(step, 0, 50.f, -0.3f);
+///
+/// // important sound that is never stolen by footsteps
+/// sf::SoundMixer::VoiceId alarm = mixer.play(alarmBuffer, 10);
+/// ...
+/// mixer.stop(alarm);
+/// \endcode
+///
+/// \see sf::Sound, sf::SoundStream
+///
+////////////////////////////////////////////////////////////
@@ -30,13 +30,22 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Audio/Export.hpp>
 #include <SFML/Audio/SoundSource.hpp>
-#include <SFML/System/Thread.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/TaskScheduler.hpp>
 #include <SFML/System/Time.hpp>
 #include <cstdlib>
+#include <deque>
+#include <vector>
 
 
 namespace sf
 {
+namespace priv
+{
+    class StreamingThread;
+}
+
 ////////////////////////////////////////////////////////////
 /// \brief Abstract base class for streamed audio sources
 ///
@@ -55,6 +64,18 @@ public :
         std::size_t  sampleCount; ///< Number of samples pointed by Samples
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Statistics about the streaming of the audio data
+    ///
+    ////////////////////////////////////////////////////////////
+    struct StreamStats
+    {
+        Uint64 underrunCount; ///< Number of times the playing queue ran dry, causing a gap in the sound
+        Uint64 chunkCount;    ///< Number of chunks played
+        Time   meanLatency;   ///< Mean time between the decoding of a chunk and the start of its playback
+        Time   maxLatency;    ///< Longest time between the decoding of a chunk and the start of its playback
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Destructor
     ///
@@ -67,8 +88,9 @@ public :
     /// This function starts the stream if it was stopped, resumes
     /// it if it was paused, and restarts it from beginning if it
     /// was it already playing.
-    /// This function uses its own thread so that it doesn't block
-    /// the rest of the program while the stream is played.
+    /// The stream is played in the background by a thread shared
+    /// by all the streams, so that it doesn't block the rest of
+    /// the program.
     ///
     /// \see pause, stop
     ///
@@ -175,6 +197,78 @@ public :
     ////////////////////////////////////////////////////////////
     bool getLoop() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the number of audio buffers queued ahead of the playback
+    ///
+    /// More buffers make the stream more robust to a slow source
+    /// or a busy system, at the cost of memory. The change is
+    /// applied the next time the stream is started.
+    /// The default number of buffers is 3, the minimum is 2.
+    ///
+    /// \param bufferCount Number of buffers
+    ///
+    /// \see getBufferCount, setBufferDuration
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBufferCount(unsigned int bufferCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of audio buffers queued ahead of the playback
+    ///
+    /// \return Number of buffers
+    ///
+    /// \see setBufferCount
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getBufferCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the duration of audio requested for each buffer
+    ///
+    /// The audio queued ahead of the playback is at most the
+    /// buffer count times this duration: shorter buffers reduce
+    /// the delay before a change in the source (a seek, or new
+    /// data in a generated stream) is heard, but the source is
+    /// asked for data more often. The derived class decides the
+    /// actual size of the chunks it returns, but it should use
+    /// getChunkSampleCount() (sf::Music does).
+    /// The change is applied the next time the stream is started.
+    /// The default duration is 250 milliseconds.
+    ///
+    /// \param duration Duration of a buffer
+    ///
+    /// \see getBufferDuration, setBufferCount
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBufferDuration(Time duration);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the duration of audio requested for each buffer
+    ///
+    /// \return Duration of a buffer
+    ///
+    /// \see setBufferDuration
+    ///
+    ////////////////////////////////////////////////////////////
+    Time getBufferDuration() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the statistics of the streaming
+    ///
+    /// They are accumulated over all the playbacks of the stream
+    /// until resetStreamStats() is called.
+    ///
+    /// \return Streaming statistics
+    ///
+    ////////////////////////////////////////////////////////////
+    StreamStats getStreamStats() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset the statistics of the streaming
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetStreamStats();
+
 protected :
 
     ////////////////////////////////////////////////////////////
@@ -201,12 +295,29 @@ protected :
     ////////////////////////////////////////////////////////////
     void initialize(unsigned int channelCount, unsigned int sampleRate);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of samples to put in a chunk
+    ///
+    /// This is the number of samples (for all the channels) that
+    /// fills a buffer, according to the buffer duration and the
+    /// stream parameters.
+    ///
+    /// \return Number of samples per chunk
+    ///
+    /// \see setBufferDuration
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getChunkSampleCount() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Request a new chunk of audio samples from the stream source
     ///
     /// This function must be overriden by derived classes to provide
-    /// the audio samples to play. It is called continuously by the
-    /// streaming loop, in a separate thread.
+    /// the audio samples to play. It is called continuously while
+    /// the stream is playing, in a worker thread of the default
+    /// sf::TaskScheduler, ahead of the playback. The samples are
+    /// copied, so \a data only needs to remain valid until the
+    /// function is called again.
     /// The source can choose to stop the streaming loop at any time, by
     /// returning false to the caller.
     ///
@@ -230,66 +341,98 @@ protected :
 
 private :
 
+    friend class priv::StreamingThread;
+
     ////////////////////////////////////////////////////////////
-    /// \brief Function called as the entry point of the thread
+    /// \brief Chunk of samples decoded ahead of the playback
     ///
-    /// This function starts the streaming loop, and returns
-    /// only when the sound is stopped.
+    ////////////////////////////////////////////////////////////
+    struct PrefetchedChunk
+    {
+        std::vector<Int16> samples;     ///< Copy of the samples returned by onGetData
+        bool               last;        ///< Is it the last chunk before the end of the source?
+        bool               endOfStream; ///< Is it the last chunk to play (end of the source, not looping)?
+        Int64              decodeTime;  ///< Time at which the chunk was decoded, in microseconds
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Information about an audio buffer
     ///
     ////////////////////////////////////////////////////////////
-    void streamData();
+    struct BufferInfo
+    {
+        std::size_t sampleCount; ///< Number of samples in the buffer
+        bool        last;        ///< Is it the last buffer before the end of the source?
+        Int64       decodeTime;  ///< Time at which its chunk was decoded, in microseconds
+    };
 
     ////////////////////////////////////////////////////////////
-    /// \brief Fill a new buffer with audio samples, and append
-    ///        it to the playing queue
+    /// \brief Start streaming from the current source position
     ///
-    /// This function is called as soon as a buffer has been fully
-    /// consumed; it fills it again and inserts it back into the
-    /// playing queue.
+    /// The stream must be stopped.
     ///
-    /// \param buffer Number of the buffer to fill (in [0, BufferCount])
+    ////////////////////////////////////////////////////////////
+    void startStreaming();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decode chunks ahead of the playback
     ///
-    /// \return True if the stream source has requested to stop, false otherwise
+    /// This function runs in a worker thread of the default
+    /// task scheduler, and returns when all the chunks are full
+    /// or the end of the source is reached.
     ///
     ////////////////////////////////////////////////////////////
-    bool fillAndPushBuffer(unsigned int bufferNum);
+    void prefetch();
 
     ////////////////////////////////////////////////////////////
-    /// \brief Fill the audio buffers and put them all into the playing queue
+    /// \brief Refill the playing queue with the prefetched chunks
     ///
-    /// This function is called when playing starts and the
-    /// playing queue is empty.
+    /// This function is called periodically by the streaming
+    /// thread; it is the only one that touches the playing
+    /// queue while the stream is playing.
     ///
-    /// \return True if the derived class has requested to stop, false otherwise
+    /// \param nextUpdate Receives the time until the next buffer
+    ///                   of the queue is consumed
+    ///
+    /// \return False if the stream has reached its end and stopped
     ///
     ////////////////////////////////////////////////////////////
-    bool fillQueue();
+    bool update(Time& nextUpdate);
 
     ////////////////////////////////////////////////////////////
-    /// \brief Clear all the audio buffers and empty the playing queue
-    ///
-    /// This function is called when the stream is stopped.
+    /// \brief Stop the source and destroy the audio buffers
     ///
     ////////////////////////////////////////////////////////////
-    void clearQueue();
-
-    enum
-    {
-        BufferCount = 3 ///< Number of audio buffers used by the streaming loop
-    };
+    void releaseBuffers();
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    Thread        m_thread;                  ///< Thread running the background tasks
-    bool          m_isStreaming;             ///< Streaming state (true = playing, false = stopped)
-    unsigned int  m_buffers[BufferCount];    ///< Sound buffers used to store temporary audio data
-    unsigned int  m_channelCount;            ///< Number of channels (1 = mono, 2 = stereo, ...)
-    unsigned int  m_sampleRate;              ///< Frequency (samples / second)
-    Uint32        m_format;                  ///< Format of the internal sound buffers
-    bool          m_loop;                    ///< Loop flag (true to loop, false to play once)
-    Uint64        m_samplesProcessed;        ///< Number of buffers processed since beginning of the stream
-    bool          m_endBuffers[BufferCount]; ///< Each buffer is marked as "end buffer" or not, for proper duration calculation
+    bool                         m_isStreaming;      ///< Streaming state (true = playing, false = stopped)
+    unsigned int                 m_channelCount;     ///< Number of channels (1 = mono, 2 = stereo, ...)
+    unsigned int                 m_sampleRate;       ///< Frequency (samples / second)
+    Uint32                       m_format;           ///< Format of the internal sound buffers
+    bool                         m_loop;             ///< Loop flag (true to loop, false to play once)
+    Uint64                       m_samplesProcessed; ///< Number of samples played since the beginning of the stream
+    unsigned int                 m_bufferCount;      ///< Number of buffers to use for the next playback
+    Time                         m_bufferDuration;   ///< Duration of a buffer
+    std::vector<unsigned int>    m_buffers;          ///< Sound buffers used to store temporary audio data
+    std::vector<BufferInfo>      m_bufferInfos;      ///< Content of each buffer
+    std::vector<unsigned int>    m_freeBuffers;      ///< Indices of the buffers not in the playing queue
+    std::deque<unsigned int>     m_queuedBuffers;    ///< Indices of the buffers in the playing queue, in order
+    bool                         m_requestStop;      ///< Has the last chunk been queued?
+    bool                         m_hasStarted;       ///< Has the source been played since the stream started?
+    mutable Mutex                m_mutex;            ///< Protects the prefetched chunks and the statistics
+    std::vector<PrefetchedChunk> m_chunks;           ///< Ring of prefetched chunks
+    std::size_t                  m_firstChunk;       ///< Index of the oldest prefetched chunk
+    std::size_t                  m_chunkCount;       ///< Number of prefetched chunks ready to be queued
+    std::size_t                  m_playingCount;     ///< Number of chunks in the playing queue
+    bool                         m_prefetching;      ///< Is a prefetch task running?
+    bool                         m_endOfData;        ///< Has the source reached its end?
+    TaskScheduler::Task          m_prefetchTask;     ///< Last prefetch task
+    Clock                        m_clock;            ///< Time reference of the decode times
+    StreamStats                  m_stats;            ///< Streaming statistics
+    Int64                        m_latencySum;       ///< Sum of the latencies, in microseconds
 };
 
 } // namespace sf
@@ -323,13 +466,20 @@ private :
 /// \li onGetData fills a new chunk of audio data to be played
 /// \li onSeek changes the current playing position in the source
 ///
-/// It is important to note that each SoundStream is played in its
-/// own separate thread, so that the streaming loop doesn't block the
-/// rest of the program. In particular, the OnGetData and OnSeek
-/// virtual functions may sometimes be called from this separate thread.
+/// It is important to note that the streams are not played in
+/// the thread that called play(), so that streaming doesn't
+/// block the rest of the program. A single thread, shared by all
+/// the streams, keeps their playing queues filled; the chunks are
+/// requested ahead of time from the worker threads of the default
+/// sf::TaskScheduler. In particular, the onGetData and onSeek
+/// virtual functions may sometimes be called from these threads.
 /// It is important to keep this in mind, because you may have to take
 /// care of synchronization issues if you share data between threads. 
 ///
+/// The buffering can be tuned with setBufferCount and
+/// setBufferDuration, and getStreamStats tells whether the
+/// source keeps up with the playback.
+///
 /// Usage example:
 /// \code
 /// class CustomStream : public sf::SoundStream
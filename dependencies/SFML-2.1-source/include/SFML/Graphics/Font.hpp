@@ -34,6 +34,7 @@
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/String.hpp>
+#include <deque>
 #include <map>
 #include <string>
 #include <vector>
@@ -51,6 +52,20 @@ class SFML_GRAPHICS_API Font
 {
 public :
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Hit and miss counters of the font's caches
+    ///
+    ////////////////////////////////////////////////////////////
+    struct CacheStats
+    {
+        CacheStats();
+
+        Uint64 glyphHits;     ///< Number of glyphs found in the cache
+        Uint64 glyphMisses;   ///< Number of glyphs that had to be loaded
+        Uint64 kerningHits;   ///< Number of kerning values found in the cache
+        Uint64 kerningMisses; ///< Number of kerning values that had to be requested to FreeType
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
@@ -142,6 +157,37 @@ public :
     ////////////////////////////////////////////////////////////
     const Glyph& getGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a range of glyphs in advance
+    ///
+    /// Glyphs are normally rasterized and added to the texture
+    /// the first time they are requested, in the middle of a frame.
+    /// Preloading them, for example while a menu is loading,
+    /// avoids this cost later. Code points that the font doesn't
+    /// provide are skipped.
+    ///
+    /// \param first         First Unicode code point of the range
+    /// \param last          Last Unicode code point of the range (included)
+    /// \param characterSize Reference character size
+    /// \param bold          Load the bold version or the regular one?
+    ///
+    /// \see getGlyph
+    ///
+    ////////////////////////////////////////////////////////////
+    void preloadGlyphs(Uint32 first, Uint32 last, unsigned int characterSize, bool bold = false) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the glyphs of a set of characters in advance
+    ///
+    /// \param characters    Characters to load
+    /// \param characterSize Reference character size
+    /// \param bold          Load the bold version or the regular one?
+    ///
+    /// \see getGlyph
+    ///
+    ////////////////////////////////////////////////////////////
+    void preloadGlyphs(const String& characters, unsigned int characterSize, bool bold = false) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the kerning offset of two glyphs
     ///
@@ -180,6 +226,9 @@ public :
     /// are requested, thus it is not very relevant. It is mainly
     /// used internally by sf::Text.
     ///
+    /// In distance field mode, the same texture is returned for
+    /// all the character sizes.
+    ///
     /// \param characterSize Reference character size
     ///
     /// \return Texture containing the glyphs of the requested size
@@ -187,6 +236,83 @@ public :
     ////////////////////////////////////////////////////////////
     const Texture& getTexture(unsigned int characterSize) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the signed distance field mode
+    ///
+    /// In this mode, glyphs are rendered once, at \a referenceSize,
+    /// into a single texture shared by all the character sizes.
+    /// Instead of the coverage of each pixel, the texture stores
+    /// the distance to the outline of the glyph, from which
+    /// sf::Text reconstructs sharp edges at any size with a
+    /// shader. This saves the memory and the rendering time of
+    /// one texture per character size, which adds up quickly
+    /// when the text is scaled with the window.
+    ///
+    /// Small sizes look slightly softer than with regular
+    /// glyphs, since no hinting is applied. The mode is
+    /// disabled by default.
+    ///
+    /// Changing the mode discards all the loaded glyphs, so it
+    /// should be set before the font is used by any text.
+    ///
+    /// \param enabled       True to enable the distance field mode, false to disable it
+    /// \param referenceSize Character size at which the glyphs are rendered
+    ///
+    /// \see isDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    void setDistanceField(bool enabled, unsigned int referenceSize = 48);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the signed distance field mode is enabled
+    ///
+    /// \return True if the glyphs are stored as distance fields
+    ///
+    /// \see setDistanceField
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isDistanceField() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the hit and miss counters of the glyph and kerning caches
+    ///
+    /// These are meant for profiling text layout: a low hit rate
+    /// means that glyphs are loaded or kerning values computed
+    /// while the application runs.
+    ///
+    /// \return Counters accumulated since the font was loaded or
+    ///         since the last call to resetCacheStats
+    ///
+    /// \see resetCacheStats
+    ///
+    ////////////////////////////////////////////////////////////
+    const CacheStats& getCacheStats() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset the hit and miss counters of the caches to zero
+    ///
+    /// The cached glyphs and kerning values are kept.
+    ///
+    /// \see getCacheStats
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetCacheStats();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the identifier of the font's current contents
+    ///
+    /// The identifier is unique among all the fonts loaded by the
+    /// application. It changes every time the font is loaded and
+    /// every time its glyphs are discarded (see setDistanceField),
+    /// and it is shared by copies of the font. This makes it a
+    /// suitable key for caches built from the font's glyphs,
+    /// unlike the address of the font.
+    ///
+    /// \return Identifier of the font, or 0 if nothing is loaded
+    ///
+    ////////////////////////////////////////////////////////////
+    Uint64 getCacheId() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Overload of assignment operator
     ///
@@ -200,22 +326,68 @@ public :
 private :
 
     ////////////////////////////////////////////////////////////
-    /// \brief Structure defining a row of glyphs
+    /// \brief Structure defining a horizontal segment of the skyline
+    ///
+    /// The skyline is the outline of the bottom of the free
+    /// space in the texture: every pixel below a segment
+    /// is either used by a glyph or lost.
     ///
     ////////////////////////////////////////////////////////////
-    struct Row
+    struct Segment
     {
-        Row(unsigned int rowTop, unsigned int rowHeight) : width(0), top(rowTop), height(rowHeight) {}
+        Segment(unsigned int segmentLeft, unsigned int segmentTop, unsigned int segmentWidth) : left(segmentLeft), top(segmentTop), width(segmentWidth) {}
 
-        unsigned int width;  ///< Current width of the row
-        unsigned int top;    ///< Y position of the row into the texture
-        unsigned int height; ///< Height of the row
+        unsigned int left;  ///< X position of the segment into the texture
+        unsigned int top;   ///< Y position of the free space above the segment
+        unsigned int width; ///< Width of the segment
     };
 
     ////////////////////////////////////////////////////////////
-    // Types
+    /// \brief Open addressing hash table mapping 64-bit keys to integers
+    ///
+    /// Lookups are a hash and a few comparisons in a contiguous
+    /// array, which is much faster than a std::map for the tiny
+    /// keys used by the glyph and kerning caches.
+    ///
     ////////////////////////////////////////////////////////////
-    typedef std::map<Uint32, Glyph> GlyphTable; ///< Table mapping a codepoint to its glyph
+    class HashTable
+    {
+    public :
+
+        HashTable();
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Find the value associated to a key
+        ///
+        /// \param key   Key to search
+        /// \param value Receives the value if the key is found
+        ///
+        /// \return True if the key was found
+        ///
+        ////////////////////////////////////////////////////////////
+        bool find(Uint64 key, int& value) const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Add a key that is not in the table yet
+        ///
+        /// \param key   Key to add
+        /// \param value Value associated to the key
+        ///
+        ////////////////////////////////////////////////////////////
+        void insert(Uint64 key, int value);
+
+    private :
+
+        struct Slot
+        {
+            Uint64 key;   ///< Key of the entry
+            int    value; ///< Value of the entry
+            bool   used;  ///< Does the slot contain an entry?
+        };
+
+        std::vector<Slot> m_slots; ///< Slots, the size is always a power of two
+        std::size_t       m_count; ///< Number of used slots
+    };
 
     ////////////////////////////////////////////////////////////
     /// \brief Structure defining a page of glyphs
@@ -225,10 +397,12 @@ private :
     {
         Page();
 
-        GlyphTable       glyphs;  ///< Table mapping code points to their corresponding glyph
-        sf::Texture      texture; ///< Texture containing the pixels of the glyphs
-        unsigned int     nextRow; ///< Y position of the next new row in the texture
-        std::vector<Row> rows;    ///< List containing the position of all the existing rows
+        HashTable            glyphIndices; ///< Table mapping code points (and bold flag) to the index of their glyph
+        std::deque<Glyph>    glyphs;       ///< Loaded glyphs (a deque keeps references valid when it grows)
+        HashTable            kernings;     ///< Cache of the kerning of the character pairs
+        int                  lineSpacing;  ///< Cached line spacing, or -1 if not computed yet
+        sf::Texture          texture;      ///< Texture containing the pixels of the glyphs
+        std::vector<Segment> skyline;      ///< Segments of the skyline, sorted from left to right
     };
 
     ////////////////////////////////////////////////////////////
@@ -237,9 +411,49 @@ private :
     ////////////////////////////////////////////////////////////
     void cleanup();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the page of glyphs of a character size, create it if needed
+    ///
+    /// The last page is remembered, so that consecutive requests
+    /// for the same size don't search the page table.
+    ///
+    /// \param characterSize Reference character size
+    ///
+    /// \return Page of glyphs of the requested size
+    ///
+    ////////////////////////////////////////////////////////////
+    Page& getPage(unsigned int characterSize) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the texture of a page if it doesn't exist yet
+    ///
+    /// Textures are created on demand, so that the pages that only
+    /// hold metrics in distance field mode don't use video memory.
+    ///
+    /// \param page Page to initialize
+    ///
+    ////////////////////////////////////////////////////////////
+    void initializePage(Page& page) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Search a glyph in the cache, and load it if needed
+    ///
+    /// \param codePoint     Unicode code point of the character to get
+    /// \param characterSize Reference character size
+    /// \param bold          Retrieve the bold version or the regular one?
+    /// \param flush         Flush OpenGL if the glyph had to be loaded?
+    ///
+    /// \return The glyph corresponding to \a codePoint and \a characterSize
+    ///
+    ////////////////////////////////////////////////////////////
+    const Glyph& findGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, bool flush) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Load a new glyph and store it in the cache
     ///
+    /// In distance field mode, the glyph is written as a distance
+    /// field to the shared page.
+    ///
     /// \param codePoint     Unicode code point of the character to load
     /// \param characterSize Reference character size
     /// \param bold          Retrieve the bold version or the regular one?
@@ -261,6 +475,18 @@ private :
     ////////////////////////////////////////////////////////////
     IntRect findGlyphRect(Page& page, unsigned int width, unsigned int height) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Make the texture of a page two times bigger
+    ///
+    /// The existing glyphs are copied on the GPU.
+    ///
+    /// \param page Page of glyphs to grow
+    ///
+    /// \return True on success, false if the maximum texture size was reached
+    ///
+    ////////////////////////////////////////////////////////////
+    bool growPage(Page& page) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Make sure that the given size is the current one
     ///
@@ -285,6 +511,12 @@ private :
     int*                       m_refCount;    ///< Reference counter used by implicit sharing
     mutable PageTable          m_pages;       ///< Table containing the glyphs pages by character size
     mutable std::vector<Uint8> m_pixelBuffer; ///< Pixel buffer holding a glyph's pixels before being written to the texture
+    mutable Page*              m_lastPage;    ///< Last page returned by getPage
+    mutable Page               m_fieldPage;   ///< Page shared by all the character sizes in distance field mode
+    unsigned int               m_fieldSize;   ///< Reference character size of the distance field glyphs, or 0 if the mode is disabled
+    mutable unsigned int       m_lastSize;    ///< Character size of the last page
+    mutable CacheStats         m_stats;       ///< Hit and miss counters of the caches
+    Uint64                     m_cacheId;     ///< Unique number that identifies the font's contents
 };
 
 } // namespace sf
@@ -327,6 +559,16 @@ private :
 /// used by a sf::Text (i.e. never write a function that
 /// uses a local sf::Font instance for creating a text).
 ///
+/// Glyphs are rendered on demand, the first time a text
+/// displays them. To avoid this cost while the application
+/// runs, the glyphs that are known to be needed can be
+/// loaded up front with preloadGlyphs.
+///
+/// Applications that display text at many different sizes,
+/// for example a user interface scaled with the window, can
+/// enable the distance field mode (see setDistanceField):
+/// all the sizes are then drawn from a single texture.
+///
 /// Usage example:
 /// \code
 /// // Declare a new font
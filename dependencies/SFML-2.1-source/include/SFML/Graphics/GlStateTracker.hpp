@@ -0,0 +1,306 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_GLSTATETRACKER_HPP
+#define SFML_GLSTATETRACKER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+
+namespace sf
+{
+class Vertex;
+
+////////////////////////////////////////////////////////////
+/// \brief Remembers the OpenGL states of a context to skip
+///        redundant state changes
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API GlStateTracker : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Groups of states, for invalidation
+    ///
+    ////////////////////////////////////////////////////////////
+    enum StateGroup
+    {
+        Capabilities = 1 << 0, ///< States toggled by glEnable/glDisable
+        ClientStates = 1 << 1, ///< States toggled by glEnableClientState/glDisableClientState
+        Matrices     = 1 << 2, ///< Matrix mode, projection, model-view and texture matrices
+        Viewport     = 1 << 3, ///< Viewport rectangle
+        Blending     = 1 << 4, ///< Blend and alpha test functions
+        Textures     = 1 << 5, ///< Texture bound to the 2D target
+        VertexArrays = 1 << 6, ///< Vertex, color and texture coordinates pointers
+
+        AllStates = Capabilities | ClientStates | Matrices | Viewport | Blending | Textures | VertexArrays ///< Everything
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Counts of the state changes requested to the tracker
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Statistics
+    {
+        Statistics();
+
+        unsigned int callsMade;   ///< Number of OpenGL calls issued
+        unsigned int callsElided; ///< Number of OpenGL calls skipped because the state was already set
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// All the states are unknown until they are first set.
+    ///
+    ////////////////////////////////////////////////////////////
+    GlStateTracker();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Forget the value of some states
+    ///
+    /// This function must be called after changing states with
+    /// direct OpenGL calls, so that the next request for these
+    /// states is not skipped by mistake.
+    ///
+    /// \param groups Combination of StateGroup values
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidate(unsigned int groups = AllStates);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable a capability (glEnable/glDisable)
+    ///
+    /// Only GL_BLEND, GL_TEXTURE_2D, GL_ALPHA_TEST, GL_DEPTH_TEST,
+    /// GL_CULL_FACE, GL_LIGHTING and GL_SCISSOR_TEST are tracked;
+    /// other capabilities are always set.
+    ///
+    /// \param capability OpenGL capability
+    /// \param enabled    True to enable it, false to disable it
+    ///
+    ////////////////////////////////////////////////////////////
+    void setEnabled(unsigned int capability, bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable a client-side array
+    ///
+    /// Only GL_VERTEX_ARRAY, GL_COLOR_ARRAY and
+    /// GL_TEXTURE_COORD_ARRAY are tracked; other arrays are
+    /// always set.
+    ///
+    /// \param array   OpenGL array
+    /// \param enabled True to enable it, false to disable it
+    ///
+    ////////////////////////////////////////////////////////////
+    void setClientStateEnabled(unsigned int array, bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Select the current matrix stack (glMatrixMode)
+    ///
+    /// \param mode GL_MODELVIEW, GL_PROJECTION or GL_TEXTURE
+    ///
+    ////////////////////////////////////////////////////////////
+    void setMatrixMode(unsigned int mode);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load a matrix into a matrix stack
+    ///
+    /// The matrix mode is changed only if the matrix has to be
+    /// loaded, so it must not be relied on afterwards.
+    ///
+    /// \param mode   GL_MODELVIEW, GL_PROJECTION or GL_TEXTURE
+    /// \param matrix 4x4 matrix, in OpenGL's column-major order
+    ///
+    ////////////////////////////////////////////////////////////
+    void loadMatrix(unsigned int mode, const float* matrix);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the viewport (glViewport)
+    ///
+    /// \param viewport Viewport rectangle, in OpenGL's window
+    ///                 coordinates (origin at the bottom)
+    ///
+    ////////////////////////////////////////////////////////////
+    void setViewport(const IntRect& viewport);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the blending factors
+    ///
+    /// Different factors for the alpha channel are only
+    /// applied if GL_EXT_blend_func_separate is available.
+    ///
+    /// \param sourceColor      Source factor of the color channels
+    /// \param destinationColor Destination factor of the color channels
+    /// \param sourceAlpha      Source factor of the alpha channel
+    /// \param destinationAlpha Destination factor of the alpha channel
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBlendFunc(unsigned int sourceColor, unsigned int destinationColor,
+                      unsigned int sourceAlpha, unsigned int destinationAlpha);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the alpha test function (glAlphaFunc)
+    ///
+    /// \param function  OpenGL comparison function
+    /// \param reference Reference value
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAlphaFunc(unsigned int function, float reference);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind a texture for rendering
+    ///
+    /// This is sf::Texture::bind, skipped if the texture is
+    /// already bound with the same coordinate type. Binding a
+    /// texture may load the texture matrix.
+    ///
+    /// \param texture        Texture to bind, or NULL to unbind
+    /// \param coordinateType Type of texture coordinates to use
+    ///
+    ////////////////////////////////////////////////////////////
+    void bindTexture(const Texture* texture, Texture::CoordinateType coordinateType = Texture::Normalized);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Point the vertex, color and texture coordinates
+    ///        arrays to an array of sf::Vertex
+    ///
+    /// \param vertices Pointer to the vertices
+    ///
+    ////////////////////////////////////////////////////////////
+    void setVertexArrays(const Vertex* vertices);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief End the current frame
+    ///
+    /// The counts of the frame become available through
+    /// getFrameStatistics, and new counts are started.
+    /// sf::RenderWindow and sf::RenderTexture call it in their
+    /// display function.
+    ///
+    ////////////////////////////////////////////////////////////
+    void endFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the counts of the last complete frame
+    ///
+    /// \return Statistics of the last frame
+    ///
+    ////////////////////////////////////////////////////////////
+    const Statistics& getFrameStatistics() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tracked value of a capability or client array
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Switch
+    {
+        unsigned int name;  ///< OpenGL enum of the state
+        int          value; ///< 1 if enabled, 0 if disabled, -1 if unknown
+    };
+
+    enum
+    {
+        SwitchCount = 7,   ///< Number of tracked capabilities
+        ArrayCount  = 3,   ///< Number of tracked client arrays
+        MatrixCount = 3    ///< Number of tracked matrix stacks
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Switch                  m_capabilities[SwitchCount];   ///< glEnable states
+    Switch                  m_arrays[ArrayCount];          ///< glEnableClientState states
+    unsigned int            m_matrixMode;                  ///< Current matrix stack, 0 if unknown
+    bool                    m_matrixKnown[MatrixCount];    ///< Are the matrices known?
+    float                   m_matrices[MatrixCount][16];   ///< Modelview, projection and texture matrices
+    bool                    m_viewportKnown;               ///< Is the viewport known?
+    IntRect                 m_viewport;                    ///< Current viewport
+    bool                    m_blendKnown;                  ///< Are the blending factors known?
+    unsigned int            m_blendFactors[4];             ///< Current blending factors
+    bool                    m_alphaKnown;                  ///< Is the alpha test function known?
+    unsigned int            m_alphaFunction;               ///< Current alpha test function
+    float                   m_alphaReference;              ///< Current alpha test reference
+    bool                    m_textureKnown;                ///< Is the bound texture known?
+    Uint64                  m_textureId;                   ///< Cache identifier of the bound texture, 0 if none
+    Texture::CoordinateType m_coordinateType;              ///< Coordinate type of the bound texture
+    const Vertex*           m_vertices;                    ///< Current vertex arrays, NULL if unknown
+    Statistics              m_frame;                       ///< Counts of the current frame
+    Statistics              m_lastFrame;                   ///< Counts of the last complete frame
+};
+
+} // namespace sf
+
+
+#endif // SFML_GLSTATETRACKER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::GlStateTracker
+/// \ingroup graphics
+///
+/// Every OpenGL call has a cost, even when it sets a state to
+/// the value it already has. sf::GlStateTracker remembers the
+/// fixed-pipeline states it has set, and skips the calls that
+/// wouldn't change anything.
+///
+/// Each render target has its own tracker (see
+/// sf::RenderTarget::getGlStateTracker), which it uses for all
+/// its drawing. Code that mixes its own OpenGL rendering with
+/// SFML's can set its states through the same tracker: SFML
+/// then knows what was changed, and neither side needs to save,
+/// restore or reset all the states around its rendering. States
+/// changed with direct OpenGL calls must be reported with
+/// invalidate().
+///
+/// The tracker counts the calls it makes and skips. The counts
+/// are grouped by frame, and those of the last frame are
+/// returned by getFrameStatistics.
+///
+/// Usage example:
+/// \code
+/// window.setActive();
+/// sf::GlStateTracker& states = window.getGlStateTracker();
+/// states.setEnabled(GL_DEPTH_TEST, true);
+/// glDrawElements(...);
+/// states.setEnabled(GL_DEPTH_TEST, false);
+/// window.draw(sprite);
+///
+/// window.display();
+/// const sf::GlStateTracker::Statistics& stats = states.getFrameStatistics();
+/// std::cout << stats.callsMade << " calls, " << stats.callsElided << " skipped" << std::endl;
+/// \endcode
+///
+/// \see sf::RenderTarget
+///
+////////////////////////////////////////////////////////////
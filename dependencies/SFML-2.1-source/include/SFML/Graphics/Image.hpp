@@ -254,6 +254,8 @@ public :
 
 private :
 
+    friend class ImageDecoder;
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
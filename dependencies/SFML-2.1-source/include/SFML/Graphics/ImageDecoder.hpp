@@ -0,0 +1,389 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_IMAGEDECODER_HPP
+#define SFML_IMAGEDECODER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/TaskScheduler.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <string>
+#include <vector>
+
+
+namespace sf
+{
+class Image;
+
+////////////////////////////////////////////////////////////
+/// \brief Decode batches of image files in parallel
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API ImageDecoder : NonCopyable
+{
+private :
+
+    struct Job;
+
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Handle to the result of a pending decode
+    ///
+    ////////////////////////////////////////////////////////////
+    class SFML_GRAPHICS_API Future
+    {
+    public :
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Default constructor
+        ///
+        /// Creates an invalid future, not bound to any decode.
+        ///
+        ////////////////////////////////////////////////////////////
+        Future();
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Copy constructor
+        ///
+        /// \param copy Instance to copy
+        ///
+        ////////////////////////////////////////////////////////////
+        Future(const Future& copy);
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Destructor
+        ///
+        ////////////////////////////////////////////////////////////
+        ~Future();
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Overload of assignment operator
+        ///
+        /// \param right Instance to assign
+        ///
+        /// \return Reference to self
+        ///
+        ////////////////////////////////////////////////////////////
+        Future& operator =(const Future& right);
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Tell whether the future is bound to a decode
+        ///
+        /// \return True if the future was returned by a decoder
+        ///
+        ////////////////////////////////////////////////////////////
+        bool isValid() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Tell whether the decode has finished
+        ///
+        /// This function never blocks.
+        ///
+        /// \return True if the result is available
+        ///
+        ////////////////////////////////////////////////////////////
+        bool isReady() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Wait until the decode has finished
+        ///
+        /// If no worker has picked up the decode yet, it is
+        /// performed directly in the calling thread instead of
+        /// waiting for a free worker.
+        ///
+        /// \return True if the image was successfully decoded
+        ///
+        ////////////////////////////////////////////////////////////
+        bool wait() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Wait for the decode and move the result to an image
+        ///
+        /// The decoded pixels are transferred without any copy;
+        /// the previous pixel storage of \a image is given back to
+        /// the decoder so that it can be reused by later decodes.
+        /// The result can only be retrieved once: further calls
+        /// (even through copies of this future) return false.
+        ///
+        /// \param image Image to fill with the decoded pixels
+        ///
+        /// \return True if the image was successfully retrieved
+        ///
+        ////////////////////////////////////////////////////////////
+        bool get(Image& image);
+
+    private :
+
+        friend class ImageDecoder;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Construct the future from a decoder job
+        ///
+        /// The future adopts a reference that was already added
+        /// to the job.
+        ///
+        /// \param decoder Decoder which owns the job
+        /// \param job     Job to bind to
+        ///
+        ////////////////////////////////////////////////////////////
+        Future(ImageDecoder* decoder, Job* job);
+
+        ////////////////////////////////////////////////////////////
+        // Member data
+        ////////////////////////////////////////////////////////////
+        ImageDecoder* m_decoder; ///< Decoder that processes the job
+        Job*          m_job;     ///< Shared state of the decode
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// \param scheduler Scheduler running the decodes, by default
+    ///                  the one shared by the whole program
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit ImageDecoder(TaskScheduler& scheduler = TaskScheduler::getDefault());
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// Waits until all the pending decodes have finished.
+    /// The futures returned by the decoder must not be used
+    /// after it is destroyed.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~ImageDecoder();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue the decoding of an image file on disk
+    ///
+    /// The supported image formats are the same as those of
+    /// sf::Image::loadFromFile.
+    ///
+    /// \param filename Path of the image file to load
+    ///
+    /// \return Future holding the result of the decode
+    ///
+    ////////////////////////////////////////////////////////////
+    Future loadFromFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue the decoding of an image file in memory
+    ///
+    /// The data is not copied: it must remain valid until the
+    /// returned future is ready.
+    ///
+    /// \param data Pointer to the file data in memory
+    /// \param size Size of the data to load, in bytes
+    ///
+    /// \return Future holding the result of the decode
+    ///
+    ////////////////////////////////////////////////////////////
+    Future loadFromMemory(const void* data, std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue the decoding of a batch of image files
+    ///
+    /// \param filenames Paths of the image files to load
+    ///
+    /// \return Futures holding the results, in the same order as \a filenames
+    ///
+    ////////////////////////////////////////////////////////////
+    std::vector<Future> loadFromFiles(const std::vector<std::string>& filenames);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Give the pixel storage of an image back to the decoder
+    ///
+    /// Once an image has been uploaded to a texture its pixels
+    /// are usually not needed anymore. Recycling them allows
+    /// the following decodes to reuse the memory instead of
+    /// allocating new buffers. The image is left empty.
+    ///
+    /// \param image Image to recycle
+    ///
+    ////////////////////////////////////////////////////////////
+    void recycle(Image& image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait until all the queued decodes have finished
+    ///
+    ////////////////////////////////////////////////////////////
+    void wait();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of worker threads
+    ///
+    /// \return Number of threads of the scheduler, which can
+    ///         decode in parallel
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getWorkerCount() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a job to the scheduler
+    ///
+    /// \param job Job to enqueue
+    ///
+    /// \return Future bound to the job
+    ///
+    ////////////////////////////////////////////////////////////
+    Future push(Job* job);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Task function decoding a job in a worker
+    ///
+    /// Does nothing but releasing the job if a waiting thread
+    /// already decoded it.
+    ///
+    /// \param job Job to decode
+    ///
+    ////////////////////////////////////////////////////////////
+    static void run(Job* job);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Mark a job as running and give it a pooled buffer
+    ///
+    /// This function must be called with m_mutex locked.
+    ///
+    /// \param job Pending job
+    ///
+    ////////////////////////////////////////////////////////////
+    void start(Job* job);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decode a job that was started
+    ///
+    /// \param job Job to decode
+    ///
+    ////////////////////////////////////////////////////////////
+    void process(Job* job);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move the result of a finished job to an image
+    ///
+    /// \param job   Finished job
+    /// \param image Image to fill with the decoded pixels
+    ///
+    /// \return True if the pixels were not already retrieved
+    ///
+    ////////////////////////////////////////////////////////////
+    bool retrieve(Job* job, Image& image);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a reference to a job
+    ///
+    /// \param job Job to reference
+    ///
+    ////////////////////////////////////////////////////////////
+    void acquire(Job* job);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a reference to a job, and destroy it if unused
+    ///
+    /// \param job Job to release
+    ///
+    ////////////////////////////////////////////////////////////
+    void release(Job* job);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Put a pixel buffer into the pool
+    ///
+    /// This function must be called with m_mutex locked.
+    ///
+    /// \param pixels Buffer to pool, it is left empty
+    ///
+    ////////////////////////////////////////////////////////////
+    void storeBuffer(std::vector<Uint8>& pixels);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    TaskScheduler&                   m_scheduler; ///< Scheduler running the decodes
+    mutable Mutex                    m_mutex;     ///< Protects the tasks, the pool and the jobs' state
+    std::vector<TaskScheduler::Task> m_tasks;     ///< Decodes that may not be finished yet
+    std::vector<std::vector<Uint8> > m_pool;      ///< Pixel buffers available for reuse
+};
+
+} // namespace sf
+
+
+#endif // SFML_IMAGEDECODER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::ImageDecoder
+/// \ingroup graphics
+///
+/// sf::ImageDecoder decodes image files on the worker threads
+/// of a sf::TaskScheduler, so that loading many images at once
+/// (typically all the textures of a game when it starts) takes
+/// advantage of all the processor cores instead of decoding
+/// one file after the other in the main thread. By default the
+/// scheduler shared by the whole program is used, so the
+/// decoder doesn't start any thread of its own.
+///
+/// Each queued file gives a sf::ImageDecoder::Future, which can
+/// be polled or waited for, and which finally transfers the
+/// decoded pixels to a sf::Image.
+///
+/// To avoid reallocating pixel memory for every file, the
+/// decoder keeps a pool of pixel buffers: the previous content
+/// of the images passed to Future::get, as well as the images
+/// explicitly given back with recycle(), are reused by the
+/// next decodes.
+///
+/// Decoding doesn't need an OpenGL context, but textures must
+/// still be created from the resulting images in a thread
+/// that has one (usually the main thread).
+///
+/// Usage example:
+/// \code
+/// std::vector<std::string> files;
+/// files.push_back("background.jpg");
+/// files.push_back("player.png");
+///
+/// sf::ImageDecoder decoder;
+/// std::vector<sf::ImageDecoder::Future> futures = decoder.loadFromFiles(files);
+///
+/// std::vector<sf::Texture> textures(files.size());
+/// sf::Image image;
+/// for (std::size_t i = 0; i < futures.size(); ++i)
+/// {
+///     if (futures[i].get(image))
+///         textures[i].loadFromImage(image);
+/// }
+/// decoder.recycle(image);
+/// \endcode
+///
+/// \see sf::Image, sf::Texture, sf::TaskScheduler
+///
+////////////////////////////////////////////////////////////
@@ -37,6 +37,7 @@
 #include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/PrimitiveType.hpp>
 #include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/GlStateTracker.hpp>
 #include <SFML/System/NonCopyable.hpp>
 
 
@@ -64,10 +65,13 @@ public :
     /// This function is usually called once every frame,
     /// to clear the previous contents of the target.
     ///
+    /// It is virtual so that a derived class can record the
+    /// command instead of executing it, see draw.
+    ///
     /// \param color Fill color to use to clear the render target
     ///
     ////////////////////////////////////////////////////////////
-    void clear(const Color& color = Color(0, 0, 0, 255));
+    virtual void clear(const Color& color = Color(0, 0, 0, 255));
 
     ////////////////////////////////////////////////////////////
     /// \brief Change the current active view
@@ -238,14 +242,21 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Draw primitives defined by an array of vertices
     ///
+    /// All the drawables end up calling this function. It is
+    /// virtual so that a derived class can record the vertices
+    /// and states instead of drawing them, for example to replay
+    /// them later in another thread. Such a class should also
+    /// override clear, and bring the other overloads back in
+    /// scope with a using declaration.
+    ///
     /// \param vertices    Pointer to the vertices
     /// \param vertexCount Number of vertices in the array
     /// \param type        Type of primitives to draw
     /// \param states      Render states to use for drawing
     ///
     ////////////////////////////////////////////////////////////
-    void draw(const Vertex* vertices, unsigned int vertexCount,
-              PrimitiveType type, const RenderStates& states = RenderStates::Default);
+    virtual void draw(const Vertex* vertices, unsigned int vertexCount,
+                      PrimitiveType type, const RenderStates& states = RenderStates::Default);
 
     ////////////////////////////////////////////////////////////
     /// \brief Return the size of the rendering region of the target
@@ -323,6 +334,24 @@ public :
     ////////////////////////////////////////////////////////////
     void resetGLStates();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the OpenGL states tracker of the target
+    ///
+    /// The target sets all its OpenGL states through this
+    /// tracker. OpenGL code drawing to the same target can set
+    /// its own states through it too: this is cheaper than
+    /// pushGLStates/popGLStates or resetGLStates, because only
+    /// the states that really change are set, on both sides.
+    /// The target must be active when the tracker is used.
+    ///
+    /// The tracker also counts the state changes of each frame,
+    /// see sf::GlStateTracker::getFrameStatistics.
+    ///
+    /// \return Reference to the tracker of the target
+    ///
+    ////////////////////////////////////////////////////////////
+    GlStateTracker& getGlStateTracker();
+
 protected :
 
     ////////////////////////////////////////////////////////////
@@ -356,22 +385,6 @@ private:
     ////////////////////////////////////////////////////////////
     void applyBlendMode(BlendMode mode);
 
-    ////////////////////////////////////////////////////////////
-    /// \brief Apply a new transform
-    ///
-    /// \param transform Transform to apply
-    ///
-    ////////////////////////////////////////////////////////////
-    void applyTransform(const Transform& transform);
-
-    ////////////////////////////////////////////////////////////
-    /// \brief Apply a new texture
-    ///
-    /// \param texture Texture to apply
-    ///
-    ////////////////////////////////////////////////////////////
-    void applyTexture(const Texture* texture);
-
     ////////////////////////////////////////////////////////////
     /// \brief Apply a new shader
     ///
@@ -404,18 +417,17 @@ private:
 
         bool      glStatesSet;    ///< Are our internal GL states set yet?
         bool      viewChanged;    ///< Has the current view changed since last draw?
-        BlendMode lastBlendMode;  ///< Cached blending mode
-        Uint64    lastTextureId;  ///< Cached texture
-        bool      useVertexCache; ///< Did we previously use the vertex cache?
+        IntRect   viewport;       ///< Viewport of the current view, in OpenGL coordinates
         Vertex    vertexCache[VertexCacheSize]; ///< Pre-transformed vertices cache
     };
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    View        m_defaultView; ///< Default view
-    View        m_view;        ///< Current view
-    StatesCache m_cache;       ///< Render states cache
+    View           m_defaultView; ///< Default view
+    View           m_view;        ///< Current view
+    StatesCache    m_cache;       ///< Render states cache
+    GlStateTracker m_glStates;    ///< OpenGL states of the target's context
 };
 
 } // namespace sf
@@ -443,7 +455,8 @@ private:
 /// On top of that, render targets are still able to render direct
 /// OpenGL stuff. It is even possible to mix together OpenGL calls
 /// and regular SFML drawing commands. When doing so, make sure that
-/// OpenGL states are not messed up by calling the
+/// OpenGL states are not messed up, either by setting them through
+/// the target's sf::GlStateTracker, or by calling the
 /// pushGLStates/popGLStates functions.
 ///
 /// \see sf::RenderWindow, sf::RenderTexture, sf::View
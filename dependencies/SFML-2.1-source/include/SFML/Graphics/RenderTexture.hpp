@@ -230,6 +230,12 @@ private :
 /// \li creating a sprite from a 3D object rendered with OpenGL
 /// \li etc.
 ///
+/// A render-texture doesn't need a window: on Linux, if SFML was
+/// built with EGL and no X server can be reached (or the
+/// SFML_HEADLESS environment variable is set), the OpenGL contexts
+/// are created with EGL instead of GLX, so that programs which only
+/// render offscreen also run on machines without a display.
+///
 /// Usage example:
 ///
 /// \code
@@ -148,6 +148,15 @@ protected:
     ////////////////////////////////////////////////////////////
     virtual void onResize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called after a frame has been displayed
+    ///
+    /// This function is called so that derived classes can
+    /// perform their own per-frame work.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onDisplay();
+
 private :
 
     ////////////////////////////////////////////////////////////
@@ -37,6 +37,7 @@
 #include <SFML/System/Vector3.hpp>
 #include <map>
 #include <string>
+#include <vector>
 
 
 namespace sf
@@ -70,6 +71,22 @@ public :
     struct CurrentTextureType {};
     static CurrentTextureType CurrentTexture;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Handle to a parameter of the shader
+    ///
+    /// \see getParameterHandle
+    ///
+    ////////////////////////////////////////////////////////////
+    typedef int ParameterHandle;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Handle to a uniform block of the shader
+    ///
+    /// \see getBlockHandle
+    ///
+    ////////////////////////////////////////////////////////////
+    typedef int BlockHandle;
+
 public :
 
     ////////////////////////////////////////////////////////////
@@ -447,6 +464,212 @@ public :
     ////////////////////////////////////////////////////////////
     void setParameter(const std::string& name, CurrentTextureType);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Resolve a parameter of the shader into a handle
+    ///
+    /// Setting a parameter by name has to look the name up every
+    /// time. Effects that update their parameters every frame
+    /// should rather resolve them once, after the shader is
+    /// loaded, and use the handle overloads of setParameter.
+    ///
+    /// Handles stay valid until the shader is loaded again.
+    /// Names that are not found in the shader are remembered
+    /// too, and reported only the first time.
+    ///
+    /// \param name Name of the parameter in the shader
+    ///
+    /// \return Handle to the parameter, or -1 if it was not found
+    ///
+    ////////////////////////////////////////////////////////////
+    ParameterHandle getParameterHandle(const std::string& name);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a float parameter of the shader
+    ///
+    /// The value is only stored: all the parameters modified
+    /// since the last draw are sent to the graphics card at once
+    /// when the shader is bound. This function does nothing if
+    /// \a handle is -1.
+    ///
+    /// \param handle Handle of the parameter (float GLSL type)
+    /// \param x      Value to assign
+    ///
+    /// \see getParameterHandle
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(ParameterHandle handle, float x);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 2-components vector parameter of the shader
+    ///
+    /// \param handle Handle of the parameter (vec2 GLSL type)
+    /// \param x      First component of the value to assign
+    /// \param y      Second component of the value to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(ParameterHandle handle, float x, float y);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 3-components vector parameter of the shader
+    ///
+    /// \param handle Handle of the parameter (vec3 GLSL type)
+    /// \param x      First component of the value to assign
+    /// \param y      Second component of the value to assign
+    /// \param z      Third component of the value to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(ParameterHandle handle, float x, float y, float z);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 4-components vector parameter of the shader
+    ///
+    /// \param handle Handle of the parameter (vec4 GLSL type)
+    /// \param x      First component of the value to assign
+    /// \param y      Second component of the value to assign
+    /// \param z      Third component of the value to assign
+    /// \param w      Fourth component of the value to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(ParameterHandle handle, float x, float y, float z, float w);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 2-components vector parameter of the shader
+    ///
+    /// \param handle Handle of the parameter (vec2 GLSL type)
+    /// \param vector Vector to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(ParameterHandle handle, const Vector2f& vector);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a 3-components vector parameter of the shader
+    ///
+    /// \param handle Handle of the parameter (vec3 GLSL type)
+    /// \param vector Vector to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(ParameterHandle handle, const Vector3f& vector);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a color parameter of the shader
+    ///
+    /// \param handle Handle of the parameter (vec4 GLSL type)
+    /// \param color  Color to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(ParameterHandle handle, const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a matrix parameter of the shader
+    ///
+    /// \param handle    Handle of the parameter (mat4 GLSL type)
+    /// \param transform Transform to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(ParameterHandle handle, const sf::Transform& transform);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a texture parameter of the shader
+    ///
+    /// \param handle  Handle of the parameter (sampler2D GLSL type)
+    /// \param texture Texture to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(ParameterHandle handle, const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Map a texture parameter to the texture of the object being drawn
+    ///
+    /// \param handle Handle of the parameter (sampler2D GLSL type)
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameter(ParameterHandle handle, CurrentTextureType);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change an array of float parameters of the shader
+    ///
+    /// Example:
+    /// \code
+    /// uniform float weights[5]; // this is the variable in the shader
+    /// \endcode
+    /// \code
+    /// float weights[5] = {0.227f, 0.195f, 0.122f, 0.054f, 0.016f};
+    /// shader.setParameterArray(shader.getParameterHandle("weights"), weights, 5);
+    /// \endcode
+    ///
+    /// Empty arrays (\a length is 0) are ignored.
+    ///
+    /// \param handle Handle of the parameter (float[] GLSL type)
+    /// \param values Pointer to the values to assign
+    /// \param length Number of elements in the array
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameterArray(ParameterHandle handle, const float* values, std::size_t length);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change an array of 2-components vector parameters of the shader
+    ///
+    /// \param handle  Handle of the parameter (vec2[] GLSL type)
+    /// \param vectors Pointer to the vectors to assign
+    /// \param length  Number of elements in the array
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameterArray(ParameterHandle handle, const Vector2f* vectors, std::size_t length);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change an array of 3-components vector parameters of the shader
+    ///
+    /// \param handle  Handle of the parameter (vec3[] GLSL type)
+    /// \param vectors Pointer to the vectors to assign
+    /// \param length  Number of elements in the array
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameterArray(ParameterHandle handle, const Vector3f* vectors, std::size_t length);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change an array of matrix parameters of the shader
+    ///
+    /// \param handle     Handle of the parameter (mat4[] GLSL type)
+    /// \param transforms Pointer to the transforms to assign
+    /// \param length     Number of elements in the array
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameterArray(ParameterHandle handle, const sf::Transform* transforms, std::size_t length);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Resolve a uniform block of the shader into a handle
+    ///
+    /// Uniform blocks group many parameters in a single buffer,
+    /// which is uploaded with one call and can be shared between
+    /// shaders. They require uniform buffer support, see
+    /// isUniformBlockAvailable.
+    ///
+    /// Handles stay valid until the shader is loaded again.
+    ///
+    /// \param name Name of the uniform block in the shader
+    ///
+    /// \return Handle to the block, or -1 if it was not found
+    ///
+    ////////////////////////////////////////////////////////////
+    BlockHandle getBlockHandle(const std::string& name);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the contents of a uniform block
+    ///
+    /// The data must follow the memory layout of the block in
+    /// the shader (use the std140 layout to make it predictable).
+    /// It is copied, and uploaded the next time the shader is
+    /// bound. This function does nothing if \a handle is -1.
+    ///
+    /// \param handle Handle of the block
+    /// \param data   Pointer to the contents of the block
+    /// \param size   Size of the data, in bytes
+    ///
+    /// \see getBlockHandle
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBlockData(BlockHandle handle, const void* data, std::size_t size);
+
     ////////////////////////////////////////////////////////////
     /// \brief Bind a shader for rendering
     ///
@@ -482,6 +705,14 @@ public :
     ////////////////////////////////////////////////////////////
     static bool isAvailable();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports uniform blocks
+    ///
+    /// \return True if uniform blocks are supported, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isUniformBlockAvailable();
+
 private :
 
     ////////////////////////////////////////////////////////////
@@ -508,28 +739,71 @@ private :
     void bindTextures() const;
 
     ////////////////////////////////////////////////////////////
-    /// \brief Get the location ID of a shader parameter
+    /// \brief Send the modified parameters and blocks to the program
+    ///
+    /// The program must be in use.
+    ///
+    ////////////////////////////////////////////////////////////
+    void flushParameters() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Store the new value of a parameter until the next flush
     ///
-    /// \param name Name of the parameter to search
+    /// \param handle     Handle of the parameter
+    /// \param values     Components of all the elements to assign
+    /// \param length     Number of elements (1 if not an array)
+    /// \param components Number of components per element (16 for matrices)
     ///
-    /// \return Location ID of the parameter, or -1 if not found
+    ////////////////////////////////////////////////////////////
+    void setParameterValues(ParameterHandle handle, const float* values, std::size_t length, unsigned int components);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destroy the buffers of the uniform blocks
+    ///
+    ////////////////////////////////////////////////////////////
+    void destroyBlocks();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Resolved parameter and its pending value
     ///
     ////////////////////////////////////////////////////////////
-    int getParamLocation(const std::string& name);
+    struct Parameter
+    {
+        std::string        name;       ///< Name of the parameter in the shader
+        int                location;   ///< Location of the parameter in the program
+        unsigned int       components; ///< Number of components of an element of the value
+        std::vector<float> values;     ///< Last assigned value
+        bool               dirty;      ///< Has the value changed since the last flush?
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Resolved uniform block and its pending contents
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Block
+    {
+        std::string        name;   ///< Name of the block in the shader
+        unsigned int       buffer; ///< OpenGL identifier of the uniform buffer
+        std::vector<Uint8> data;   ///< Last assigned contents
+        bool               dirty;  ///< Have the contents changed since the last flush?
+    };
 
     ////////////////////////////////////////////////////////////
     // Types
     ////////////////////////////////////////////////////////////
     typedef std::map<int, const Texture*> TextureTable;
-    typedef std::map<std::string, int> ParamTable;
+    typedef std::multimap<Uint32, int> ParamTable;
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    unsigned int m_shaderProgram;  ///< OpenGL identifier for the program
-    int          m_currentTexture; ///< Location of the current texture in the shader
-    TextureTable m_textures;       ///< Texture variables in the shader, mapped to their location
-    ParamTable   m_params;         ///< Parameters location cache
+    unsigned int                   m_shaderProgram;   ///< OpenGL identifier for the program
+    int                            m_currentTexture;  ///< Location of the current texture in the shader
+    TextureTable                   m_textures;        ///< Texture variables in the shader, mapped to their location
+    ParamTable                     m_params;          ///< Parameter handles, indexed by the hash of their name
+    mutable std::vector<Parameter> m_parameters;      ///< Resolved parameters, indexed by handle
+    mutable std::vector<int>       m_dirtyParameters; ///< Handles of the parameters modified since the last flush
+    mutable std::vector<Block>     m_blocks;          ///< Resolved uniform blocks, indexed by handle (and binding point)
 };
 
 } // namespace sf
@@ -623,6 +897,19 @@ private :
 /// second one doesn't impact the rendering process and can be
 /// easily inserted anywhere without impacting all the code.
 ///
+/// Post-processing effects usually update a few parameters every
+/// frame. Resolving them once with getParameterHandle avoids
+/// looking their names up each time; the new values are then
+/// just stored, and sent to the graphics card in one go when
+/// the shader is used for drawing:
+/// \code
+/// sf::Shader::ParameterHandle time = shader.getParameterHandle("time");
+/// ...
+/// // in the main loop
+/// shader.setParameter(time, clock.getElapsedTime().asSeconds());
+/// window.draw(sprite, &shader);
+/// \endcode
+///
 /// Like sf::Texture that can be used as a raw OpenGL texture,
 /// sf::Shader can also be used directly as a raw shader for
 /// custom OpenGL geometry.
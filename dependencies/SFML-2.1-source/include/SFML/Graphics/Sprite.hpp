@@ -191,6 +191,8 @@ public :
 
 private :
 
+    friend class SpriteBatch;
+
     ////////////////////////////////////////////////////////////
     /// \brief Draw the sprite to a render target
     ///
@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_SPRITEBATCH_HPP
+#define SFML_SPRITEBATCH_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <vector>
+
+
+namespace sf
+{
+class Sprite;
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Draw many sprites with as few draw calls as possible
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API SpriteBatch : public Drawable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty batch.
+    ///
+    ////////////////////////////////////////////////////////////
+    SpriteBatch();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the sprites from the batch
+    ///
+    /// The allocated memory is kept, so that a batch that is
+    /// refilled every frame doesn't allocate anything.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reserve memory for a given number of sprites
+    ///
+    /// \param spriteCount Number of sprites to reserve memory for
+    ///
+    ////////////////////////////////////////////////////////////
+    void reserve(std::size_t spriteCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a sprite to the batch
+    ///
+    /// The sprite is copied in its current state: its vertices
+    /// are transformed on the CPU, so later changes to the sprite
+    /// are not reflected until the batch is refilled. Sprites
+    /// without a texture are ignored, like when drawn directly.
+    ///
+    /// Sprites are drawn in the order they were added. Every time
+    /// the texture changes a new draw call is needed, so sprites
+    /// sharing the same texture should be added consecutively.
+    ///
+    /// \param sprite Sprite to add
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(const Sprite& sprite);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of sprites in the batch
+    ///
+    /// \return Number of sprites
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getSpriteCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of draw calls needed to draw the batch
+    ///
+    /// \return Number of consecutive runs of sprites sharing a texture
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getDrawCallCount() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the batch to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Consecutive sprites sharing the same texture
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Run
+    {
+        const Texture* texture; ///< Texture of the sprites
+        std::size_t    first;   ///< Index of the first vertex of the run
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Vertex> m_vertices;    ///< Pre-transformed quads of all the sprites
+    std::size_t         m_vertexCount; ///< Number of vertices in use
+    std::vector<Run>    m_runs;        ///< Draw calls, in order
+};
+
+} // namespace sf
+
+
+#endif // SFML_SPRITEBATCH_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::SpriteBatch
+/// \ingroup graphics
+///
+/// Drawing a sprite costs a matrix upload and a draw call,
+/// which quickly adds up when there are thousands of them.
+/// sf::SpriteBatch collects sprites into a single array of
+/// pre-transformed quads, and draws it with one call per
+/// texture change instead of one call per sprite.
+///
+/// Filling the batch only takes the sprites' cached transforms:
+/// for a sprite that moves without rotating or scaling, no
+/// trigonometry nor matrix product is involved.
+///
+/// A batch is typically cleared and refilled every frame with
+/// the visible sprites, sorted by texture when the drawing
+/// order allows it.
+///
+/// Usage example:
+/// \code
+/// sf::SpriteBatch batch;
+///
+/// // in the main loop...
+/// batch.clear();
+/// for (std::size_t i = 0; i < sprites.size(); ++i)
+///     batch.add(sprites[i]);
+///
+/// window.draw(batch);
+/// \endcode
+///
+/// \see sf::Sprite, sf::VertexArray
+///
+////////////////////////////////////////////////////////////
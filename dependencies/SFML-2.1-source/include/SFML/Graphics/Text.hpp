@@ -41,6 +41,11 @@
 
 namespace sf
 {
+namespace priv
+{
+    class TextLayoutCache;
+}
+
 ////////////////////////////////////////////////////////////
 /// \brief Graphical text that can be drawn to a render target
 ///
@@ -93,6 +98,10 @@ public :
     /// \endcode
     /// A text's string is empty by default.
     ///
+    /// Only the characters that follow the first difference
+    /// with the previous string are laid out again, which makes
+    /// frequently updated texts such as counters cheap.
+    ///
     /// \param string New string
     ///
     /// \see getString
@@ -265,6 +274,22 @@ public :
 
 private :
 
+    friend class priv::TextLayoutCache;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief State of the layout before a character
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Cursor
+    {
+        float        x;           ///< Horizontal pen position
+        float        y;           ///< Baseline of the current line
+        float        minY;        ///< Top of the highest glyph so far
+        float        width;       ///< Width of the longest finished line
+        Uint32       prevChar;    ///< Previous character, for kerning
+        unsigned int vertexCount; ///< Number of vertices before the character
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Draw the text to a render target
     ///
@@ -277,19 +302,27 @@ private :
     ////////////////////////////////////////////////////////////
     /// \brief Update the text's geometry
     ///
+    /// The geometry of the characters before \a first is kept.
+    /// When the whole geometry is rebuilt, it is first searched
+    /// in the process-wide layout cache, so that identical texts
+    /// share the work.
+    ///
+    /// \param first Index of the first character that changed
+    ///
     ////////////////////////////////////////////////////////////
-    void updateGeometry();
+    void updateGeometry(std::size_t first = 0);
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    String        m_string;        ///< String to display
-    const Font*   m_font;          ///< Font used to display the string
-    unsigned int  m_characterSize; ///< Base size of characters, in pixels
-    Uint32        m_style;         ///< Text style (see Style enum)
-    Color         m_color;         ///< Text color
-    VertexArray   m_vertices;      ///< Vertex array containing the text's geometry
-    FloatRect     m_bounds;        ///< Bounding rectangle of the text (in local coordinates)
+    String              m_string;        ///< String to display
+    const Font*         m_font;          ///< Font used to display the string
+    unsigned int        m_characterSize; ///< Base size of characters, in pixels
+    Uint32              m_style;         ///< Text style (see Style enum)
+    Color               m_color;         ///< Text color
+    VertexArray         m_vertices;      ///< Vertex array containing the text's geometry
+    FloatRect           m_bounds;        ///< Bounding rectangle of the text (in local coordinates)
+    std::vector<Cursor> m_cursors;       ///< Layout state before each character and after the last one, empty if unknown
 };
 
 } // namespace sf
@@ -316,6 +349,10 @@ private :
 ///
 /// sf::Text works in combination with the sf::Font class, which
 /// loads and provides the glyphs (visual characters) of a given font.
+/// If the font is in distance field mode (see sf::Font::setDistanceField),
+/// the text is drawn with a built-in shader that keeps the edges of
+/// the glyphs sharp at any size, unless a shader is already set in
+/// the render states.
 ///
 /// The separation of sf::Font and sf::Text allows more flexibility
 /// and better performances: indeed a sf::Font is a heavy resource,
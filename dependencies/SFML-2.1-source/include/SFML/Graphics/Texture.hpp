@@ -58,6 +58,18 @@ public :
         Pixels      ///< Texture coordinates in range [0 .. size]
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief GPU block-compression formats that can be loaded
+    ///
+    ////////////////////////////////////////////////////////////
+    enum CompressedFormat
+    {
+        Dxt1,    ///< S3TC DXT1, opaque RGB (4 bits per pixel)
+        Dxt5,    ///< S3TC DXT5, RGBA with interpolated alpha (8 bits per pixel)
+        Etc2Rgb, ///< ETC2, opaque RGB (4 bits per pixel)
+        Etc2Rgba ///< ETC2 with EAC alpha, RGBA (8 bits per pixel)
+    };
+
 public :
 
     ////////////////////////////////////////////////////////////
@@ -213,6 +225,48 @@ public :
     ////////////////////////////////////////////////////////////
     bool loadFromImage(const Image& image, const IntRect& area = IntRect());
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the texture from a pre-compressed file on disk
+    ///
+    /// The file must be a KTX container holding a 2D texture in
+    /// one of the formats of the CompressedFormat enum. Its
+    /// blocks are uploaded as they are, without being decoded,
+    /// and stay compressed in video memory (4 to 8 times smaller
+    /// than the equivalent RGBA texture). The mipmap levels
+    /// stored in the file, if any, are uploaded as well.
+    ///
+    /// The format must be supported by the graphics driver, see
+    /// isCompressedFormatAvailable. A compressed texture can't
+    /// be modified with the update functions.
+    ///
+    /// If this function fails, the texture is left unchanged.
+    ///
+    /// \param filename Path of the KTX file to load
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromCompressedMemory, isCompressedFormatAvailable
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromCompressedFile(const std::string& filename);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Load the texture from a pre-compressed file in memory
+    ///
+    /// See loadFromCompressedFile for details.
+    ///
+    /// If this function fails, the texture is left unchanged.
+    ///
+    /// \param data Pointer to the KTX file data in memory
+    /// \param size Size of the data to load, in bytes
+    ///
+    /// \return True if loading was successful
+    ///
+    /// \see loadFromCompressedFile, isCompressedFormatAvailable
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromCompressedMemory(const void* data, std::size_t size);
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the size of the texture
     ///
@@ -221,6 +275,16 @@ public :
     ////////////////////////////////////////////////////////////
     Vector2u getSize() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the texture holds compressed pixels
+    ///
+    /// \return True if the texture was loaded from a compressed file
+    ///
+    /// \see loadFromCompressedFile
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isCompressed() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Copy the texture pixels to an image
     ///
@@ -350,6 +414,47 @@ public :
     ////////////////////////////////////////////////////////////
     void update(const Window& window, unsigned int x, unsigned int y);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the texture from another texture
+    ///
+    /// Although the source texture can be smaller than this texture,
+    /// this function is usually used for updating the whole texture.
+    /// The other overload, which has (x, y) additional arguments,
+    /// is more convenient for updating a sub-area of this texture.
+    ///
+    /// No additional check is performed on the size of the passed
+    /// texture, passing a texture bigger than this texture
+    /// will lead to an undefined behaviour.
+    ///
+    /// This function does nothing if either texture was not
+    /// previously created.
+    ///
+    /// \param texture Source texture to copy to this texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update a part of this texture from another texture
+    ///
+    /// The copy is done on the GPU when frame buffer objects are
+    /// supported, the pixels don't go through system memory.
+    /// Otherwise the source texture is read back with copyToImage.
+    ///
+    /// No additional check is performed on the size of the texture,
+    /// passing an invalid combination of texture size and offset
+    /// will lead to an undefined behaviour.
+    ///
+    /// This function does nothing if either texture was not
+    /// previously created.
+    ///
+    /// \param texture Source texture to copy to this texture
+    /// \param x       X offset in this texture where to copy the source texture
+    /// \param y       Y offset in this texture where to copy the source texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const Texture& texture, unsigned int x, unsigned int y);
+
     ////////////////////////////////////////////////////////////
     /// \brief Enable or disable the smooth filter
     ///
@@ -359,6 +464,9 @@ public :
     /// you should leave it disabled.
     /// The smooth filter is disabled by default.
     ///
+    /// If the texture has mipmaps, the smooth filter also blends
+    /// between the two closest mipmap levels (trilinear filtering).
+    ///
     /// \param smooth True to enable smoothing, false to disable it
     ///
     /// \see isSmooth
@@ -410,6 +518,46 @@ public :
     ////////////////////////////////////////////////////////////
     bool isRepeated() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Generate a mipmap using the current texture data
+    ///
+    /// Mipmaps are pre-computed chains of optimized textures. Each
+    /// level of texture in a mipmap is generated by halving each of
+    /// the previous level's dimensions. This is done until the final
+    /// level has the size of 1x1. The textures generated in this
+    /// process may make use of more advanced filters which might
+    /// improve the visual quality of textures when they are applied
+    /// to objects much smaller than they are. This is known as
+    /// minification. Because fewer texels (texture elements) have
+    /// to be sampled from when heavily minified, usage of mipmaps
+    /// can also improve rendering performance in certain scenarios.
+    ///
+    /// The levels are generated by the graphics driver if it
+    /// supports it, and with a 2x2 box filter otherwise.
+    ///
+    /// Mipmap generation relies on the texture's data being up to
+    /// date: updating the texture afterwards discards its mipmap,
+    /// this function has to be called again after the update.
+    /// Compressed textures can't be mipmapped this way, their
+    /// levels have to be stored in the compressed file instead.
+    ///
+    /// \return True if mipmap generation was successful, false if unsuccessful
+    ///
+    /// \see hasMipmap, setSmooth
+    ///
+    ////////////////////////////////////////////////////////////
+    bool generateMipmap();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the texture has a mipmap
+    ///
+    /// \return True if the texture has mipmap levels, false otherwise
+    ///
+    /// \see generateMipmap
+    ///
+    ////////////////////////////////////////////////////////////
+    bool hasMipmap() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Overload of assignment operator
     ///
@@ -420,6 +568,16 @@ public :
     ////////////////////////////////////////////////////////////
     Texture& operator =(const Texture& right);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Swap the contents of this texture with those of another
+    ///
+    /// Unlike the assignment operator, no pixel is copied.
+    ///
+    /// \param right Instance to swap with
+    ///
+    ////////////////////////////////////////////////////////////
+    void swap(Texture& right);
+
     ////////////////////////////////////////////////////////////
     /// \brief Bind a texture for rendering
     ///
@@ -465,10 +623,22 @@ public :
     ////////////////////////////////////////////////////////////
     static unsigned int getMaximumSize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the graphics driver supports a compression format
+    ///
+    /// \param format Compression format to check
+    ///
+    /// \return True if textures in this format can be loaded
+    ///
+    /// \see loadFromCompressedFile
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isCompressedFormatAvailable(CompressedFormat format);
+
 private :
 
     friend class RenderTexture;
-    friend class RenderTarget;
+    friend class GlStateTracker;
 
     ////////////////////////////////////////////////////////////
     /// \brief Get a valid image size according to hardware support
@@ -485,6 +655,24 @@ private :
     ////////////////////////////////////////////////////////////
     static unsigned int getValidSize(unsigned int size);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the minification filter of the texture
+    ///
+    /// The filter depends on both the smooth flag and the
+    /// presence of a mipmap. The texture must be bound.
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyMinFilter() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Discard the mipmap of the texture
+    ///
+    /// Called when the texture's data changes. The texture
+    /// must be bound.
+    ///
+    ////////////////////////////////////////////////////////////
+    void invalidateMipmap();
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
@@ -494,6 +682,8 @@ private :
     bool         m_isSmooth;      ///< Status of the smooth filter
     bool         m_isRepeated;    ///< Is the texture in repeat mode?
     mutable bool m_pixelsFlipped; ///< To work around the inconsistency in Y orientation
+    bool         m_isCompressed;  ///< Does the texture hold block-compressed pixels?
+    bool         m_hasMipmap;     ///< Does the texture have mipmap levels?
     Uint64       m_cacheId;       ///< Unique number that identifies the texture to the render target's cache
 };
 
@@ -322,6 +322,7 @@ private :
     Vector2f          m_scale;                      ///< Scale of the object
     mutable Transform m_transform;                  ///< Combined transformation of the object
     mutable bool      m_transformNeedUpdate;        ///< Does the transform need to be recomputed?
+    mutable bool      m_translationNeedUpdate;      ///< Does only the translation part of the transform need to be recomputed?
     mutable Transform m_inverseTransform;           ///< Combined transformation of the object
     mutable bool      m_inverseTransformNeedUpdate; ///< Does the transform need to be recomputed?
 };
@@ -33,12 +33,18 @@
 #include <SFML/Network/TcpSocket.hpp>
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/System/Time.hpp>
+#include <deque>
 #include <map>
 #include <string>
 
 
 namespace sf
 {
+namespace priv
+{
+    struct HttpCallback;
+}
+
 ////////////////////////////////////////////////////////////
 /// \brief A HTTP client
 ///
@@ -121,7 +127,9 @@ public :
         ////////////////////////////////////////////////////////////
         /// \brief Set the HTTP version for the request
         ///
-        /// The HTTP version is 1.0 by default.
+        /// The HTTP version is 1.1 by default. With HTTP 1.0, the
+        /// connection is closed after every response, unless the
+        /// "Connection" field is set to "keep-alive".
         ///
         /// \param major Major HTTP version number
         /// \param minor Minor HTTP version number
@@ -141,6 +149,22 @@ public :
         ////////////////////////////////////////////////////////////
         void setBody(const std::string& body);
 
+        ////////////////////////////////////////////////////////////
+        /// \brief Write the body of the response to a file
+        ///
+        /// Instead of being accumulated in memory, the body of a
+        /// successful (2xx) response is written to the file as it
+        /// is received, which is better suited to large downloads.
+        /// In this case, Response::getBody returns an empty string.
+        /// Error responses are still kept in memory, so that the
+        /// file is not overwritten with an error page.
+        /// An empty filename (the default) disables this feature.
+        ///
+        /// \param filename Path of the file to write
+        ///
+        ////////////////////////////////////////////////////////////
+        void setResponseFile(const std::string& filename);
+
     private :
 
         friend class Http;
@@ -182,6 +206,7 @@ public :
         unsigned int m_majorVersion; ///< Major HTTP version
         unsigned int m_minorVersion; ///< Minor HTTP version
         std::string  m_body;         ///< Body of the request
+        std::string  m_responseFile; ///< File to write the body of the response to
     };
 
     ////////////////////////////////////////////////////////////
@@ -305,17 +330,6 @@ public :
 
         friend class Http;
 
-        ////////////////////////////////////////////////////////////
-        /// \brief Construct the header from a response string
-        ///
-        /// This function is used by Http to build the response
-        /// of a request.
-        ///
-        /// \param data Content of the response to parse
-        ///
-        ////////////////////////////////////////////////////////////
-        void parse(const std::string& data);
-
         ////////////////////////////////////////////////////////////
         // Types
         ////////////////////////////////////////////////////////////
@@ -353,11 +367,23 @@ public :
     ////////////////////////////////////////////////////////////
     Http(const std::string& host, unsigned short port = 0);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// Pending asynchronous requests are dropped, without
+    /// calling their callback.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~Http();
+
     ////////////////////////////////////////////////////////////
     /// \brief Set the target host
     ///
     /// This function just stores the host address and port, it
     /// doesn't actually connect to it until you send a request.
+    /// If the host changes, the connection to the previous one
+    /// is closed and its pending requests fail with
+    /// Response::ConnectionFailed.
     /// The port has a default value of 0, which means that the
     /// HTTP client will use the right port according to the
     /// protocol used (80 for HTTP, 443 for HTTPS). You should
@@ -377,10 +403,12 @@ public :
     /// Any missing mandatory header field in the request will be added
     /// with an appropriate value.
     /// Warning: this function waits for the server's response and may
-    /// not return instantly; use a thread if you don't want to block your
-    /// application, or use a timeout to limit the time to wait. A value
-    /// of Time::Zero means that the client will use the system defaut timeout
-    /// (which is usually pretty long).
+    /// not return instantly; use sendRequestAsync if you don't want to
+    /// block your application, or use a timeout to limit the time to wait.
+    /// A value of Time::Zero means that the client will use the system
+    /// defaut timeout (which is usually pretty long).
+    /// The request is queued after the pending asynchronous ones, whose
+    /// callbacks may therefore be called before this function returns.
     ///
     /// \param request Request to send
     /// \param timeout Maximum time to wait
@@ -390,17 +418,212 @@ public :
     ////////////////////////////////////////////////////////////
     Response sendRequest(const Request& request, Time timeout = Time::Zero);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue a HTTP request without waiting for the response
+    ///
+    /// This function returns immediately: the request is sent,
+    /// and its response received, by the next calls to update.
+    /// When the response is complete, \a callback is called with
+    /// it, from update. It can be any callable object that accepts
+    /// a const Http::Response& argument.
+    ///
+    /// \param request  Request to send
+    /// \param callback Function to call with the response
+    ///
+    /// \see update
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename F>
+    void sendRequestAsync(const Request& request, F callback);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue a HTTP request, with a member function as callback
+    ///
+    /// \param request  Request to send
+    /// \param function Member function to call with the response
+    /// \param object   Object to call the member function on
+    ///
+    /// \see update
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename C>
+    void sendRequestAsync(const Request& request, void(C::*function)(const Response&), C* object);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Queue a HTTP request whose response is not needed
+    ///
+    /// \param request Request to send
+    ///
+    /// \see update
+    ///
+    ////////////////////////////////////////////////////////////
+    void sendRequestAsync(const Request& request);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Send and receive the data of the pending requests
+    ///
+    /// This function does as much work as possible without
+    /// blocking: it connects to the host if needed, writes the
+    /// queued requests and reads the available response data,
+    /// then calls the callbacks of the completed requests.
+    /// It is typically called once per frame. If \a timeout is
+    /// not zero, it waits up to \a timeout for the network if
+    /// nothing could be done immediately.
+    ///
+    /// Callbacks must not call update or sendRequest themselves,
+    /// but they can queue new asynchronous requests.
+    ///
+    /// \param timeout Maximum time to wait for the network
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(Time timeout = Time::Zero);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of requests waiting for their response
+    ///
+    /// \return Number of queued and in-flight requests
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getPendingRequestCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the maximum number of pipelined requests
+    ///
+    /// Pipelining writes the next requests on the connection
+    /// before the response to the first one has been received,
+    /// which saves a round trip per request. Only GET and HEAD
+    /// requests are pipelined; a POST request waits until the
+    /// connection is idle. Use a depth of 1 to disable pipelining,
+    /// for servers that don't support it.
+    /// The default depth is 4.
+    ///
+    /// \param depth Maximum number of requests sent but not answered
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPipelineDepth(unsigned int depth);
+
 private :
 
+    struct PendingRequest;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief State of the connection to the host
+    ///
+    ////////////////////////////////////////////////////////////
+    enum ConnectionState
+    {
+        Disconnected, ///< No connection
+        Connecting,   ///< Non-blocking connection in progress
+        Connected     ///< Connected, ready to send requests
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add the missing fields of a request and queue it
+    ///
+    /// \param request  Request to send
+    /// \param callback Callback to call with the response (can be NULL)
+    ///
+    /// \return Queued request
+    ///
+    ////////////////////////////////////////////////////////////
+    PendingRequest* enqueue(const Request& request, priv::HttpCallback* callback);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Do the work of update
+    ///
+    /// \param timeout Maximum time to wait, or a negative time to wait forever
+    ///
+    ////////////////////////////////////////////////////////////
+    void process(Time timeout);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write the requests that can be sent now to the output buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    void fillPipeline();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Send as much of the output buffer as possible
+    ///
+    /// \return False if the connection is broken
+    ///
+    ////////////////////////////////////////////////////////////
+    bool sendOutput();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Parse the received data into the responses in flight
+    ///
+    /// \param closed True if the server has closed the connection
+    ///
+    /// \return True if the connection must be closed
+    ///
+    ////////////////////////////////////////////////////////////
+    bool parseInput(bool closed);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write data to the body of a response
+    ///
+    /// \param request Request whose response is being received
+    /// \param data    Pointer to the data
+    /// \param size    Size of the data, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    static void writeBody(PendingRequest& request, const char* data, std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Close the connection
+    ///
+    /// The requests that were sent but not answered are sent
+    /// again on the next connection. If the connection is closed
+    /// because of a failure, this happens only once per request:
+    /// the requests that were already retried fail. Requests that
+    /// are not idempotent (POST) are never sent again, the server
+    /// may have processed them already; they fail instead.
+    ///
+    /// \param failure True if the connection was closed unexpectedly
+    ///
+    ////////////////////////////////////////////////////////////
+    void closeConnection(bool failure);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move a request to the completed list
+    ///
+    /// \param index Index of the request in the queue
+    ///
+    ////////////////////////////////////////////////////////////
+    void complete(std::size_t index);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Fail all the pending requests
+    ///
+    ////////////////////////////////////////////////////////////
+    void failAll();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Call and destroy the callbacks of the completed requests
+    ///
+    ////////////////////////////////////////////////////////////
+    void dispatch();
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    TcpSocket      m_connection; ///< Connection to the host
-    IpAddress      m_host;       ///< Web host address
-    std::string    m_hostName;   ///< Web host name
-    unsigned short m_port;       ///< Port used for connection with host
+    TcpSocket                   m_connection;    ///< Connection to the host
+    IpAddress                   m_host;          ///< Web host address
+    std::string                 m_hostName;      ///< Web host name
+    unsigned short              m_port;          ///< Port used for connection with host
+    ConnectionState             m_state;         ///< State of the connection
+    std::deque<PendingRequest*> m_requests;      ///< Requests waiting for their response, in order
+    std::deque<PendingRequest*> m_completed;     ///< Requests whose callback must be called
+    std::size_t                 m_sentCount;     ///< Number of requests at the front of the queue written to the output
+    std::string                 m_output;        ///< Data waiting to be sent
+    std::size_t                 m_outputOffset;  ///< Number of bytes of m_output already sent
+    std::string                 m_input;         ///< Received data not parsed yet
+    unsigned int                m_pipelineDepth; ///< Maximum number of requests in flight
 };
 
+#include <SFML/Network/Http.inl>
+
 } // namespace sf
 
 
@@ -438,6 +661,13 @@ private :
 /// sf::Http::Request and return the corresponding sf::Http::Response
 /// from the server.
 ///
+/// It can also send requests asynchronously with sendRequestAsync:
+/// the function returns immediately, and the response is passed
+/// to a callback by a later call to update, which never blocks and
+/// can therefore be called every frame. The connection to the host
+/// is kept alive between requests when the server allows it, and
+/// consecutive GET and HEAD requests are pipelined on it.
+///
 /// Usage example:
 /// \code
 /// // Create a new HTTP client
@@ -462,6 +692,14 @@ private :
 /// {
 ///     std::cout << "Error " << status << std::endl;
 /// }
+///
+/// // Download a file without blocking, and be notified when it's done
+/// sf::Http::Request download("levels/pack1.zip");
+/// download.setResponseFile("pack1.zip");
+/// http.sendRequestAsync(download, &onDownloaded);
+///
+/// // in the main loop...
+/// http.update();
 /// \endcode
 ///
 ////////////////////////////////////////////////////////////
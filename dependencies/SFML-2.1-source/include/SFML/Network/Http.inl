@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+namespace priv
+{
+// Base class for abstract response callbacks
+struct HttpCallback
+{
+    virtual ~HttpCallback() {}
+    virtual void run(const Http::Response& response) = 0;
+};
+
+// Specialization using a functor (including free functions)
+template <typename F>
+struct HttpCallbackFunctor : HttpCallback
+{
+    HttpCallbackFunctor(F functor) : m_functor(functor) {}
+    virtual void run(const Http::Response& response) {m_functor(response);}
+    F m_functor;
+};
+
+// Specialization using a member function
+template <typename C>
+struct HttpCallbackMemberFunc : HttpCallback
+{
+    HttpCallbackMemberFunc(void(C::*function)(const Http::Response&), C* object) : m_function(function), m_object(object) {}
+    virtual void run(const Http::Response& response) {(m_object->*m_function)(response);}
+    void(C::*m_function)(const Http::Response&);
+    C* m_object;
+};
+
+} // namespace priv
+
+
+////////////////////////////////////////////////////////////
+template <typename F>
+void Http::sendRequestAsync(const Request& request, F callback)
+{
+    enqueue(request, new priv::HttpCallbackFunctor<F>(callback));
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename C>
+void Http::sendRequestAsync(const Request& request, void(C::*function)(const Response&), C* object)
+{
+    enqueue(request, new priv::HttpCallbackMemberFunc<C>(function, object));
+}
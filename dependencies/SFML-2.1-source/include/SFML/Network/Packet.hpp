@@ -35,6 +35,11 @@
 
 namespace sf
 {
+namespace priv
+{
+    class PacketBuffer;
+}
+
 class String;
 class TcpSocket;
 class UdpSocket;
@@ -59,12 +64,34 @@ public :
     ////////////////////////////////////////////////////////////
     Packet();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// The data is shared by the two packets until one of them
+    /// is modified, so copying a packet to send it to many
+    /// sockets costs nothing.
+    ///
+    /// \param copy Instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    Packet(const Packet& copy);
+
     ////////////////////////////////////////////////////////////
     /// \brief Virtual destructor
     ///
     ////////////////////////////////////////////////////////////
     virtual ~Packet();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    Packet& operator =(const Packet& right);
+
     ////////////////////////////////////////////////////////////
     /// \brief Append data to the end of the packet
     ///
@@ -273,12 +300,27 @@ private :
     ////////////////////////////////////////////////////////////
     bool checkSize(std::size_t size);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Make room at the end of the packet
+    ///
+    /// The packet gets its own buffer if it was shared. The size
+    /// of the packet is not changed.
+    ///
+    /// \param size Number of bytes to make room for
+    ///
+    /// \return Pointer to the first byte after the current data
+    ///
+    ////////////////////////////////////////////////////////////
+    char* reserve(std::size_t size);
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    std::vector<char> m_data;    ///< Data stored in the packet
-    std::size_t       m_readPos; ///< Current reading position in the packet
-    bool              m_isValid; ///< Reading state of the packet
+    priv::PacketBuffer* m_buffer;   ///< Pooled buffer holding the data, possibly shared with other packets
+    std::size_t         m_size;     ///< Size of the data stored in the packet
+    std::size_t         m_readPos;  ///< Current reading position in the packet
+    bool                m_isValid;  ///< Reading state of the packet
+    priv::PacketBuffer* m_incoming; ///< Buffer of the data passed to onReceive by a socket, which can be taken instead of copied
 };
 
 } // namespace sf
@@ -309,6 +351,12 @@ private :
 /// Indeed, the native C++ types may have different sizes on two platforms
 /// and your data may be corrupted if that happens.
 ///
+/// The data of packets is stored in buffers recycled through a
+/// pool, so that a program sending and receiving packets all
+/// the time doesn't allocate memory once it has warmed up.
+/// Copies of a packet share the same buffer until one of them
+/// is modified.
+///
 /// Usage example:
 /// \code
 /// sf::Uint32 x = 24;
@@ -168,6 +168,7 @@ protected :
 private :
 
     friend class SocketSelector;
+    friend class Http;
 
     ////////////////////////////////////////////////////////////
     // Member data
@@ -30,6 +30,7 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Network/Export.hpp>
 #include <SFML/System/Time.hpp>
+#include <cstddef>
 
 
 namespace sf
@@ -44,12 +45,48 @@ class SFML_NETWORK_API SocketSelector
 {
 public :
 
+    ////////////////////////////////////////////////////////////
+    /// \brief System facility used to wait for the sockets
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Backend
+    {
+        DefaultBackend, ///< Best backend available on the system
+        SelectBackend,  ///< select(), available everywhere but limited to FD_SETSIZE sockets
+        EpollBackend    ///< epoll, Linux only; scales to many thousands of sockets
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief When sockets are reported as ready
+    ///
+    ////////////////////////////////////////////////////////////
+    enum TriggerMode
+    {
+        LevelTriggered, ///< Ready as long as there is data to receive
+        EdgeTriggered   ///< Ready once each time new data arrives (epoll only)
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
+    /// Uses the default backend, level-triggered.
+    ///
     ////////////////////////////////////////////////////////////
     SocketSelector();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the selector with a specific backend
+    ///
+    /// If the backend is not available on the system, select()
+    /// is used instead. Edge-triggered mode is only supported
+    /// by epoll, select() is always level-triggered.
+    ///
+    /// \param backend Backend to use
+    /// \param mode    When sockets are reported as ready
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit SocketSelector(Backend backend, TriggerMode mode = LevelTriggered);
+
     ////////////////////////////////////////////////////////////
     /// \brief Copy constructor
     ///
@@ -141,6 +178,41 @@ public :
     ////////////////////////////////////////////////////////////
     bool isReady(Socket& socket) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of sockets ready after the last wait
+    ///
+    /// With epoll, iterating over the ready sockets with
+    /// getReadyCount and getReady costs nothing for the sockets
+    /// that are not ready, whereas calling isReady on every
+    /// socket is proportional to their total number.
+    ///
+    /// \return Number of ready sockets
+    ///
+    /// \see getReady
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getReadyCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a socket ready after the last wait
+    ///
+    /// \param index Index of the ready socket, in [0, getReadyCount()[
+    ///
+    /// \return Reference to the ready socket
+    ///
+    /// \see getReadyCount
+    ///
+    ////////////////////////////////////////////////////////////
+    Socket& getReady(std::size_t index) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the backend actually used by the selector
+    ///
+    /// \return Backend of the selector, never DefaultBackend
+    ///
+    ////////////////////////////////////////////////////////////
+    Backend getBackend() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Overload of assignment operator
     ///
@@ -153,6 +225,15 @@ public :
 
 private :
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Set up the backend of a new selector
+    ///
+    /// \param backend Requested backend
+    /// \param mode    When sockets are reported as ready
+    ///
+    ////////////////////////////////////////////////////////////
+    void create(Backend backend, TriggerMode mode);
+
     struct SocketSelectorImpl;
 
     ////////////////////////////////////////////////////////////
@@ -196,6 +277,15 @@ private :
 /// \li make it wait until there is data available on any of the sockets
 /// \li test each socket to find out which ones are ready
 ///
+/// On Linux, selectors use epoll by default: they are not
+/// limited to FD_SETSIZE sockets, and the cost of a wait
+/// depends on the number of ready sockets rather than on the
+/// total number of sockets, as long as the ready ones are
+/// iterated with getReadyCount() and getReady(). In
+/// edge-triggered mode, a socket is reported once when new
+/// data arrives, so it must be non-blocking and read until
+/// its receive function returns sf::Socket::NotReady.
+///
 /// Usage example:
 /// \code
 /// // Create a socket to listen to new connections
@@ -29,6 +29,7 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Network/Export.hpp>
+#include <SFML/Network/Packet.hpp>
 #include <SFML/Network/Socket.hpp>
 #include <SFML/System/Time.hpp>
 
@@ -37,7 +38,6 @@ namespace sf
 {
 class TcpListener;
 class IpAddress;
-class Packet;
 
 ////////////////////////////////////////////////////////////
 /// \brief Specialized socket using the TCP protocol
@@ -196,9 +196,9 @@ private:
     {
         PendingPacket();
 
-        Uint32            Size;         ///< Data of packet size
-        std::size_t       SizeReceived; ///< Number of size bytes received so far
-        std::vector<char> Data;         ///< Data of the packet
+        Uint32      Size;         ///< Data of packet size
+        std::size_t SizeReceived; ///< Number of size bytes received so far
+        Packet      Data;         ///< Data of the packet, received directly into its pooled buffer
     };
 
     ////////////////////////////////////////////////////////////
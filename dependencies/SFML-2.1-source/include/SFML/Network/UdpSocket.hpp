@@ -30,12 +30,12 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Network/Export.hpp>
 #include <SFML/Network/Socket.hpp>
+#include <SFML/Network/IpAddress.hpp>
 #include <vector>
 
 
 namespace sf
 {
-class IpAddress;
 class Packet;
 
 ////////////////////////////////////////////////////////////
@@ -54,6 +54,25 @@ public :
         MaxDatagramSize = 65507 ///< The maximum number of bytes that can be sent in a single UDP datagram
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Address and port of a remote peer
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Peer
+    {
+        ////////////////////////////////////////////////////////////
+        /// \brief Construct the peer from its address and port
+        ///
+        /// \param peerAddress Address of the peer
+        /// \param peerPort    Port of the peer
+        ///
+        ////////////////////////////////////////////////////////////
+        Peer(const IpAddress& peerAddress = IpAddress::None, unsigned short peerPort = 0) : address(peerAddress), port(peerPort) {}
+
+        IpAddress      address; ///< Address of the peer
+        unsigned short port;    ///< Port of the peer
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
@@ -122,6 +141,27 @@ public :
     ////////////////////////////////////////////////////////////
     Status send(const void* data, std::size_t size, const IpAddress& remoteAddress, unsigned short remotePort);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Send the same raw data to several remote peers
+    ///
+    /// This is equivalent to sending the data to every peer in
+    /// turn, but much faster for a large number of peers: on
+    /// Linux, the datagrams are sent by blocks of 64 with a single
+    /// system call per block. If sending to a peer fails, the
+    /// other peers still receive the data, and the status of the
+    /// last failure is returned.
+    ///
+    /// \param data  Pointer to the sequence of bytes to send
+    /// \param size  Number of bytes to send
+    /// \param peers Receivers of the data
+    ///
+    /// \return Status code
+    ///
+    /// \see receive
+    ///
+    ////////////////////////////////////////////////////////////
+    Status send(const void* data, std::size_t size, const std::vector<Peer>& peers);
+
     ////////////////////////////////////////////////////////////
     /// \brief Receive raw data from a remote peer
     ///
@@ -278,6 +318,9 @@ private:
 /// socket.send(message.c_str(), message.size() + 1, sender, port);
 /// \endcode
 ///
+/// A server that sends the same data to many clients, as in a
+/// broadcast, can pass them all to a single call to send.
+///
 /// \see sf::Socket, sf::TcpSocket, sf::Packet
 ///
 ////////////////////////////////////////////////////////////
@@ -35,8 +35,12 @@
 #include <SFML/System/InputStream.hpp>
 #include <SFML/System/Lock.hpp>
 #include <SFML/System/Mutex.hpp>
+#include <SFML/System/Semaphore.hpp>
+#include <SFML/System/SharedLock.hpp>
+#include <SFML/System/SharedMutex.hpp>
 #include <SFML/System/Sleep.hpp>
 #include <SFML/System/String.hpp>
+#include <SFML/System/TaskScheduler.hpp>
 #include <SFML/System/Thread.hpp>
 #include <SFML/System/ThreadLocal.hpp>
 #include <SFML/System/ThreadLocalPtr.hpp>
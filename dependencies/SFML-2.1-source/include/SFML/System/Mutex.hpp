@@ -30,6 +30,7 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/System/Export.hpp>
 #include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
 
 
 namespace sf
@@ -48,11 +49,39 @@ class SFML_SYSTEM_API Mutex : NonCopyable
 {
 public :
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Locking behaviour of a mutex
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Type
+    {
+        Recursive,   ///< Can be locked several times by the same thread
+        NonRecursive ///< Faster, but locking it twice in the same thread deadlocks
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Contention statistics of a mutex
+    ///
+    /// Only collected while profiling is enabled.
+    ///
+    /// \see setProfilingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    struct ContentionStats
+    {
+        Uint64 lockCount;       ///< Number of times the mutex was locked
+        Uint64 contentionCount; ///< Number of times a thread had to wait for the mutex
+        Time   waitTime;        ///< Total time spent waiting for the mutex
+        Time   holdTime;        ///< Total time the mutex was held
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
+    /// \param type Locking behaviour of the mutex
+    ///
     ////////////////////////////////////////////////////////////
-    Mutex();
+    explicit Mutex(Type type = Recursive);
 
     ////////////////////////////////////////////////////////////
     /// \brief Destructor
@@ -80,12 +109,45 @@ public :
     ////////////////////////////////////////////////////////////
     void unlock();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the contention statistics of the mutex
+    ///
+    /// The statistics are updated while the mutex is held, lock
+    /// it first to read consistent values.
+    ///
+    /// \return Statistics since the creation of the mutex or the
+    ///         last call to resetContentionStats
+    ///
+    ////////////////////////////////////////////////////////////
+    ContentionStats getContentionStats() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset the contention statistics of the mutex
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetContentionStats();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable the collection of contention statistics
+    ///
+    /// Profiling applies to all the mutexes. It is disabled by
+    /// default, as it reads the clock twice per lock. It should
+    /// be changed before the mutexes are used by several threads.
+    ///
+    /// \param enabled True to collect statistics, false to stop
+    ///
+    ////////////////////////////////////////////////////////////
+    static void setProfilingEnabled(bool enabled);
+
 private :
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    priv::MutexImpl* m_mutexImpl; ///< OS-specific implementation
+    priv::MutexImpl* m_mutexImpl;   ///< OS-specific implementation
+    unsigned int     m_lockDepth;   ///< Number of nested locks by the owning thread
+    Time             m_acquireTime; ///< Time at which the mutex was acquired, zero if not profiled
+    ContentionStats  m_stats;       ///< Contention statistics
 };
 
 } // namespace sf
@@ -136,13 +198,23 @@ private :
 /// environments where exceptions can be thrown, you should
 /// use the helper class sf::Lock to lock/unlock mutexes.
 ///
-/// SFML mutexes are recursive, which means that you can lock
-/// a mutex multiple times in the same thread without creating
+/// SFML mutexes are recursive by default, which means that you can
+/// lock a mutex multiple times in the same thread without creating
 /// a deadlock. In this case, the first call to lock() behaves
 /// as usual, and the following ones have no effect.
 /// However, you must call unlock() exactly as many times as you
 /// called lock(). If you don't, the mutex won't be released.
 ///
-/// \see sf::Lock
+/// Mutexes that are never locked twice by the same thread can be
+/// created as sf::Mutex::NonRecursive. They spin briefly before
+/// putting the thread to sleep, which is much cheaper for short
+/// critical sections. For data that is mostly read, see
+/// sf::SharedMutex.
+///
+/// To find which mutexes threads are waiting for, enable profiling
+/// with sf::Mutex::setProfilingEnabled and read the statistics of
+/// each mutex with getContentionStats.
+///
+/// \see sf::Lock, sf::SharedMutex
 ///
 ////////////////////////////////////////////////////////////
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_SEMAPHORE_HPP
+#define SFML_SEMAPHORE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/Export.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+
+namespace sf
+{
+namespace priv
+{
+    class SemaphoreImpl;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Counter that threads can wait on until it is
+///        signaled by another thread
+///
+////////////////////////////////////////////////////////////
+class SFML_SYSTEM_API Semaphore : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// \param count Initial number of signals
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit Semaphore(unsigned int count = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~Semaphore();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait for a signal and consume it
+    ///
+    /// If there is no signal available, this call blocks the
+    /// execution until another thread posts one.
+    ///
+    /// \see post
+    ///
+    ////////////////////////////////////////////////////////////
+    void wait();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add signals, waking up as many waiting threads
+    ///
+    /// \param count Number of signals to add
+    ///
+    /// \see wait
+    ///
+    ////////////////////////////////////////////////////////////
+    void post(unsigned int count = 1);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    priv::SemaphoreImpl* m_semaphoreImpl; ///< OS-specific implementation
+};
+
+} // namespace sf
+
+
+#endif // SFML_SEMAPHORE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::Semaphore
+/// \ingroup system
+///
+/// A semaphore holds a number of signals. wait() takes one,
+/// blocking until there is one to take, and post() adds some.
+/// It lets a thread sleep until another one has work for it,
+/// instead of polling a flag protected by a mutex.
+///
+/// Usage example:
+/// \code
+/// sf::Semaphore ready;
+///
+/// void consumer()
+/// {
+///     for (;;)
+///     {
+///         ready.wait(); // sleeps until an item is produced
+///         ...
+///     }
+/// }
+///
+/// void producer()
+/// {
+///     ...
+///     ready.post();
+/// }
+/// \endcode
+///
+/// \see sf::Mutex
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_SHAREDMUTEX_HPP
+#define SFML_SHAREDMUTEX_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/Export.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+
+namespace sf
+{
+namespace priv
+{
+    class SharedMutexImpl;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Mutex that can be held by several readers at once,
+///        or by a single writer
+///
+////////////////////////////////////////////////////////////
+class SFML_SYSTEM_API SharedMutex : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    SharedMutex();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~SharedMutex();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Lock the mutex for writing
+    ///
+    /// If the mutex is already locked in another thread, for
+    /// reading or writing, this call will block the execution
+    /// until the mutex is released.
+    ///
+    /// \see unlock
+    ///
+    ////////////////////////////////////////////////////////////
+    void lock();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Unlock the mutex after writing
+    ///
+    /// \see lock
+    ///
+    ////////////////////////////////////////////////////////////
+    void unlock();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Lock the mutex for reading
+    ///
+    /// If the mutex is locked for writing in another thread,
+    /// this call will block the execution until it is released.
+    /// Any number of threads can hold the mutex for reading.
+    ///
+    /// \see unlockShared
+    ///
+    ////////////////////////////////////////////////////////////
+    void lockShared();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Unlock the mutex after reading
+    ///
+    /// \see lockShared
+    ///
+    ////////////////////////////////////////////////////////////
+    void unlockShared();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    priv::SharedMutexImpl* m_mutexImpl; ///< OS-specific implementation
+};
+
+} // namespace sf
+
+
+#endif // SFML_SHAREDMUTEX_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::SharedMutex
+/// \ingroup system
+///
+/// sf::SharedMutex protects a resource that is read much more
+/// often than it is modified. Readers don't block each other,
+/// only a writer gets exclusive access.
+///
+/// Waiting writers have priority over new readers, so that a
+/// steady stream of readers can't starve them.
+///
+/// Unlike sf::Mutex, a shared mutex is not recursive: a thread
+/// must not lock it again, for reading or writing, while it
+/// holds it.
+///
+/// Usage example:
+/// \code
+/// std::map<std::string, Resource> resources;
+/// sf::SharedMutex mutex;
+///
+/// const Resource* find(const std::string& name)
+/// {
+///     sf::SharedLock lock(mutex); // other readers can enter too
+///     ...
+/// }
+///
+/// void add(const std::string& name, const Resource& resource)
+/// {
+///     sf::SharedLock lock(mutex, sf::SharedLock::Exclusive); // waits for all the readers
+///     resources[name] = resource;
+/// }
+/// \endcode
+///
+/// \see sf::SharedLock, sf::Mutex
+///
+////////////////////////////////////////////////////////////
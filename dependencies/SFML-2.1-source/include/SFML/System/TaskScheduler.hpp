@@ -0,0 +1,450 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_TASKSCHEDULER_HPP
+#define SFML_TASKSCHEDULER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/Export.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+
+namespace sf
+{
+namespace priv
+{
+    struct TaskState;
+    class SemaphoreImpl;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Run short functions on a fixed pool of worker threads
+///
+////////////////////////////////////////////////////////////
+class SFML_SYSTEM_API TaskScheduler : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Handle to a task added to a scheduler
+    ///
+    ////////////////////////////////////////////////////////////
+    class SFML_SYSTEM_API Task
+    {
+    public :
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Default constructor
+        ///
+        /// Creates an invalid handle, not bound to any task.
+        ///
+        ////////////////////////////////////////////////////////////
+        Task();
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Copy constructor
+        ///
+        /// \param copy Instance to copy
+        ///
+        ////////////////////////////////////////////////////////////
+        Task(const Task& copy);
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Destructor
+        ///
+        /// Destroying the handle doesn't cancel the task.
+        ///
+        ////////////////////////////////////////////////////////////
+        ~Task();
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Overload of assignment operator
+        ///
+        /// \param right Instance to assign
+        ///
+        /// \return Reference to self
+        ///
+        ////////////////////////////////////////////////////////////
+        Task& operator =(const Task& right);
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Tell whether the handle is bound to a task
+        ///
+        /// \return True if the handle was returned by a scheduler
+        ///
+        ////////////////////////////////////////////////////////////
+        bool isValid() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Tell whether the task has finished
+        ///
+        /// This function never blocks.
+        ///
+        /// \return True if the task function has returned
+        ///
+        ////////////////////////////////////////////////////////////
+        bool isDone() const;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Wait until the task has finished
+        ///
+        /// Instead of blocking, the calling thread runs other
+        /// pending tasks of the scheduler while it waits. This
+        /// makes it safe to wait for a task from inside another
+        /// task, without starving the pool.
+        ///
+        ////////////////////////////////////////////////////////////
+        void wait() const;
+
+    private :
+
+        friend class TaskScheduler;
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Construct the handle from a task state
+        ///
+        /// The handle adopts a reference that was already added
+        /// to the state.
+        ///
+        /// \param state State of the task
+        ///
+        ////////////////////////////////////////////////////////////
+        Task(priv::TaskState* state);
+
+        ////////////////////////////////////////////////////////////
+        // Member data
+        ////////////////////////////////////////////////////////////
+        priv::TaskState* m_state; ///< Shared state of the task
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// The worker threads are started immediately and stay
+    /// alive until the scheduler is destroyed.
+    ///
+    /// \param workerCount Number of worker threads, or 0 to
+    ///                    use one per available processor core
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit TaskScheduler(unsigned int workerCount = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// Waits until all the tasks have finished, then stops
+    /// the worker threads.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TaskScheduler();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a task from a functor with no argument
+    ///
+    /// Like sf::Thread, this function is a template so that it
+    /// accepts free functions as well as function objects. The
+    /// functor is copied.
+    ///
+    /// \param function Functor or free function to run
+    ///
+    /// \return Handle to the task
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename F>
+    Task add(F function);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a task from a functor with an argument
+    ///
+    /// \param function Functor or free function to run
+    /// \param argument Argument to pass to the function
+    ///
+    /// \return Handle to the task
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename F, typename A>
+    Task add(F function, A argument);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a task from a member function and an object
+    ///
+    /// \param function Member function to run
+    /// \param object   Pointer to the object to call the function on
+    ///
+    /// \return Handle to the task
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename C>
+    Task add(void(C::*function)(), C* object);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a task that runs after another one has finished
+    ///
+    /// The new task doesn't occupy any worker until \a dependency
+    /// is done. If the dependency is invalid or already done,
+    /// the task is queued immediately.
+    ///
+    /// \param dependency Task to wait for
+    /// \param function   Functor or free function to run
+    ///
+    /// \return Handle to the task
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename F>
+    Task addAfter(const Task& dependency, F function);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a task that runs after several others have finished
+    ///
+    /// \param dependencies Tasks to wait for
+    /// \param function     Functor or free function to run
+    ///
+    /// \return Handle to the task
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename F>
+    Task addAfter(const std::vector<Task>& dependencies, F function);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Call a function for every index of a range, in parallel
+    ///
+    /// The range is split into chunks of \a grainSize indices
+    /// which are distributed to the workers; the calling thread
+    /// takes part in the work and the function returns once
+    /// every index has been processed. \a function is called
+    /// as function(index) and must be safe to call concurrently.
+    ///
+    /// \param begin     First index of the range
+    /// \param end       One past the last index of the range
+    /// \param function  Functor or free function to call
+    /// \param grainSize Number of indices per chunk, or 0 to make
+    ///                  a few chunks per worker
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename F>
+    void parallelFor(std::size_t begin, std::size_t end, F function, std::size_t grainSize = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait until all the tasks of the scheduler have finished
+    ///
+    /// The calling thread helps running them while it waits.
+    /// This function must not be called from inside a task,
+    /// which would wait for itself.
+    ///
+    ////////////////////////////////////////////////////////////
+    void waitAll();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of worker threads
+    ///
+    /// \return Number of threads running tasks in parallel
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int getWorkerCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the scheduler shared by the whole program
+    ///
+    /// It is created on first use with one worker per processor
+    /// core and is never destroyed. Sharing it rather than
+    /// creating several pools avoids having more busy threads
+    /// than cores.
+    ///
+    /// \return Reference to the default scheduler
+    ///
+    ////////////////////////////////////////////////////////////
+    static TaskScheduler& getDefault();
+
+private :
+
+    friend class Task;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Worker thread with its own queue of tasks
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Worker
+    {
+        Worker(TaskScheduler* owner, std::size_t position);
+        void run();
+
+        TaskScheduler*                scheduler; ///< Scheduler owning the worker
+        std::size_t                   index;     ///< Position of the worker in the pool
+        Thread                        thread;    ///< Thread running the worker
+        Mutex                         mutex;     ///< Protects the queue
+        std::deque<priv::TaskState*>  tasks;     ///< Tasks added by this worker
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a task and queue it once its dependencies are done
+    ///
+    /// \param function        Function to run, the task takes ownership of it
+    /// \param dependencies    Tasks to wait for, can be NULL
+    /// \param dependencyCount Number of elements in \a dependencies
+    ///
+    /// \return Handle to the task
+    ///
+    ////////////////////////////////////////////////////////////
+    Task submit(priv::ThreadFunc* function, const Task* dependencies = NULL, std::size_t dependencyCount = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Put a task whose dependencies are done in a queue
+    ///
+    /// \param task Task to queue
+    ///
+    ////////////////////////////////////////////////////////////
+    void enqueue(priv::TaskState* task);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Take the next task to run
+    ///
+    /// The worker's own queue is used first (newest task first,
+    /// its data is still in the cache), then the queue of the
+    /// tasks added by other threads, then the oldest task of
+    /// the other workers is stolen.
+    ///
+    /// \param worker Worker asking for a task, or NULL for
+    ///               a thread that is not part of the pool
+    ///
+    /// \return Task to run, or NULL if all the queues are empty
+    ///
+    ////////////////////////////////////////////////////////////
+    priv::TaskState* takeTask(Worker* worker);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Run a task and queue the tasks that depend on it
+    ///
+    /// \param task Task to run
+    ///
+    ////////////////////////////////////////////////////////////
+    void execute(priv::TaskState* task);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait for a task, running other tasks meanwhile
+    ///
+    /// \param task Task to wait for
+    ///
+    ////////////////////////////////////////////////////////////
+    void wait(priv::TaskState* task);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Main loop of the worker threads
+    ///
+    /// \param worker Worker running the loop
+    ///
+    ////////////////////////////////////////////////////////////
+    void runWorker(Worker& worker);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the worker of this scheduler running in the calling thread
+    ///
+    /// \return Pointer to the worker, or NULL if the calling
+    ///         thread is not one of the workers
+    ///
+    ////////////////////////////////////////////////////////////
+    Worker* getCurrentWorker() const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Worker*>          m_workers;       ///< Worker threads
+    Mutex                         m_mutex;         ///< Protects the shared queue
+    std::deque<priv::TaskState*>  m_tasks;         ///< Tasks added by threads outside of the pool
+    Mutex                         m_graphMutex;    ///< Protects the dependencies between tasks
+    Mutex                         m_sleepMutex;    ///< Protects the idle workers count and the stop flag
+    priv::SemaphoreImpl*          m_semaphore;     ///< Idle workers wait on it for new tasks
+    unsigned int                  m_sleepingCount; ///< Number of workers waiting for a task
+    bool                          m_stopping;      ///< Are the workers asked to exit?
+    volatile long                 m_queuedCount;   ///< Number of tasks in all the queues
+    volatile long                 m_activeCount;   ///< Number of tasks not finished yet
+};
+
+#include <SFML/System/TaskScheduler.inl>
+
+} // namespace sf
+
+
+#endif // SFML_TASKSCHEDULER_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::TaskScheduler
+/// \ingroup system
+///
+/// Creating a sf::Thread for every background job is costly:
+/// each one is a new operating system thread, and running
+/// many of them at once makes them compete for the cores.
+/// sf::TaskScheduler instead starts a fixed number of worker
+/// threads once, and feeds them small functions (tasks).
+///
+/// Each worker has its own queue: tasks added from inside a
+/// task go to the queue of the worker running it, so related
+/// work tends to stay on the same core. A worker that runs
+/// out of tasks steals the oldest ones from the others, which
+/// balances the load without a single contended queue.
+///
+/// A task can depend on other tasks: it is only queued when
+/// all of them are done, so chains of jobs (load a file, then
+/// decode it, then build something from it) don't keep a
+/// worker blocked. parallelFor splits a loop over the workers
+/// and the calling thread.
+///
+/// Waiting for a task never leaves the calling thread idle if
+/// there is something to do: it runs pending tasks until the
+/// one it waits for is done.
+///
+/// Tasks should be short and must not block on each other
+/// by other means than Task::wait, otherwise the workers can
+/// deadlock. Long-lived jobs (like a render loop) are better
+/// served by a dedicated sf::Thread.
+///
+/// Usage example:
+/// \code
+/// void loadLevel(int index)
+/// {
+///     ...
+/// }
+///
+/// sf::TaskScheduler& scheduler = sf::TaskScheduler::getDefault();
+///
+/// // run in the background, then continue when it's done
+/// sf::TaskScheduler::Task level = scheduler.add(&loadLevel, 1);
+/// sf::TaskScheduler::Task start = scheduler.addAfter(level, &startLevel);
+///
+/// // split a loop over all the cores
+/// scheduler.parallelFor(0, particles.size(), UpdateParticle(particles));
+///
+/// start.wait();
+/// \endcode
+///
+/// \see sf::Thread
+///
+////////////////////////////////////////////////////////////
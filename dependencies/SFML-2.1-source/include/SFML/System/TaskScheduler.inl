@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+namespace priv
+{
+// Call a function for a chunk of the range of a parallel for
+template <typename F>
+struct ParallelForChunk : ThreadFunc
+{
+    ParallelForChunk(F function, std::size_t begin, std::size_t end) : m_function(function), m_begin(begin), m_end(end) {}
+    virtual void run() {for (std::size_t i = m_begin; i < m_end; ++i) m_function(i);}
+    F           m_function;
+    std::size_t m_begin;
+    std::size_t m_end;
+};
+
+} // namespace priv
+
+
+////////////////////////////////////////////////////////////
+template <typename F>
+TaskScheduler::Task TaskScheduler::add(F function)
+{
+    return submit(new priv::ThreadFunctor<F>(function));
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename F, typename A>
+TaskScheduler::Task TaskScheduler::add(F function, A argument)
+{
+    return submit(new priv::ThreadFunctorWithArg<F, A>(function, argument));
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename C>
+TaskScheduler::Task TaskScheduler::add(void(C::*function)(), C* object)
+{
+    return submit(new priv::ThreadMemberFunc<C>(function, object));
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename F>
+TaskScheduler::Task TaskScheduler::addAfter(const Task& dependency, F function)
+{
+    return submit(new priv::ThreadFunctor<F>(function), &dependency, 1);
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename F>
+TaskScheduler::Task TaskScheduler::addAfter(const std::vector<Task>& dependencies, F function)
+{
+    return submit(new priv::ThreadFunctor<F>(function), dependencies.empty() ? NULL : &dependencies[0], dependencies.size());
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename F>
+void TaskScheduler::parallelFor(std::size_t begin, std::size_t end, F function, std::size_t grainSize)
+{
+    if (begin >= end)
+        return;
+
+    // A few chunks per thread, so that stealing can even out
+    // iterations that don't all take the same time
+    std::size_t count = end - begin;
+    if (grainSize == 0)
+    {
+        std::size_t chunkCount = (getWorkerCount() + 1) * 4;
+        grainSize = (count + chunkCount - 1) / chunkCount;
+    }
+
+    std::vector<Task> chunks;
+    chunks.reserve(count / grainSize + 1);
+    for (std::size_t first = begin; first < end;)
+    {
+        std::size_t last = (end - first > grainSize) ? first + grainSize : end;
+        chunks.push_back(submit(new priv::ParallelForChunk<F>(function, first, last)));
+        first = last;
+    }
+
+    for (std::vector<Task>::const_iterator it = chunks.begin(); it != chunks.end(); ++it)
+        it->wait();
+}
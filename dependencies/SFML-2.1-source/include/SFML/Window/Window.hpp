@@ -35,9 +35,11 @@
 #include <SFML/Window/WindowStyle.hpp>
 #include <SFML/Window/GlResource.hpp>
 #include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/System/String.hpp>
+#include <vector>
 
 
 namespace sf
@@ -58,6 +60,20 @@ class SFML_WINDOW_API Window : GlResource, NonCopyable
 {
 public :
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Frame timing statistics
+    ///
+    /// Frame times are measured between two calls to display().
+    ///
+    ////////////////////////////////////////////////////////////
+    struct FrameStats
+    {
+        Time   meanFrameTime;   ///< Average frame time since the last reset
+        Time   p99FrameTime;    ///< 99th percentile of the recent frame times
+        Uint64 frameCount;      ///< Number of frames since the last reset
+        Uint64 missedDeadlines; ///< Number of frames that took longer than the framerate limit
+    };
+
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
@@ -202,6 +218,32 @@ public :
     ////////////////////////////////////////////////////////////
     bool pollEvent(Event& event);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Pop all the pending events at once
+    ///
+    /// This function is equivalent to calling pollEvent until it
+    /// returns false or \a maxCount events are returned, but the
+    /// events are copied in a single pass.
+    /// \code
+    /// sf::Event events[32];
+    /// std::size_t count;
+    /// while ((count = window.pollEvents(events, 32)) > 0)
+    /// {
+    ///    for (std::size_t i = 0; i < count; ++i)
+    ///        // process events[i]...
+    /// }
+    /// \endcode
+    ///
+    /// \param events   Array to fill with the events
+    /// \param maxCount Maximum number of events to return
+    ///
+    /// \return Number of events written to \a events, 0 if the event queue was empty
+    ///
+    /// \see pollEvent
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t pollEvents(Event* events, std::size_t maxCount);
+
     ////////////////////////////////////////////////////////////
     /// \brief Wait for an event and return it
     ///
@@ -328,6 +370,22 @@ public :
     ////////////////////////////////////////////////////////////
     void setVerticalSyncEnabled(bool enabled);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable adaptive vertical synchronization
+    ///
+    /// Adaptive v-sync behaves like regular v-sync as long as
+    /// frames are ready in time, but a late frame is displayed
+    /// immediately instead of waiting for the next refresh, so
+    /// that the framerate doesn't drop to half the refresh rate.
+    /// If the driver doesn't support it, regular v-sync is used.
+    ///
+    /// \param enabled True to enable adaptive v-sync, false to deactivate v-sync
+    ///
+    /// \see setVerticalSyncEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAdaptiveVerticalSyncEnabled(bool enabled);
+
     ////////////////////////////////////////////////////////////
     /// \brief Show or hide the mouse cursor
     ///
@@ -358,17 +416,37 @@ public :
     /// If a limit is set, the window will use a small delay after
     /// each call to display() to ensure that the current frame
     /// lasted long enough to match the framerate limit.
-    /// SFML will try to match the given limit as much as it can,
-    /// but since it internally uses sf::sleep, whose precision
-    /// depends on the underlying OS, the results may be a little
-    /// unprecise as well (for example, you can get 65 FPS when
-    /// requesting 60).
+    /// Frames are scheduled on fixed deadlines, so that a frame
+    /// that ends early doesn't shift the next ones. The window
+    /// sleeps until shortly before the deadline and spins for
+    /// the rest; the margin adapts to how much sf::sleep
+    /// overshoots on the current system.
     ///
     /// \param limit Framerate limit, in frames per seconds (use 0 to disable limit)
     ///
     ////////////////////////////////////////////////////////////
     void setFramerateLimit(unsigned int limit);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the frame timing statistics
+    ///
+    /// The percentile is computed over the last 128 frames.
+    ///
+    /// \return Statistics since the last call to resetFrameStats
+    ///
+    /// \see resetFrameStats
+    ///
+    ////////////////////////////////////////////////////////////
+    FrameStats getFrameStats() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset the frame timing statistics
+    ///
+    /// \see getFrameStats
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetFrameStats();
+
     ////////////////////////////////////////////////////////////
     /// \brief Change the joystick threshold
     ///
@@ -444,6 +522,16 @@ protected :
     ////////////////////////////////////////////////////////////
     virtual void onResize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Function called after a frame has been displayed
+    ///
+    /// This function is called by display(), right after the
+    /// buffers are swapped, so that derived classes can perform
+    /// their own per-frame work.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void onDisplay();
+
 private:
 
     ////////////////////////////////////////////////////////////
@@ -466,14 +554,27 @@ private:
     ////////////////////////////////////////////////////////////
     void initialize();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait for the next frame deadline and record the frame time
+    ///
+    ////////////////////////////////////////////////////////////
+    void paceFrame();
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    priv::WindowImpl* m_impl;           ///< Platform-specific implementation of the window
-    priv::GlContext*  m_context;        ///< Platform-specific implementation of the OpenGL context
-    Clock             m_clock;          ///< Clock for measuring the elapsed time between frames
-    Time              m_frameTimeLimit; ///< Current framerate limit
-    Vector2u          m_size;           ///< Current size of the window
+    priv::WindowImpl* m_impl;            ///< Platform-specific implementation of the window
+    priv::GlContext*  m_context;         ///< Platform-specific implementation of the OpenGL context
+    Clock             m_clock;           ///< Clock for measuring the elapsed time between frames
+    Time              m_frameTimeLimit;  ///< Current framerate limit
+    Time              m_frameDeadline;   ///< Time at which the current frame should end
+    Time              m_lastFrame;       ///< Time at which the previous frame ended
+    Time              m_sleepMargin;     ///< Time spun instead of slept before a deadline
+    std::vector<Time> m_frameTimes;      ///< Ring buffer of the recent frame times
+    Time              m_frameTimeSum;    ///< Sum of the frame times since the last reset
+    Uint64            m_frameCount;      ///< Number of frames since the last reset
+    Uint64            m_missedDeadlines; ///< Number of late frames since the last reset
+    Vector2u          m_size;            ///< Current size of the window
 };
 
 } // namespace sf
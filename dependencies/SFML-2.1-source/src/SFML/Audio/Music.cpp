@@ -27,6 +27,7 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Audio/Music.hpp>
 #include <SFML/Audio/ALCheck.hpp>
+#include <SFML/Audio/SampleCache.hpp>
 #include <SFML/Audio/SoundFile.hpp>
 #include <SFML/System/Lock.hpp>
 #include <SFML/System/Err.hpp>
@@ -61,7 +62,7 @@ bool Music::openFromFile(const std::string& filename)
     stop();
 
     // Open the underlying sound file
-    if (!m_file->openRead(filename))
+    if (!m_file->openRead(filename, &SampleCache::getDefault()))
         return false;
 
     // Perform common initializations
@@ -117,6 +118,10 @@ bool Music::onGetData(SoundStream::Chunk& data)
 {
     Lock lock(m_mutex);
 
+    // Follow the buffer duration of the stream, which may have changed
+    if (m_samples.size() != getChunkSampleCount())
+        m_samples.resize(getChunkSampleCount());
+
     // Fill the chunk parameters
     data.samples     = &m_samples[0];
     data.sampleCount = m_file->read(&m_samples[0], m_samples.size());
@@ -141,11 +146,11 @@ void Music::initialize()
     // Compute the music duration
     m_duration = seconds(static_cast<float>(m_file->getSampleCount()) / m_file->getSampleRate() / m_file->getChannelCount());
 
-    // Resize the internal buffer so that it can contain 1 second of audio samples
-    m_samples.resize(m_file->getSampleRate() * m_file->getChannelCount());
-
     // Initialize the stream
     SoundStream::initialize(m_file->getChannelCount(), m_file->getSampleRate());
+
+    // Resize the internal buffer so that it can contain one buffer of audio samples
+    m_samples.resize(getChunkSampleCount());
 }
 
 } // namespace sf
@@ -0,0 +1,358 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Audio/SampleCache.hpp>
+#include <SFML/Audio/SoundFile.hpp>
+#include <SFML/System/Lock.hpp>
+#include <algorithm>
+#include <cstring>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+const std::size_t SampleCache::ChunkFrameCount;
+
+
+////////////////////////////////////////////////////////////
+struct SampleCache::Preload
+{
+    SampleCache* cache;    ///< Cache to fill
+    std::string  filename; ///< Path of the sound file to decode
+};
+
+
+////////////////////////////////////////////////////////////
+SampleCache::File::File() :
+sampleCount (0),
+channelCount(0),
+sampleRate  (0),
+chunks      (),
+cachedCount (0),
+isPreloading(false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+SampleCache::SampleCache(std::size_t byteBudget) :
+m_mutex     (Mutex::NonRecursive),
+m_files     (),
+m_lru       (),
+m_byteBudget(byteBudget),
+m_byteSize  (0),
+m_preloads  ()
+{
+    resetCacheStats();
+}
+
+
+////////////////////////////////////////////////////////////
+SampleCache::~SampleCache()
+{
+    // The preloads lock the cache, they can't be waited for with the mutex locked
+    std::vector<TaskScheduler::Task> preloads;
+    {
+        Lock lock(m_mutex);
+        preloads.swap(m_preloads);
+    }
+
+    for (std::vector<TaskScheduler::Task>::iterator it = preloads.begin(); it != preloads.end(); ++it)
+        it->wait();
+
+    clear();
+}
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler::Task SampleCache::preload(const std::string& filename)
+{
+    Lock lock(m_mutex);
+
+    // The properties of the file are not known until it is opened by the task
+    File& file = m_files[filename];
+    if (file.isPreloading || (!file.chunks.empty() && (file.cachedCount == file.chunks.size())))
+        return TaskScheduler::Task();
+
+    file.isPreloading = true;
+
+    // Forget about the preloads that are over
+    for (std::size_t i = 0; i < m_preloads.size();)
+    {
+        if (m_preloads[i].isDone())
+        {
+            m_preloads[i] = m_preloads.back();
+            m_preloads.pop_back();
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    Preload* preload = new Preload;
+    preload->cache = this;
+    preload->filename = filename;
+
+    TaskScheduler::Task task = TaskScheduler::getDefault().add(&SampleCache::decode, preload);
+    m_preloads.push_back(task);
+
+    return task;
+}
+
+
+////////////////////////////////////////////////////////////
+bool SampleCache::isCached(const std::string& filename) const
+{
+    Lock lock(m_mutex);
+
+    FileTable::const_iterator it = m_files.find(filename);
+    return (it != m_files.end()) && !it->second.chunks.empty() && (it->second.cachedCount == it->second.chunks.size());
+}
+
+
+////////////////////////////////////////////////////////////
+void SampleCache::setByteBudget(std::size_t byteBudget)
+{
+    Lock lock(m_mutex);
+
+    m_byteBudget = byteBudget;
+    evict(m_byteBudget);
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SampleCache::getByteBudget() const
+{
+    Lock lock(m_mutex);
+
+    return m_byteBudget;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SampleCache::getByteSize() const
+{
+    Lock lock(m_mutex);
+
+    return m_byteSize;
+}
+
+
+////////////////////////////////////////////////////////////
+void SampleCache::clear()
+{
+    Lock lock(m_mutex);
+
+    // The properties of the files are kept, they are cheap and save reopening them
+    evict(0);
+}
+
+
+////////////////////////////////////////////////////////////
+SampleCache::CacheStats SampleCache::getCacheStats() const
+{
+    Lock lock(m_mutex);
+
+    return m_stats;
+}
+
+
+////////////////////////////////////////////////////////////
+void SampleCache::resetCacheStats()
+{
+    Lock lock(m_mutex);
+
+    m_stats.hits         = 0;
+    m_stats.misses       = 0;
+    m_stats.evictions    = 0;
+    m_stats.decodedBytes = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+SampleCache& SampleCache::getDefault()
+{
+    // Never destroyed: musics may still be streaming when the program exits
+    static SampleCache* cache = new SampleCache;
+    return *cache;
+}
+
+
+////////////////////////////////////////////////////////////
+bool SampleCache::getInfo(const std::string& filename, std::size_t& sampleCount, unsigned int& channelCount, unsigned int& sampleRate) const
+{
+    Lock lock(m_mutex);
+
+    FileTable::const_iterator it = m_files.find(filename);
+    if ((it == m_files.end()) || (it->second.channelCount == 0))
+        return false;
+
+    sampleCount  = it->second.sampleCount;
+    channelCount = it->second.channelCount;
+    sampleRate   = it->second.sampleRate;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void SampleCache::setInfo(const std::string& filename, std::size_t sampleCount, unsigned int channelCount, unsigned int sampleRate)
+{
+    Lock lock(m_mutex);
+
+    File& file = m_files[filename];
+
+    // The length announced by the header of compressed files may be
+    // wrong: it is corrected when the end is reached during decoding
+    std::size_t chunkCount = (sampleCount / channelCount + ChunkFrameCount - 1) / ChunkFrameCount;
+    for (std::size_t i = chunkCount; i < file.chunks.size(); ++i)
+    {
+        if (file.chunks[i])
+        {
+            m_byteSize -= file.chunks[i]->samples.size() * sizeof(Int16);
+            m_lru.erase(file.chunks[i]->lruPosition);
+            delete file.chunks[i];
+            file.cachedCount--;
+        }
+    }
+
+    file.sampleCount  = sampleCount;
+    file.channelCount = channelCount;
+    file.sampleRate   = sampleRate;
+    file.chunks.resize(chunkCount, NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+int SampleCache::read(const std::string& filename, std::size_t index, std::size_t offset, Int16* data, std::size_t count)
+{
+    Lock lock(m_mutex);
+
+    FileTable::iterator it = m_files.find(filename);
+    if ((it == m_files.end()) || (index >= it->second.chunks.size()) || !it->second.chunks[index])
+        return -1;
+
+    Chunk* chunk = it->second.chunks[index];
+    m_stats.hits++;
+
+    // Mark the chunk as the most recently used
+    m_lru.splice(m_lru.begin(), m_lru, chunk->lruPosition);
+
+    if (offset >= chunk->samples.size())
+        return 0;
+
+    count = std::min(count, chunk->samples.size() - offset);
+    std::memcpy(data, &chunk->samples[offset], count * sizeof(Int16));
+
+    return static_cast<int>(count);
+}
+
+
+////////////////////////////////////////////////////////////
+void SampleCache::insert(const std::string& filename, std::size_t index, const Int16* samples, std::size_t count)
+{
+    Lock lock(m_mutex);
+
+    m_stats.misses++;
+    m_stats.decodedBytes += count * sizeof(Int16);
+
+    FileTable::iterator it = m_files.find(filename);
+    if ((it == m_files.end()) || (index >= it->second.chunks.size()) || it->second.chunks[index])
+        return;
+
+    // A chunk larger than the whole budget is never cached
+    std::size_t byteCount = count * sizeof(Int16);
+    if (byteCount > m_byteBudget)
+        return;
+
+    evict(m_byteBudget - byteCount);
+
+    Chunk* chunk = new Chunk;
+    chunk->file = &it->second;
+    chunk->index = index;
+    chunk->samples.assign(samples, samples + count);
+    chunk->lruPosition = m_lru.insert(m_lru.begin(), chunk);
+
+    it->second.chunks[index] = chunk;
+    it->second.cachedCount++;
+    m_byteSize += byteCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void SampleCache::evict(std::size_t byteSize)
+{
+    while ((m_byteSize > byteSize) && !m_lru.empty())
+    {
+        Chunk* chunk = m_lru.back();
+        m_lru.pop_back();
+
+        chunk->file->chunks[chunk->index] = NULL;
+        chunk->file->cachedCount--;
+        m_byteSize -= chunk->samples.size() * sizeof(Int16);
+        m_stats.evictions++;
+
+        delete chunk;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SampleCache::decode(Preload* preload)
+{
+    SampleCache& cache = *preload->cache;
+
+    // Reading the file through the cache is enough to fill it
+    priv::SoundFile file;
+    if (file.openRead(preload->filename, &cache))
+    {
+        // Don't decode more than the budget, the beginning would be evicted by the end
+        std::size_t remaining = std::min(file.getSampleCount(), cache.getByteBudget() / sizeof(Int16));
+        std::vector<Int16> samples(ChunkFrameCount * file.getChannelCount());
+        while (remaining > 0)
+        {
+            std::size_t count = file.read(&samples[0], std::min(remaining, samples.size()));
+            if (count == 0)
+                break;
+
+            remaining -= count;
+        }
+    }
+
+    {
+        Lock lock(cache.m_mutex);
+
+        FileTable::iterator it = cache.m_files.find(preload->filename);
+        if (it != cache.m_files.end())
+            it->second.isPreloading = false;
+    }
+
+    delete preload;
+}
+
+} // namespace sf
@@ -26,8 +26,10 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Audio/SampleCache.hpp>
 #include <SFML/Audio/SoundFile.hpp>
 #include <SFML/Audio/Sound.hpp>
+#include <SFML/Audio/SoundMixer.hpp>
 #include <SFML/Audio/AudioDevice.hpp>
 #include <SFML/Audio/ALCheck.hpp>
 #include <SFML/System/Err.hpp>
@@ -53,7 +55,8 @@ SoundBuffer::SoundBuffer(const SoundBuffer& copy) :
 m_buffer  (0),
 m_samples (copy.m_samples),
 m_duration(copy.m_duration),
-m_sounds  () // don't copy the attached sounds
+m_sounds  (), // don't copy the attached sounds
+m_mixers  ()
 {
     // Create the buffer
     alCheck(alGenBuffers(1, &m_buffer));
@@ -70,6 +73,9 @@ SoundBuffer::~SoundBuffer()
     for (SoundList::const_iterator it = m_sounds.begin(); it != m_sounds.end(); ++it)
         (*it)->resetBuffer();
 
+    // Stop the mixer voices reading our samples
+    detachMixers();
+
     // Destroy the buffer
     if (m_buffer)
         alCheck(alDeleteBuffers(1, &m_buffer));
@@ -80,7 +86,7 @@ SoundBuffer::~SoundBuffer()
 bool SoundBuffer::loadFromFile(const std::string& filename)
 {
     priv::SoundFile file;
-    if (file.openRead(filename))
+    if (file.openRead(filename, &SampleCache::getDefault()))
         return initialize(file);
     else
         return false;
@@ -115,6 +121,7 @@ bool SoundBuffer::loadFromSamples(const Int16* samples, std::size_t sampleCount,
     if (samples && sampleCount && channelCount && sampleRate)
     {
         // Copy the new audio samples
+        detachMixers();
         m_samples.assign(samples, samples + sampleCount);
 
         // Update the internal buffer with the new samples
@@ -200,6 +207,9 @@ SoundBuffer& SoundBuffer::operator =(const SoundBuffer& right)
 {
     SoundBuffer temp(right);
 
+    // Our samples are about to be replaced
+    detachMixers();
+
     std::swap(m_samples,  temp.m_samples);
     std::swap(m_buffer,   temp.m_buffer);
     std::swap(m_duration, temp.m_duration);
@@ -218,6 +228,7 @@ bool SoundBuffer::initialize(priv::SoundFile& file)
     unsigned int sampleRate   = file.getSampleRate();
 
     // Read the samples from the provided file
+    detachMixers();
     m_samples.resize(sampleCount);
     if (file.read(&m_samples[0], sampleCount) == sampleCount)
     {
@@ -272,4 +283,28 @@ void SoundBuffer::detachSound(Sound* sound) const
     m_sounds.erase(sound);
 }
 
+
+////////////////////////////////////////////////////////////
+void SoundBuffer::attachMixer(SoundMixer* mixer) const
+{
+    m_mixers.insert(mixer);
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundBuffer::detachMixer(SoundMixer* mixer) const
+{
+    m_mixers.erase(mixer);
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundBuffer::detachMixers()
+{
+    MixerList mixers;
+    std::swap(mixers, m_mixers);
+    for (MixerList::const_iterator it = mixers.begin(); it != mixers.end(); ++it)
+        (*it)->stopBuffer(*this);
+}
+
 } // namespace sf
@@ -26,8 +26,10 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Audio/SoundFile.hpp>
+#include <SFML/Audio/SampleCache.hpp>
 #include <SFML/System/InputStream.hpp>
 #include <SFML/System/Err.hpp>
+#include <algorithm>
 #include <cstring>
 #include <cctype>
 
@@ -50,10 +52,13 @@ namespace priv
 {
 ////////////////////////////////////////////////////////////
 SoundFile::SoundFile() :
-m_file        (NULL),
-m_sampleCount (0),
-m_channelCount(0),
-m_sampleRate  (0)
+m_file           (NULL),
+m_sampleCount    (0),
+m_channelCount   (0),
+m_sampleRate     (0),
+m_cache          (NULL),
+m_position       (0),
+m_decoderPosition(0)
 {
 
 }
@@ -62,8 +67,7 @@ m_sampleRate  (0)
 ////////////////////////////////////////////////////////////
 SoundFile::~SoundFile()
 {
-    if (m_file)
-        sf_close(m_file);
+    close();
 }
 
 
@@ -89,11 +93,20 @@ unsigned int SoundFile::getSampleRate() const
 
 
 ////////////////////////////////////////////////////////////
-bool SoundFile::openRead(const std::string& filename)
+bool SoundFile::openRead(const std::string& filename, SampleCache* cache)
 {
     // If the file is already opened, first close it
-    if (m_file)
-        sf_close(m_file);
+    close();
+
+    // A file already known by the cache is only opened when a chunk has to be decoded
+    if (cache && cache->getInfo(filename, m_sampleCount, m_channelCount, m_sampleRate))
+    {
+        m_cache           = cache;
+        m_filename        = filename;
+        m_position        = 0;
+        m_decoderPosition = 0;
+        return true;
+    }
 
     // Open the sound file
     SF_INFO fileInfo;
@@ -108,6 +121,16 @@ bool SoundFile::openRead(const std::string& filename)
     // Initialize the internal state from the loaded information
     initialize(fileInfo);
 
+    // Let the next openings of the file skip the header
+    if (cache)
+    {
+        m_cache           = cache;
+        m_filename        = filename;
+        m_position        = 0;
+        m_decoderPosition = 0;
+        cache->setInfo(filename, m_sampleCount, m_channelCount, m_sampleRate);
+    }
+
     return true;
 }
 
@@ -116,8 +139,7 @@ bool SoundFile::openRead(const std::string& filename)
 bool SoundFile::openRead(const void* data, std::size_t sizeInBytes)
 {
     // If the file is already opened, first close it
-    if (m_file)
-        sf_close(m_file);
+    close();
 
     // Prepare the memory I/O structure
     SF_VIRTUAL_IO io;
@@ -152,8 +174,7 @@ bool SoundFile::openRead(const void* data, std::size_t sizeInBytes)
 bool SoundFile::openRead(InputStream& stream)
 {
     // If the file is already opened, first close it
-    if (m_file)
-        sf_close(m_file);
+    close();
 
     // Prepare the memory I/O structure
     SF_VIRTUAL_IO io;
@@ -190,8 +211,7 @@ bool SoundFile::openRead(InputStream& stream)
 bool SoundFile::openWrite(const std::string& filename, unsigned int channelCount, unsigned int sampleRate)
 {
     // If the file is already opened, first close it
-    if (m_file)
-        sf_close(m_file);
+    close();
 
     // Find the right format according to the file extension
     int format = getFormatFromFilename(filename);
@@ -228,10 +248,31 @@ bool SoundFile::openWrite(const std::string& filename, unsigned int channelCount
 ////////////////////////////////////////////////////////////
 std::size_t SoundFile::read(Int16* data, std::size_t sampleCount)
 {
-    if (m_file && data && sampleCount)
-        return static_cast<std::size_t>(sf_read_short(m_file, data, sampleCount));
-    else
+    if (!data || !sampleCount)
         return 0;
+
+    if (!m_cache)
+        return m_file ? static_cast<std::size_t>(sf_read_short(m_file, data, sampleCount)) : 0;
+
+    // Read chunk by chunk, from the cache or else from the decoder
+    std::size_t chunkSampleCount = SampleCache::ChunkFrameCount * m_channelCount;
+    std::size_t total = 0;
+    while (total < sampleCount)
+    {
+        std::size_t index  = m_position / chunkSampleCount;
+        std::size_t offset = m_position % chunkSampleCount;
+        std::size_t count  = std::min(sampleCount - total, chunkSampleCount - offset);
+
+        int cached = m_cache->read(m_filename, index, offset, data + total, count);
+        std::size_t read = (cached >= 0) ? static_cast<std::size_t>(cached) : decodeChunk(index, offset, data + total, count);
+        if (read == 0)
+            break;
+
+        total += read;
+        m_position += read;
+    }
+
+    return total;
 }
 
 
@@ -256,7 +297,13 @@ void SoundFile::write(const Int16* data, std::size_t sampleCount)
 ////////////////////////////////////////////////////////////
 void SoundFile::seek(Time timeOffset)
 {
-    if (m_file)
+    if (m_cache)
+    {
+        // The decoder is only moved if the new position is not cached
+        std::size_t frameOffset = static_cast<std::size_t>(timeOffset.asSeconds() * m_sampleRate);
+        m_position = std::min(frameOffset * m_channelCount, m_sampleCount);
+    }
+    else if (m_file)
     {
         sf_count_t frameOffset = static_cast<sf_count_t>(timeOffset.asSeconds() * m_sampleRate);
         sf_seek(m_file, frameOffset, SEEK_SET);
@@ -319,6 +366,75 @@ int SoundFile::getFormatFromFilename(const std::string& filename)
 }
 
 
+////////////////////////////////////////////////////////////
+void SoundFile::close()
+{
+    if (m_file)
+        sf_close(m_file);
+
+    m_file = NULL;
+    m_cache = NULL;
+    m_filename.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SoundFile::decodeChunk(std::size_t index, std::size_t offset, Int16* data, std::size_t count)
+{
+    // Open the file on the first miss, if its properties came from the cache
+    if (!m_file)
+    {
+        SF_INFO fileInfo;
+        fileInfo.format = 0;
+        m_file = sf_open(m_filename.c_str(), SFM_READ, &fileInfo);
+        if (!m_file)
+        {
+            err() << "Failed to open sound file \"" << m_filename << "\" (" << sf_strerror(m_file) << ")" << std::endl;
+            return 0;
+        }
+
+        m_decoderPosition = 0;
+    }
+
+    // Sequential reading doesn't need to seek, as the decoder is already
+    // at the start of the next chunk
+    std::size_t chunkSampleCount = SampleCache::ChunkFrameCount * m_channelCount;
+    std::size_t start = index * chunkSampleCount;
+    if (m_decoderPosition != start)
+    {
+        if (sf_seek(m_file, static_cast<sf_count_t>(start / m_channelCount), SEEK_SET) < 0)
+            return 0;
+
+        m_decoderPosition = start;
+    }
+
+    m_chunk.resize(chunkSampleCount);
+    std::size_t decoded = static_cast<std::size_t>(sf_read_short(m_file, &m_chunk[0], chunkSampleCount));
+    m_decoderPosition += decoded;
+
+    // The header of compressed files may announce a wrong length: the
+    // real one is known once the end is reached
+    if ((decoded < chunkSampleCount) && (start + decoded != m_sampleCount))
+    {
+        m_sampleCount = start + decoded;
+        m_cache->setInfo(m_filename, m_sampleCount, m_channelCount, m_sampleRate);
+    }
+
+    if (decoded == 0)
+        return 0;
+
+    m_cache->insert(m_filename, index, &m_chunk[0], decoded);
+
+    if (offset >= decoded)
+        return 0;
+
+    count = std::min(count, decoded - offset);
+    std::memcpy(data, &m_chunk[offset], count * sizeof(Int16));
+
+    return count;
+}
+
+
 ////////////////////////////////////////////////////////////
 sf_count_t SoundFile::Memory::getLength(void* user)
 {
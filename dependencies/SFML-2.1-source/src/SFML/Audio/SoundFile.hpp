@@ -32,11 +32,13 @@
 #include <SFML/System/Time.hpp>
 #include <sndfile.h>
 #include <string>
+#include <vector>
 
 
 namespace sf
 {
 class InputStream;
+class SampleCache;
 
 namespace priv
 {
@@ -87,12 +89,19 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Open a sound file for reading
     ///
+    /// With a cache, the file is decoded in chunks which are
+    /// shared through the cache, and seeking is deferred until
+    /// a chunk that is not cached has to be decoded. If the
+    /// properties of the file are already known by the cache,
+    /// the file is not even opened until then.
+    ///
     /// \param filename Path of the sound file to load
+    /// \param cache    Cache of decoded samples to use, or NULL
     ///
     /// \return True if the file was successfully opened
     ///
     ////////////////////////////////////////////////////////////
-    bool openRead(const std::string& filename);
+    bool openRead(const std::string& filename, SampleCache* cache = NULL);
 
     ////////////////////////////////////////////////////////////
     /// \brief Open a sound file in memory for reading
@@ -178,6 +187,25 @@ private :
     ////////////////////////////////////////////////////////////
     static int getFormatFromFilename(const std::string& filename);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Close the file and stop using the cache
+    ///
+    ////////////////////////////////////////////////////////////
+    void close();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Decode a chunk into the cache, and read samples from it
+    ///
+    /// \param index  Position of the chunk in the file
+    /// \param offset First sample to read, relative to the chunk
+    /// \param data   Pointer to the sample array to fill
+    /// \param count  Maximum number of samples to read
+    ///
+    /// \return Number of samples actually read
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t decodeChunk(std::size_t index, std::size_t offset, Int16* data, std::size_t count);
+
     ////////////////////////////////////////////////////////////
     /// \brief Data and callbacks for opening from memory
     ///
@@ -212,12 +240,17 @@ private :
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    SNDFILE*     m_file;         ///< File descriptor
-    Memory       m_memory;       ///< Memory reading info
-    Stream       m_stream;       ///< Stream reading info
-    std::size_t  m_sampleCount;  ///< Total number of samples in the file
-    unsigned int m_channelCount; ///< Number of channels used by the sound
-    unsigned int m_sampleRate;   ///< Number of samples per second
+    SNDFILE*           m_file;            ///< File descriptor
+    Memory             m_memory;          ///< Memory reading info
+    Stream             m_stream;          ///< Stream reading info
+    std::size_t        m_sampleCount;     ///< Total number of samples in the file
+    unsigned int       m_channelCount;    ///< Number of channels used by the sound
+    unsigned int       m_sampleRate;      ///< Number of samples per second
+    SampleCache*       m_cache;           ///< Cache of decoded samples, if the file is read through it
+    std::string        m_filename;        ///< Path of the file, identifying it in the cache
+    std::size_t        m_position;        ///< Read position when reading through the cache, in samples
+    std::size_t        m_decoderPosition; ///< Position of the decoder, in samples
+    std::vector<Int16> m_chunk;           ///< Samples of the last decoded chunk
 };
 
 } // namespace priv
@@ -0,0 +1,615 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Audio/SoundMixer.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Audio/SoundStream.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Lock.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define SFML_SOUNDMIXER_SSE2
+#endif
+
+
+namespace
+{
+    // A voice identifier is made of the voice index and its generation
+    const unsigned int indexBits = 12;
+    const sf::Uint32 indexMask = (1 << indexBits) - 1;
+    const sf::Uint32 generationMask = 0xFFFFFFFF >> indexBits;
+
+    // 1.0 in 32.32 fixed point
+    const sf::Uint64 fixedOne = static_cast<sf::Uint64>(1) << 32;
+
+    // Stream playing the mix through OpenAL
+    class MixerStream : public sf::SoundStream
+    {
+    public :
+
+        MixerStream(sf::SoundMixer& mixer) :
+        m_mixer(mixer)
+        {
+            // Short buffers, sound effects must follow the game closely
+            initialize(2, mixer.getSampleRate());
+            setBufferDuration(sf::milliseconds(20));
+        }
+
+        ~MixerStream()
+        {
+            stop();
+        }
+
+    private :
+
+        virtual bool onGetData(Chunk& data)
+        {
+            m_samples.resize(getChunkSampleCount());
+            m_mixer.mix(&m_samples[0], m_samples.size() / 2);
+
+            data.samples = &m_samples[0];
+            data.sampleCount = m_samples.size();
+
+            // The mix never ends
+            return true;
+        }
+
+        virtual void onSeek(sf::Time)
+        {
+        }
+
+        sf::SoundMixer&        m_mixer;
+        std::vector<sf::Int16> m_samples;
+    };
+
+    // Convert 16 bits samples to floats
+    void convertToFloat(const sf::Int16* in, float* out, std::size_t count)
+    {
+        std::size_t i = 0;
+
+    #ifdef SFML_SOUNDMIXER_SSE2
+
+        for (; i + 8 <= count; i += 8)
+        {
+            // Sign-extend by putting the samples in the high halves and shifting back
+            __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            __m128i low  = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+            __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+            _mm_storeu_ps(out + i, _mm_cvtepi32_ps(low));
+            _mm_storeu_ps(out + i + 4, _mm_cvtepi32_ps(high));
+        }
+
+    #endif
+
+        for (; i < count; ++i)
+            out[i] = in[i];
+    }
+
+    // Resample frames with linear interpolation
+    void resample(const sf::Int16* in, std::size_t inFrameCount, unsigned int channelCount, sf::Uint64 position, sf::Uint64 step, float* out, std::size_t outFrameCount)
+    {
+        const float fracScale = 1.f / 4294967296.f;
+        std::size_t last = inFrameCount - 1;
+        std::size_t i = 0;
+
+    #ifdef SFML_SOUNDMIXER_SSE2
+
+        // There is no gather instruction: the neighbours are loaded one by one,
+        // and interpolated 4 samples at once. The last frame of the buffer is
+        // left to the scalar loop, which doesn't read past it
+        const __m128 fracScales = _mm_set1_ps(1.f / 16777216.f);
+        if (channelCount == 1)
+        {
+            for (; (i + 4 <= outFrameCount) && (((position + step * 3) >> 32) < last); i += 4)
+            {
+                sf::Uint64 p0 = position;
+                sf::Uint64 p1 = p0 + step;
+                sf::Uint64 p2 = p1 + step;
+                sf::Uint64 p3 = p2 + step;
+                position = p3 + step;
+
+                const sf::Int16* s0 = in + (p0 >> 32);
+                const sf::Int16* s1 = in + (p1 >> 32);
+                const sf::Int16* s2 = in + (p2 >> 32);
+                const sf::Int16* s3 = in + (p3 >> 32);
+
+                // Keep 24 bits of the fractional part, so that it converts exactly
+                __m128i frac = _mm_setr_epi32(static_cast<int>((p0 & 0xFFFFFFFF) >> 8), static_cast<int>((p1 & 0xFFFFFFFF) >> 8),
+                                              static_cast<int>((p2 & 0xFFFFFFFF) >> 8), static_cast<int>((p3 & 0xFFFFFFFF) >> 8));
+                __m128 a = _mm_cvtepi32_ps(_mm_setr_epi32(s0[0], s1[0], s2[0], s3[0]));
+                __m128 b = _mm_cvtepi32_ps(_mm_setr_epi32(s0[1], s1[1], s2[1], s3[1]));
+                __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(frac), fracScales);
+                _mm_storeu_ps(out + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t)));
+            }
+        }
+        else
+        {
+            for (; (i + 2 <= outFrameCount) && (((position + step) >> 32) < last); i += 2)
+            {
+                sf::Uint64 p0 = position;
+                sf::Uint64 p1 = p0 + step;
+                position = p1 + step;
+
+                const sf::Int16* s0 = in + (p0 >> 32) * 2;
+                const sf::Int16* s1 = in + (p1 >> 32) * 2;
+
+                int f0 = static_cast<int>((p0 & 0xFFFFFFFF) >> 8);
+                int f1 = static_cast<int>((p1 & 0xFFFFFFFF) >> 8);
+                __m128 a = _mm_cvtepi32_ps(_mm_setr_epi32(s0[0], s0[1], s1[0], s1[1]));
+                __m128 b = _mm_cvtepi32_ps(_mm_setr_epi32(s0[2], s0[3], s1[2], s1[3]));
+                __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_setr_epi32(f0, f0, f1, f1)), fracScales);
+                _mm_storeu_ps(out + i * 2, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t)));
+            }
+        }
+
+    #endif
+
+        for (; i < outFrameCount; ++i)
+        {
+            std::size_t index = static_cast<std::size_t>(position >> 32);
+            std::size_t next = std::min(index + 1, last);
+            float frac = static_cast<float>(position & 0xFFFFFFFF) * fracScale;
+
+            for (unsigned int c = 0; c < channelCount; ++c)
+            {
+                float a = in[index * channelCount + c];
+                float b = in[next * channelCount + c];
+                out[i * channelCount + c] = a + (b - a) * frac;
+            }
+
+            position += step;
+        }
+    }
+
+    // Add frames to the interleaved stereo mix, with a gain per output channel
+    void accumulate(const float* in, unsigned int channelCount, float* mix, std::size_t frameCount, float gainLeft, float gainRight)
+    {
+        std::size_t i = 0;
+
+    #ifdef SFML_SOUNDMIXER_SSE2
+
+        __m128 gains = _mm_setr_ps(gainLeft, gainRight, gainLeft, gainRight);
+        if (channelCount == 1)
+        {
+            // Duplicate each mono sample to both channels
+            for (; i + 4 <= frameCount; i += 4)
+            {
+                __m128 samples = _mm_loadu_ps(in + i);
+                __m128 low  = _mm_unpacklo_ps(samples, samples);
+                __m128 high = _mm_unpackhi_ps(samples, samples);
+                _mm_storeu_ps(mix + i * 2,     _mm_add_ps(_mm_loadu_ps(mix + i * 2),     _mm_mul_ps(low, gains)));
+                _mm_storeu_ps(mix + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(mix + i * 2 + 4), _mm_mul_ps(high, gains)));
+            }
+        }
+        else
+        {
+            for (; i + 2 <= frameCount; i += 2)
+                _mm_storeu_ps(mix + i * 2, _mm_add_ps(_mm_loadu_ps(mix + i * 2), _mm_mul_ps(_mm_loadu_ps(in + i * 2), gains)));
+        }
+
+    #endif
+
+        for (; i < frameCount; ++i)
+        {
+            float left  = in[i * channelCount];
+            float right = in[i * channelCount + channelCount - 1];
+            mix[i * 2]     += left * gainLeft;
+            mix[i * 2 + 1] += right * gainRight;
+        }
+    }
+
+    // Convert the mix to 16 bits samples, with saturation
+    void convertToInt16(const float* in, sf::Int16* out, std::size_t count, float gain)
+    {
+        std::size_t i = 0;
+
+    #ifdef SFML_SOUNDMIXER_SSE2
+
+        __m128 gains = _mm_set1_ps(gain);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i low  = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i), gains));
+            __m128i high = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i + 4), gains));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(low, high));
+        }
+
+    #endif
+
+        for (; i < count; ++i)
+        {
+            float sample = in[i] * gain;
+            if (sample > 32767.f)
+                out[i] = 32767;
+            else if (sample < -32768.f)
+                out[i] = -32768;
+            else
+                out[i] = static_cast<sf::Int16>(sample + (sample < 0.f ? -0.5f : 0.5f));
+        }
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+SoundMixer::SoundMixer(unsigned int voiceCount, unsigned int sampleRate) :
+m_mutex       (Mutex::NonRecursive),
+m_voices      (std::max(1u, std::min(voiceCount, indexMask + 1))),
+m_sampleRate  (sampleRate),
+m_masterVolume(1.f),
+m_startCounter(0),
+m_mixBuffer   (),
+m_voiceBuffer (),
+m_output      (NULL),
+m_buffers     ()
+{
+    for (std::vector<Voice>::iterator it = m_voices.begin(); it != m_voices.end(); ++it)
+    {
+        it->buffer = NULL;
+        it->samples = NULL;
+        it->generation = 0;
+    }
+
+    resetMixerStats();
+}
+
+
+////////////////////////////////////////////////////////////
+SoundMixer::~SoundMixer()
+{
+    close();
+
+    for (std::set<const SoundBuffer*>::const_iterator it = m_buffers.begin(); it != m_buffers.end(); ++it)
+        (*it)->detachMixer(this);
+}
+
+
+////////////////////////////////////////////////////////////
+bool SoundMixer::open(Device device)
+{
+    close();
+
+    if (device == DefaultDevice)
+    {
+        m_output = new MixerStream(*this);
+        if (m_output->getChannelCount() == 0)
+        {
+            close();
+            return false;
+        }
+
+        m_output->play();
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundMixer::close()
+{
+    // The stream stops when destroyed, after which it doesn't mix anymore
+    delete m_output;
+    m_output = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+SoundMixer::VoiceId SoundMixer::play(const SoundBuffer& buffer, int priority, float volume, float pan, float pitch)
+{
+    unsigned int channelCount = buffer.getChannelCount();
+    if (!buffer.getSamples() || (buffer.getSampleCount() < channelCount) || (channelCount < 1) || (channelCount > 2))
+        return InvalidVoice;
+
+    Lock lock(m_mutex);
+
+    // Take a free voice, or else the one playing the least important
+    // sound, the oldest one among equals
+    Voice* voice = NULL;
+    for (std::vector<Voice>::iterator it = m_voices.begin(); it != m_voices.end(); ++it)
+    {
+        if (!it->samples)
+        {
+            voice = &*it;
+            break;
+        }
+
+        if (!voice || (it->priority < voice->priority) || ((it->priority == voice->priority) && (it->startOrder < voice->startOrder)))
+            voice = &*it;
+    }
+
+    if (voice->samples)
+    {
+        if (voice->priority > priority)
+        {
+            m_stats.droppedVoices++;
+            return InvalidVoice;
+        }
+
+        m_stats.stolenVoices++;
+    }
+
+    // Make sure the buffer stops the voice before its samples disappear
+    if (m_buffers.insert(&buffer).second)
+        buffer.attachMixer(this);
+
+    voice->buffer       = &buffer;
+    voice->samples      = buffer.getSamples();
+    voice->frameCount   = buffer.getSampleCount() / channelCount;
+    voice->channelCount = channelCount;
+    voice->sampleRate   = buffer.getSampleRate();
+    voice->position     = 0;
+    voice->volume       = std::max(0.f, std::min(volume, 100.f)) / 100.f;
+    voice->pan          = std::max(-1.f, std::min(pan, 1.f));
+    voice->priority     = priority;
+    voice->startOrder   = m_startCounter++;
+    updateGains(*voice);
+
+    voice->step = static_cast<Uint64>(std::max(pitch, 0.f) * voice->sampleRate / m_sampleRate * fixedOne);
+    if (voice->step == 0)
+        voice->step = 1;
+
+    // Invalidate the identifiers of the previous sound of this voice
+    voice->generation = (voice->generation + 1) & generationMask;
+    if (voice->generation == 0)
+        voice->generation = 1;
+
+    m_stats.startedVoices++;
+
+    return (voice->generation << indexBits) | static_cast<Uint32>(voice - &m_voices[0]);
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundMixer::stop(VoiceId voice)
+{
+    Lock lock(m_mutex);
+
+    if (Voice* found = findVoice(voice))
+        found->samples = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundMixer::stopAll()
+{
+    Lock lock(m_mutex);
+
+    for (std::vector<Voice>::iterator it = m_voices.begin(); it != m_voices.end(); ++it)
+        it->samples = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+bool SoundMixer::isPlaying(VoiceId voice) const
+{
+    Lock lock(m_mutex);
+
+    return const_cast<SoundMixer*>(this)->findVoice(voice) != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundMixer::setVolume(VoiceId voice, float volume)
+{
+    Lock lock(m_mutex);
+
+    if (Voice* found = findVoice(voice))
+    {
+        found->volume = std::max(0.f, std::min(volume, 100.f)) / 100.f;
+        updateGains(*found);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundMixer::setPan(VoiceId voice, float pan)
+{
+    Lock lock(m_mutex);
+
+    if (Voice* found = findVoice(voice))
+    {
+        found->pan = std::max(-1.f, std::min(pan, 1.f));
+        updateGains(*found);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundMixer::setPitch(VoiceId voice, float pitch)
+{
+    Lock lock(m_mutex);
+
+    if (Voice* found = findVoice(voice))
+    {
+        found->step = static_cast<Uint64>(std::max(pitch, 0.f) * found->sampleRate / m_sampleRate * fixedOne);
+        if (found->step == 0)
+            found->step = 1;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundMixer::setMasterVolume(float volume)
+{
+    Lock lock(m_mutex);
+
+    m_masterVolume = std::max(0.f, std::min(volume, 100.f)) / 100.f;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundMixer::mix(Int16* samples, std::size_t frameCount)
+{
+    Clock clock;
+    Lock lock(m_mutex);
+
+    m_mixBuffer.assign(frameCount * 2, 0.f);
+    if (m_voiceBuffer.size() < frameCount * 2)
+        m_voiceBuffer.resize(frameCount * 2);
+
+    for (std::vector<Voice>::iterator it = m_voices.begin(); it != m_voices.end(); ++it)
+    {
+        // Free the voices which reached the end of their buffer
+        if (it->samples && (mixVoice(*it, frameCount) < frameCount))
+            it->samples = NULL;
+    }
+
+    if (frameCount > 0)
+        convertToInt16(&m_mixBuffer[0], samples, frameCount * 2, m_masterVolume);
+
+    m_stats.mixedFrames += frameCount;
+    m_stats.mixTime += clock.getElapsedTime();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SoundMixer::getVoiceCount() const
+{
+    return static_cast<unsigned int>(m_voices.size());
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SoundMixer::getSampleRate() const
+{
+    return m_sampleRate;
+}
+
+
+////////////////////////////////////////////////////////////
+SoundMixer::MixerStats SoundMixer::getMixerStats() const
+{
+    Lock lock(m_mutex);
+
+    MixerStats stats = m_stats;
+    stats.activeVoices = 0;
+    for (std::vector<Voice>::const_iterator it = m_voices.begin(); it != m_voices.end(); ++it)
+    {
+        if (it->samples)
+            stats.activeVoices++;
+    }
+
+    return stats;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundMixer::resetMixerStats()
+{
+    Lock lock(m_mutex);
+
+    m_stats.activeVoices  = 0;
+    m_stats.startedVoices = 0;
+    m_stats.stolenVoices  = 0;
+    m_stats.droppedVoices = 0;
+    m_stats.mixedFrames   = 0;
+    m_stats.mixTime       = Time::Zero;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundMixer::stopBuffer(const SoundBuffer& buffer)
+{
+    Lock lock(m_mutex);
+
+    for (std::vector<Voice>::iterator it = m_voices.begin(); it != m_voices.end(); ++it)
+    {
+        if (it->buffer == &buffer)
+            it->samples = NULL;
+    }
+
+    m_buffers.erase(&buffer);
+}
+
+
+////////////////////////////////////////////////////////////
+SoundMixer::Voice* SoundMixer::findVoice(VoiceId voice)
+{
+    std::size_t index = voice & indexMask;
+    if ((voice == InvalidVoice) || (index >= m_voices.size()))
+        return NULL;
+
+    Voice& found = m_voices[index];
+    return (found.samples && (found.generation == (voice >> indexBits))) ? &found : NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundMixer::updateGains(Voice& voice)
+{
+    if (voice.channelCount == 1)
+    {
+        // Constant power: the sound doesn't get louder in the center
+        float angle = (voice.pan + 1.f) * 3.141592654f / 4.f;
+        voice.gainLeft  = voice.volume * std::cos(angle);
+        voice.gainRight = voice.volume * std::sin(angle);
+    }
+    else
+    {
+        // Balance: attenuate the opposite channel
+        voice.gainLeft  = voice.volume * (voice.pan > 0.f ? 1.f - voice.pan : 1.f);
+        voice.gainRight = voice.volume * (voice.pan < 0.f ? 1.f + voice.pan : 1.f);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SoundMixer::mixVoice(Voice& voice, std::size_t frameCount)
+{
+    Uint64 end = static_cast<Uint64>(voice.frameCount) << 32;
+    if (voice.position >= end)
+        return 0;
+
+    // Number of output frames before the end of the buffer
+    Uint64 available = (end - voice.position + voice.step - 1) / voice.step;
+    std::size_t count = static_cast<std::size_t>(std::min(static_cast<Uint64>(frameCount), available));
+    if (count == 0)
+        return 0;
+
+    float* frames = &m_voiceBuffer[0];
+    if ((voice.step == fixedOne) && ((voice.position & 0xFFFFFFFF) == 0))
+    {
+        // Same rate and pitch: no interpolation needed
+        const Int16* first = voice.samples + (voice.position >> 32) * voice.channelCount;
+        convertToFloat(first, frames, count * voice.channelCount);
+    }
+    else
+    {
+        resample(voice.samples, voice.frameCount, voice.channelCount, voice.position, voice.step, frames, count);
+    }
+
+    accumulate(frames, voice.channelCount, &m_mixBuffer[0], count, voice.gainLeft, voice.gainRight);
+    voice.position += voice.step * count;
+
+    return count;
+}
+
+} // namespace sf
@@ -28,27 +28,34 @@
 #include <SFML/Audio/SoundStream.hpp>
 #include <SFML/Audio/AudioDevice.hpp>
 #include <SFML/Audio/ALCheck.hpp>
-#include <SFML/System/Sleep.hpp>
+#include <SFML/Audio/StreamingThread.hpp>
+#include <SFML/System/Lock.hpp>
 #include <SFML/System/Err.hpp>
 
-#ifdef _MSC_VER
-    #pragma warning(disable : 4355) // 'this' used in base member initializer list
-#endif
-
 
 namespace sf
 {
 ////////////////////////////////////////////////////////////
 SoundStream::SoundStream() :
-m_thread          (&SoundStream::streamData, this),
 m_isStreaming     (false),
 m_channelCount    (0),
 m_sampleRate      (0),
 m_format          (0),
 m_loop            (false),
-m_samplesProcessed(0)
+m_samplesProcessed(0),
+m_bufferCount     (3),
+m_bufferDuration  (milliseconds(250)),
+m_requestStop     (false),
+m_hasStarted      (false),
+m_mutex           (Mutex::NonRecursive),
+m_firstChunk      (0),
+m_chunkCount      (0),
+m_playingCount    (0),
+m_prefetching     (false),
+m_endOfData       (false),
+m_latencySum      (0)
 {
-
+    resetStreamStats();
 }
 
 
@@ -96,13 +103,15 @@ void SoundStream::play()
         return;
     }
 
+    // Make sure that a stream which reached its end is fully stopped
+    stop();
+
     // Move to the beginning
     onSeek(Time::Zero);
 
-    // Start updating the stream in a separate thread to avoid blocking the application
+    // Start updating the stream in the background to avoid blocking the application
     m_samplesProcessed = 0;
-    m_isStreaming = true;
-    m_thread.launch();
+    startStreaming();
 }
 
 
@@ -116,9 +125,17 @@ void SoundStream::pause()
 ////////////////////////////////////////////////////////////
 void SoundStream::stop()
 {
-    // Wait for the thread to terminate
-    m_isStreaming = false;
-    m_thread.wait();
+    {
+        Lock lock(m_mutex);
+        m_isStreaming = false;
+    }
+
+    // Once removed from the streaming thread and with no prefetch
+    // running, nobody else touches the stream
+    priv::StreamingThread::getInstance().remove(this);
+    m_prefetchTask.wait();
+
+    releaseBuffers();
 }
 
 
@@ -160,8 +177,7 @@ void SoundStream::setPlayingOffset(Time timeOffset)
 
     // Restart streaming
     m_samplesProcessed = static_cast<Uint64>(timeOffset.asSeconds() * m_sampleRate * m_channelCount);
-    m_isStreaming = true;
-    m_thread.launch();
+    startStreaming();
 }
 
 
@@ -197,169 +213,314 @@ bool SoundStream::getLoop() const
 
 
 ////////////////////////////////////////////////////////////
-void SoundStream::streamData()
+void SoundStream::setBufferCount(unsigned int bufferCount)
+{
+    m_bufferCount = bufferCount > 2 ? bufferCount : 2;
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int SoundStream::getBufferCount() const
+{
+    return m_bufferCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundStream::setBufferDuration(Time duration)
 {
-    // Create the buffers
-    alCheck(alGenBuffers(BufferCount, m_buffers));
-    for (int i = 0; i < BufferCount; ++i)
-        m_endBuffers[i] = false;
+    m_bufferDuration = duration > milliseconds(1) ? duration : milliseconds(1);
+}
 
-    // Fill the queue
-    bool requestStop = fillQueue();
 
-    // Play the sound
-    alCheck(alSourcePlay(m_source));
+////////////////////////////////////////////////////////////
+Time SoundStream::getBufferDuration() const
+{
+    return m_bufferDuration;
+}
+
+
+////////////////////////////////////////////////////////////
+SoundStream::StreamStats SoundStream::getStreamStats() const
+{
+    Lock lock(m_mutex);
+
+    StreamStats stats = m_stats;
+    if (stats.chunkCount > 0)
+        stats.meanLatency = microseconds(m_latencySum / static_cast<Int64>(stats.chunkCount));
+
+    return stats;
+}
+
 
-    while (m_isStreaming)
+////////////////////////////////////////////////////////////
+void SoundStream::resetStreamStats()
+{
+    Lock lock(m_mutex);
+
+    m_stats.underrunCount = 0;
+    m_stats.chunkCount    = 0;
+    m_stats.meanLatency   = Time::Zero;
+    m_stats.maxLatency    = Time::Zero;
+    m_latencySum = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SoundStream::getChunkSampleCount() const
+{
+    Int64 frames = m_bufferDuration.asMicroseconds() * m_sampleRate / 1000000;
+
+    return static_cast<std::size_t>(frames > 0 ? frames : 1) * m_channelCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundStream::startStreaming()
+{
     {
-        // The stream has been interrupted!
-        if (SoundSource::getStatus() == Stopped)
+        Lock lock(m_mutex);
+
+        m_chunks.resize(m_bufferCount);
+        m_firstChunk   = 0;
+        m_chunkCount   = 0;
+        m_playingCount = 0;
+        m_endOfData    = false;
+        m_prefetching  = true;
+        m_isStreaming  = true;
+    }
+
+    m_requestStop = false;
+    m_hasStarted = false;
+
+    // Start decoding right away, rather than waiting for the streaming thread
+    m_prefetchTask = TaskScheduler::getDefault().add(&SoundStream::prefetch, this);
+    priv::StreamingThread::getInstance().add(this);
+}
+
+
+////////////////////////////////////////////////////////////
+void SoundStream::prefetch()
+{
+    for (;;)
+    {
+        PrefetchedChunk* chunk = NULL;
         {
-            if (!requestStop)
-            {
-                // Just continue
-                alCheck(alSourcePlay(m_source));
-            }
-            else
+            Lock lock(m_mutex);
+
+            // Don't decode further ahead than the number of buffers
+            if (!m_isStreaming || m_endOfData || (m_chunkCount + m_playingCount >= m_chunks.size()))
             {
-                // End streaming
-                m_isStreaming = false;
+                m_prefetching = false;
+                return;
             }
+
+            // The streaming thread never touches the chunks past the ready ones
+            chunk = &m_chunks[(m_firstChunk + m_chunkCount) % m_chunks.size()];
         }
 
-        // Get the number of buffers that have been processed (ie. ready for reuse)
-        ALint nbProcessed = 0;
-        alCheck(alGetSourcei(m_source, AL_BUFFERS_PROCESSED, &nbProcessed));
+        // Acquire audio data
+        Chunk data = {NULL, 0};
+        chunk->last = !onGetData(data);
+        chunk->endOfStream = false;
+        chunk->samples.assign(data.samples, data.samples + (data.samples ? data.sampleCount : 0));
+        chunk->decodeTime = m_clock.getElapsedTime().asMicroseconds();
 
-        while (nbProcessed--)
+        if (chunk->last)
         {
-            // Pop the first unused buffer from the queue
-            ALuint buffer;
-            alCheck(alSourceUnqueueBuffers(m_source, 1, &buffer));
-
-            // Find its number
-            unsigned int bufferNum = 0;
-            for (int i = 0; i < BufferCount; ++i)
-                if (m_buffers[i] == buffer)
-                {
-                    bufferNum = i;
-                    break;
-                }
-
-            // Retrieve its size and add it to the samples count
-            if (m_endBuffers[bufferNum])
-            {
-                // This was the last buffer: reset the sample count
-                m_samplesProcessed = 0;
-                m_endBuffers[bufferNum] = false;
-            }
+            // Check if the stream must loop or stop
+            if (m_loop)
+                onSeek(Time::Zero);
             else
-            {
-                ALint size, bits;
-                alCheck(alGetBufferi(buffer, AL_SIZE, &size));
-                alCheck(alGetBufferi(buffer, AL_BITS, &bits));
-                m_samplesProcessed += size / (bits / 8);
-            }
-
-            // Fill it and push it back into the playing queue
-            if (!requestStop)
-            {
-                if (fillAndPushBuffer(bufferNum))
-                    requestStop = true;
-            }
+                chunk->endOfStream = true;
         }
 
-        // Leave some time for the other threads if the stream is still playing
-        if (SoundSource::getStatus() != Stopped)
-            sleep(milliseconds(10));
+        Lock lock(m_mutex);
+        m_endOfData = chunk->endOfStream;
+        m_chunkCount++;
     }
-
-    // Stop the playback
-    alCheck(alSourceStop(m_source));
-
-    // Unqueue any buffer left in the queue
-    clearQueue();
-
-    // Delete the buffers
-    alCheck(alSourcei(m_source, AL_BUFFER, 0));
-    alCheck(alDeleteBuffers(BufferCount, m_buffers));
 }
 
 
 ////////////////////////////////////////////////////////////
-bool SoundStream::fillAndPushBuffer(unsigned int bufferNum)
+bool SoundStream::update(Time& nextUpdate)
 {
-    bool requestStop = false;
+    // Create the buffers when the stream starts
+    if (m_buffers.empty())
+    {
+        m_buffers.resize(m_bufferCount);
+        m_bufferInfos.resize(m_bufferCount);
+        alCheck(alGenBuffers(static_cast<ALsizei>(m_buffers.size()), &m_buffers[0]));
+        for (unsigned int i = 0; i < m_buffers.size(); ++i)
+            m_freeBuffers.push_back(i);
+    }
+
+    // Recycle the buffers that have been played
+    ALint nbProcessed = 0;
+    alCheck(alGetSourcei(m_source, AL_BUFFERS_PROCESSED, &nbProcessed));
 
-    // Acquire audio data
-    Chunk data = {NULL, 0};
-    if (!onGetData(data))
+    Int64 now = m_clock.getElapsedTime().asMicroseconds();
+    while (nbProcessed-- && !m_queuedBuffers.empty())
     {
-        // Mark the buffer as the last one (so that we know when to reset the playing position)
-        m_endBuffers[bufferNum] = true;
+        ALuint buffer;
+        alCheck(alSourceUnqueueBuffers(m_source, 1, &buffer));
 
-        // Check if the stream must loop or stop
-        if (m_loop)
-        {
-            // Return to the beginning of the stream source
-            onSeek(Time::Zero);
+        unsigned int bufferNum = m_queuedBuffers.front();
+        m_queuedBuffers.pop_front();
+        m_freeBuffers.push_back(bufferNum);
 
-            // If we previously had no data, try to fill the buffer once again
-            if (!data.samples || (data.sampleCount == 0))
-            {
-                return fillAndPushBuffer(bufferNum);
-            }
+        // Retrieve its size and add it to the samples count
+        const BufferInfo& info = m_bufferInfos[bufferNum];
+        if (info.last)
+        {
+            // This was the last buffer: reset the sample count
+            m_samplesProcessed = 0;
         }
         else
         {
-            // Not looping: request stop
-            requestStop = true;
+            m_samplesProcessed += info.sampleCount;
         }
+
+        // It started playing one buffer duration ago (give or take
+        // an update interval, since the end of a buffer isn't notified)
+        Int64 duration = static_cast<Int64>(info.sampleCount) * 1000000 / m_channelCount / m_sampleRate;
+        Int64 latency = now - duration - info.decodeTime;
+        if (latency < 0)
+            latency = 0;
+
+        Lock lock(m_mutex);
+        m_playingCount--;
+        m_stats.chunkCount++;
+        m_latencySum += latency;
+        if (microseconds(latency) > m_stats.maxLatency)
+            m_stats.maxLatency = microseconds(latency);
     }
 
-    // Fill the buffer if some data was returned
-    if (data.samples && data.sampleCount)
+    // Push the prefetched chunks into the playing queue
+    while (!m_requestStop && !m_freeBuffers.empty())
     {
-        unsigned int buffer = m_buffers[bufferNum];
+        PrefetchedChunk* chunk = NULL;
+        {
+            Lock lock(m_mutex);
+            if (m_chunkCount == 0)
+                break;
+            chunk = &m_chunks[m_firstChunk];
+        }
+
+        if (!chunk->samples.empty())
+        {
+            unsigned int bufferNum = m_freeBuffers.back();
+            m_freeBuffers.pop_back();
+
+            // Fill the buffer
+            unsigned int buffer = m_buffers[bufferNum];
+            ALsizei size = static_cast<ALsizei>(chunk->samples.size()) * sizeof(Int16);
+            alCheck(alBufferData(buffer, m_format, &chunk->samples[0], size, m_sampleRate));
+
+            // Push it into the sound queue
+            alCheck(alSourceQueueBuffers(m_source, 1, &buffer));
+            m_queuedBuffers.push_back(bufferNum);
+
+            BufferInfo& info = m_bufferInfos[bufferNum];
+            info.sampleCount = chunk->samples.size();
+            info.last        = chunk->last;
+            info.decodeTime  = chunk->decodeTime;
+        }
+        else if (chunk->last && !m_queuedBuffers.empty())
+        {
+            // No data at the end: the previous buffer was the last one
+            m_bufferInfos[m_queuedBuffers.back()].last = true;
+        }
 
-        // Fill the buffer
-        ALsizei size = static_cast<ALsizei>(data.sampleCount) * sizeof(Int16);
-        alCheck(alBufferData(buffer, m_format, data.samples, size, m_sampleRate));
+        if (chunk->endOfStream)
+            m_requestStop = true;
 
-        // Push it into the sound queue
-        alCheck(alSourceQueueBuffers(m_source, 1, &buffer));
+        Lock lock(m_mutex);
+        m_firstChunk = (m_firstChunk + 1) % m_chunks.size();
+        m_chunkCount--;
+        if (!chunk->samples.empty())
+            m_playingCount++;
     }
 
-    return requestStop;
-}
+    // Decode the next chunks while the queued ones are playing
+    bool startPrefetch = false;
+    {
+        Lock lock(m_mutex);
+        if (!m_prefetching && !m_endOfData && (m_chunkCount + m_playingCount < m_chunks.size()))
+        {
+            m_prefetching  = true;
+            startPrefetch = true;
+        }
+    }
+    if (startPrefetch)
+        m_prefetchTask = TaskScheduler::getDefault().add(&SoundStream::prefetch, this);
 
+    // The source stops by itself when it runs out of buffers
+    if (SoundSource::getStatus() == Stopped)
+    {
+        if (!m_queuedBuffers.empty())
+        {
+            // The queue ran dry before new data was available
+            if (m_hasStarted)
+            {
+                Lock lock(m_mutex);
+                m_stats.underrunCount++;
+            }
 
-////////////////////////////////////////////////////////////
-bool SoundStream::fillQueue()
-{
-    // Fill and enqueue all the available buffers
-    bool requestStop = false;
-    for (int i = 0; (i < BufferCount) && !requestStop; ++i)
+            alCheck(alSourcePlay(m_source));
+            m_hasStarted = true;
+        }
+        else if (m_requestStop)
+        {
+            // Everything was played: end streaming
+            releaseBuffers();
+            Lock lock(m_mutex);
+            m_isStreaming = false;
+            return false;
+        }
+    }
+
+    // Come back when the buffer being played is over
+    if (!m_queuedBuffers.empty() && (SoundSource::getStatus() == Playing))
     {
-        if (fillAndPushBuffer(i))
-            requestStop = true;
+        ALint offset = 0;
+        alCheck(alGetSourcei(m_source, AL_SAMPLE_OFFSET, &offset));
+
+        Int64 frames = static_cast<Int64>(m_bufferInfos[m_queuedBuffers.front()].sampleCount / m_channelCount) - offset;
+        if (frames > 0)
+            nextUpdate = microseconds(frames * 1000000 / m_sampleRate);
+        else
+            nextUpdate = Time::Zero;
     }
 
-    return requestStop;
+    return true;
 }
 
 
 ////////////////////////////////////////////////////////////
-void SoundStream::clearQueue()
+void SoundStream::releaseBuffers()
 {
-    // Get the number of buffers still in the queue
+    // Stop the playback
+    alCheck(alSourceStop(m_source));
+
+    if (m_buffers.empty())
+        return;
+
+    // Unqueue any buffer left in the queue
     ALint nbQueued;
     alCheck(alGetSourcei(m_source, AL_BUFFERS_QUEUED, &nbQueued));
 
-    // Unqueue them all
     ALuint buffer;
     for (ALint i = 0; i < nbQueued; ++i)
         alCheck(alSourceUnqueueBuffers(m_source, 1, &buffer));
+
+    // Delete the buffers
+    alCheck(alSourcei(m_source, AL_BUFFER, 0));
+    alCheck(alDeleteBuffers(static_cast<ALsizei>(m_buffers.size()), &m_buffers[0]));
+
+    m_buffers.clear();
+    m_freeBuffers.clear();
+    m_queuedBuffers.clear();
 }
 
 } // namespace sf
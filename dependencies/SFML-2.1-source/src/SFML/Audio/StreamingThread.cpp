@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Audio/StreamingThread.hpp>
+#include <SFML/Audio/SoundStream.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <algorithm>
+
+#ifdef _MSC_VER
+    #pragma warning(disable : 4355) // 'this' used in base member initializer list
+#endif
+
+
+namespace
+{
+    // OpenAL doesn't notify when a buffer has been played, so the
+    // thread sleeps until the earliest one is expected to be done.
+    // The upper bound makes sure that new streams and freshly
+    // prefetched chunks are picked up quickly
+    const sf::Time minUpdateInterval = sf::milliseconds(1);
+    const sf::Time maxUpdateInterval = sf::milliseconds(10);
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+StreamingThread& StreamingThread::getInstance()
+{
+    // Never destroyed, streams may still be stopped by static destructors
+    static StreamingThread* instance = new StreamingThread;
+    return *instance;
+}
+
+
+////////////////////////////////////////////////////////////
+StreamingThread::StreamingThread() :
+m_thread   (&StreamingThread::run, this),
+m_mutex    (Mutex::NonRecursive),
+m_streams  (),
+m_isRunning(false)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingThread::add(SoundStream* stream)
+{
+    {
+        Lock lock(m_mutex);
+
+        if (std::find(m_streams.begin(), m_streams.end(), stream) == m_streams.end())
+            m_streams.push_back(stream);
+
+        if (m_isRunning)
+            return;
+        m_isRunning = true;
+    }
+
+    // Launching waits for the previous run of the thread, which
+    // has already left its loop since it was marked as not running
+    m_thread.launch();
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingThread::remove(SoundStream* stream)
+{
+    // The whole update loop holds the mutex, so once it is ours
+    // the stream can't be in the middle of an update
+    Lock lock(m_mutex);
+
+    std::vector<SoundStream*>::iterator it = std::find(m_streams.begin(), m_streams.end(), stream);
+    if (it != m_streams.end())
+        m_streams.erase(it);
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingThread::run()
+{
+    for (;;)
+    {
+        Time interval = maxUpdateInterval;
+
+        {
+            Lock lock(m_mutex);
+
+            // Exit when there's nothing left to play, the thread is
+            // launched again by the next stream
+            if (m_streams.empty())
+            {
+                m_isRunning = false;
+                return;
+            }
+
+            for (std::size_t i = 0; i < m_streams.size();)
+            {
+                Time nextUpdate = maxUpdateInterval;
+                if (m_streams[i]->update(nextUpdate))
+                {
+                    interval = std::min(interval, nextUpdate);
+                    ++i;
+                }
+                else
+                {
+                    // The stream has reached its end
+                    m_streams.erase(m_streams.begin() + i);
+                }
+            }
+        }
+
+        sleep(std::max(interval, minUpdateInterval));
+    }
+}
+
+} // namespace priv
+
+} // namespace sf
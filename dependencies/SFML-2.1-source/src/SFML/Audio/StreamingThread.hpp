@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_STREAMINGTHREAD_HPP
+#define SFML_STREAMINGTHREAD_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
+#include <vector>
+
+
+namespace sf
+{
+class SoundStream;
+
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Thread keeping the playing queues of all the streams filled
+///
+////////////////////////////////////////////////////////////
+class StreamingThread : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the unique instance of the class
+    ///
+    /// \return Reference to the streaming thread
+    ///
+    ////////////////////////////////////////////////////////////
+    static StreamingThread& getInstance();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start updating a stream
+    ///
+    /// The thread is launched if it was not running.
+    ///
+    /// \param stream Stream to update
+    ///
+    ////////////////////////////////////////////////////////////
+    void add(SoundStream* stream);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop updating a stream
+    ///
+    /// When this function returns, the stream is guaranteed not
+    /// to be updated anymore.
+    ///
+    /// \param stream Stream to remove
+    ///
+    ////////////////////////////////////////////////////////////
+    void remove(SoundStream* stream);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    StreamingThread();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the streams until none is left
+    ///
+    ////////////////////////////////////////////////////////////
+    void run();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Thread                    m_thread;    ///< Thread updating the streams
+    Mutex                     m_mutex;     ///< Protects the list of streams
+    std::vector<SoundStream*> m_streams;   ///< Streams being played
+    bool                      m_isRunning; ///< Is the thread running?
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_STREAMINGTHREAD_HPP
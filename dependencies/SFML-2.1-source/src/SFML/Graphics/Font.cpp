@@ -27,19 +27,35 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/Graphics/TextLayoutCache.hpp>
 #include <SFML/System/InputStream.hpp>
 #include <SFML/System/Err.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 #include FT_OUTLINE_H
 #include FT_BITMAP_H
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 
 
 namespace
 {
+    // Thread-safe unique identifier generator,
+    // is used by the caches built from the glyphs (see getCacheId)
+    sf::Uint64 getUniqueId()
+    {
+        static sf::Uint64 id = 1; // start at 1, zero is "no font"
+        static sf::Mutex mutex(sf::Mutex::NonRecursive);
+
+        sf::Lock lock(mutex);
+        return id++;
+    }
+
     // FreeType callbacks that operate on a sf::InputStream
     unsigned long read(FT_Stream rec, unsigned long offset, unsigned char* buffer, unsigned long count)
     {
@@ -57,6 +73,125 @@ namespace
     void close(FT_Stream)
     {
     }
+
+    // Mix the bits of a cache key, so that consecutive code points spread over the table
+    std::size_t hashKey(sf::Uint64 key)
+    {
+        sf::Uint32 hash = static_cast<sf::Uint32>(key) ^ (static_cast<sf::Uint32>(key >> 32) * 0x85EBCA6Bu);
+        hash ^= hash >> 16;
+        hash *= 0x7FEB352Du;
+        hash ^= hash >> 15;
+        return hash;
+    }
+
+    // Scale a glyph metric from the distance field size to a character size
+    int scaleMetric(int value, float scale)
+    {
+        return static_cast<int>(std::floor(value * scale + 0.5f));
+    }
+
+    // Squared distance transform of a sampled function, in linear time
+    // (Felzenszwalb and Huttenlocher, "Distance Transforms of Sampled Functions")
+    const float infinity = 1e20f;
+    void distanceTransform(float* grid, std::size_t offset, std::size_t stride, std::size_t length,
+                           std::vector<float>& f, std::vector<float>& z, std::vector<int>& v)
+    {
+        for (std::size_t q = 0; q < length; ++q)
+            f[q] = grid[offset + q * stride];
+
+        // Compute the lower envelope of the parabolas rooted at each sample
+        int k = 0;
+        v[0] = 0;
+        z[0] = -infinity;
+        z[1] = infinity;
+        for (std::size_t q = 1; q < length; ++q)
+        {
+            float fq = f[q] + static_cast<float>(q * q);
+            float s;
+            for (;;)
+            {
+                int r = v[k];
+                s = (fq - f[r] - static_cast<float>(r * r)) / (2.f * (static_cast<float>(q) - r));
+                if ((s > z[k]) || (k == 0))
+                    break;
+                --k;
+            }
+
+            ++k;
+            v[k] = static_cast<int>(q);
+            z[k] = s;
+            z[k + 1] = infinity;
+        }
+
+        // Sample the envelope
+        k = 0;
+        for (std::size_t q = 0; q < length; ++q)
+        {
+            while (z[k + 1] < q)
+                ++k;
+
+            float distance = static_cast<float>(q) - v[k];
+            grid[offset + q * stride] = distance * distance + f[v[k]];
+        }
+    }
+
+    // Replace the alpha channel of RGBA pixels holding the coverage of a glyph
+    // by the signed distance to its outline: 0.5 on the outline, 1 at radius
+    // pixels inside the glyph and 0 at radius pixels outside
+    void computeDistanceField(sf::Uint8* pixels, unsigned int width, unsigned int height, unsigned int radius)
+    {
+        std::size_t count = width * height;
+        std::vector<float> outside(count);
+        std::vector<float> inside(count);
+
+        // Seed the distances from the coverage, so that partially
+        // covered pixels place the outline with sub-pixel accuracy
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            float coverage = pixels[i * 4 + 3] / 255.f;
+            if (coverage >= 1.f)
+            {
+                outside[i] = 0.f;
+                inside[i] = infinity;
+            }
+            else if (coverage <= 0.f)
+            {
+                outside[i] = infinity;
+                inside[i] = 0.f;
+            }
+            else
+            {
+                float toOutside = std::max(0.f, 0.5f - coverage);
+                float toInside  = std::max(0.f, coverage - 0.5f);
+                outside[i] = toOutside * toOutside;
+                inside[i]  = toInside * toInside;
+            }
+        }
+
+        // 2D transform: columns, then rows
+        std::size_t length = std::max(width, height);
+        std::vector<float> f(length);
+        std::vector<float> z(length + 1);
+        std::vector<int> v(length);
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            distanceTransform(&outside[0], x, width, height, f, z, v);
+            distanceTransform(&inside[0], x, width, height, f, z, v);
+        }
+        for (unsigned int y = 0; y < height; ++y)
+        {
+            distanceTransform(&outside[0], y * width, 1, width, f, z, v);
+            distanceTransform(&inside[0], y * width, 1, width, f, z, v);
+        }
+
+        // Positive distances are outside the glyph
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            float distance = std::sqrt(outside[i]) - std::sqrt(inside[i]);
+            float value = 0.5f - distance / (2.f * radius);
+            pixels[i * 4 + 3] = static_cast<sf::Uint8>(std::min(std::max(value, 0.f), 1.f) * 255.f + 0.5f);
+        }
+    }
 }
 
 
@@ -64,10 +199,18 @@ namespace sf
 {
 ////////////////////////////////////////////////////////////
 Font::Font() :
-m_library  (NULL),
-m_face     (NULL),
-m_streamRec(NULL),
-m_refCount (NULL)
+m_library    (NULL),
+m_face       (NULL),
+m_streamRec  (NULL),
+m_refCount   (NULL),
+m_pages      (),
+m_pixelBuffer(),
+m_lastPage   (NULL),
+m_fieldPage  (),
+m_fieldSize  (0),
+m_lastSize   (0),
+m_stats      (),
+m_cacheId    (0)
 {
 
 }
@@ -80,7 +223,13 @@ m_face       (copy.m_face),
 m_streamRec  (copy.m_streamRec),
 m_refCount   (copy.m_refCount),
 m_pages      (copy.m_pages),
-m_pixelBuffer(copy.m_pixelBuffer)
+m_pixelBuffer(copy.m_pixelBuffer),
+m_lastPage   (NULL),
+m_fieldPage  (copy.m_fieldPage),
+m_fieldSize  (copy.m_fieldSize),
+m_lastSize   (0),
+m_stats      (copy.m_stats),
+m_cacheId    (copy.m_cacheId)
 {
     // Note: as FreeType doesn't provide functions for copying/cloning,
     // we must share all the FreeType pointers
@@ -132,6 +281,7 @@ bool Font::loadFromFile(const std::string& filename)
 
     // Store the loaded font in our ugly void* :)
     m_face = face;
+    m_cacheId = getUniqueId();
 
     return true;
 }
@@ -172,6 +322,7 @@ bool Font::loadFromMemory(const void* data, std::size_t sizeInBytes)
 
     // Store the loaded font in our ugly void* :)
     m_face = face;
+    m_cacheId = getUniqueId();
 
     return true;
 }
@@ -231,6 +382,7 @@ bool Font::loadFromStream(InputStream& stream)
 
     // Store the loaded font in our ugly void* :)
     m_face = face;
+    m_cacheId = getUniqueId();
     m_streamRec = rec;
 
     return true;
@@ -240,25 +392,48 @@ bool Font::loadFromStream(InputStream& stream)
 ////////////////////////////////////////////////////////////
 const Glyph& Font::getGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) const
 {
-    // Get the page corresponding to the character size
-    GlyphTable& glyphs = m_pages[characterSize].glyphs;
+    return findGlyph(codePoint, characterSize, bold, true);
+}
 
-    // Build the key by combining the code point and the bold flag
-    Uint32 key = ((bold ? 1 : 0) << 31) | codePoint;
 
-    // Search the glyph into the cache
-    GlyphTable::const_iterator it = glyphs.find(key);
-    if (it != glyphs.end())
+////////////////////////////////////////////////////////////
+void Font::preloadGlyphs(Uint32 first, Uint32 last, unsigned int characterSize, bool bold) const
+{
+    FT_Face face = static_cast<FT_Face>(m_face);
+    if (!face || (first > last))
+        return;
+
+    for (Uint32 codePoint = first; ; ++codePoint)
     {
-        // Found: just return it
-        return it->second;
+        // Skip the characters that are missing from the font
+        if (FT_Get_Char_Index(face, codePoint) != 0)
+            findGlyph(codePoint, characterSize, bold, false);
+
+        if (codePoint == last)
+            break;
     }
-    else
+
+    // Flush once for the whole range
+    glCheck(glFlush());
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::preloadGlyphs(const String& characters, unsigned int characterSize, bool bold) const
+{
+    FT_Face face = static_cast<FT_Face>(m_face);
+    if (!face || characters.isEmpty())
+        return;
+
+    for (String::ConstIterator it = characters.begin(); it != characters.end(); ++it)
     {
-        // Not found: we have to load it
-        Glyph glyph = loadGlyph(codePoint, characterSize, bold);
-        return glyphs.insert(std::make_pair(key, glyph)).first->second;
+        // Skip the characters that are missing from the font
+        if (FT_Get_Char_Index(face, *it) != 0)
+            findGlyph(*it, characterSize, bold, false);
     }
+
+    // Flush once for the whole string
+    glCheck(glFlush());
 }
 
 
@@ -271,18 +446,35 @@ int Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize) co
 
     FT_Face face = static_cast<FT_Face>(m_face);
 
-    if (face && FT_HAS_KERNING(face) && setCurrentSize(characterSize))
+    if (face && FT_HAS_KERNING(face))
     {
+        // Search the pair into the cache
+        Page& page = getPage(characterSize);
+        Uint64 key = (static_cast<Uint64>(first) << 32) | second;
+        int kerning;
+        if (page.kernings.find(key, kerning))
+        {
+            m_stats.kerningHits++;
+            return kerning;
+        }
+
+        m_stats.kerningMisses++;
+        if (!setCurrentSize(characterSize))
+            return 0;
+
         // Convert the characters to indices
         FT_UInt index1 = FT_Get_Char_Index(face, first);
         FT_UInt index2 = FT_Get_Char_Index(face, second);
 
         // Get the kerning vector
-        FT_Vector kerning;
-        FT_Get_Kerning(face, index1, index2, FT_KERNING_DEFAULT, &kerning);
+        FT_Vector vector;
+        FT_Get_Kerning(face, index1, index2, FT_KERNING_DEFAULT, &vector);
+
+        // Store the X advance
+        kerning = vector.x >> 6;
+        page.kernings.insert(key, kerning);
 
-        // Return the X advance
-        return kerning.x >> 6;
+        return kerning;
     }
     else
     {
@@ -296,22 +488,79 @@ int Font::getKerning(Uint32 first, Uint32 second, unsigned int characterSize) co
 int Font::getLineSpacing(unsigned int characterSize) const
 {
     FT_Face face = static_cast<FT_Face>(m_face);
+    if (!face)
+        return 0;
 
-    if (face && setCurrentSize(characterSize))
+    // Changing the current size is expensive, so the value is cached
+    Page& page = getPage(characterSize);
+    if (page.lineSpacing < 0)
     {
-        return (face->size->metrics.height >> 6);
+        if (!setCurrentSize(characterSize))
+            return 0;
+
+        page.lineSpacing = static_cast<int>(face->size->metrics.height >> 6);
     }
-    else
+
+    return page.lineSpacing;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture& Font::getTexture(unsigned int characterSize) const
+{
+    Page& page = m_fieldSize ? m_fieldPage : getPage(characterSize);
+    initializePage(page);
+
+    return page.texture;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::setDistanceField(bool enabled, unsigned int referenceSize)
+{
+    unsigned int fieldSize = enabled ? referenceSize : 0;
+    if (fieldSize != m_fieldSize)
     {
-        return 0;
+        m_fieldSize = fieldSize;
+
+        // The loaded glyphs are of the wrong kind now
+        m_pages.clear();
+        m_fieldPage = Page();
+        m_lastPage = NULL;
+        priv::TextLayoutCache::removeFont(*this);
+
+        // Tell the external glyph caches too
+        if (m_face)
+            m_cacheId = getUniqueId();
     }
 }
 
 
 ////////////////////////////////////////////////////////////
-const Texture& Font::getTexture(unsigned int characterSize) const
+bool Font::isDistanceField() const
 {
-    return m_pages[characterSize].texture;
+    return m_fieldSize != 0;
+}
+
+
+////////////////////////////////////////////////////////////
+const Font::CacheStats& Font::getCacheStats() const
+{
+    return m_stats;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::resetCacheStats()
+{
+    m_stats = CacheStats();
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 Font::getCacheId() const
+{
+    return m_cacheId;
 }
 
 
@@ -325,6 +574,16 @@ Font& Font::operator =(const Font& right)
     std::swap(m_pages,       temp.m_pages);
     std::swap(m_pixelBuffer, temp.m_pixelBuffer);
     std::swap(m_refCount,    temp.m_refCount);
+    std::swap(m_fieldPage,   temp.m_fieldPage);
+    std::swap(m_fieldSize,   temp.m_fieldSize);
+    std::swap(m_stats,       temp.m_stats);
+    std::swap(m_cacheId,     temp.m_cacheId);
+
+    // The page table changed, forget the last page
+    m_lastPage = NULL;
+
+    // The texts laid out with the previous glyphs are obsolete
+    priv::TextLayoutCache::removeFont(*this);
 
     return *this;
 }
@@ -366,6 +625,113 @@ void Font::cleanup()
     m_refCount  = NULL;
     m_pages.clear();
     m_pixelBuffer.clear();
+    m_lastPage = NULL;
+    m_fieldPage = Page();
+    m_stats = CacheStats();
+    m_cacheId = 0;
+
+    // Forget the texts laid out with this font
+    priv::TextLayoutCache::removeFont(*this);
+}
+
+
+////////////////////////////////////////////////////////////
+Font::Page& Font::getPage(unsigned int characterSize) const
+{
+    // Text is usually laid out with the same size for many glyphs in a row
+    if (!m_lastPage || (m_lastSize != characterSize))
+    {
+        // Pages are never removed from the table, so the pointer stays valid
+        m_lastPage = &m_pages[characterSize];
+        m_lastSize = characterSize;
+    }
+
+    return *m_lastPage;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::initializePage(Page& page) const
+{
+    if (!page.skyline.empty())
+        return;
+
+    // Make sure that the texture is initialized by default
+    sf::Image image;
+    image.create(128, 128, Color(255, 255, 255, 0));
+
+    // Reserve a 2x2 white square for texturing underlines
+    for (int x = 0; x < 2; ++x)
+        for (int y = 0; y < 2; ++y)
+            image.setPixel(x, y, Color(255, 255, 255, 255));
+
+    // Create the texture
+    page.texture.loadFromImage(image);
+    page.texture.setSmooth(true);
+
+    // Leave the white square and a 1 pixel margin out of the free space
+    page.skyline.push_back(Segment(0, 3, 3));
+    page.skyline.push_back(Segment(3, 0, image.getSize().x - 3));
+}
+
+
+////////////////////////////////////////////////////////////
+const Glyph& Font::findGlyph(Uint32 codePoint, unsigned int characterSize, bool bold, bool flush) const
+{
+    // Get the page corresponding to the character size
+    Page& page = getPage(characterSize);
+
+    // Build the key by combining the code point and the bold flag
+    Uint32 key = ((bold ? 1 : 0) << 31) | codePoint;
+
+    // Search the glyph into the cache
+    int index;
+    if (page.glyphIndices.find(key, index))
+    {
+        // Found: just return it
+        m_stats.glyphHits++;
+        return page.glyphs[index];
+    }
+
+    // Not found: we have to load it
+    m_stats.glyphMisses++;
+    Glyph glyph;
+    bool loaded = false;
+    if (m_fieldSize)
+    {
+        // Get the distance field glyph, which is loaded once for all the sizes
+        if (!m_fieldPage.glyphIndices.find(key, index))
+        {
+            index = static_cast<int>(m_fieldPage.glyphs.size());
+            m_fieldPage.glyphIndices.insert(key, index);
+            m_fieldPage.glyphs.push_back(loadGlyph(codePoint, m_fieldSize, bold));
+            loaded = true;
+        }
+
+        // Scale its metrics to the requested size, the texture rectangle is shared
+        const Glyph& field = m_fieldPage.glyphs[index];
+        float scale = static_cast<float>(characterSize) / m_fieldSize;
+        glyph.advance       = scaleMetric(field.advance, scale);
+        glyph.bounds.left   = scaleMetric(field.bounds.left, scale);
+        glyph.bounds.top    = scaleMetric(field.bounds.top, scale);
+        glyph.bounds.width  = scaleMetric(field.bounds.width, scale);
+        glyph.bounds.height = scaleMetric(field.bounds.height, scale);
+        glyph.textureRect   = field.textureRect;
+    }
+    else
+    {
+        glyph = loadGlyph(codePoint, characterSize, bold);
+        loaded = true;
+    }
+
+    // Force an OpenGL flush, so that the font's texture will appear updated
+    // in all contexts immediately (solves problems in multi-threaded apps)
+    if (loaded && flush)
+        glCheck(glFlush());
+
+    page.glyphIndices.insert(key, static_cast<int>(page.glyphs.size()));
+    page.glyphs.push_back(glyph);
+    return page.glyphs.back();
 }
 
 
@@ -384,8 +750,9 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
     if (!setCurrentSize(characterSize))
         return glyph;
 
-    // Load the glyph corresponding to the code point
-    if (FT_Load_Char(face, codePoint, FT_LOAD_TARGET_NORMAL) != 0)
+    // Load the glyph corresponding to the code point (hinting is meaningless
+    // for distance fields, which are scaled to other sizes)
+    if (FT_Load_Char(face, codePoint, m_fieldSize ? FT_LOAD_NO_HINTING : FT_LOAD_TARGET_NORMAL) != 0)
         return glyph;
 
     // Retrieve the glyph
@@ -423,11 +790,12 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
     if ((width > 0) && (height > 0))
     {
         // Leave a small padding around characters, so that filtering doesn't
-        // pollute them with pixels from neighbours
-        const unsigned int padding = 1;
+        // pollute them with pixels from neighbours; distance fields need
+        // enough room around the outline to fade out
+        const unsigned int padding = m_fieldSize ? std::max(2u, m_fieldSize / 8) : 1;
 
         // Get the glyphs page corresponding to the character size
-        Page& page = m_pages[characterSize];
+        Page& page = m_fieldSize ? m_fieldPage : getPage(characterSize);
 
         // Find a good position for the new glyph into the texture
         glyph.textureRect = findGlyphRect(page, width + 2 * padding, height + 2 * padding);
@@ -438,8 +806,21 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
         glyph.bounds.width  = width + 2 * padding;
         glyph.bounds.height = height + 2 * padding;
 
+        // The texture is not cleared when it grows, so the padding
+        // must be written along with the glyph: start with white
+        // transparent pixels, then fill the alpha of the glyph's area
+        unsigned int bufferWidth  = glyph.textureRect.width;
+        unsigned int bufferHeight = glyph.textureRect.height;
+        m_pixelBuffer.resize(bufferWidth * bufferHeight * 4);
+        for (std::size_t i = 0; i < m_pixelBuffer.size(); i += 4)
+        {
+            m_pixelBuffer[i + 0] = 255;
+            m_pixelBuffer[i + 1] = 255;
+            m_pixelBuffer[i + 2] = 255;
+            m_pixelBuffer[i + 3] = 0;
+        }
+
         // Extract the glyph's pixels from the bitmap
-        m_pixelBuffer.resize(width * height * 4, 255);
         const Uint8* pixels = bitmap.buffer;
         if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
         {
@@ -449,7 +830,7 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
                 for (int x = 0; x < width; ++x)
                 {
                     // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
+                    std::size_t index = ((x + padding) + (y + padding) * bufferWidth) * 4 + 3;
                     m_pixelBuffer[index] = ((pixels[x / 8]) & (1 << (7 - (x % 8)))) ? 255 : 0;
                 }
                 pixels += bitmap.pitch;
@@ -463,28 +844,26 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
                 for (int x = 0; x < width; ++x)
                 {
                     // The color channels remain white, just fill the alpha channel
-                    std::size_t index = (x + y * width) * 4 + 3;
+                    std::size_t index = ((x + padding) + (y + padding) * bufferWidth) * 4 + 3;
                     m_pixelBuffer[index] = pixels[x];
                 }
                 pixels += bitmap.pitch;
             }
         }
 
+        // Convert the coverage to distances
+        if (m_fieldSize)
+            computeDistanceField(&m_pixelBuffer[0], bufferWidth, bufferHeight, padding);
+
         // Write the pixels to the texture
-        unsigned int x = glyph.textureRect.left + padding;
-        unsigned int y = glyph.textureRect.top + padding;
-        unsigned int w = glyph.textureRect.width - 2 * padding;
-        unsigned int h = glyph.textureRect.height - 2 * padding;
-        page.texture.update(&m_pixelBuffer[0], w, h, x, y);
+        unsigned int x = glyph.textureRect.left;
+        unsigned int y = glyph.textureRect.top;
+        page.texture.update(&m_pixelBuffer[0], bufferWidth, bufferHeight, x, y);
     }
 
     // Delete the FT glyph
     FT_Done_Glyph(glyphDesc);
 
-    // Force an OpenGL flush, so that the font's texture will appear updated
-    // in all contexts immediately (solves problems in multi-threaded apps)
-    glCheck(glFlush());
-
     // Done :)
     return glyph;
 }
@@ -493,68 +872,122 @@ Glyph Font::loadGlyph(Uint32 codePoint, unsigned int characterSize, bool bold) c
 ////////////////////////////////////////////////////////////
 IntRect Font::findGlyphRect(Page& page, unsigned int width, unsigned int height) const
 {
-    // Find the line that fits well the glyph
-    Row* row = NULL;
-    float bestRatio = 0;
-    for (std::vector<Row>::iterator it = page.rows.begin(); it != page.rows.end() && !row; ++it)
+    initializePage(page);
+
+    for (;;)
     {
-        float ratio = static_cast<float>(height) / it->height;
+        unsigned int textureWidth  = page.texture.getSize().x;
+        unsigned int textureHeight = page.texture.getSize().y;
+
+        // Find the position where the bottom of the glyph is the highest in the
+        // texture (bottom-left heuristic); in case of equality, prefer the narrowest
+        // segment so that wide segments remain available for wide glyphs
+        std::size_t bestIndex = page.skyline.size();
+        unsigned int bestTop = 0;
+        unsigned int bestBottom = textureHeight + 1;
+        unsigned int bestWidth = 0;
+        for (std::size_t i = 0; i < page.skyline.size(); ++i)
+        {
+            // Segments are sorted from left to right, the next ones won't fit either
+            if (page.skyline[i].left + width > textureWidth)
+                break;
+
+            // The glyph rests on the highest segment that it covers
+            unsigned int top = 0;
+            unsigned int covered = 0;
+            for (std::size_t j = i; covered < width; ++j)
+            {
+                top = std::max(top, page.skyline[j].top);
+                covered += page.skyline[j].width;
+            }
 
-        // Ignore rows that are either too small or too high
-        if ((ratio < 0.7f) || (ratio > 1.f))
-            continue;
+            if (top + height > textureHeight)
+                continue;
 
-        // Check if there's enough horizontal space left in the row
-        if (width > page.texture.getSize().x - it->width)
-            continue;
+            if ((top + height < bestBottom) || ((top + height == bestBottom) && (page.skyline[i].width < bestWidth)))
+            {
+                bestIndex  = i;
+                bestTop    = top;
+                bestBottom = top + height;
+                bestWidth  = page.skyline[i].width;
+            }
+        }
 
-        // Make sure that this new row is the best found so far
-        if (ratio < bestRatio)
-            continue;
+        if (bestIndex < page.skyline.size())
+        {
+            unsigned int left = page.skyline[bestIndex].left;
 
-        // The current row passed all the tests: we can select it
-        row = &*it;
-        bestRatio = ratio;
-    }
+            // Insert the top of the glyph into the skyline
+            page.skyline.insert(page.skyline.begin() + bestIndex, Segment(left, bestBottom, width));
 
-    // If we didn't find a matching row, create a new one (10% taller than the glyph)
-    if (!row)
-    {
-        int rowHeight = height + height / 10;
-        while (page.nextRow + rowHeight >= page.texture.getSize().y)
-        {
-            // Not enough space: resize the texture if possible
-            unsigned int textureWidth  = page.texture.getSize().x;
-            unsigned int textureHeight = page.texture.getSize().y;
-            if ((textureWidth * 2 <= Texture::getMaximumSize()) && (textureHeight * 2 <= Texture::getMaximumSize()))
+            // Shorten or remove the segments that are now hidden by the glyph
+            std::size_t next = bestIndex + 1;
+            while (next < page.skyline.size())
             {
-                // Make the texture 2 times bigger
-                Image newImage;
-                newImage.create(textureWidth * 2, textureHeight * 2, Color(255, 255, 255, 0));
-                newImage.copy(page.texture.copyToImage(), 0, 0);
-                page.texture.loadFromImage(newImage);
+                Segment& segment = page.skyline[next];
+                if (segment.left >= left + width)
+                    break;
+
+                unsigned int hidden = left + width - segment.left;
+                if (hidden < segment.width)
+                {
+                    segment.left  += hidden;
+                    segment.width -= hidden;
+                    break;
+                }
+
+                page.skyline.erase(page.skyline.begin() + next);
             }
-            else
+
+            // Merge the neighbour segments that have the same height
+            for (std::size_t i = 0; i + 1 < page.skyline.size(); )
             {
-                // Oops, we've reached the maximum texture size...
-                err() << "Failed to add a new character to the font: the maximum texture size has been reached" << std::endl;
-                return IntRect(0, 0, 2, 2);
+                if (page.skyline[i].top == page.skyline[i + 1].top)
+                {
+                    page.skyline[i].width += page.skyline[i + 1].width;
+                    page.skyline.erase(page.skyline.begin() + i + 1);
+                }
+                else
+                {
+                    ++i;
+                }
             }
+
+            return IntRect(left, bestTop, width, height);
         }
 
-        // We can now create the new row
-        page.rows.push_back(Row(page.nextRow, rowHeight));
-        page.nextRow += rowHeight;
-        row = &page.rows.back();
+        // Not enough space: resize the texture if possible
+        if (!growPage(page))
+        {
+            // Oops, we've reached the maximum texture size...
+            err() << "Failed to add a new character to the font: the maximum texture size has been reached" << std::endl;
+            return IntRect(0, 0, 2, 2);
+        }
     }
+}
 
-    // Find the glyph's rectangle on the selected row
-    IntRect rect(row->width, row->top, width, height);
 
-    // Update the row informations
-    row->width += width;
+////////////////////////////////////////////////////////////
+bool Font::growPage(Page& page) const
+{
+    unsigned int textureWidth  = page.texture.getSize().x;
+    unsigned int textureHeight = page.texture.getSize().y;
+    if ((textureWidth * 2 > Texture::getMaximumSize()) || (textureHeight * 2 > Texture::getMaximumSize()))
+        return false;
 
-    return rect;
+    // Make the texture 2 times bigger, and copy the existing glyphs
+    // without reading them back from the graphics card
+    Texture newTexture;
+    if (!newTexture.create(textureWidth * 2, textureHeight * 2))
+        return false;
+    newTexture.setSmooth(page.texture.isSmooth());
+    newTexture.update(page.texture);
+    page.texture.swap(newTexture);
+
+    // The new columns on the right are free from top to bottom
+    page.skyline.push_back(Segment(textureWidth, 0, textureWidth));
+
+    return true;
 }
 
 
@@ -580,20 +1013,80 @@ bool Font::setCurrentSize(unsigned int characterSize) const
 
 ////////////////////////////////////////////////////////////
 Font::Page::Page() :
-nextRow(3)
+lineSpacing(-1)
 {
-    // Make sure that the texture is initialized by default
-    sf::Image image;
-    image.create(128, 128, Color(255, 255, 255, 0));
+    // The texture is created on demand, see Font::initializePage
+}
 
-    // Reserve a 2x2 white square for texturing underlines
-    for (int x = 0; x < 2; ++x)
-        for (int y = 0; y < 2; ++y)
-            image.setPixel(x, y, Color(255, 255, 255, 255));
 
-    // Create the texture
-    texture.loadFromImage(image);
-    texture.setSmooth(true);
+
+////////////////////////////////////////////////////////////
+Font::CacheStats::CacheStats() :
+glyphHits    (0),
+glyphMisses  (0),
+kerningHits  (0),
+kerningMisses(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+Font::HashTable::HashTable() :
+m_slots(),
+m_count(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+bool Font::HashTable::find(Uint64 key, int& value) const
+{
+    if (m_slots.empty())
+        return false;
+
+    // Linear probing, the table is never more than half full
+    std::size_t mask = m_slots.size() - 1;
+    for (std::size_t i = hashKey(key) & mask; m_slots[i].used; i = (i + 1) & mask)
+    {
+        if (m_slots[i].key == key)
+        {
+            value = m_slots[i].value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+void Font::HashTable::insert(Uint64 key, int value)
+{
+    // Grow the table when it becomes half full, to keep probe sequences short
+    if ((m_count + 1) * 2 > m_slots.size())
+    {
+        std::vector<Slot> slots(m_slots.empty() ? 64 : m_slots.size() * 2);
+        for (std::size_t i = 0; i < slots.size(); ++i)
+            slots[i].used = false;
+
+        m_slots.swap(slots);
+        m_count = 0;
+        for (std::vector<Slot>::const_iterator it = slots.begin(); it != slots.end(); ++it)
+        {
+            if (it->used)
+                insert(it->key, it->value);
+        }
+    }
+
+    std::size_t mask = m_slots.size() - 1;
+    std::size_t i = hashKey(key) & mask;
+    while (m_slots[i].used)
+        i = (i + 1) & mask;
+
+    m_slots[i].key   = key;
+    m_slots[i].value = value;
+    m_slots[i].used  = true;
+    m_count++;
 }
 
 } // namespace sf
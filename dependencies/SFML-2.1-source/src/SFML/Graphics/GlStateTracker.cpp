@@ -0,0 +1,346 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/GlStateTracker.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <cstring>
+
+
+namespace
+{
+    // Index of a matrix stack in the tracker's arrays, -1 if it is not tracked
+    int getMatrixIndex(GLenum mode)
+    {
+        switch (mode)
+        {
+            case GL_MODELVIEW :  return 0;
+            case GL_PROJECTION : return 1;
+            case GL_TEXTURE :    return 2;
+            default :            return -1;
+        }
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+GlStateTracker::Statistics::Statistics() :
+callsMade  (0),
+callsElided(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+GlStateTracker::GlStateTracker() :
+m_matrixMode    (0),
+m_viewportKnown (false),
+m_viewport      (),
+m_blendKnown    (false),
+m_alphaKnown    (false),
+m_alphaFunction (0),
+m_alphaReference(0.f),
+m_textureKnown  (false),
+m_textureId     (0),
+m_coordinateType(Texture::Normalized),
+m_vertices      (NULL),
+m_frame         (),
+m_lastFrame     ()
+{
+    static const GLenum capabilities[SwitchCount] = {GL_BLEND, GL_TEXTURE_2D, GL_ALPHA_TEST, GL_DEPTH_TEST,
+                                                     GL_CULL_FACE, GL_LIGHTING, GL_SCISSOR_TEST};
+    static const GLenum arrays[ArrayCount] = {GL_VERTEX_ARRAY, GL_COLOR_ARRAY, GL_TEXTURE_COORD_ARRAY};
+
+    for (int i = 0; i < SwitchCount; ++i)
+        m_capabilities[i].name = capabilities[i];
+    for (int i = 0; i < ArrayCount; ++i)
+        m_arrays[i].name = arrays[i];
+
+    invalidate();
+}
+
+
+////////////////////////////////////////////////////////////
+void GlStateTracker::invalidate(unsigned int groups)
+{
+    if (groups & Capabilities)
+    {
+        for (int i = 0; i < SwitchCount; ++i)
+            m_capabilities[i].value = -1;
+    }
+
+    if (groups & ClientStates)
+    {
+        for (int i = 0; i < ArrayCount; ++i)
+            m_arrays[i].value = -1;
+    }
+
+    if (groups & Matrices)
+    {
+        m_matrixMode = 0;
+        for (int i = 0; i < MatrixCount; ++i)
+            m_matrixKnown[i] = false;
+
+        // A texture bound with pixel coordinates depends on the texture matrix
+        m_textureKnown = false;
+    }
+
+    if (groups & Viewport)
+        m_viewportKnown = false;
+
+    if (groups & Blending)
+    {
+        m_blendKnown = false;
+        m_alphaKnown = false;
+    }
+
+    if (groups & Textures)
+        m_textureKnown = false;
+
+    if (groups & VertexArrays)
+        m_vertices = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlStateTracker::setEnabled(unsigned int capability, bool enabled)
+{
+    int value = enabled ? 1 : 0;
+    for (int i = 0; i < SwitchCount; ++i)
+    {
+        if (m_capabilities[i].name == capability)
+        {
+            if (m_capabilities[i].value == value)
+            {
+                ++m_frame.callsElided;
+                return;
+            }
+
+            m_capabilities[i].value = value;
+            break;
+        }
+    }
+
+    if (enabled)
+        glCheck(glEnable(capability));
+    else
+        glCheck(glDisable(capability));
+    ++m_frame.callsMade;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlStateTracker::setClientStateEnabled(unsigned int array, bool enabled)
+{
+    int value = enabled ? 1 : 0;
+    for (int i = 0; i < ArrayCount; ++i)
+    {
+        if (m_arrays[i].name == array)
+        {
+            if (m_arrays[i].value == value)
+            {
+                ++m_frame.callsElided;
+                return;
+            }
+
+            m_arrays[i].value = value;
+            break;
+        }
+    }
+
+    if (enabled)
+        glCheck(glEnableClientState(array));
+    else
+        glCheck(glDisableClientState(array));
+    ++m_frame.callsMade;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlStateTracker::setMatrixMode(unsigned int mode)
+{
+    if (mode == m_matrixMode)
+    {
+        ++m_frame.callsElided;
+        return;
+    }
+
+    glCheck(glMatrixMode(mode));
+    m_matrixMode = mode;
+    ++m_frame.callsMade;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlStateTracker::loadMatrix(unsigned int mode, const float* matrix)
+{
+    int index = getMatrixIndex(mode);
+    if ((index >= 0) && m_matrixKnown[index] && (std::memcmp(m_matrices[index], matrix, 16 * sizeof(float)) == 0))
+    {
+        ++m_frame.callsElided;
+        return;
+    }
+
+    setMatrixMode(mode);
+    glCheck(glLoadMatrixf(matrix));
+    ++m_frame.callsMade;
+
+    if (index >= 0)
+    {
+        std::memcpy(m_matrices[index], matrix, 16 * sizeof(float));
+        m_matrixKnown[index] = true;
+    }
+
+    // A texture bound with pixel coordinates depends on the texture matrix
+    if (mode == GL_TEXTURE)
+        m_textureKnown = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlStateTracker::setViewport(const IntRect& viewport)
+{
+    if (m_viewportKnown && (viewport == m_viewport))
+    {
+        ++m_frame.callsElided;
+        return;
+    }
+
+    glCheck(glViewport(viewport.left, viewport.top, viewport.width, viewport.height));
+    m_viewport = viewport;
+    m_viewportKnown = true;
+    ++m_frame.callsMade;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlStateTracker::setBlendFunc(unsigned int sourceColor, unsigned int destinationColor,
+                                  unsigned int sourceAlpha, unsigned int destinationAlpha)
+{
+    if (m_blendKnown && (m_blendFactors[0] == sourceColor) && (m_blendFactors[1] == destinationColor) &&
+                        (m_blendFactors[2] == sourceAlpha) && (m_blendFactors[3] == destinationAlpha))
+    {
+        ++m_frame.callsElided;
+        return;
+    }
+
+    if (((sourceColor != sourceAlpha) || (destinationColor != destinationAlpha)) && GLEW_EXT_blend_func_separate)
+        glCheck(glBlendFuncSeparateEXT(sourceColor, destinationColor, sourceAlpha, destinationAlpha));
+    else
+        glCheck(glBlendFunc(sourceColor, destinationColor));
+
+    m_blendFactors[0] = sourceColor;
+    m_blendFactors[1] = destinationColor;
+    m_blendFactors[2] = sourceAlpha;
+    m_blendFactors[3] = destinationAlpha;
+    m_blendKnown = true;
+    ++m_frame.callsMade;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlStateTracker::setAlphaFunc(unsigned int function, float reference)
+{
+    if (m_alphaKnown && (function == m_alphaFunction) && (reference == m_alphaReference))
+    {
+        ++m_frame.callsElided;
+        return;
+    }
+
+    glCheck(glAlphaFunc(function, reference));
+    m_alphaFunction = function;
+    m_alphaReference = reference;
+    m_alphaKnown = true;
+    ++m_frame.callsMade;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlStateTracker::bindTexture(const Texture* texture, Texture::CoordinateType coordinateType)
+{
+    // Use the texture's cache identifier rather than its address or OpenGL
+    // name, both may be recycled by a new texture
+    Uint64 textureId = (texture && texture->m_texture) ? texture->m_cacheId : 0;
+    if (m_textureKnown && (textureId == m_textureId) && ((textureId == 0) || (coordinateType == m_coordinateType)))
+    {
+        ++m_frame.callsElided;
+        return;
+    }
+
+    Texture::bind(texture, coordinateType);
+    ++m_frame.callsMade;
+
+    // sf::Texture::bind loads the texture matrix when the texture needs
+    // one, and then goes back to the model-view mode
+    if (textureId && ((coordinateType == Texture::Pixels) || texture->m_pixelsFlipped))
+    {
+        m_matrixKnown[getMatrixIndex(GL_TEXTURE)] = false;
+        m_matrixMode = GL_MODELVIEW;
+    }
+
+    m_textureId = textureId;
+    m_coordinateType = coordinateType;
+    m_textureKnown = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlStateTracker::setVertexArrays(const Vertex* vertices)
+{
+    if (vertices == m_vertices)
+    {
+        m_frame.callsElided += 3;
+        return;
+    }
+
+    const char* data = reinterpret_cast<const char*>(vertices);
+    glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
+    glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8));
+    glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
+    m_vertices = vertices;
+    m_frame.callsMade += 3;
+}
+
+
+////////////////////////////////////////////////////////////
+void GlStateTracker::endFrame()
+{
+    m_lastFrame = m_frame;
+    m_frame = Statistics();
+}
+
+
+////////////////////////////////////////////////////////////
+const GlStateTracker::Statistics& GlStateTracker::getFrameStatistics() const
+{
+    return m_lastFrame;
+}
+
+} // namespace sf
@@ -0,0 +1,423 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/ImageDecoder.hpp>
+#include <SFML/Graphics/ImageLoader.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/System/Lock.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    // Maximum number of pixel buffers kept in the pool
+    const std::size_t maxPooledBuffers = 32;
+
+    // Tell whether a decode task is over
+    bool isTaskDone(const sf::TaskScheduler::Task& task)
+    {
+        return task.isDone();
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+struct ImageDecoder::Job
+{
+    enum State
+    {
+        Pending, ///< Waiting for a worker
+        Running, ///< Being decoded by a worker or a waiting thread
+        Done     ///< Result available
+    };
+
+    Job() :
+    decoder (NULL),
+    data    (NULL),
+    dataSize(0),
+    state   (Pending),
+    success (false),
+    taken   (false),
+    refCount(0)
+    {
+    }
+
+    ImageDecoder*      decoder;  ///< Decoder which owns the job
+    std::string        filename; ///< File to decode, if data is NULL
+    const void*        data;     ///< File data in memory
+    std::size_t        dataSize; ///< Size of the file data in memory
+    std::vector<Uint8> pixels;   ///< Decoded pixels
+    Vector2u           size;     ///< Size of the decoded image
+    State              state;    ///< Progress of the decode
+    bool               success;  ///< Was the decode successful?
+    bool               taken;    ///< Were the pixels moved to an image?
+    unsigned int       refCount; ///< Number of futures (plus the task) referencing the job
+    Mutex              running;  ///< Locked during the whole decode
+};
+
+
+////////////////////////////////////////////////////////////
+ImageDecoder::Future::Future() :
+m_decoder(NULL),
+m_job    (NULL)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+ImageDecoder::Future::Future(ImageDecoder* decoder, Job* job) :
+m_decoder(decoder),
+m_job    (job)
+{
+    // The reference was already added when the job was queued
+}
+
+
+////////////////////////////////////////////////////////////
+ImageDecoder::Future::Future(const Future& copy) :
+m_decoder(copy.m_decoder),
+m_job    (copy.m_job)
+{
+    if (m_job)
+        m_decoder->acquire(m_job);
+}
+
+
+////////////////////////////////////////////////////////////
+ImageDecoder::Future::~Future()
+{
+    if (m_job)
+        m_decoder->release(m_job);
+}
+
+
+////////////////////////////////////////////////////////////
+ImageDecoder::Future& ImageDecoder::Future::operator =(const Future& right)
+{
+    if (right.m_job)
+        right.m_decoder->acquire(right.m_job);
+    if (m_job)
+        m_decoder->release(m_job);
+
+    m_decoder = right.m_decoder;
+    m_job = right.m_job;
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageDecoder::Future::isValid() const
+{
+    return m_job != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageDecoder::Future::isReady() const
+{
+    if (!m_job)
+        return false;
+
+    Lock lock(m_decoder->m_mutex);
+    return m_job->state == Job::Done;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageDecoder::Future::wait() const
+{
+    if (!m_job)
+        return false;
+
+    bool decodeHere = false;
+    {
+        Lock lock(m_decoder->m_mutex);
+
+        if (m_job->state == Job::Done)
+            return m_job->success;
+
+        // Nobody is working on it yet: decode it here rather than
+        // waiting for a worker to become available, the task will
+        // find it running and do nothing
+        if (m_job->state == Job::Pending)
+        {
+            m_decoder->start(m_job);
+            decodeHere = true;
+        }
+    }
+
+    if (decodeHere)
+    {
+        m_decoder->process(m_job);
+    }
+    else
+    {
+        // The worker holds this mutex until the decode is finished
+        m_job->running.lock();
+        m_job->running.unlock();
+    }
+
+    Lock lock(m_decoder->m_mutex);
+    return m_job->success;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageDecoder::Future::get(Image& image)
+{
+    if (!wait())
+        return false;
+
+    return m_decoder->retrieve(m_job, image);
+}
+
+
+////////////////////////////////////////////////////////////
+ImageDecoder::ImageDecoder(TaskScheduler& scheduler) :
+m_scheduler(scheduler)
+{
+    // Make sure the loader singleton is created before any worker uses it
+    priv::ImageLoader::getInstance();
+}
+
+
+////////////////////////////////////////////////////////////
+ImageDecoder::~ImageDecoder()
+{
+    wait();
+}
+
+
+////////////////////////////////////////////////////////////
+ImageDecoder::Future ImageDecoder::loadFromFile(const std::string& filename)
+{
+    Job* job = new Job;
+    job->filename = filename;
+
+    return push(job);
+}
+
+
+////////////////////////////////////////////////////////////
+ImageDecoder::Future ImageDecoder::loadFromMemory(const void* data, std::size_t size)
+{
+    Job* job = new Job;
+    job->data = data;
+    job->dataSize = size;
+
+    return push(job);
+}
+
+
+////////////////////////////////////////////////////////////
+std::vector<ImageDecoder::Future> ImageDecoder::loadFromFiles(const std::vector<std::string>& filenames)
+{
+    std::vector<Future> futures;
+    futures.reserve(filenames.size());
+
+    for (std::vector<std::string>::const_iterator it = filenames.begin(); it != filenames.end(); ++it)
+    {
+        Job* job = new Job;
+        job->filename = *it;
+        futures.push_back(push(job));
+    }
+
+    return futures;
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageDecoder::recycle(Image& image)
+{
+    Lock lock(m_mutex);
+
+    storeBuffer(image.m_pixels);
+    image.m_size = Vector2u(0, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageDecoder::wait()
+{
+    // The scheduler may be shared, only wait for our own decodes
+    std::vector<TaskScheduler::Task> tasks;
+    {
+        Lock lock(m_mutex);
+        tasks.swap(m_tasks);
+    }
+
+    for (std::vector<TaskScheduler::Task>::const_iterator it = tasks.begin(); it != tasks.end(); ++it)
+        it->wait();
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int ImageDecoder::getWorkerCount() const
+{
+    return m_scheduler.getWorkerCount();
+}
+
+
+////////////////////////////////////////////////////////////
+ImageDecoder::Future ImageDecoder::push(Job* job)
+{
+    // One reference is owned by the task until it has run,
+    // the other one by the returned future
+    job->decoder = this;
+    job->refCount = 2;
+
+    TaskScheduler::Task task = m_scheduler.add(&ImageDecoder::run, job);
+
+    {
+        Lock lock(m_mutex);
+
+        // Forget the decodes that are over, so that the list doesn't grow forever
+        m_tasks.erase(std::remove_if(m_tasks.begin(), m_tasks.end(), &isTaskDone), m_tasks.end());
+        m_tasks.push_back(task);
+    }
+
+    return Future(this, job);
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageDecoder::run(Job* job)
+{
+    ImageDecoder* decoder = job->decoder;
+
+    bool decodeHere = false;
+    {
+        Lock lock(decoder->m_mutex);
+
+        if (job->state == Job::Pending)
+        {
+            decoder->start(job);
+            decodeHere = true;
+        }
+    }
+
+    if (decodeHere)
+        decoder->process(job);
+
+    // Drop the reference owned by the task
+    decoder->release(job);
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageDecoder::start(Job* job)
+{
+    job->state = Job::Running;
+    job->running.lock();
+
+    // Pick a buffer from the pool, so that decoding reuses its memory
+    if (!m_pool.empty())
+    {
+        job->pixels.swap(m_pool.back());
+        m_pool.pop_back();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageDecoder::process(Job* job)
+{
+    priv::ImageLoader& loader = priv::ImageLoader::getInstance();
+    bool success = job->data ? loader.loadImageFromMemory(job->data, job->dataSize, job->pixels, job->size)
+                             : loader.loadImageFromFile(job->filename, job->pixels, job->size);
+
+    // Wake up the threads waiting for this job before taking the
+    // decoder's mutex again, so that the two locks are never nested
+    // in this order
+    job->success = success;
+    job->running.unlock();
+
+    Lock lock(m_mutex);
+    job->state = Job::Done;
+}
+
+
+////////////////////////////////////////////////////////////
+bool ImageDecoder::retrieve(Job* job, Image& image)
+{
+    Lock lock(m_mutex);
+
+    if (job->taken)
+        return false;
+
+    // Swap the pixel buffers, the previous storage of the image goes to the pool
+    image.m_pixels.swap(job->pixels);
+    image.m_size = job->size;
+    job->taken = true;
+    storeBuffer(job->pixels);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageDecoder::acquire(Job* job)
+{
+    Lock lock(m_mutex);
+
+    job->refCount++;
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageDecoder::release(Job* job)
+{
+    Lock lock(m_mutex);
+
+    if (--job->refCount == 0)
+    {
+        // Nobody retrieved the result: keep its memory for the next decodes
+        storeBuffer(job->pixels);
+        delete job;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ImageDecoder::storeBuffer(std::vector<Uint8>& pixels)
+{
+    if ((pixels.capacity() > 0) && (m_pool.size() < maxPooledBuffers))
+    {
+        m_pool.push_back(std::vector<Uint8>());
+        m_pool.back().swap(pixels);
+        m_pool.back().clear();
+    }
+    else
+    {
+        std::vector<Uint8>().swap(pixels);
+    }
+}
+
+} // namespace sf
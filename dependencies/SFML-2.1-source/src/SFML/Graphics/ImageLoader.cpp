@@ -36,6 +36,7 @@ extern "C"
     #include <jpeglib.h>
     #include <jerror.h>
 }
+#include <algorithm>
 #include <cctype>
 
 
@@ -65,6 +66,29 @@ namespace
         sf::InputStream* stream = static_cast<sf::InputStream*>(user);
         return stream->tell() >= stream->getSize();
     }
+
+    // Read a 32-bits integer from a KTX file, in the file's byte order
+    sf::Uint32 readKtxInt(const unsigned char* data, bool swapBytes)
+    {
+        sf::Uint32 value;
+        memcpy(&value, data, sizeof(value));
+        if (swapBytes)
+            value = (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+        return value;
+    }
+
+    // Get the size of a 4x4 block of a compressed format, or 0 if the format is not supported
+    std::size_t getBlockSize(sf::Uint32 format)
+    {
+        switch (format)
+        {
+            case 0x83F0 : return 8;  // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+            case 0x83F3 : return 16; // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+            case 0x9274 : return 8;  // GL_COMPRESSED_RGB8_ETC2
+            case 0x9278 : return 16; // GL_COMPRESSED_RGBA8_ETC2_EAC
+            default :     return 0;
+        }
+    }
 }
 
 
@@ -84,7 +108,10 @@ ImageLoader& ImageLoader::getInstance()
 ////////////////////////////////////////////////////////////
 ImageLoader::ImageLoader()
 {
-    // Nothing to do
+    // stb_image lazily fills its default zlib tables the first time a
+    // PNG uses them; do it once here so that concurrent decodes (see
+    // sf::ImageDecoder) never race on a partially initialized table
+    init_defaults();
 }
 
 
@@ -219,6 +246,95 @@ bool ImageLoader::loadImageFromStream(InputStream& stream, std::vector<Uint8>& p
 }
 
 
+////////////////////////////////////////////////////////////
+bool ImageLoader::loadCompressedImageFromMemory(const void* data, std::size_t dataSize, CompressedPixels& pixels)
+{
+    static const unsigned char identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+    const std::size_t headerSize = 64;
+
+    // Check the file identifier
+    const unsigned char* begin = static_cast<const unsigned char*>(data);
+    if (!data || (dataSize < headerSize) || (memcmp(begin, identifier, sizeof(identifier)) != 0))
+    {
+        err() << "Failed to load compressed image from memory, not a KTX file" << std::endl;
+        return false;
+    }
+
+    // The file may have been written on a machine with the other byte order
+    bool swapBytes = readKtxInt(begin + 12, false) != 0x04030201;
+
+    Uint32 glType        = readKtxInt(begin + 16, swapBytes);
+    Uint32 glFormat      = readKtxInt(begin + 24, swapBytes);
+    Uint32 internal      = readKtxInt(begin + 28, swapBytes);
+    Uint32 width         = readKtxInt(begin + 36, swapBytes);
+    Uint32 height        = readKtxInt(begin + 40, swapBytes);
+    Uint32 depth         = readKtxInt(begin + 44, swapBytes);
+    Uint32 arraySize     = readKtxInt(begin + 48, swapBytes);
+    Uint32 faces         = readKtxInt(begin + 52, swapBytes);
+    Uint32 levelCount    = readKtxInt(begin + 56, swapBytes);
+    Uint32 keyValueBytes = readKtxInt(begin + 60, swapBytes);
+
+    // Only accept what can be uploaded as a single compressed 2D texture
+    std::size_t blockSize = getBlockSize(internal);
+    if ((glType != 0) || (glFormat != 0) || (blockSize == 0) || (width == 0) || (height == 0) ||
+        (depth > 1) || (arraySize > 0) || (faces != 1))
+    {
+        err() << "Failed to load compressed image from memory, unsupported KTX texture (format 0x"
+              << std::hex << internal << std::dec << ", " << width << "x" << height << ")" << std::endl;
+        return false;
+    }
+
+    // A level count of 0 means that the mipmaps must be generated by the loader
+    if (levelCount == 0)
+        levelCount = 1;
+
+    // A full mipmap chain has floor(log2(max(width, height))) + 1 levels, never more
+    Uint32 maxLevelCount = 1;
+    for (Uint32 size = std::max(width, height); size > 1; size /= 2)
+        ++maxLevelCount;
+    if (levelCount > maxLevelCount)
+    {
+        err() << "Failed to load compressed image from memory, invalid KTX level count ("
+              << levelCount << " levels for a " << width << "x" << height << " texture)" << std::endl;
+        return false;
+    }
+
+    pixels.format = internal;
+    pixels.size = Vector2u(width, height);
+    pixels.levels.resize(levelCount);
+
+    const unsigned char* end = begin + dataSize;
+    const unsigned char* current = begin + headerSize;
+    if (keyValueBytes > static_cast<std::size_t>(end - current))
+    {
+        err() << "Failed to load compressed image from memory, the KTX file is truncated" << std::endl;
+        return false;
+    }
+    current += keyValueBytes;
+
+    for (Uint32 level = 0; level < levelCount; ++level)
+    {
+        // Each level is stored as its size followed by its blocks, padded to 4 bytes
+        std::size_t expected = ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+        if ((end - current < 4) || (readKtxInt(current, swapBytes) != expected) ||
+            (static_cast<std::size_t>(end - current - 4) < expected))
+        {
+            err() << "Failed to load compressed image from memory, invalid KTX level " << level << std::endl;
+            return false;
+        }
+        current += 4;
+
+        pixels.levels[level].assign(current, current + expected);
+        current += std::min((expected + 3) & ~static_cast<std::size_t>(3), static_cast<std::size_t>(end - current));
+
+        width  = width  > 1 ? width  / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 bool ImageLoader::saveImageToFile(const std::string& filename, const std::vector<Uint8>& pixels, const Vector2u& size)
 {
@@ -40,9 +40,23 @@ class InputStream;
 
 namespace priv
 {
+////////////////////////////////////////////////////////////
+/// \brief Block-compressed pixels, to be uploaded as they are
+///
+////////////////////////////////////////////////////////////
+struct CompressedPixels
+{
+    unsigned int                     format; ///< OpenGL internal format of the blocks
+    Vector2u                         size;   ///< Size of the first level, in pixels
+    std::vector<std::vector<Uint8> > levels; ///< Blocks of each mipmap level, largest first
+};
+
 ////////////////////////////////////////////////////////////
 /// \brief Load/save image files
 ///
+/// The loading functions can be called concurrently from
+/// multiple threads.
+///
 ////////////////////////////////////////////////////////////
 class ImageLoader : NonCopyable
 {
@@ -93,6 +107,21 @@ public :
     ////////////////////////////////////////////////////////////
     bool loadImageFromStream(InputStream& stream, std::vector<Uint8>& pixels, Vector2u& size);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Load block-compressed pixels from a KTX file in memory
+    ///
+    /// Only 2D textures in a compressed format are supported,
+    /// the blocks are returned without being decoded.
+    ///
+    /// \param data     Pointer to the file data in memory
+    /// \param dataSize Size of the data to load, in bytes
+    /// \param pixels   Compressed pixels to fill
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadCompressedImageFromMemory(const void* data, std::size_t dataSize, CompressedPixels& pixels);
+
     ////////////////////////////////////////////////////////////
     /// \bref Save an array of pixels as an image file
     ///
@@ -41,7 +41,8 @@ namespace sf
 RenderTarget::RenderTarget() :
 m_defaultView(),
 m_view       (),
-m_cache      ()
+m_cache      (),
+m_glStates   ()
 {
     m_cache.glStatesSet = false;
 }
@@ -167,58 +168,41 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
         if (useVertexCache)
         {
             // Pre-transform the vertices and store them into the vertex cache
+            // (the matrix is read once, so that writing the cache doesn't force
+            // the compiler to reload it for every vertex)
+            const float* matrix = states.transform.getMatrix();
+            float a00 = matrix[0], a01 = matrix[4], a02 = matrix[12];
+            float a10 = matrix[1], a11 = matrix[5], a12 = matrix[13];
             for (unsigned int i = 0; i < vertexCount; ++i)
             {
                 Vertex& vertex = m_cache.vertexCache[i];
-                vertex.position = states.transform * vertices[i].position;
+                const Vector2f& position = vertices[i].position;
+                vertex.position.x = a00 * position.x + a01 * position.y + a02;
+                vertex.position.y = a10 * position.x + a11 * position.y + a12;
                 vertex.color = vertices[i].color;
                 vertex.texCoords = vertices[i].texCoords;
             }
 
             // Since vertices are transformed, we must use an identity transform to render them
-            if (!m_cache.useVertexCache)
-                applyTransform(Transform::Identity);
+            m_glStates.loadMatrix(GL_MODELVIEW, Transform::Identity.getMatrix());
         }
         else
         {
-            applyTransform(states.transform);
+            m_glStates.loadMatrix(GL_MODELVIEW, states.transform.getMatrix());
         }
 
-        // Apply the view
-        if (m_cache.viewChanged)
-            applyCurrentView();
-
-        // Apply the blend mode
-        if (states.blendMode != m_cache.lastBlendMode)
-            applyBlendMode(states.blendMode);
-
-        // Apply the texture
-        Uint64 textureId = states.texture ? states.texture->m_cacheId : 0;
-        if (textureId != m_cache.lastTextureId)
-            applyTexture(states.texture);
+        // Apply the view, the render states and the texture; the tracker skips
+        // what is already set, and restores what other users of the context changed
+        applyCurrentView();
+        applyBlendMode(states.blendMode);
+        m_glStates.bindTexture(states.texture, Texture::Pixels);
 
         // Apply the shader
         if (states.shader)
             applyShader(states.shader);
 
-        // If we pre-transform the vertices, we must use our internal vertex cache
-        if (useVertexCache)
-        {
-            // ... and if we already used it previously, we don't need to set the pointers again
-            if (!m_cache.useVertexCache)
-                vertices = m_cache.vertexCache;
-            else
-                vertices = NULL;
-        }
-
         // Setup the pointers to the vertices' components
-        if (vertices)
-        {
-            const char* data = reinterpret_cast<const char*>(vertices);
-            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
-            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8));
-            glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
-        }
+        m_glStates.setVertexArrays(useVertexCache ? m_cache.vertexCache : vertices);
 
         // Find the OpenGL primitive type
         static const GLenum modes[] = {GL_POINTS, GL_LINES, GL_LINE_STRIP, GL_TRIANGLES,
@@ -231,9 +215,6 @@ void RenderTarget::draw(const Vertex* vertices, unsigned int vertexCount,
         // Unbind the shader, if any
         if (states.shader)
             applyShader(NULL);
-
-        // Update the cache
-        m_cache.useVertexCache = useVertexCache;
     }
 }
 
@@ -281,6 +262,9 @@ void RenderTarget::popGLStates()
         glCheck(glPopMatrix());
         glCheck(glPopClientAttrib());
         glCheck(glPopAttrib());
+
+        // The restored states are those of the user, which we don't know
+        m_glStates.invalidate();
     }
 }
 
@@ -293,26 +277,28 @@ void RenderTarget::resetGLStates()
         // Make sure that GLEW is initialized
         priv::ensureGlewInit();
 
+        // The states may have been changed behind our back
+        m_glStates.invalidate();
+
         // Define the default OpenGL states
-        glCheck(glDisable(GL_CULL_FACE));
-        glCheck(glDisable(GL_LIGHTING));
-        glCheck(glDisable(GL_DEPTH_TEST));
-        glCheck(glDisable(GL_ALPHA_TEST));
-        glCheck(glEnable(GL_TEXTURE_2D));
-        glCheck(glEnable(GL_BLEND));
-        glCheck(glMatrixMode(GL_MODELVIEW));
-        glCheck(glEnableClientState(GL_VERTEX_ARRAY));
-        glCheck(glEnableClientState(GL_COLOR_ARRAY));
-        glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+        m_glStates.setEnabled(GL_CULL_FACE, false);
+        m_glStates.setEnabled(GL_LIGHTING, false);
+        m_glStates.setEnabled(GL_DEPTH_TEST, false);
+        m_glStates.setEnabled(GL_ALPHA_TEST, false);
+        m_glStates.setEnabled(GL_TEXTURE_2D, true);
+        m_glStates.setEnabled(GL_BLEND, true);
+        m_glStates.setMatrixMode(GL_MODELVIEW);
+        m_glStates.setClientStateEnabled(GL_VERTEX_ARRAY, true);
+        m_glStates.setClientStateEnabled(GL_COLOR_ARRAY, true);
+        m_glStates.setClientStateEnabled(GL_TEXTURE_COORD_ARRAY, true);
         m_cache.glStatesSet = true;
 
         // Apply the default SFML states
         applyBlendMode(BlendAlpha);
-        applyTransform(Transform::Identity);
-        applyTexture(NULL);
+        m_glStates.loadMatrix(GL_MODELVIEW, Transform::Identity.getMatrix());
+        m_glStates.bindTexture(NULL);
         if (Shader::isAvailable())
             applyShader(NULL);
-        m_cache.useVertexCache = false;
 
         // Set the default view
         setView(getView());
@@ -320,6 +306,13 @@ void RenderTarget::resetGLStates()
 }
 
 
+////////////////////////////////////////////////////////////
+GlStateTracker& RenderTarget::getGlStateTracker()
+{
+    return m_glStates;
+}
+
+
 ////////////////////////////////////////////////////////////
 void RenderTarget::initialize()
 {
@@ -335,19 +328,17 @@ void RenderTarget::initialize()
 ////////////////////////////////////////////////////////////
 void RenderTarget::applyCurrentView()
 {
-    // Set the viewport
-    IntRect viewport = getViewport(m_view);
-    int top = getSize().y - (viewport.top + viewport.height);
-    glCheck(glViewport(viewport.left, top, viewport.width, viewport.height));
-
-    // Set the projection matrix
-    glCheck(glMatrixMode(GL_PROJECTION));
-    glCheck(glLoadMatrixf(m_view.getTransform().getMatrix()));
-
-    // Go back to model-view mode
-    glCheck(glMatrixMode(GL_MODELVIEW));
+    // Convert the viewport to OpenGL coordinates only when the view changes
+    if (m_cache.viewChanged)
+    {
+        m_cache.viewport = getViewport(m_view);
+        m_cache.viewport.top = getSize().y - (m_cache.viewport.top + m_cache.viewport.height);
+        m_cache.viewChanged = false;
+    }
 
-    m_cache.viewChanged = false;
+    // Set the viewport and the projection matrix
+    m_glStates.setViewport(m_cache.viewport);
+    m_glStates.loadMatrix(GL_PROJECTION, m_view.getTransform().getMatrix());
 }
 
 
@@ -356,56 +347,31 @@ void RenderTarget::applyBlendMode(BlendMode mode)
 {
     switch (mode)
     {
-        // glBlendFuncSeparateEXT is used when available to avoid an incorrect alpha value when the target
-        // is a RenderTexture -- in this case the alpha value must be written directly to the target buffer
+        // The alpha factors are used when glBlendFuncSeparateEXT is available, to avoid an incorrect alpha
+        // value when the target is a RenderTexture -- in this case the alpha value must be written directly
+        // to the target buffer
 
         // Alpha blending
         default :
         case BlendAlpha :
-            if (GLEW_EXT_blend_func_separate)
-                glCheck(glBlendFuncSeparateEXT(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA));
-            else
-                glCheck(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+            m_glStates.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
             break;
 
         // Additive blending
         case BlendAdd :
-            if (GLEW_EXT_blend_func_separate)
-                glCheck(glBlendFuncSeparateEXT(GL_SRC_ALPHA, GL_ONE, GL_ONE, GL_ONE));
-            else
-                glCheck(glBlendFunc(GL_SRC_ALPHA, GL_ONE));
+            m_glStates.setBlendFunc(GL_SRC_ALPHA, GL_ONE, GL_ONE, GL_ONE);
             break;
 
         // Multiplicative blending
         case BlendMultiply :
-            glCheck(glBlendFunc(GL_DST_COLOR, GL_ZERO));
+            m_glStates.setBlendFunc(GL_DST_COLOR, GL_ZERO, GL_DST_COLOR, GL_ZERO);
             break;
 
         // No blending
         case BlendNone :
-            glCheck(glBlendFunc(GL_ONE, GL_ZERO));
+            m_glStates.setBlendFunc(GL_ONE, GL_ZERO, GL_ONE, GL_ZERO);
             break;
     }
-
-    m_cache.lastBlendMode = mode;
-}
-
-
-////////////////////////////////////////////////////////////
-void RenderTarget::applyTransform(const Transform& transform)
-{
-    // No need to call glMatrixMode(GL_MODELVIEW), it is always the
-    // current mode (for optimization purpose, since it's the most used)
-    glCheck(glLoadMatrixf(transform.getMatrix()));
-}
-
-
-////////////////////////////////////////////////////////////
-void RenderTarget::applyTexture(const Texture* texture)
-{
-    Texture::bind(texture, Texture::Pixels);
-
-    m_cache.lastTextureId = texture ? texture->m_cacheId : 0;
 }
 
 
@@ -421,10 +387,17 @@ void RenderTarget::applyShader(const Shader* shader)
 ////////////////////////////////////////////////////////////
 // Render states caching strategies
 //
+// All the fixed-pipeline states go through the target's
+// GlStateTracker, which skips a call when the state already
+// has the requested value. Since other code drawing with the
+// same context can use the tracker too, the states are never
+// assumed to be still set from the previous draw: they are
+// requested again every time, and the tracker decides.
+//
 // * View
-//   If SetView was called since last draw, the projection
-//   matrix is updated. We don't need more, the view doesn't
-//   change frequently.
+//   The viewport is only converted to OpenGL coordinates when
+//   SetView was called since last draw. The viewport and the
+//   projection matrix are compared to the current ones.
 //
 // * Transform
 //   The transform matrix is usually expensive because each
@@ -435,8 +408,13 @@ void RenderTarget::applyShader(const Shader* shader)
 //   to render them.
 //
 // * Blending mode
-//   It's a simple integral value, so we can easily check
-//   whether the value to apply is the same as before or not.
+//   Its blending factors are a few integral values, so we can
+//   easily check whether they are the same as before or not.
+//
+// * Vertex arrays
+//   Pre-transformed vertices are always in the same cache,
+//   so the array pointers don't change until a larger array
+//   is drawn.
 //
 // * Texture
 //   Storing the pointer or OpenGL ID of the last used texture
@@ -128,6 +128,9 @@ void RenderTexture::display()
     {
         m_impl->updateTexture(m_texture.m_texture);
         m_texture.m_pixelsFlipped = true;
+
+        // Start counting the OpenGL calls of the next frame
+        getGlStateTracker().endFrame();
     }
 }
 
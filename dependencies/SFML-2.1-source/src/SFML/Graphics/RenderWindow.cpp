@@ -114,4 +114,12 @@ void RenderWindow::onResize()
     setView(getView());
 }
 
+
+////////////////////////////////////////////////////////////
+void RenderWindow::onDisplay()
+{
+    // Start counting the OpenGL calls of the next frame
+    getGlStateTracker().endFrame();
+}
+
 } // namespace sf
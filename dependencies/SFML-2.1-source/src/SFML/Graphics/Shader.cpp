@@ -31,6 +31,7 @@
 #include <SFML/Graphics/GLCheck.hpp>
 #include <SFML/System/InputStream.hpp>
 #include <SFML/System/Err.hpp>
+#include <cstring>
 #include <fstream>
 #include <vector>
 
@@ -83,6 +84,19 @@ namespace
         buffer.push_back('\0');
         return success;
     }
+
+    // Hash a parameter name (FNV-1a), to look it up without comparing strings
+    sf::Uint32 hashName(const std::string& name)
+    {
+        sf::Uint32 hash = 2166136261u;
+        for (std::string::const_iterator it = name.begin(); it != name.end(); ++it)
+        {
+            hash ^= static_cast<unsigned char>(*it);
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
 }
 
 
@@ -94,10 +108,13 @@ Shader::CurrentTextureType Shader::CurrentTexture;
 
 ////////////////////////////////////////////////////////////
 Shader::Shader() :
-m_shaderProgram (0),
-m_currentTexture(-1),
-m_textures      (),
-m_params        ()
+m_shaderProgram  (0),
+m_currentTexture (-1),
+m_textures       (),
+m_params         (),
+m_parameters     (),
+m_dirtyParameters(),
+m_blocks         ()
 {
 }
 
@@ -107,6 +124,9 @@ Shader::~Shader()
 {
     ensureGlContext();
 
+    // Destroy the uniform buffers
+    destroyBlocks();
+
     // Destroy effect program
     if (m_shaderProgram)
         glCheck(glDeleteObjectARB(m_shaderProgram));
@@ -221,179 +241,310 @@ bool Shader::loadFromStream(InputStream& vertexShaderStream, InputStream& fragme
 ////////////////////////////////////////////////////////////
 void Shader::setParameter(const std::string& name, float x)
 {
-    if (m_shaderProgram)
-    {
-        ensureGlContext();
+    setParameter(getParameterHandle(name), x);
+}
+
 
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
+////////////////////////////////////////////////////////////
+void Shader::setParameter(const std::string& name, float x, float y)
+{
+    setParameter(getParameterHandle(name), x, y);
+}
 
-        // Get parameter location and assign it new values
-        GLint location = getParamLocation(name);
-        if (location != -1)
-            glCheck(glUniform1fARB(location, x));
 
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
-    }
+////////////////////////////////////////////////////////////
+void Shader::setParameter(const std::string& name, float x, float y, float z)
+{
+    setParameter(getParameterHandle(name), x, y, z);
 }
 
 
 ////////////////////////////////////////////////////////////
-void Shader::setParameter(const std::string& name, float x, float y)
+void Shader::setParameter(const std::string& name, float x, float y, float z, float w)
 {
-    if (m_shaderProgram)
-    {
-        ensureGlContext();
+    setParameter(getParameterHandle(name), x, y, z, w);
+}
 
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
 
-        // Get parameter location and assign it new values
-        GLint location = getParamLocation(name);
-        if (location != -1)
-            glCheck(glUniform2fARB(location, x, y));
+////////////////////////////////////////////////////////////
+void Shader::setParameter(const std::string& name, const Vector2f& v)
+{
+    setParameter(name, v.x, v.y);
+}
 
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
-    }
+
+////////////////////////////////////////////////////////////
+void Shader::setParameter(const std::string& name, const Vector3f& v)
+{
+    setParameter(name, v.x, v.y, v.z);
 }
 
 
 ////////////////////////////////////////////////////////////
-void Shader::setParameter(const std::string& name, float x, float y, float z)
+void Shader::setParameter(const std::string& name, const Color& color)
 {
-    if (m_shaderProgram)
-    {
-        ensureGlContext();
+    setParameter(name, color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f);
+}
+
 
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
+////////////////////////////////////////////////////////////
+void Shader::setParameter(const std::string& name, const sf::Transform& transform)
+{
+    setParameter(getParameterHandle(name), transform);
+}
 
-        // Get parameter location and assign it new values
-        GLint location = getParamLocation(name);
-        if (location != -1)
-            glCheck(glUniform3fARB(location, x, y, z));
 
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
-    }
+////////////////////////////////////////////////////////////
+void Shader::setParameter(const std::string& name, const Texture& texture)
+{
+    setParameter(getParameterHandle(name), texture);
 }
 
 
 ////////////////////////////////////////////////////////////
-void Shader::setParameter(const std::string& name, float x, float y, float z, float w)
+void Shader::setParameter(const std::string& name, CurrentTextureType)
 {
-    if (m_shaderProgram)
-    {
-        ensureGlContext();
+    setParameter(getParameterHandle(name), CurrentTexture);
+}
+
 
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
+////////////////////////////////////////////////////////////
+Shader::ParameterHandle Shader::getParameterHandle(const std::string& name)
+{
+    if (!m_shaderProgram)
+        return -1;
 
-        // Get parameter location and assign it new values
-        GLint location = getParamLocation(name);
-        if (location != -1)
-            glCheck(glUniform4fARB(location, x, y, z, w));
+    // Check the cache
+    Uint32 hash = hashName(name);
+    std::pair<ParamTable::const_iterator, ParamTable::const_iterator> range = m_params.equal_range(hash);
+    for (ParamTable::const_iterator it = range.first; it != range.second; ++it)
+    {
+        // Names that were not found are cached too, so that they are reported only once
+        if (m_parameters[it->second].name == name)
+            return (m_parameters[it->second].location != -1) ? it->second : -1;
+    }
 
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
+    // Not in cache, request the location from OpenGL
+    ensureGlContext();
+    int location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
+    if (location == -1)
+    {
+        // Error: location not found
+        err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
     }
+
+    // Add it to the cache
+    Parameter parameter;
+    parameter.name = name;
+    parameter.location = location;
+    parameter.components = 0;
+    parameter.dirty = false;
+    m_parameters.push_back(parameter);
+
+    ParameterHandle handle = static_cast<ParameterHandle>(m_parameters.size() - 1);
+    m_params.insert(std::make_pair(hash, handle));
+
+    return (location != -1) ? handle : -1;
 }
 
 
 ////////////////////////////////////////////////////////////
-void Shader::setParameter(const std::string& name, const Vector2f& v)
+void Shader::setParameter(ParameterHandle handle, float x)
 {
-    setParameter(name, v.x, v.y);
+    setParameterValues(handle, &x, 1, 1);
 }
 
 
 ////////////////////////////////////////////////////////////
-void Shader::setParameter(const std::string& name, const Vector3f& v)
+void Shader::setParameter(ParameterHandle handle, float x, float y)
 {
-    setParameter(name, v.x, v.y, v.z);
+    float values[] = {x, y};
+    setParameterValues(handle, values, 1, 2);
 }
 
 
 ////////////////////////////////////////////////////////////
-void Shader::setParameter(const std::string& name, const Color& color)
+void Shader::setParameter(ParameterHandle handle, float x, float y, float z)
 {
-    setParameter(name, color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f);
+    float values[] = {x, y, z};
+    setParameterValues(handle, values, 1, 3);
 }
 
 
 ////////////////////////////////////////////////////////////
-void Shader::setParameter(const std::string& name, const sf::Transform& transform)
+void Shader::setParameter(ParameterHandle handle, float x, float y, float z, float w)
 {
-    if (m_shaderProgram)
-    {
-        ensureGlContext();
+    float values[] = {x, y, z, w};
+    setParameterValues(handle, values, 1, 4);
+}
+
 
-        // Enable program
-        GLhandleARB program = glGetHandleARB(GL_PROGRAM_OBJECT_ARB);
-        glCheck(glUseProgramObjectARB(m_shaderProgram));
+////////////////////////////////////////////////////////////
+void Shader::setParameter(ParameterHandle handle, const Vector2f& vector)
+{
+    setParameter(handle, vector.x, vector.y);
+}
 
-        // Get parameter location and assign it new values
-        GLint location = getParamLocation(name);
-        if (location != -1)
-            glCheck(glUniformMatrix4fvARB(location, 1, GL_FALSE, transform.getMatrix()));
 
-        // Disable program
-        glCheck(glUseProgramObjectARB(program));
-    }
+////////////////////////////////////////////////////////////
+void Shader::setParameter(ParameterHandle handle, const Vector3f& vector)
+{
+    setParameter(handle, vector.x, vector.y, vector.z);
 }
 
 
 ////////////////////////////////////////////////////////////
-void Shader::setParameter(const std::string& name, const Texture& texture)
+void Shader::setParameter(ParameterHandle handle, const Color& color)
 {
-    if (m_shaderProgram)
-    {
-        ensureGlContext();
+    setParameter(handle, color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameter(ParameterHandle handle, const sf::Transform& transform)
+{
+    setParameterValues(handle, transform.getMatrix(), 1, 16);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameter(ParameterHandle handle, const Texture& texture)
+{
+    if ((handle < 0) || (static_cast<std::size_t>(handle) >= m_parameters.size()))
+        return;
+
+    ensureGlContext();
 
-        // Find the location of the variable in the shader
-        int location = getParamLocation(name);
-        if (location != -1)
+    // Store the location -> texture mapping
+    int location = m_parameters[handle].location;
+    TextureTable::iterator it = m_textures.find(location);
+    if (it == m_textures.end())
+    {
+        // New entry, make sure there are enough texture units
+        static const GLint maxUnits = getMaxTextureUnits();
+        if (m_textures.size() + 1 >= static_cast<std::size_t>(maxUnits))
         {
-            // Store the location -> texture mapping
-            TextureTable::iterator it = m_textures.find(location);
-            if (it == m_textures.end())
-            {
-                // New entry, make sure there are enough texture units
-                static const GLint maxUnits = getMaxTextureUnits();
-                if (m_textures.size() + 1 >= static_cast<std::size_t>(maxUnits))
-                {
-                    err() << "Impossible to use texture \"" << name << "\" for shader: all available texture units are used" << std::endl;
-                    return;
-                }
-
-                m_textures[location] = &texture;
-            }
-            else
-            {
-                // Location already used, just replace the texture
-                it->second = &texture;
-            }
+            err() << "Impossible to use texture \"" << m_parameters[handle].name << "\" for shader: all available texture units are used" << std::endl;
+            return;
         }
+
+        m_textures[location] = &texture;
+    }
+    else
+    {
+        // Location already used, just replace the texture
+        it->second = &texture;
     }
 }
 
 
 ////////////////////////////////////////////////////////////
-void Shader::setParameter(const std::string& name, CurrentTextureType)
+void Shader::setParameter(ParameterHandle handle, CurrentTextureType)
 {
-    if (m_shaderProgram)
+    if ((handle < 0) || (static_cast<std::size_t>(handle) >= m_parameters.size()))
+        return;
+
+    m_currentTexture = m_parameters[handle].location;
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameterArray(ParameterHandle handle, const float* values, std::size_t length)
+{
+    setParameterValues(handle, values, length, 1);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameterArray(ParameterHandle handle, const Vector2f* vectors, std::size_t length)
+{
+    // Vector2f is two packed floats, like a vec2
+    if (vectors)
+        setParameterValues(handle, &vectors[0].x, length, 2);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameterArray(ParameterHandle handle, const Vector3f* vectors, std::size_t length)
+{
+    // Vector3f is three packed floats, like a vec3
+    if (vectors)
+        setParameterValues(handle, &vectors[0].x, length, 3);
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameterArray(ParameterHandle handle, const sf::Transform* transforms, std::size_t length)
+{
+    if ((handle < 0) || (static_cast<std::size_t>(handle) >= m_parameters.size()) || !transforms || (length == 0))
+        return;
+
+    // Transforms are not packed, copy their matrices one after the other
+    Parameter& parameter = m_parameters[handle];
+    parameter.components = 16;
+    parameter.values.resize(length * 16);
+    for (std::size_t i = 0; i < length; ++i)
+        std::memcpy(&parameter.values[i * 16], transforms[i].getMatrix(), 16 * sizeof(float));
+
+    if (!parameter.dirty)
+    {
+        parameter.dirty = true;
+        m_dirtyParameters.push_back(handle);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+Shader::BlockHandle Shader::getBlockHandle(const std::string& name)
+{
+    if (!m_shaderProgram)
+        return -1;
+
+    // Shaders only have a few blocks, a linear search is enough
+    for (std::size_t i = 0; i < m_blocks.size(); ++i)
     {
-        ensureGlContext();
+        if (m_blocks[i].name == name)
+            return static_cast<BlockHandle>(i);
+    }
 
-        // Find the location of the variable in the shader
-        m_currentTexture = getParamLocation(name);
+    if (!isUniformBlockAvailable())
+    {
+        err() << "Failed to use uniform block \"" << name << "\": your system doesn't support uniform buffers "
+              << "(you should test Shader::isUniformBlockAvailable() before using uniform blocks)" << std::endl;
+        return -1;
     }
+
+    GLuint index = glGetUniformBlockIndex(m_shaderProgram, name.c_str());
+    if (index == GL_INVALID_INDEX)
+    {
+        err() << "Uniform block \"" << name << "\" not found in shader" << std::endl;
+        return -1;
+    }
+
+    // Each block gets the binding point matching its handle,
+    // its buffer is attached to it whenever the shader is bound
+    BlockHandle handle = static_cast<BlockHandle>(m_blocks.size());
+    glCheck(glUniformBlockBinding(m_shaderProgram, index, handle));
+
+    Block block;
+    block.name = name;
+    block.buffer = 0;
+    block.dirty = false;
+    m_blocks.push_back(block);
+
+    return handle;
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setBlockData(BlockHandle handle, const void* data, std::size_t size)
+{
+    if ((handle < 0) || (static_cast<std::size_t>(handle) >= m_blocks.size()) || !data)
+        return;
+
+    const Uint8* bytes = static_cast<const Uint8*>(data);
+    m_blocks[handle].data.assign(bytes, bytes + size);
+    m_blocks[handle].dirty = true;
 }
 
 
@@ -407,6 +558,9 @@ void Shader::bind(const Shader* shader)
         // Enable the program
         glCheck(glUseProgramObjectARB(shader->m_shaderProgram));
 
+        // Send the parameters that changed since the last draw
+        shader->flushParameters();
+
         // Bind the textures
         shader->bindTextures();
 
@@ -437,6 +591,13 @@ bool Shader::isAvailable()
 }
 
 
+////////////////////////////////////////////////////////////
+bool Shader::isUniformBlockAvailable()
+{
+    return isAvailable() && GLEW_ARB_uniform_buffer_object;
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Shader::compile(const char* vertexShaderCode, const char* fragmentShaderCode)
 {
@@ -458,6 +619,9 @@ bool Shader::compile(const char* vertexShaderCode, const char* fragmentShaderCod
     m_currentTexture = -1;
     m_textures.clear();
     m_params.clear();
+    m_parameters.clear();
+    m_dirtyParameters.clear();
+    destroyBlocks();
 
     // Create the program
     m_shaderProgram = glCreateProgramObjectARB();
@@ -562,32 +726,84 @@ void Shader::bindTextures() const
 
 
 ////////////////////////////////////////////////////////////
-int Shader::getParamLocation(const std::string& name)
+void Shader::flushParameters() const
 {
-    // Check the cache
-    ParamTable::const_iterator it = m_params.find(name);
-    if (it != m_params.end())
+    for (std::vector<int>::const_iterator it = m_dirtyParameters.begin(); it != m_dirtyParameters.end(); ++it)
     {
-        // Already in cache, return it
-        return it->second;
+        Parameter& parameter = m_parameters[*it];
+        const GLfloat* values = &parameter.values[0];
+        GLsizei length = static_cast<GLsizei>(parameter.values.size() / parameter.components);
+
+        switch (parameter.components)
+        {
+            case 1 :  glCheck(glUniform1fvARB(parameter.location, length, values)); break;
+            case 2 :  glCheck(glUniform2fvARB(parameter.location, length, values)); break;
+            case 3 :  glCheck(glUniform3fvARB(parameter.location, length, values)); break;
+            case 4 :  glCheck(glUniform4fvARB(parameter.location, length, values)); break;
+            case 16 : glCheck(glUniformMatrix4fvARB(parameter.location, length, GL_FALSE, values)); break;
+        }
+
+        parameter.dirty = false;
     }
-    else
+    m_dirtyParameters.clear();
+
+    // Upload the modified uniform blocks, and attach all of them to their binding point
+    for (std::size_t i = 0; i < m_blocks.size(); ++i)
     {
-        // Not in cache, request the location from OpenGL
-        int location = glGetUniformLocationARB(m_shaderProgram, name.c_str());
-        if (location != -1)
+        Block& block = m_blocks[i];
+        if (block.dirty)
         {
-            // Location found: add it to the cache
-            m_params.insert(std::make_pair(name, location));
+            if (!block.buffer)
+            {
+                GLuint buffer;
+                glCheck(glGenBuffers(1, &buffer));
+                block.buffer = static_cast<unsigned int>(buffer);
+            }
+
+            glCheck(glBindBuffer(GL_UNIFORM_BUFFER, block.buffer));
+            glCheck(glBufferData(GL_UNIFORM_BUFFER, block.data.size(), block.data.empty() ? NULL : &block.data[0], GL_DYNAMIC_DRAW));
+            block.dirty = false;
         }
-        else
+
+        if (block.buffer)
+            glCheck(glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(i), block.buffer));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::setParameterValues(ParameterHandle handle, const float* values, std::size_t length, unsigned int components)
+{
+    // Empty arrays can't be sent to OpenGL, ignore them
+    if ((handle < 0) || (static_cast<std::size_t>(handle) >= m_parameters.size()) || !values || (length == 0))
+        return;
+
+    // Just store the value, it is sent when the shader is bound for the next draw
+    Parameter& parameter = m_parameters[handle];
+    parameter.components = components;
+    parameter.values.assign(values, values + length * components);
+
+    if (!parameter.dirty)
+    {
+        parameter.dirty = true;
+        m_dirtyParameters.push_back(handle);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void Shader::destroyBlocks()
+{
+    for (std::vector<Block>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    {
+        if (it->buffer)
         {
-            // Error: location not found
-            err() << "Parameter \"" << name << "\" not found in shader" << std::endl;
+            GLuint buffer = static_cast<GLuint>(it->buffer);
+            glCheck(glDeleteBuffers(1, &buffer));
         }
-
-        return location;
     }
+
+    m_blocks.clear();
 }
 
 } // namespace sf
@@ -77,8 +77,13 @@ void Sprite::setTextureRect(const IntRect& rectangle)
 {
     if (rectangle != m_textureRect)
     {
+        // Animations usually only move the rectangle, in which
+        // case the geometry of the sprite stays the same
+        bool resized = (rectangle.width != m_textureRect.width) || (rectangle.height != m_textureRect.height);
+
         m_textureRect = rectangle;
-        updatePositions();
+        if (resized)
+            updatePositions();
         updateTexCoords();
     }
 }
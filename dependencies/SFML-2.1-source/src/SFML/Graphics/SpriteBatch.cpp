@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/SpriteBatch.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+SpriteBatch::SpriteBatch() :
+m_vertices   (),
+m_vertexCount(0),
+m_runs       ()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::clear()
+{
+    // Keep the vertices, they are overwritten when the batch is refilled
+    m_vertexCount = 0;
+    m_runs.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::reserve(std::size_t spriteCount)
+{
+    if (m_vertices.size() < spriteCount * 4)
+        m_vertices.resize(spriteCount * 4);
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::add(const Sprite& sprite)
+{
+    if (!sprite.m_texture)
+        return;
+
+    // Start a new draw call if the texture changes
+    if (m_runs.empty() || (m_runs.back().texture != sprite.m_texture))
+    {
+        Run run;
+        run.texture = sprite.m_texture;
+        run.first = m_vertexCount;
+        m_runs.push_back(run);
+    }
+
+    // The local quad is (0, 0) (0, h) (w, h) (w, 0), so each corner is the
+    // translation plus a combination of the two scaled axes of the transform:
+    // 4 multiplications instead of a full point transform per corner
+    const float* matrix = sprite.getTransform().getMatrix();
+    const Vertex* local = sprite.m_vertices;
+    float width  = local[2].position.x;
+    float height = local[2].position.y;
+
+    float x = matrix[12];
+    float y = matrix[13];
+    float widthX  = matrix[0] * width;
+    float widthY  = matrix[1] * width;
+    float heightX = matrix[4] * height;
+    float heightY = matrix[5] * height;
+
+    if (m_vertexCount + 4 > m_vertices.size())
+        m_vertices.resize(m_vertices.size() * 2 + 4);
+    Vertex* quad = &m_vertices[m_vertexCount];
+    m_vertexCount += 4;
+
+    quad[0].position.x = x;
+    quad[0].position.y = y;
+    quad[1].position.x = x + heightX;
+    quad[1].position.y = y + heightY;
+    quad[2].position.x = x + heightX + widthX;
+    quad[2].position.y = y + heightY + widthY;
+    quad[3].position.x = x + widthX;
+    quad[3].position.y = y + widthY;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        quad[i].color = local[i].color;
+        quad[i].texCoords = local[i].texCoords;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SpriteBatch::getSpriteCount() const
+{
+    return m_vertexCount / 4;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SpriteBatch::getDrawCallCount() const
+{
+    return m_runs.size();
+}
+
+
+////////////////////////////////////////////////////////////
+void SpriteBatch::draw(RenderTarget& target, RenderStates states) const
+{
+    for (std::size_t i = 0; i < m_runs.size(); ++i)
+    {
+        std::size_t first = m_runs[i].first;
+        std::size_t end = (i + 1 < m_runs.size()) ? m_runs[i + 1].first : m_vertexCount;
+
+        states.texture = m_runs[i].texture;
+        target.draw(&m_vertices[first], static_cast<unsigned int>(end - first), Quads, states);
+    }
+}
+
+} // namespace sf
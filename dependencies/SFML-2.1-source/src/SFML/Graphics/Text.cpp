@@ -27,10 +27,57 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Shader.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/TextLayoutCache.hpp>
+#include <algorithm>
 #include <cassert>
 
 
+namespace
+{
+    // Get the shader that draws the glyphs of distance field fonts: the alpha
+    // channel holds the distance to the outline, which is turned back into
+    // an antialiased edge as wide as a screen pixel, whatever the scale
+    const sf::Shader* getDistanceFieldShader()
+    {
+        static const char* source =
+            "uniform sampler2D texture;"
+            "void main()"
+            "{"
+            "    float distance = texture2D(texture, gl_TexCoord[0].xy).a;"
+            "    float width = 0.7 * fwidth(distance);"
+            "    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);"
+            "    gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * alpha);"
+            "}";
+
+        // The shader is created once and never destroyed, as it may be
+        // used until the very last text is drawn
+        static sf::Shader* shader = NULL;
+        static bool initialized = false;
+        if (!initialized)
+        {
+            initialized = true;
+            if (sf::Shader::isAvailable())
+            {
+                shader = new sf::Shader;
+                if (shader->loadFromMemory(source, sf::Shader::Fragment))
+                {
+                    shader->setParameter("texture", sf::Shader::CurrentTexture);
+                }
+                else
+                {
+                    delete shader;
+                    shader = NULL;
+                }
+            }
+        }
+
+        return shader;
+    }
+}
+
+
 namespace sf
 {
 ////////////////////////////////////////////////////////////
@@ -41,7 +88,8 @@ m_characterSize(30),
 m_style        (Regular),
 m_color        (255, 255, 255),
 m_vertices     (Quads),
-m_bounds       ()
+m_bounds       (),
+m_cursors      ()
 {
 
 }
@@ -55,7 +103,8 @@ m_characterSize(characterSize),
 m_style        (Regular),
 m_color        (255, 255, 255),
 m_vertices     (Quads),
-m_bounds       ()
+m_bounds       (),
+m_cursors      ()
 {
     updateGeometry();
 }
@@ -64,8 +113,18 @@ m_bounds       ()
 ////////////////////////////////////////////////////////////
 void Text::setString(const String& string)
 {
+    // Find the first character that changed
+    std::size_t size = std::min(m_string.getSize(), string.getSize());
+    std::size_t first = 0;
+    while ((first < size) && (m_string[first] == string[first]))
+        ++first;
+
+    // Nothing to do if the string is the same
+    if ((first == size) && (m_string.getSize() == string.getSize()))
+        return;
+
     m_string = string;
-    updateGeometry();
+    updateGeometry(first);
 }
 
 
@@ -217,25 +276,43 @@ void Text::draw(RenderTarget& target, RenderStates states) const
     {
         states.transform *= getTransform();
         states.texture = &m_font->getTexture(m_characterSize);
+
+        // Distance field glyphs need a shader to look sharp; without
+        // shader support they are still readable, only blurry
+        if (m_font->isDistanceField() && !states.shader)
+            states.shader = getDistanceFieldShader();
+
         target.draw(m_vertices, states);
     }
 }
 
 
 ////////////////////////////////////////////////////////////
-void Text::updateGeometry()
+void Text::updateGeometry(std::size_t first)
 {
-    // Clear the previous geometry
-    m_vertices.clear();
-    m_bounds = FloatRect();
-
     // No font: nothing to draw
     if (!m_font)
+    {
+        m_vertices.clear();
+        m_bounds = FloatRect();
+        m_cursors.clear();
         return;
+    }
 
-    // No text: nothing to draw
-    if (m_string.isEmpty())
+    // The layout can only be resumed if the state before the first changed character is known
+    if (first >= m_cursors.size())
+        first = 0;
+
+    // The whole text changed: look for an identical one in the cache
+    if ((first == 0) && !m_string.isEmpty() && priv::TextLayoutCache::load(*this))
+    {
+        for (unsigned int i = 0; i < m_vertices.getVertexCount(); ++i)
+            m_vertices[i].color = m_color;
+
+        // The per-character state is not cached, the next update will start over
+        m_cursors.clear();
         return;
+    }
 
     // Compute values related to the text style
     bool  bold               = (m_style & Bold) != 0;
@@ -247,14 +324,38 @@ void Text::updateGeometry()
     // Precompute the variables needed by the algorithm
     float hspace = static_cast<float>(m_font->getGlyph(L' ', m_characterSize, bold).advance);
     float vspace = static_cast<float>(m_font->getLineSpacing(m_characterSize));
-    float x      = 0.f;
-    float y      = static_cast<float>(m_characterSize);
+
+    // Restore the layout state before the first changed character,
+    // and remove the geometry that follows it
+    Cursor cursor;
+    if (first > 0)
+    {
+        cursor = m_cursors[first];
+    }
+    else
+    {
+        cursor.x           = 0.f;
+        cursor.y           = static_cast<float>(m_characterSize);
+        cursor.minY        = static_cast<float>(m_characterSize);
+        cursor.width       = 0.f;
+        cursor.prevChar    = 0;
+        cursor.vertexCount = 0;
+    }
+    m_cursors.resize(first);
+    m_vertices.resize(cursor.vertexCount);
+
+    float&  x        = cursor.x;
+    float&  y        = cursor.y;
+    float&  minY     = cursor.minY;
+    Uint32& prevChar = cursor.prevChar;
 
     // Create one quad for each character
-    float minY = static_cast<float>(m_characterSize);
-    Uint32 prevChar = 0;
-    for (std::size_t i = 0; i < m_string.getSize(); ++i)
+    for (std::size_t i = first; i < m_string.getSize(); ++i)
     {
+        // Remember the state, so that the layout can be resumed from here
+        cursor.vertexCount = m_vertices.getVertexCount();
+        m_cursors.push_back(cursor);
+
         Uint32 curChar = m_string[i];
 
         // Apply the kerning offset
@@ -285,8 +386,8 @@ void Text::updateGeometry()
                 continue;
 
             case L'\n' :
-                if (x > m_bounds.width)
-                    m_bounds.width = x;
+                if (x > cursor.width)
+                    cursor.width = x;
                 y += vspace;
                 x = 0;
                 continue;
@@ -323,6 +424,17 @@ void Text::updateGeometry()
             minY = y + top;
     }
 
+    // Remember the final state, for appending characters
+    cursor.vertexCount = m_vertices.getVertexCount();
+    m_cursors.push_back(cursor);
+
+    // No text: nothing to draw
+    if (m_string.isEmpty())
+    {
+        m_bounds = FloatRect();
+        return;
+    }
+
     // If we're using the underlined style, add the last line
     if (underlined)
     {
@@ -338,9 +450,12 @@ void Text::updateGeometry()
     // Update the bounding rectangle
     m_bounds.left = 0;
     m_bounds.top = minY;
-    if (x > m_bounds.width)
-        m_bounds.width = x;
+    m_bounds.width = (x > cursor.width) ? x : cursor.width;
     m_bounds.height = y - minY;
+
+    // Share the geometry with the identical texts
+    if (first == 0)
+        priv::TextLayoutCache::store(*this);
 }
 
 } // namespace sf
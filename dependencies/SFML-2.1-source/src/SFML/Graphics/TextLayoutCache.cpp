@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/TextLayoutCache.hpp>
+#include <SFML/System/SharedMutex.hpp>
+#include <SFML/System/SharedLock.hpp>
+#include <map>
+
+
+namespace
+{
+    // Maximum number of texts in the cache; it is simply emptied when full,
+    // as texts that are worth caching are laid out again soon after
+    const std::size_t maxEntries = 256;
+
+    // Identifies a layout (the string itself is compared separately)
+    struct Key
+    {
+        sf::Uint32      hash;
+        const sf::Font* font;
+        unsigned int    characterSize;
+        sf::Uint32      style;
+
+        bool operator <(const Key& right) const
+        {
+            if (hash != right.hash)
+                return hash < right.hash;
+            if (font != right.font)
+                return font < right.font;
+            if (characterSize != right.characterSize)
+                return characterSize < right.characterSize;
+            return style < right.style;
+        }
+    };
+
+    // Geometry of a text
+    struct Entry
+    {
+        sf::String      string;
+        sf::VertexArray vertices;
+        sf::FloatRect   bounds;
+    };
+
+    typedef std::multimap<Key, Entry> EntryTable;
+
+    // The cache is never destroyed, as fonts may still
+    // remove their entries during static destruction
+    EntryTable& getEntries()
+    {
+        static EntryTable* entries = new EntryTable;
+        return *entries;
+    }
+    sf::SharedMutex& getMutex()
+    {
+        static sf::SharedMutex* mutex = new sf::SharedMutex;
+        return *mutex;
+    }
+
+    // Hash a string (FNV-1a over its code points)
+    sf::Uint32 hashString(const sf::String& string)
+    {
+        sf::Uint32 hash = 2166136261u;
+        for (sf::String::ConstIterator it = string.begin(); it != string.end(); ++it)
+        {
+            hash ^= *it;
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+bool TextLayoutCache::load(Text& text)
+{
+    Key key = {hashString(text.m_string), text.m_font, text.m_characterSize, text.m_style};
+
+    SharedLock lock(getMutex());
+    EntryTable& entries = getEntries();
+
+    std::pair<EntryTable::const_iterator, EntryTable::const_iterator> range = entries.equal_range(key);
+    for (EntryTable::const_iterator it = range.first; it != range.second; ++it)
+    {
+        if (it->second.string == text.m_string)
+        {
+            text.m_vertices = it->second.vertices;
+            text.m_bounds = it->second.bounds;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayoutCache::store(const Text& text)
+{
+    Key key = {hashString(text.m_string), text.m_font, text.m_characterSize, text.m_style};
+
+    SharedLock lock(getMutex(), SharedLock::Exclusive);
+    EntryTable& entries = getEntries();
+
+    // Don't store the same layout twice
+    std::pair<EntryTable::const_iterator, EntryTable::const_iterator> range = entries.equal_range(key);
+    for (EntryTable::const_iterator it = range.first; it != range.second; ++it)
+    {
+        if (it->second.string == text.m_string)
+            return;
+    }
+
+    if (entries.size() >= maxEntries)
+        entries.clear();
+
+    EntryTable::iterator it = entries.insert(std::make_pair(key, Entry()));
+    it->second.string = text.m_string;
+    it->second.vertices = text.m_vertices;
+    it->second.bounds = text.m_bounds;
+}
+
+
+////////////////////////////////////////////////////////////
+void TextLayoutCache::removeFont(const Font& font)
+{
+    SharedLock lock(getMutex(), SharedLock::Exclusive);
+    EntryTable& entries = getEntries();
+
+    for (EntryTable::iterator it = entries.begin(); it != entries.end(); )
+    {
+        if (it->first.font == &font)
+            entries.erase(it++);
+        else
+            ++it;
+    }
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_TEXTLAYOUTCACHE_HPP
+#define SFML_TEXTLAYOUTCACHE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Text.hpp>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Process-wide cache of the geometry of texts
+///
+/// Many texts display the same string with the same font,
+/// size and style (labels, menu entries, ...). The cache
+/// keeps the geometry computed for one of them, so that
+/// the others copy it instead of laying out the string again.
+///
+////////////////////////////////////////////////////////////
+class TextLayoutCache
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the cached geometry of a text's string, if any
+    ///
+    /// The string, font, character size and style of \a text
+    /// are used to find the geometry. Vertices are returned with
+    /// the color of the text that stored them.
+    ///
+    /// \param text Text to fill
+    ///
+    /// \return True if the geometry was found in the cache
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool load(Text& text);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Store the geometry of a text in the cache
+    ///
+    /// \param text Text whose geometry is up to date
+    ///
+    ////////////////////////////////////////////////////////////
+    static void store(const Text& text);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the geometry computed with a font
+    ///
+    /// This must be called whenever the glyphs of a font
+    /// change, or when it is destroyed.
+    ///
+    /// \param font Font whose entries must be removed
+    ///
+    ////////////////////////////////////////////////////////////
+    static void removeFont(const Font& font);
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_TEXTLAYOUTCACHE_HPP
@@ -27,14 +27,27 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/ImageLoader.hpp>
 #include <SFML/Graphics/GLCheck.hpp>
 #include <SFML/Graphics/TextureSaver.hpp>
 #include <SFML/Window/Window.hpp>
 #include <SFML/System/Mutex.hpp>
 #include <SFML/System/Lock.hpp>
 #include <SFML/System/Err.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <fstream>
+#include <vector>
+
+
+// ETC2 formats are core in OpenGL 4.3 but too recent for our GLEW headers
+#ifndef GL_COMPRESSED_RGB8_ETC2
+    #define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+    #define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
 
 
 namespace
@@ -44,11 +57,76 @@ namespace
     sf::Uint64 getUniqueId()
     {
         static sf::Uint64 id = 1; // start at 1, zero is "no texture"
-        static sf::Mutex mutex;
+        static sf::Mutex mutex(sf::Mutex::NonRecursive);
 
         sf::Lock lock(mutex);
         return id++;
     }
+
+    // Get the OpenGL internal format of a compression format
+    GLenum getCompressedFormatId(sf::Texture::CompressedFormat format)
+    {
+        switch (format)
+        {
+            case sf::Texture::Dxt1 :     return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            case sf::Texture::Dxt5 :     return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case sf::Texture::Etc2Rgb :  return GL_COMPRESSED_RGB8_ETC2;
+            case sf::Texture::Etc2Rgba : return GL_COMPRESSED_RGBA8_ETC2_EAC;
+            default :                    return 0;
+        }
+    }
+
+    // Check whether the driver can sample textures of the given internal format
+    bool isCompressedFormatIdAvailable(GLenum format)
+    {
+        // glCompressedTexImage2D is only available since OpenGL 1.3
+        sf::priv::ensureGlewInit();
+        if (!GLEW_VERSION_1_3)
+            return false;
+
+        // Look for the format in the list advertised by the driver
+        GLint count = 0;
+        glCheck(glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count));
+        if (count <= 0)
+            return false;
+
+        std::vector<GLint> formats(count);
+        glCheck(glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, &formats[0]));
+
+        for (std::vector<GLint>::const_iterator it = formats.begin(); it != formats.end(); ++it)
+        {
+            if (static_cast<GLenum>(*it) == format)
+                return true;
+        }
+
+        return false;
+    }
+
+    // Halve an RGBA image with a 2x2 box filter. Only the top-left
+    // validWidth x validHeight texels are read, the padding beyond them
+    // is replaced by the nearest valid texel; a texel on the last valid
+    // row or column of an odd sized region is averaged with itself
+    void downsample(const std::vector<sf::Uint8>& source, unsigned int width, unsigned int validWidth, unsigned int validHeight,
+                    std::vector<sf::Uint8>& target, unsigned int targetWidth, unsigned int targetHeight)
+    {
+        target.resize(targetWidth * targetHeight * 4);
+
+        sf::Uint8* out = &target[0];
+        for (unsigned int y = 0; y < targetHeight; ++y)
+        {
+            const sf::Uint8* row0 = &source[std::min(2 * y, validHeight - 1) * width * 4];
+            const sf::Uint8* row1 = &source[std::min(2 * y + 1, validHeight - 1) * width * 4];
+
+            for (unsigned int x = 0; x < targetWidth; ++x)
+            {
+                unsigned int x0 = std::min(2 * x, validWidth - 1) * 4;
+                unsigned int x1 = std::min(2 * x + 1, validWidth - 1) * 4;
+
+                for (unsigned int i = 0; i < 4; ++i)
+                    *out++ = static_cast<sf::Uint8>((row0[x0 + i] + row0[x1 + i] + row1[x0 + i] + row1[x1 + i] + 2) / 4);
+            }
+        }
+    }
 }
 
 
@@ -62,6 +140,8 @@ m_texture      (0),
 m_isSmooth     (false),
 m_isRepeated   (false),
 m_pixelsFlipped(false),
+m_isCompressed (false),
+m_hasMipmap    (false),
 m_cacheId      (getUniqueId())
 {
 
@@ -76,10 +156,17 @@ m_texture      (0),
 m_isSmooth     (copy.m_isSmooth),
 m_isRepeated   (copy.m_isRepeated),
 m_pixelsFlipped(false),
+m_isCompressed (false),
+m_hasMipmap    (false),
 m_cacheId      (getUniqueId())
 {
     if (copy.m_texture)
+    {
         loadFromImage(copy.copyToImage());
+
+        if (copy.m_hasMipmap)
+            generateMipmap();
+    }
 }
 
 
@@ -126,6 +213,8 @@ bool Texture::create(unsigned int width, unsigned int height)
     m_size.y        = height;
     m_actualSize    = actualSize;
     m_pixelsFlipped = false;
+    m_isCompressed  = false;
+    m_hasMipmap     = false;
 
     ensureGlContext();
 
@@ -143,10 +232,11 @@ bool Texture::create(unsigned int width, unsigned int height)
     // Initialize the texture
     glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
     glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_actualSize.x, m_actualSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
-    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+    applyMinFilter();
     m_cacheId = getUniqueId();
 
     return true;
@@ -244,6 +334,114 @@ bool Texture::loadFromImage(const Image& image, const IntRect& area)
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::loadFromCompressedFile(const std::string& filename)
+{
+    // Read the whole file, its blocks are uploaded as they are
+    std::ifstream file(filename.c_str(), std::ios_base::binary);
+    if (!file)
+    {
+        err() << "Failed to load compressed texture \"" << filename << "\". Reason : can't open file" << std::endl;
+        return false;
+    }
+
+    file.seekg(0, std::ios_base::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios_base::beg);
+
+    std::vector<char> data(size > 0 ? static_cast<std::size_t>(size) : 0);
+    if (data.empty() || !file.read(&data[0], data.size()))
+    {
+        err() << "Failed to load compressed texture \"" << filename << "\". Reason : can't read file" << std::endl;
+        return false;
+    }
+
+    return loadFromCompressedMemory(&data[0], data.size());
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::loadFromCompressedMemory(const void* data, std::size_t size)
+{
+    priv::CompressedPixels pixels;
+    if (!priv::ImageLoader::getInstance().loadCompressedImageFromMemory(data, size, pixels))
+        return false;
+
+    ensureGlContext();
+
+    if (!isCompressedFormatIdAvailable(pixels.format))
+    {
+        err() << "Failed to create compressed texture, format 0x" << std::hex << pixels.format << std::dec
+              << " is not supported by the graphics driver" << std::endl;
+        return false;
+    }
+
+    // Blocks can't be padded, so the size must be valid as it is
+    if ((getValidSize(pixels.size.x) != pixels.size.x) || (getValidSize(pixels.size.y) != pixels.size.y))
+    {
+        err() << "Failed to create compressed texture, its size (" << pixels.size.x << "x" << pixels.size.y
+              << ") is not a power of two" << std::endl;
+        return false;
+    }
+
+    // Check the maximum texture size
+    unsigned int maxSize = getMaximumSize();
+    if ((pixels.size.x > maxSize) || (pixels.size.y > maxSize))
+    {
+        err() << "Failed to create compressed texture, its size is too high "
+              << "(" << pixels.size.x << "x" << pixels.size.y << ", "
+              << "maximum is " << maxSize << "x" << maxSize << ")"
+              << std::endl;
+        return false;
+    }
+
+    // All the validity checks passed, we can store the new texture settings
+    m_size          = pixels.size;
+    m_actualSize    = pixels.size;
+    m_pixelsFlipped = false;
+    m_isCompressed  = true;
+    m_hasMipmap     = pixels.levels.size() > 1;
+
+    // Create the OpenGL texture if it doesn't exist yet
+    if (!m_texture)
+    {
+        GLuint texture;
+        glCheck(glGenTextures(1, &texture));
+        m_texture = static_cast<unsigned int>(texture);
+    }
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    // Upload the blocks of every level
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    unsigned int width = pixels.size.x;
+    unsigned int height = pixels.size.y;
+    for (std::size_t level = 0; level < pixels.levels.size(); ++level)
+    {
+        const std::vector<Uint8>& blocks = pixels.levels[level];
+        glCheck(glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), pixels.format, width, height, 0,
+                                       static_cast<GLsizei>(blocks.size()), &blocks[0]));
+
+        width  = width  > 1 ? width  / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(pixels.levels.size() - 1)));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_isRepeated ? GL_REPEAT : GL_CLAMP_TO_EDGE));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+    applyMinFilter();
+    m_cacheId = getUniqueId();
+
+    // Force an OpenGL flush, so that the texture will appear updated
+    // in all contexts immediately (solves problems in multi-threaded apps)
+    glCheck(glFlush());
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 Vector2u Texture::getSize() const
 {
@@ -251,6 +449,13 @@ Vector2u Texture::getSize() const
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::isCompressed() const
+{
+    return m_isCompressed;
+}
+
+
 ////////////////////////////////////////////////////////////
 Image Texture::copyToImage() const
 {
@@ -324,6 +529,12 @@ void Texture::update(const Uint8* pixels, unsigned int width, unsigned int heigh
     assert(x + width <= m_size.x);
     assert(y + height <= m_size.y);
 
+    if (m_isCompressed)
+    {
+        err() << "Failed to update texture, compressed textures can't be modified" << std::endl;
+        return;
+    }
+
     if (pixels && m_texture)
     {
         ensureGlContext();
@@ -334,6 +545,7 @@ void Texture::update(const Uint8* pixels, unsigned int width, unsigned int heigh
         // Copy pixels from the given array to the texture
         glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
         glCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+        invalidateMipmap();
         m_pixelsFlipped = false;
         m_cacheId = getUniqueId();
     }
@@ -368,6 +580,12 @@ void Texture::update(const Window& window, unsigned int x, unsigned int y)
     assert(x + window.getSize().x <= m_size.x);
     assert(y + window.getSize().y <= m_size.y);
 
+    if (m_isCompressed)
+    {
+        err() << "Failed to update texture, compressed textures can't be modified" << std::endl;
+        return;
+    }
+
     if (m_texture && window.setActive(true))
     {
         // Make sure that the current texture binding will be preserved
@@ -376,12 +594,77 @@ void Texture::update(const Window& window, unsigned int x, unsigned int y)
         // Copy pixels from the back-buffer to the texture
         glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
         glCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, window.getSize().x, window.getSize().y));
+        invalidateMipmap();
         m_pixelsFlipped = true;
         m_cacheId = getUniqueId();
     }
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::update(const Texture& texture)
+{
+    update(texture, 0, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::update(const Texture& texture, unsigned int x, unsigned int y)
+{
+    assert(x + texture.m_size.x <= m_size.x);
+    assert(y + texture.m_size.y <= m_size.y);
+
+    if (!m_texture || !texture.m_texture)
+        return;
+
+    if (m_isCompressed || texture.m_isCompressed)
+    {
+        err() << "Failed to update texture, compressed textures can't be copied" << std::endl;
+        return;
+    }
+
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    bool copied = false;
+    if (GLEW_EXT_framebuffer_object && !texture.m_pixelsFlipped)
+    {
+        // Attach the source texture to a temporary frame buffer, and copy it from there
+        GLint previousFrameBuffer = 0;
+        glCheck(glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &previousFrameBuffer));
+
+        GLuint frameBuffer = 0;
+        glCheck(glGenFramebuffersEXT(1, &frameBuffer));
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, frameBuffer));
+        glCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, texture.m_texture, 0));
+
+        GLenum status;
+        glCheck(status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT));
+        if (status == GL_FRAMEBUFFER_COMPLETE_EXT)
+        {
+            // Make sure that the current texture binding will be preserved
+            priv::TextureSaver save;
+
+            glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+            glCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 0, 0, texture.m_size.x, texture.m_size.y));
+            invalidateMipmap();
+            m_pixelsFlipped = false;
+            m_cacheId = getUniqueId();
+            copied = true;
+        }
+
+        glCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, static_cast<GLuint>(previousFrameBuffer)));
+        glCheck(glDeleteFramebuffersEXT(1, &frameBuffer));
+    }
+
+    // Fall back to a copy through system memory
+    if (!copied)
+        update(texture.copyToImage(), x, y);
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::setSmooth(bool smooth)
 {
@@ -398,7 +681,7 @@ void Texture::setSmooth(bool smooth)
 
             glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
             glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
-            glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_isSmooth ? GL_LINEAR : GL_NEAREST));
+            applyMinFilter();
         }
     }
 }
@@ -440,6 +723,86 @@ bool Texture::isRepeated() const
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::generateMipmap()
+{
+    if (!m_texture)
+        return false;
+
+    if (m_isCompressed)
+    {
+        // Compressed levels can't be rendered to, they come from the file
+        if (m_hasMipmap)
+            return true;
+
+        err() << "Failed to generate mipmap, compressed textures must be loaded with their mipmap levels" << std::endl;
+        return false;
+    }
+
+    ensureGlContext();
+
+    // Make sure that GLEW is initialized
+    priv::ensureGlewInit();
+
+    // Number of levels below the base level, down to 1x1
+    unsigned int maxLevel = 0;
+    for (unsigned int size = std::max(m_actualSize.x, m_actualSize.y); size > 1; size /= 2)
+        ++maxLevel;
+
+    // Make sure that the current texture binding will be preserved
+    priv::TextureSaver save;
+
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_texture));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(maxLevel)));
+
+    if (GLEW_EXT_framebuffer_object)
+    {
+        // Let the driver filter the levels
+        glCheck(glGenerateMipmapEXT(GL_TEXTURE_2D));
+    }
+    else
+    {
+        // Read the base level back and filter each level from the previous one.
+        // The levels keep the padded size, but are filtered from the texels
+        // covering m_size only so that the padding doesn't bleed into the edges
+        unsigned int width = m_actualSize.x;
+        unsigned int height = m_actualSize.y;
+        unsigned int validWidth = m_size.x;
+        unsigned int validHeight = m_size.y;
+        std::vector<Uint8> pixels(width * height * 4);
+        std::vector<Uint8> level;
+        glCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]));
+
+        for (unsigned int i = 1; i <= maxLevel; ++i)
+        {
+            unsigned int levelWidth  = width  > 1 ? width  / 2 : 1;
+            unsigned int levelHeight = height > 1 ? height / 2 : 1;
+
+            downsample(pixels, width, validWidth, validHeight, level, levelWidth, levelHeight);
+            glCheck(glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA8, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, &level[0]));
+
+            pixels.swap(level);
+            width = levelWidth;
+            height = levelHeight;
+            validWidth = std::min((validWidth + 1) / 2, width);
+            validHeight = std::min((validHeight + 1) / 2, height);
+        }
+    }
+
+    m_hasMipmap = true;
+    applyMinFilter();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Texture::hasMipmap() const
+{
+    return m_hasMipmap;
+}
+
+
 ////////////////////////////////////////////////////////////
 void Texture::bind(const Texture* texture, CoordinateType coordinateType)
 {
@@ -501,23 +864,44 @@ unsigned int Texture::getMaximumSize()
 }
 
 
+////////////////////////////////////////////////////////////
+bool Texture::isCompressedFormatAvailable(CompressedFormat format)
+{
+    ensureGlContext();
+
+    return isCompressedFormatIdAvailable(getCompressedFormatId(format));
+}
+
+
 ////////////////////////////////////////////////////////////
 Texture& Texture::operator =(const Texture& right)
 {
     Texture temp(right);
 
-    std::swap(m_size,          temp.m_size);
-    std::swap(m_actualSize,    temp.m_actualSize);
-    std::swap(m_texture,       temp.m_texture);
-    std::swap(m_isSmooth,      temp.m_isSmooth);
-    std::swap(m_isRepeated,    temp.m_isRepeated);
-    std::swap(m_pixelsFlipped, temp.m_pixelsFlipped);
-    m_cacheId = getUniqueId();
+    swap(temp);
 
     return *this;
 }
 
 
+////////////////////////////////////////////////////////////
+void Texture::swap(Texture& right)
+{
+    std::swap(m_size,          right.m_size);
+    std::swap(m_actualSize,    right.m_actualSize);
+    std::swap(m_texture,       right.m_texture);
+    std::swap(m_isSmooth,      right.m_isSmooth);
+    std::swap(m_isRepeated,    right.m_isRepeated);
+    std::swap(m_pixelsFlipped, right.m_pixelsFlipped);
+    std::swap(m_isCompressed,  right.m_isCompressed);
+    std::swap(m_hasMipmap,     right.m_hasMipmap);
+
+    // Both textures now hold different pixels than before
+    m_cacheId = getUniqueId();
+    right.m_cacheId = getUniqueId();
+}
+
+
 ////////////////////////////////////////////////////////////
 unsigned int Texture::getValidSize(unsigned int size)
 {
@@ -542,4 +926,30 @@ unsigned int Texture::getValidSize(unsigned int size)
     }
 }
 
+
+////////////////////////////////////////////////////////////
+void Texture::applyMinFilter() const
+{
+    GLint filter;
+    if (m_hasMipmap)
+        filter = m_isSmooth ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR;
+    else
+        filter = m_isSmooth ? GL_LINEAR : GL_NEAREST;
+
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter));
+}
+
+
+////////////////////////////////////////////////////////////
+void Texture::invalidateMipmap()
+{
+    if (!m_hasMipmap)
+        return;
+
+    // The levels still hold the old data, stop sampling them
+    m_hasMipmap = false;
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+    applyMinFilter();
+}
+
 } // namespace sf
@@ -39,6 +39,7 @@ m_rotation                  (0),
 m_scale                     (1, 1),
 m_transform                 (),
 m_transformNeedUpdate       (true),
+m_translationNeedUpdate     (true),
 m_inverseTransform          (),
 m_inverseTransformNeedUpdate(true)
 {
@@ -56,7 +57,7 @@ void Transformable::setPosition(float x, float y)
 {
     m_position.x = x;
     m_position.y = y;
-    m_transformNeedUpdate = true;
+    m_translationNeedUpdate = true;
     m_inverseTransformNeedUpdate = true;
 }
 
@@ -102,7 +103,7 @@ void Transformable::setOrigin(float x, float y)
 {
     m_origin.x = x;
     m_origin.y = y;
-    m_transformNeedUpdate = true;
+    m_translationNeedUpdate = true;
     m_inverseTransformNeedUpdate = true;
 }
 
@@ -183,9 +184,16 @@ const Transform& Transformable::getTransform() const
     // Recompute the combined transform if needed
     if (m_transformNeedUpdate)
     {
-        float angle  = -m_rotation * 3.141592654f / 180.f;
-        float cosine = static_cast<float>(std::cos(angle));
-        float sine   = static_cast<float>(std::sin(angle));
+        // Most objects are never rotated, don't pay for the trigonometry then
+        float cosine = 1.f;
+        float sine   = 0.f;
+        if (m_rotation != 0.f)
+        {
+            float angle = -m_rotation * 3.141592654f / 180.f;
+            cosine = static_cast<float>(std::cos(angle));
+            sine   = static_cast<float>(std::sin(angle));
+        }
+
         float sxc    = m_scale.x * cosine;
         float syc    = m_scale.y * cosine;
         float sxs    = m_scale.x * sine;
@@ -197,6 +205,20 @@ const Transform& Transformable::getTransform() const
                                 -sxs, syc, ty,
                                  0.f, 0.f, 1.f);
         m_transformNeedUpdate = false;
+        m_translationNeedUpdate = false;
+    }
+    else if (m_translationNeedUpdate)
+    {
+        // Only the position or the origin changed (typically, a moving
+        // object): the rotation/scale part of the matrix is still valid
+        const float* matrix = m_transform.getMatrix();
+        float tx = -m_origin.x * matrix[0] - m_origin.y * matrix[4] + m_position.x;
+        float ty = -m_origin.x * matrix[1] - m_origin.y * matrix[5] + m_position.y;
+
+        m_transform = Transform(matrix[0], matrix[4], tx,
+                                matrix[1], matrix[5], ty,
+                                0.f,       0.f,       1.f);
+        m_translationNeedUpdate = false;
     }
 
     return m_transform;
@@ -492,8 +492,15 @@ static stbi_uc *stbi_gif_load(stbi *s, int *x, int *y, int *comp, int req_comp);
 static int      stbi_gif_info(stbi *s, int *x, int *y, int *comp);
 
 
-// this is not threadsafe
-static const char *failure_reason;
+// one failure reason per thread, so that concurrent decodes don't race on it
+#if defined(_MSC_VER)
+   #define STBI_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+   #define STBI_THREAD_LOCAL __thread
+#else
+   #define STBI_THREAD_LOCAL
+#endif
+static STBI_THREAD_LOCAL const char *failure_reason;
 
 const char *stbi_failure_reason(void)
 {
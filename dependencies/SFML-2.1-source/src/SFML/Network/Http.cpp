@@ -26,9 +26,13 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Network/Http.hpp>
-#include <cctype>
+#include <SFML/Network/SocketImpl.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Err.hpp>
 #include <algorithm>
-#include <iterator>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
 #include <sstream>
 
 
@@ -41,17 +45,100 @@ namespace
             *i = static_cast<char>(std::tolower(*i));
         return str;
     }
+
+    // Remove the leading and trailing spaces of a string
+    std::string trim(const std::string& str)
+    {
+        std::string::size_type first = str.find_first_not_of(" \t");
+        if (first == std::string::npos)
+            return "";
+
+        std::string::size_type last = str.find_last_not_of(" \t");
+        return str.substr(first, last - first + 1);
+    }
+
+    // Check if the value of a field contains a token (case insensitive)
+    bool hasToken(const std::string& value, const std::string& token)
+    {
+        return toLower(value).find(token) != std::string::npos;
+    }
+
+    // Longest line accepted in the header of a response
+    const std::size_t maxLineSize = 64 * 1024;
+
+    // Callback used by sendRequest to get the response of its request
+    struct ResponseReceiver
+    {
+        ResponseReceiver(sf::Http::Response& response, bool& done) : m_response(&response), m_done(&done) {}
+        void operator ()(const sf::Http::Response& response) {*m_response = response; *m_done = true;}
+        sf::Http::Response* m_response;
+        bool*               m_done;
+    };
 }
 
 
 namespace sf
 {
+////////////////////////////////////////////////////////////
+struct Http::PendingRequest
+{
+    ////////////////////////////////////////////////////////////
+    enum Stage
+    {
+        StatusLine, ///< Waiting for the status line
+        Header,     ///< Reading the header fields
+        Body,       ///< Reading a body of known length
+        ChunkSize,  ///< Waiting for the size of the next chunk
+        ChunkData,  ///< Reading the data of a chunk
+        ChunkEnd,   ///< Waiting for the end of line that follows a chunk
+        Trailer,    ///< Reading the fields that follow the last chunk
+        UntilClose, ///< Reading a body that ends when the connection is closed
+        Complete    ///< The response is complete
+    };
+
+    ////////////////////////////////////////////////////////////
+    PendingRequest() :
+    idempotent(true),
+    hasBody   (true),
+    closes    (false),
+    callback  (NULL),
+    stage     (StatusLine),
+    remaining (0),
+    answered  (false),
+    retried   (false)
+    {
+    }
+
+    ////////////////////////////////////////////////////////////
+    ~PendingRequest()
+    {
+        delete callback;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::string         data;         ///< Request, ready to be sent
+    bool                idempotent;   ///< Can the request be pipelined and sent again?
+    bool                hasBody;      ///< Does the response have a body? (false for HEAD requests)
+    bool                closes;       ///< Does the request ask the server to close the connection?
+    std::string         responseFile; ///< File to write the body of the response to
+    priv::HttpCallback* callback;     ///< Function to call with the response
+    Response            response;     ///< Response being received
+    Stage               stage;        ///< Current parsing stage of the response
+    std::size_t         remaining;    ///< Bytes left in the body or in the current chunk
+    std::ofstream       file;         ///< Output file, when the body is written to a file
+    bool                answered;     ///< Has any data of the response been received?
+    bool                retried;      ///< Has the request already been sent again after a failure?
+};
+
+
 ////////////////////////////////////////////////////////////
 Http::Request::Request(const std::string& uri, Method method, const std::string& body)
 {
     setMethod(method);
     setUri(uri);
-    setHttpVersion(1, 0);
+    setHttpVersion(1, 1);
     setBody(body);
 }
 
@@ -96,6 +183,13 @@ void Http::Request::setBody(const std::string& body)
 }
 
 
+////////////////////////////////////////////////////////////
+void Http::Request::setResponseFile(const std::string& filename)
+{
+    m_responseFile = filename;
+}
+
+
 ////////////////////////////////////////////////////////////
 std::string Http::Request::prepare() const
 {
@@ -193,90 +287,48 @@ const std::string& Http::Response::getBody() const
 
 
 ////////////////////////////////////////////////////////////
-void Http::Response::parse(const std::string& data)
+Http::Http() :
+m_host         (),
+m_port         (0),
+m_state        (Disconnected),
+m_sentCount    (0),
+m_outputOffset (0),
+m_pipelineDepth(4)
 {
-    std::istringstream in(data);
-
-    // Extract the HTTP version from the first line
-    std::string version;
-    if (in >> version)
-    {
-        if ((version.size() >= 8) && (version[6] == '.') &&
-            (toLower(version.substr(0, 5)) == "http/")   &&
-             isdigit(version[5]) && isdigit(version[7]))
-        {
-            m_majorVersion = version[5] - '0';
-            m_minorVersion = version[7] - '0';
-        }
-        else
-        {
-            // Invalid HTTP version
-            m_status = InvalidResponse;
-            return;
-        }
-    }
-
-    // Extract the status code from the first line
-    int status;
-    if (in >> status)
-    {
-        m_status = static_cast<Status>(status);
-    }
-    else
-    {
-        // Invalid status code
-        m_status = InvalidResponse;
-        return;
-    }
-
-    // Ignore the end of the first line
-    in.ignore(10000, '\n');
-
-    // Parse the other lines, which contain fields, one by one
-    std::string line;
-    while (std::getline(in, line) && (line.size() > 2))
-    {
-        std::string::size_type pos = line.find(": ");
-        if (pos != std::string::npos)
-        {
-            // Extract the field name and its value
-            std::string field = line.substr(0, pos);
-            std::string value = line.substr(pos + 2);
-
-            // Remove any trailing \r
-            if (!value.empty() && (*value.rbegin() == '\r'))
-                value.erase(value.size() - 1);
-
-            // Add the field
-            m_fields[toLower(field)] = value;
-        }
-    }
-
-    // Finally extract the body
-    m_body.clear();
-    std::copy(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>(), std::back_inserter(m_body));
+    m_connection.setBlocking(false);
 }
 
 
 ////////////////////////////////////////////////////////////
-Http::Http() :
-m_host(),
-m_port(0)
+Http::Http(const std::string& host, unsigned short port) :
+m_host         (),
+m_port         (0),
+m_state        (Disconnected),
+m_sentCount    (0),
+m_outputOffset (0),
+m_pipelineDepth(4)
 {
-
+    m_connection.setBlocking(false);
+    setHost(host, port);
 }
 
 
 ////////////////////////////////////////////////////////////
-Http::Http(const std::string& host, unsigned short port)
+Http::~Http()
 {
-    setHost(host, port);
+    for (std::deque<PendingRequest*>::iterator it = m_requests.begin(); it != m_requests.end(); ++it)
+        delete *it;
+    for (std::deque<PendingRequest*>::iterator it = m_completed.begin(); it != m_completed.end(); ++it)
+        delete *it;
 }
 
 
 ////////////////////////////////////////////////////////////
 void Http::setHost(const std::string& host, unsigned short port)
 {
+    std::string previousName = m_hostName;
+    unsigned short previousPort = m_port;
+
     // Detect the protocol used
     std::string protocol = toLower(host.substr(0, 8));
     if (protocol.substr(0, 7) == "http://")
@@ -302,12 +354,110 @@ void Http::setHost(const std::string& host, unsigned short port)
     if (!m_hostName.empty() && (*m_hostName.rbegin() == '/'))
         m_hostName.erase(m_hostName.size() - 1);
 
+    if ((m_hostName == previousName) && (m_port == previousPort))
+        return;
+
     m_host = IpAddress(m_hostName);
+
+    // Requests queued for the previous host can't be sent anymore
+    if (m_state != Disconnected)
+    {
+        m_connection.disconnect();
+        m_state = Disconnected;
+        m_output.clear();
+        m_outputOffset = 0;
+        m_input.clear();
+    }
+    failAll();
 }
 
 
 ////////////////////////////////////////////////////////////
 Http::Response Http::sendRequest(const Http::Request& request, Time timeout)
+{
+    Response response;
+    bool done = false;
+    PendingRequest* pending = enqueue(request, new priv::HttpCallbackFunctor<ResponseReceiver>(ResponseReceiver(response, done)));
+
+    Clock clock;
+    while (!done)
+    {
+        if (timeout <= Time::Zero)
+        {
+            // No timeout: wait as long as needed
+            process(microseconds(-1));
+        }
+        else
+        {
+            Time remaining = timeout - clock.getElapsedTime();
+            if (remaining > Time::Zero)
+            {
+                process(remaining);
+            }
+            else
+            {
+                // Timeout: give up on the request. If it was sent, the state
+                // of the connection is unknown and we must close it
+                std::deque<PendingRequest*>::iterator it = std::find(m_requests.begin(), m_requests.end(), pending);
+                if (it - m_requests.begin() < static_cast<std::ptrdiff_t>(m_sentCount))
+                {
+                    closeConnection(false);
+                    it = std::find(m_requests.begin(), m_requests.end(), pending);
+                }
+
+                if (it != m_requests.end())
+                {
+                    m_requests.erase(it);
+                    delete pending;
+                }
+                else
+                {
+                    // Closing the connection completed the request (it was
+                    // partially answered, or can't be sent again): it is
+                    // deleted by dispatch(), but must not report a response
+                    delete pending->callback;
+                    pending->callback = NULL;
+                }
+                dispatch();
+                break;
+            }
+        }
+    }
+
+    return response;
+}
+
+
+////////////////////////////////////////////////////////////
+void Http::sendRequestAsync(const Request& request)
+{
+    enqueue(request, NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+void Http::update(Time timeout)
+{
+    process(timeout);
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t Http::getPendingRequestCount() const
+{
+    return m_requests.size();
+}
+
+
+////////////////////////////////////////////////////////////
+void Http::setPipelineDepth(unsigned int depth)
+{
+    m_pipelineDepth = (depth > 0 ? depth : 1);
+}
+
+
+////////////////////////////////////////////////////////////
+Http::PendingRequest* Http::enqueue(const Request& request, priv::HttpCallback* callback)
 {
     // First make sure that the request is valid -- add missing mandatory fields
     Request toSend(request);
@@ -333,44 +483,460 @@ Http::Response Http::sendRequest(const Http::Request& request, Time timeout)
     {
         toSend.setField("Content-Type", "application/x-www-form-urlencoded");
     }
-    if ((toSend.m_majorVersion * 10 + toSend.m_minorVersion >= 11) && !toSend.hasField("Connection"))
+
+    // HTTP 1.1 keeps the connection alive unless told otherwise, HTTP 1.0 closes it
+    const std::string& connection = toSend.m_fields["connection"];
+    bool keepAlive = (toSend.m_majorVersion * 10 + toSend.m_minorVersion >= 11) ? !hasToken(connection, "close")
+                                                                                : hasToken(connection, "keep-alive");
+
+    PendingRequest* pending = new PendingRequest;
+    pending->data         = toSend.prepare();
+    pending->idempotent   = (toSend.m_method != Request::Post);
+    pending->hasBody      = (toSend.m_method != Request::Head);
+    pending->closes       = !keepAlive;
+    pending->responseFile = toSend.m_responseFile;
+    pending->callback     = callback;
+    m_requests.push_back(pending);
+
+    return pending;
+}
+
+
+////////////////////////////////////////////////////////////
+void Http::process(Time timeout)
+{
+    // Open the connection if there's something to send
+    if ((m_state == Disconnected) && !m_requests.empty())
+    {
+        Socket::Status status = (m_host != IpAddress::None) ? m_connection.connect(m_host, m_port) : Socket::Error;
+        if (status == Socket::Done)
+        {
+            m_state = Connected;
+        }
+        else if (status == Socket::NotReady)
+        {
+            m_state = Connecting;
+        }
+        else
+        {
+            m_connection.disconnect();
+            failAll();
+        }
+    }
+
+    if (m_state == Connected)
+        fillPipeline();
+
+    if (m_state != Disconnected)
+    {
+        SocketHandle handle = m_connection.getHandle();
+
+    #ifndef SFML_SYSTEM_WINDOWS
+        if (handle >= FD_SETSIZE)
+        {
+            err() << "The HTTP connection can't be used with select(): its handle (" << handle
+                  << ") exceeds FD_SETSIZE (" << FD_SETSIZE << ")" << std::endl;
+            m_connection.disconnect();
+            m_state = Disconnected;
+            failAll();
+            dispatch();
+            return;
+        }
+    #endif
+
+        // Wait until the socket is ready: readable, or writable if we have
+        // something to write, or if we're waiting for the connection
+        fd_set readSet;
+        fd_set writeSet;
+        fd_set errorSet;
+        FD_ZERO(&readSet);
+        FD_ZERO(&writeSet);
+        FD_ZERO(&errorSet);
+        FD_SET(handle, &readSet);
+        FD_SET(handle, &errorSet);
+        if ((m_state == Connecting) || (m_outputOffset < m_output.size()))
+            FD_SET(handle, &writeSet);
+
+        timeval time;
+        time.tv_sec  = static_cast<long>(timeout.asMicroseconds() / 1000000);
+        time.tv_usec = static_cast<long>(timeout.asMicroseconds() % 1000000);
+
+        int count = select(static_cast<int>(handle + 1), &readSet, &writeSet, &errorSet, timeout < Time::Zero ? NULL : &time);
+
+        if ((m_state == Connecting) && (count > 0))
+        {
+            // The connection attempt is over: it either succeeded or failed
+            // (errors are reported in the error set on Windows)
+            if (m_connection.getRemoteAddress() != IpAddress::None)
+            {
+                m_state = Connected;
+                fillPipeline();
+            }
+            else
+            {
+                m_connection.disconnect();
+                m_state = Disconnected;
+                failAll();
+            }
+        }
+
+        if (m_state == Connected)
+        {
+            // If sending fails, the server may have answered before
+            // closing the connection, so we still read the socket
+            bool closed = !sendOutput();
+
+            // Receive everything that is available
+            if (closed || (count > 0))
+            {
+                char buffer[16384];
+                for (;;)
+                {
+                    std::size_t received = 0;
+                    Socket::Status status = m_connection.receive(buffer, sizeof(buffer), received);
+                    if (status == Socket::Done)
+                    {
+                        m_input.append(buffer, received);
+                    }
+                    else
+                    {
+                        if (status != Socket::NotReady)
+                            closed = true;
+                        break;
+                    }
+                }
+            }
+
+            // A connection closed by the server without notice is a failure
+            bool mustClose = parseInput(closed);
+            if (mustClose || closed)
+            {
+                closeConnection(!mustClose);
+            }
+            else
+            {
+                // Completed responses make room for the next requests
+                fillPipeline();
+                sendOutput();
+            }
+        }
+    }
+
+    dispatch();
+}
+
+
+////////////////////////////////////////////////////////////
+void Http::fillPipeline()
+{
+    while ((m_sentCount < m_requests.size()) && (m_sentCount < m_pipelineDepth))
     {
-        toSend.setField("Connection", "close");
+        const PendingRequest* next = m_requests[m_sentCount];
+        if (m_sentCount > 0)
+        {
+            // Only requests that can safely be sent again are pipelined, and
+            // nothing can follow a request after which the server closes the connection
+            const PendingRequest* last = m_requests[m_sentCount - 1];
+            if (!next->idempotent || !last->idempotent || last->closes)
+                break;
+        }
+
+        m_output += next->data;
+        ++m_sentCount;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool Http::sendOutput()
+{
+    // Send as much as the socket accepts
+    while (m_outputOffset < m_output.size())
+    {
+        int sent = priv::SocketImpl::send(m_connection.getHandle(), m_output.data() + m_outputOffset, m_output.size() - m_outputOffset, NULL, 0);
+        if (sent < 0)
+            return priv::SocketImpl::getErrorStatus() == Socket::NotReady;
+
+        m_outputOffset += sent;
     }
 
-    // Prepare the response
-    Response received;
+    m_output.clear();
+    m_outputOffset = 0;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Http::parseInput(bool closed)
+{
+    std::size_t offset = 0;
+    bool mustClose = false;
 
-    // Connect the socket to the host
-    if (m_connection.connect(m_host, m_port, timeout) == Socket::Done)
+    // Responses arrive in the same order as the requests
+    while ((m_sentCount > 0) && !mustClose)
     {
-        // Convert the request to string and send it through the connected socket
-        std::string requestStr = toSend.prepare();
+        PendingRequest& request = *m_requests.front();
+        Response& response = request.response;
+        std::size_t available = m_input.size() - offset;
+        if (available > 0)
+            request.answered = true;
+
+        if ((request.stage == PendingRequest::Body) || (request.stage == PendingRequest::ChunkData))
+        {
+            // Known amount of body data
+            std::size_t size = std::min(available, request.remaining);
+            if (size == 0)
+                break;
+
+            writeBody(request, m_input.data() + offset, size);
+            offset += size;
+            request.remaining -= size;
+            if (request.remaining == 0)
+                request.stage = (request.stage == PendingRequest::Body) ? PendingRequest::Complete : PendingRequest::ChunkEnd;
+        }
+        else if (request.stage == PendingRequest::UntilClose)
+        {
+            // The body goes on until the server closes the connection
+            writeBody(request, m_input.data() + offset, available);
+            offset += available;
+            if (!closed)
+                break;
 
-        if (!requestStr.empty())
+            request.stage = PendingRequest::Complete;
+        }
+        else
         {
-            // Send it through the socket
-            if (m_connection.send(requestStr.c_str(), requestStr.size()) == Socket::Done)
+            // All the other stages read lines
+            std::string::size_type end = m_input.find('\n', offset);
+            if (end == std::string::npos)
             {
-                // Wait for the server's response
-                std::string receivedStr;
-                std::size_t size = 0;
-                char buffer[1024];
-                while (m_connection.receive(buffer, sizeof(buffer), size) == Socket::Done)
+                if (available > maxLineSize)
                 {
-                    receivedStr.append(buffer, buffer + size);
+                    response.m_status = Response::InvalidResponse;
+                    request.stage = PendingRequest::Complete;
                 }
+                else
+                {
+                    break;
+                }
+            }
+            else
+            {
+                std::string line(m_input, offset, end - offset);
+                if (!line.empty() && (*line.rbegin() == '\r'))
+                    line.erase(line.size() - 1);
+                offset = end + 1;
 
-                // Build the Response object from the received data
-                received.parse(receivedStr);
+                switch (request.stage)
+                {
+                    case PendingRequest::StatusLine :
+                    {
+                        // Extract the HTTP version and the status code, e.g. "HTTP/1.1 200 OK"
+                        if (line.empty())
+                            break;
+
+                        if ((line.size() >= 12) && (toLower(line.substr(0, 5)) == "http/") &&
+                            isdigit(line[5]) && (line[6] == '.') && isdigit(line[7]) && (line[8] == ' ') &&
+                            isdigit(line[9]) && isdigit(line[10]) && isdigit(line[11]))
+                        {
+                            response.m_majorVersion = line[5] - '0';
+                            response.m_minorVersion = line[7] - '0';
+                            response.m_status = static_cast<Response::Status>(std::atoi(line.c_str() + 9));
+                            request.stage = PendingRequest::Header;
+                        }
+                        else
+                        {
+                            response.m_status = Response::InvalidResponse;
+                            request.stage = PendingRequest::Complete;
+                        }
+                        break;
+                    }
+
+                    case PendingRequest::Header :
+                    case PendingRequest::Trailer :
+                    {
+                        if (!line.empty())
+                        {
+                            // Add the field
+                            std::string::size_type pos = line.find(':');
+                            if (pos != std::string::npos)
+                                response.m_fields[toLower(trim(line.substr(0, pos)))] = trim(line.substr(pos + 1));
+                        }
+                        else if (request.stage == PendingRequest::Trailer)
+                        {
+                            request.stage = PendingRequest::Complete;
+                        }
+                        else if ((response.m_status >= 100) && (response.m_status < 200))
+                        {
+                            // Interim response, the final one follows
+                            response = Response();
+                            request.stage = PendingRequest::StatusLine;
+                        }
+                        else
+                        {
+                            // End of the header: find out how the body is delimited
+                            const std::string& length = response.getField("content-length");
+                            if (!request.hasBody || (response.m_status == Response::NoContent) || (response.m_status == Response::NotModified))
+                            {
+                                request.stage = PendingRequest::Complete;
+                            }
+                            else if (hasToken(response.getField("transfer-encoding"), "chunked"))
+                            {
+                                request.stage = PendingRequest::ChunkSize;
+                            }
+                            else if (!length.empty())
+                            {
+                                request.remaining = std::strtoul(length.c_str(), NULL, 10);
+                                request.stage = (request.remaining > 0) ? PendingRequest::Body : PendingRequest::Complete;
+                            }
+                            else
+                            {
+                                request.stage = PendingRequest::UntilClose;
+                            }
+
+                            // Successful bodies may go to a file instead of memory
+                            if (request.hasBody && !request.responseFile.empty() && (response.m_status >= 200) && (response.m_status < 300))
+                            {
+                                request.file.open(request.responseFile.c_str(), std::ios_base::binary | std::ios_base::trunc);
+                                if (!request.file)
+                                    err() << "Failed to open \"" << request.responseFile << "\" for writing, keeping the HTTP response in memory" << std::endl;
+                            }
+                        }
+                        break;
+                    }
+
+                    case PendingRequest::ChunkSize :
+                    {
+                        // The size is in hexadecimal, possibly followed by extensions
+                        char* end = NULL;
+                        request.remaining = std::strtoul(line.c_str(), &end, 16);
+                        if (end == line.c_str())
+                        {
+                            response.m_status = Response::InvalidResponse;
+                            request.stage = PendingRequest::Complete;
+                        }
+                        else
+                        {
+                            request.stage = (request.remaining > 0) ? PendingRequest::ChunkData : PendingRequest::Trailer;
+                        }
+                        break;
+                    }
+
+                    case PendingRequest::ChunkEnd :
+                    {
+                        request.stage = PendingRequest::ChunkSize;
+                        break;
+                    }
+
+                    default :
+                        break;
+                }
             }
         }
 
-        // Close the connection
-        m_connection.disconnect();
+        if (request.stage == PendingRequest::Complete)
+        {
+            // Check if the server keeps the connection open after this response
+            const std::string& connection = response.getField("connection");
+            bool keepAlive = (response.m_majorVersion * 10 + response.m_minorVersion >= 11) ? !hasToken(connection, "close")
+                                                                                            : hasToken(connection, "keep-alive");
+            if (!keepAlive || request.closes || (response.m_status == Response::InvalidResponse))
+                mustClose = true;
+
+            complete(0);
+        }
+    }
+
+    m_input.erase(0, offset);
+
+    return mustClose;
+}
+
+
+////////////////////////////////////////////////////////////
+void Http::writeBody(PendingRequest& request, const char* data, std::size_t size)
+{
+    if (request.file.is_open())
+        request.file.write(data, static_cast<std::streamsize>(size));
+    else
+        request.response.m_body.append(data, size);
+}
+
+
+////////////////////////////////////////////////////////////
+void Http::closeConnection(bool failure)
+{
+    m_connection.disconnect();
+    m_state = Disconnected;
+    m_output.clear();
+    m_outputOffset = 0;
+    m_input.clear();
+
+    // Requests sent on this connection are sent again on the next one,
+    // unless their response was cut, they already failed once, or the
+    // server may have acted on them already (POST)
+    std::size_t sent = m_sentCount;
+    m_sentCount = 0;
+    std::size_t index = 0;
+    for (std::size_t i = 0; i < sent; ++i)
+    {
+        PendingRequest* request = m_requests[index];
+        if (!request->answered && request->idempotent && !(failure && request->retried))
+        {
+            request->retried = request->retried || failure;
+            ++index;
+        }
+        else
+        {
+            request->response = Response();
+            complete(index);
+        }
     }
+}
+
+
+////////////////////////////////////////////////////////////
+void Http::complete(std::size_t index)
+{
+    PendingRequest* request = m_requests[index];
+    if (request->file.is_open())
+        request->file.close();
+
+    m_requests.erase(m_requests.begin() + index);
+    if (index < m_sentCount)
+        --m_sentCount;
+
+    m_completed.push_back(request);
+}
 
-    return received;
+
+////////////////////////////////////////////////////////////
+void Http::failAll()
+{
+    while (!m_requests.empty())
+    {
+        m_requests.front()->response = Response();
+        complete(0);
+    }
+    m_sentCount = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void Http::dispatch()
+{
+    // Callbacks may queue new requests, but they don't touch the completed list
+    while (!m_completed.empty())
+    {
+        PendingRequest* request = m_completed.front();
+        m_completed.pop_front();
+
+        if (request->callback)
+            request->callback->run(request->response);
+
+        delete request;
+    }
 }
 
 } // namespace sf
@@ -26,8 +26,10 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Network/Packet.hpp>
+#include <SFML/Network/PacketBuffer.hpp>
 #include <SFML/Network/SocketImpl.hpp>
 #include <SFML/System/String.hpp>
+#include <algorithm>
 #include <cstring>
 #include <cwchar>
 
@@ -36,17 +38,52 @@ namespace sf
 {
 ////////////////////////////////////////////////////////////
 Packet::Packet() :
-m_readPos(0),
-m_isValid(true)
+m_buffer  (NULL),
+m_size    (0),
+m_readPos (0),
+m_isValid (true),
+m_incoming(NULL)
 {
 
 }
 
 
+////////////////////////////////////////////////////////////
+Packet::Packet(const Packet& copy) :
+m_buffer  (copy.m_buffer),
+m_size    (copy.m_size),
+m_readPos (copy.m_readPos),
+m_isValid (copy.m_isValid),
+m_incoming(NULL)
+{
+    if (m_buffer)
+        m_buffer->addReference();
+}
+
+
 ////////////////////////////////////////////////////////////
 Packet::~Packet()
 {
+    if (m_buffer)
+        m_buffer->release();
+}
+
+
+////////////////////////////////////////////////////////////
+Packet& Packet::operator =(const Packet& right)
+{
+    // Add the reference first, in case both packets share the same buffer
+    if (right.m_buffer)
+        right.m_buffer->addReference();
+    if (m_buffer)
+        m_buffer->release();
+
+    m_buffer  = right.m_buffer;
+    m_size    = right.m_size;
+    m_readPos = right.m_readPos;
+    m_isValid = right.m_isValid;
 
+    return *this;
 }
 
 
@@ -55,9 +92,8 @@ void Packet::append(const void* data, std::size_t sizeInBytes)
 {
     if (data && (sizeInBytes > 0))
     {
-        std::size_t start = m_data.size();
-        m_data.resize(start + sizeInBytes);
-        std::memcpy(&m_data[start], data, sizeInBytes);
+        std::memcpy(reserve(sizeInBytes), data, sizeInBytes);
+        m_size += sizeInBytes;
     }
 }
 
@@ -65,7 +101,14 @@ void Packet::append(const void* data, std::size_t sizeInBytes)
 ////////////////////////////////////////////////////////////
 void Packet::clear()
 {
-    m_data.clear();
+    // Keep the buffer for the next data, unless other packets still use it
+    if (m_buffer && m_buffer->isShared())
+    {
+        m_buffer->release();
+        m_buffer = NULL;
+    }
+
+    m_size = 0;
     m_readPos = 0;
     m_isValid = true;
 }
@@ -74,21 +117,21 @@ void Packet::clear()
 ////////////////////////////////////////////////////////////
 const void* Packet::getData() const
 {
-    return !m_data.empty() ? &m_data[0] : NULL;
+    return (m_size > 0) ? m_buffer->getData() : NULL;
 }
 
 
 ////////////////////////////////////////////////////////////
 std::size_t Packet::getDataSize() const
 {
-    return m_data.size();
+    return m_size;
 }
 
 
 ////////////////////////////////////////////////////////////
 bool Packet::endOfPacket() const
 {
-    return m_readPos >= m_data.size();
+    return m_readPos >= m_size;
 }
 
 
@@ -115,7 +158,7 @@ Packet& Packet::operator >>(Int8& data)
 {
     if (checkSize(sizeof(data)))
     {
-        data = *reinterpret_cast<const Int8*>(&m_data[m_readPos]);
+        data = *reinterpret_cast<const Int8*>(m_buffer->getData() + m_readPos);
         m_readPos += sizeof(data);
     }
 
@@ -128,7 +171,7 @@ Packet& Packet::operator >>(Uint8& data)
 {
     if (checkSize(sizeof(data)))
     {
-        data = *reinterpret_cast<const Uint8*>(&m_data[m_readPos]);
+        data = *reinterpret_cast<const Uint8*>(m_buffer->getData() + m_readPos);
         m_readPos += sizeof(data);
     }
 
@@ -141,7 +184,7 @@ Packet& Packet::operator >>(Int16& data)
 {
     if (checkSize(sizeof(data)))
     {
-        data = ntohs(*reinterpret_cast<const Int16*>(&m_data[m_readPos]));
+        data = ntohs(*reinterpret_cast<const Int16*>(m_buffer->getData() + m_readPos));
         m_readPos += sizeof(data);
     }
 
@@ -154,7 +197,7 @@ Packet& Packet::operator >>(Uint16& data)
 {
     if (checkSize(sizeof(data)))
     {
-        data = ntohs(*reinterpret_cast<const Uint16*>(&m_data[m_readPos]));
+        data = ntohs(*reinterpret_cast<const Uint16*>(m_buffer->getData() + m_readPos));
         m_readPos += sizeof(data);
     }
 
@@ -167,7 +210,7 @@ Packet& Packet::operator >>(Int32& data)
 {
     if (checkSize(sizeof(data)))
     {
-        data = ntohl(*reinterpret_cast<const Int32*>(&m_data[m_readPos]));
+        data = ntohl(*reinterpret_cast<const Int32*>(m_buffer->getData() + m_readPos));
         m_readPos += sizeof(data);
     }
 
@@ -180,7 +223,7 @@ Packet& Packet::operator >>(Uint32& data)
 {
     if (checkSize(sizeof(data)))
     {
-        data = ntohl(*reinterpret_cast<const Uint32*>(&m_data[m_readPos]));
+        data = ntohl(*reinterpret_cast<const Uint32*>(m_buffer->getData() + m_readPos));
         m_readPos += sizeof(data);
     }
 
@@ -193,7 +236,7 @@ Packet& Packet::operator >>(float& data)
 {
     if (checkSize(sizeof(data)))
     {
-        data = *reinterpret_cast<const float*>(&m_data[m_readPos]);
+        data = *reinterpret_cast<const float*>(m_buffer->getData() + m_readPos);
         m_readPos += sizeof(data);
     }
 
@@ -206,7 +249,7 @@ Packet& Packet::operator >>(double& data)
 {
     if (checkSize(sizeof(data)))
     {
-        data = *reinterpret_cast<const double*>(&m_data[m_readPos]);
+        data = *reinterpret_cast<const double*>(m_buffer->getData() + m_readPos);
         m_readPos += sizeof(data);
     }
 
@@ -224,7 +267,7 @@ Packet& Packet::operator >>(char* data)
     if ((length > 0) && checkSize(length))
     {
         // Then extract characters
-        std::memcpy(data, &m_data[m_readPos], length);
+        std::memcpy(data, m_buffer->getData() + m_readPos, length);
         data[length] = '\0';
 
         // Update reading position
@@ -246,7 +289,7 @@ Packet& Packet::operator >>(std::string& data)
     if ((length > 0) && checkSize(length))
     {
         // Then extract characters
-        data.assign(&m_data[m_readPos], length);
+        data.assign(m_buffer->getData() + m_readPos, length);
 
         // Update reading position
         m_readPos += length;
@@ -484,12 +527,35 @@ Packet& Packet::operator <<(const String& data)
 ////////////////////////////////////////////////////////////
 bool Packet::checkSize(std::size_t size)
 {
-    m_isValid = m_isValid && (m_readPos + size <= m_data.size());
+    m_isValid = m_isValid && (m_readPos + size <= m_size);
 
     return m_isValid;
 }
 
 
+////////////////////////////////////////////////////////////
+char* Packet::reserve(std::size_t size)
+{
+    if (!m_buffer || m_buffer->isShared() || (m_buffer->getCapacity() < m_size + size))
+    {
+        // Grow geometrically, like a vector
+        std::size_t capacity = m_size + size;
+        if (m_buffer && !m_buffer->isShared())
+            capacity = std::max(capacity, m_buffer->getCapacity() * 2);
+
+        priv::PacketBuffer* buffer = priv::PacketBuffer::acquire(capacity);
+        if (m_size > 0)
+            std::memcpy(buffer->getData(), m_buffer->getData(), m_size);
+        if (m_buffer)
+            m_buffer->release();
+
+        m_buffer = buffer;
+    }
+
+    return m_buffer->getData() + m_size;
+}
+
+
 ////////////////////////////////////////////////////////////
 const void* Packet::onSend(std::size_t& size)
 {
@@ -501,7 +567,20 @@ const void* Packet::onSend(std::size_t& size)
 ////////////////////////////////////////////////////////////
 void Packet::onReceive(const void* data, std::size_t size)
 {
-    append(data, size);
+    // Take the buffer the socket received the data into, rather than copying it
+    if (m_incoming && (m_size == 0) && (data == m_incoming->getData()))
+    {
+        m_incoming->addReference();
+        if (m_buffer)
+            m_buffer->release();
+
+        m_buffer = m_incoming;
+        m_size = size;
+    }
+    else
+    {
+        append(data, size);
+    }
 }
 
 } // namespace sf
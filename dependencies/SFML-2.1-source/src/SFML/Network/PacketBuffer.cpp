@@ -0,0 +1,202 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Network/PacketBuffer.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Mutex.hpp>
+
+#if defined(SFML_SYSTEM_WINDOWS)
+    #include <windows.h>
+#endif
+
+
+namespace
+{
+    // Buffers are pooled by power of two sizes, from 64 bytes to 64 KB.
+    // Larger buffers are rare enough to be allocated every time
+    const unsigned int classCount = 11;
+    const std::size_t minCapacity = 64;
+
+    // Maximum number of free buffers kept by each pool
+    const std::size_t maxFreeCount = 64;
+
+    // Free buffers
+    struct Pool
+    {
+        Pool() : mutex(sf::Mutex::NonRecursive)
+        {
+            for (unsigned int i = 0; i < classCount; ++i)
+            {
+                buffers[i] = NULL;
+                counts[i] = 0;
+            }
+        }
+
+        sf::Mutex               mutex;
+        sf::priv::PacketBuffer* buffers[classCount];
+        std::size_t             counts[classCount];
+    };
+
+    Pool& getPool()
+    {
+        // Never destroyed: packets may be released by static destructors
+        static Pool* pool = new Pool;
+        return *pool;
+    }
+
+    volatile long allocationCount = 0;
+
+    // Add a value to an integer shared between threads, and get the result
+    long atomicAdd(volatile long* value, long increment)
+    {
+    #if defined(SFML_SYSTEM_WINDOWS)
+        return InterlockedExchangeAdd(value, increment) + increment;
+    #else
+        return __sync_add_and_fetch(value, increment);
+    #endif
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+PacketBuffer* PacketBuffer::acquire(std::size_t capacity)
+{
+    unsigned int sizeClass = 0;
+    std::size_t classCapacity = minCapacity;
+    while ((classCapacity < capacity) && (sizeClass < classCount))
+    {
+        classCapacity *= 2;
+        sizeClass++;
+    }
+
+    if (sizeClass < classCount)
+    {
+        Pool& pool = getPool();
+        Lock lock(pool.mutex);
+
+        PacketBuffer* buffer = pool.buffers[sizeClass];
+        if (buffer)
+        {
+            pool.buffers[sizeClass] = buffer->m_next;
+            pool.counts[sizeClass]--;
+            buffer->m_refCount = 1;
+            return buffer;
+        }
+    }
+    else
+    {
+        classCapacity = capacity;
+    }
+
+    atomicAdd(&allocationCount, 1);
+    return new PacketBuffer(classCapacity, sizeClass);
+}
+
+
+////////////////////////////////////////////////////////////
+void PacketBuffer::addReference()
+{
+    atomicAdd(&m_refCount, 1);
+}
+
+
+////////////////////////////////////////////////////////////
+void PacketBuffer::release()
+{
+    if (atomicAdd(&m_refCount, -1) > 0)
+        return;
+
+    if (m_sizeClass < classCount)
+    {
+        Pool& pool = getPool();
+        Lock lock(pool.mutex);
+
+        if (pool.counts[m_sizeClass] < maxFreeCount)
+        {
+            m_next = pool.buffers[m_sizeClass];
+            pool.buffers[m_sizeClass] = this;
+            pool.counts[m_sizeClass]++;
+            return;
+        }
+    }
+
+    delete this;
+}
+
+
+////////////////////////////////////////////////////////////
+bool PacketBuffer::isShared() const
+{
+    return m_refCount > 1;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t PacketBuffer::getCapacity() const
+{
+    return m_capacity;
+}
+
+
+////////////////////////////////////////////////////////////
+char* PacketBuffer::getData()
+{
+    return m_data;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint64 PacketBuffer::getAllocationCount()
+{
+    return static_cast<Uint64>(atomicAdd(&allocationCount, 0));
+}
+
+
+////////////////////////////////////////////////////////////
+PacketBuffer::PacketBuffer(std::size_t capacity, unsigned int sizeClass) :
+m_refCount (1),
+m_capacity (capacity),
+m_sizeClass(sizeClass),
+m_next     (NULL),
+m_data     (new char[capacity])
+{
+}
+
+
+////////////////////////////////////////////////////////////
+PacketBuffer::~PacketBuffer()
+{
+    delete[] m_data;
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_PACKETBUFFER_HPP
+#define SFML_PACKETBUFFER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Config.hpp>
+#include <cstddef>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Reference-counted storage of packets, recycled
+///        through a pool
+///
+////////////////////////////////////////////////////////////
+class PacketBuffer
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a buffer from the pool, or allocate a new one
+    ///
+    /// The returned buffer has a single reference.
+    ///
+    /// \param capacity Minimum size of the buffer, in bytes
+    ///
+    /// \return New buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    static PacketBuffer* acquire(std::size_t capacity);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a reference to the buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    void addReference();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove a reference to the buffer
+    ///
+    /// The buffer goes back to the pool when its last
+    /// reference is removed.
+    ///
+    ////////////////////////////////////////////////////////////
+    void release();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the buffer has more than one reference
+    ///
+    /// Shared buffers must not be modified.
+    ///
+    /// \return True if the buffer is shared
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isShared() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the buffer
+    ///
+    /// \return Capacity of the buffer, in bytes
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getCapacity() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the bytes of the buffer
+    ///
+    /// \return Pointer to the first byte of the buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    char* getData();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of buffers allocated since the
+    ///        program started
+    ///
+    /// Buffers taken from the pool are not counted.
+    ///
+    /// \return Number of allocations
+    ///
+    ////////////////////////////////////////////////////////////
+    static Uint64 getAllocationCount();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Constructor
+    ///
+    /// \param capacity  Size of the buffer, in bytes
+    /// \param sizeClass Index of the pool the buffer belongs to
+    ///
+    ////////////////////////////////////////////////////////////
+    PacketBuffer(std::size_t capacity, unsigned int sizeClass);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~PacketBuffer();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    volatile long m_refCount;  ///< Number of references to the buffer
+    std::size_t   m_capacity;  ///< Size of the buffer
+    unsigned int  m_sizeClass; ///< Index of the pool the buffer belongs to
+    PacketBuffer* m_next;      ///< Next free buffer, while in the pool
+    char*         m_data;      ///< Bytes of the buffer
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_PACKETBUFFER_HPP
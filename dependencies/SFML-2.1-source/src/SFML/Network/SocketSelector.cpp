@@ -29,7 +29,15 @@
 #include <SFML/Network/Socket.hpp>
 #include <SFML/Network/SocketImpl.hpp>
 #include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <map>
 #include <utility>
+#include <vector>
+
+#ifdef SFML_SYSTEM_LINUX
+    #include <sys/epoll.h>
+    #include <cerrno>
+#endif
 
 #ifdef _MSC_VER
     #pragma warning(disable : 4127) // "conditional expression is constant" generated by the FD_SET macro
@@ -41,31 +49,108 @@ namespace sf
 ////////////////////////////////////////////////////////////
 struct SocketSelector::SocketSelectorImpl
 {
-    fd_set AllSockets;   ///< Set containing all the sockets handles
-    fd_set SocketsReady; ///< Set containing handles of the sockets that are ready
-    int    MaxSocket;    ///< Maximum socket handle
+    ////////////////////////////////////////////////////////////
+    /// \brief Socket added to the selector
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        Socket* socket; ///< Socket to observe
+        bool    ready;  ///< Was the socket ready after the last wait? (epoll only)
+    };
+
+    typedef std::map<SocketHandle, Entry> SocketTable;
+
+    SocketSelector::Backend     BackendType;  ///< Backend actually used
+    SocketSelector::TriggerMode Mode;         ///< When sockets are reported as ready
+    SocketTable                 Sockets;      ///< All the sockets, by handle
+    std::vector<Socket*>        Ready;        ///< Sockets that are ready
+    fd_set                      AllSockets;   ///< Set containing all the sockets handles
+    fd_set                      SocketsReady; ///< Set containing handles of the sockets that are ready
+    int                         MaxSocket;    ///< Maximum socket handle
+#ifdef SFML_SYSTEM_LINUX
+    int                         Epoll;        ///< epoll instance
+    std::vector<epoll_event>    Events;       ///< Events returned by epoll_wait
+#endif
 };
 
 
+namespace
+{
+#ifdef SFML_SYSTEM_LINUX
+
+    // Create an epoll instance, or return -1 if the system doesn't support it
+    int createEpoll()
+    {
+        int epoll = epoll_create(1024);
+        if (epoll < 0)
+            sf::err() << "Failed to create an epoll instance, falling back to select()" << std::endl;
+
+        return epoll;
+    }
+
+    // Register a socket with an epoll instance
+    bool addToEpoll(int epoll, sf::SocketHandle handle, void* entry, sf::SocketSelector::TriggerMode mode)
+    {
+        epoll_event event;
+        event.events = EPOLLIN;
+        if (mode == sf::SocketSelector::EdgeTriggered)
+            event.events |= EPOLLET;
+        event.data.ptr = entry;
+
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, handle, &event) == 0)
+            return true;
+
+        // A closed socket is removed from epoll, but its handle may already
+        // be reused by another socket that the selector doesn't know yet
+        return (errno == EEXIST) && (epoll_ctl(epoll, EPOLL_CTL_MOD, handle, &event) == 0);
+    }
+
+#endif
+}
+
+
 ////////////////////////////////////////////////////////////
 SocketSelector::SocketSelector() :
 m_impl(new SocketSelectorImpl)
 {
-    clear();
+    create(DefaultBackend, LevelTriggered);
+}
+
+
+////////////////////////////////////////////////////////////
+SocketSelector::SocketSelector(Backend backend, TriggerMode mode) :
+m_impl(new SocketSelectorImpl)
+{
+    create(backend, mode);
 }
 
 
 ////////////////////////////////////////////////////////////
 SocketSelector::SocketSelector(const SocketSelector& copy) :
-m_impl(new SocketSelectorImpl(*copy.m_impl))
+m_impl(new SocketSelectorImpl)
 {
+    create(copy.m_impl->BackendType, copy.m_impl->Mode);
 
+    // The epoll instance can't be shared: register the sockets again
+    for (SocketSelectorImpl::SocketTable::const_iterator it = copy.m_impl->Sockets.begin(); it != copy.m_impl->Sockets.end(); ++it)
+        add(*it->second.socket);
+
+    m_impl->Ready = copy.m_impl->Ready;
+    m_impl->SocketsReady = copy.m_impl->SocketsReady;
+    for (std::vector<Socket*>::iterator it = m_impl->Ready.begin(); it != m_impl->Ready.end(); ++it)
+        m_impl->Sockets[(*it)->getHandle()].ready = true;
 }
 
 
 ////////////////////////////////////////////////////////////
 SocketSelector::~SocketSelector()
 {
+#ifdef SFML_SYSTEM_LINUX
+    if (m_impl->BackendType == EpollBackend)
+        close(m_impl->Epoll);
+#endif
+
     delete m_impl;
 }
 
@@ -74,22 +159,70 @@ SocketSelector::~SocketSelector()
 void SocketSelector::add(Socket& socket)
 {
     SocketHandle handle = socket.getHandle();
-    if (handle != priv::SocketImpl::invalidSocket())
+    if (handle == priv::SocketImpl::invalidSocket())
+        return;
+
+    if (m_impl->BackendType == SelectBackend)
     {
+    #ifndef SFML_SYSTEM_WINDOWS
+        if (handle >= FD_SETSIZE)
+        {
+            err() << "The socket can't be used with select(): its handle (" << handle
+                  << ") exceeds FD_SETSIZE (" << FD_SETSIZE << "), use the epoll backend" << std::endl;
+            return;
+        }
+    #endif
+
         FD_SET(handle, &m_impl->AllSockets);
 
         int size = static_cast<int>(handle);
         if (size > m_impl->MaxSocket)
             m_impl->MaxSocket = size;
     }
+
+    SocketSelectorImpl::Entry& entry = m_impl->Sockets[handle];
+    entry.socket = &socket;
+    entry.ready = false;
+
+#ifdef SFML_SYSTEM_LINUX
+    if ((m_impl->BackendType == EpollBackend) && !addToEpoll(m_impl->Epoll, handle, &entry, m_impl->Mode))
+    {
+        err() << "Failed to add a socket to the epoll instance" << std::endl;
+        m_impl->Sockets.erase(handle);
+    }
+#endif
 }
 
 
 ////////////////////////////////////////////////////////////
 void SocketSelector::remove(Socket& socket)
 {
-    FD_CLR(socket.getHandle(), &m_impl->AllSockets);
-    FD_CLR(socket.getHandle(), &m_impl->SocketsReady);
+    SocketHandle handle = socket.getHandle();
+
+    SocketSelectorImpl::SocketTable::iterator it = m_impl->Sockets.find(handle);
+    if (it == m_impl->Sockets.end())
+        return;
+
+    m_impl->Sockets.erase(it);
+
+    std::vector<Socket*>::iterator ready = std::find(m_impl->Ready.begin(), m_impl->Ready.end(), &socket);
+    if (ready != m_impl->Ready.end())
+        m_impl->Ready.erase(ready);
+
+    if (m_impl->BackendType == SelectBackend)
+    {
+        FD_CLR(handle, &m_impl->AllSockets);
+        FD_CLR(handle, &m_impl->SocketsReady);
+    }
+
+#ifdef SFML_SYSTEM_LINUX
+    if (m_impl->BackendType == EpollBackend)
+    {
+        // The event argument is ignored, but must not be NULL before Linux 2.6.9
+        epoll_event event;
+        epoll_ctl(m_impl->Epoll, EPOLL_CTL_DEL, handle, &event);
+    }
+#endif
 }
 
 
@@ -100,12 +233,52 @@ void SocketSelector::clear()
     FD_ZERO(&m_impl->SocketsReady);
 
     m_impl->MaxSocket = 0;
+    m_impl->Sockets.clear();
+    m_impl->Ready.clear();
+
+#ifdef SFML_SYSTEM_LINUX
+    if (m_impl->BackendType == EpollBackend)
+    {
+        // Starting over is cheaper than removing the sockets one by one
+        close(m_impl->Epoll);
+        m_impl->Epoll = createEpoll();
+        if (m_impl->Epoll < 0)
+            m_impl->BackendType = SelectBackend;
+    }
+#endif
 }
 
 
 ////////////////////////////////////////////////////////////
 bool SocketSelector::wait(Time timeout)
 {
+#ifdef SFML_SYSTEM_LINUX
+    if (m_impl->BackendType == EpollBackend)
+    {
+        // Only the previously ready sockets need to be reset
+        for (std::vector<Socket*>::iterator it = m_impl->Ready.begin(); it != m_impl->Ready.end(); ++it)
+            m_impl->Sockets[(*it)->getHandle()].ready = false;
+        m_impl->Ready.clear();
+
+        // Round the timeout up, so that short timeouts don't become a busy loop
+        int milliseconds = -1;
+        if (timeout != Time::Zero)
+            milliseconds = static_cast<int>((timeout.asMicroseconds() + 999) / 1000);
+
+        m_impl->Events.resize(std::max<std::size_t>(m_impl->Sockets.size(), 1));
+        int count = epoll_wait(m_impl->Epoll, &m_impl->Events[0], static_cast<int>(m_impl->Events.size()), milliseconds);
+
+        for (int i = 0; i < count; ++i)
+        {
+            SocketSelectorImpl::Entry* entry = static_cast<SocketSelectorImpl::Entry*>(m_impl->Events[i].data.ptr);
+            entry->ready = true;
+            m_impl->Ready.push_back(entry->socket);
+        }
+
+        return count > 0;
+    }
+#endif
+
     // Setup the timeout
     timeval time;
     time.tv_sec  = static_cast<long>(timeout.asMicroseconds() / 1000000);
@@ -117,6 +290,17 @@ bool SocketSelector::wait(Time timeout)
     // Wait until one of the sockets is ready for reading, or timeout is reached
     int count = select(m_impl->MaxSocket + 1, &m_impl->SocketsReady, NULL, NULL, timeout != Time::Zero ? &time : NULL);
 
+    // select() doesn't tell which sockets are ready, they all have to be tested
+    m_impl->Ready.clear();
+    if (count > 0)
+    {
+        for (SocketSelectorImpl::SocketTable::iterator it = m_impl->Sockets.begin(); it != m_impl->Sockets.end(); ++it)
+        {
+            if (FD_ISSET(it->first, &m_impl->SocketsReady))
+                m_impl->Ready.push_back(it->second.socket);
+        }
+    }
+
     return count > 0;
 }
 
@@ -124,7 +308,32 @@ bool SocketSelector::wait(Time timeout)
 ////////////////////////////////////////////////////////////
 bool SocketSelector::isReady(Socket& socket) const
 {
-    return FD_ISSET(socket.getHandle(), &m_impl->SocketsReady) != 0;
+    if (m_impl->BackendType == SelectBackend)
+        return FD_ISSET(socket.getHandle(), &m_impl->SocketsReady) != 0;
+
+    SocketSelectorImpl::SocketTable::const_iterator it = m_impl->Sockets.find(socket.getHandle());
+    return (it != m_impl->Sockets.end()) && it->second.ready;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t SocketSelector::getReadyCount() const
+{
+    return m_impl->Ready.size();
+}
+
+
+////////////////////////////////////////////////////////////
+Socket& SocketSelector::getReady(std::size_t index) const
+{
+    return *m_impl->Ready[index];
+}
+
+
+////////////////////////////////////////////////////////////
+SocketSelector::Backend SocketSelector::getBackend() const
+{
+    return m_impl->BackendType;
 }
 
 
@@ -138,4 +347,29 @@ SocketSelector& SocketSelector::operator =(const SocketSelector& right)
     return *this;
 }
 
+
+////////////////////////////////////////////////////////////
+void SocketSelector::create(Backend backend, TriggerMode mode)
+{
+    m_impl->BackendType = SelectBackend;
+    m_impl->Mode = LevelTriggered;
+
+#ifdef SFML_SYSTEM_LINUX
+    if (backend != SelectBackend)
+    {
+        m_impl->Epoll = createEpoll();
+        if (m_impl->Epoll >= 0)
+        {
+            m_impl->BackendType = EpollBackend;
+            m_impl->Mode = mode;
+        }
+    }
+#else
+    (void)backend;
+    (void)mode;
+#endif
+
+    clear();
+}
+
 } // namespace sf
@@ -282,10 +282,9 @@ Socket::Status TcpSocket::send(Packet& packet)
     // This means that we have to send the packet size first, so that the
     // receiver knows the actual end of the packet in the data stream.
 
-    // We allocate an extra memory block so that the size can be sent
-    // together with the data in a single call. This may seem inefficient,
-    // but it is actually required to avoid partial send, which could cause
-    // data corruption on the receiving end.
+    // The size and the data are sent together in a single call, to avoid
+    // partial sends which could cause data corruption on the receiving end.
+    // A gathering send does it without copying them into a single block.
 
     // Get the data to send from the packet
     std::size_t size = 0;
@@ -293,17 +292,27 @@ Socket::Status TcpSocket::send(Packet& packet)
 
     // First convert the packet size to network byte order
     Uint32 packetSize = htonl(static_cast<Uint32>(size));
- 
-    // Allocate memory for the data block to send
-    std::vector<char> blockToSend(sizeof(packetSize) + size);
- 
-    // Copy the packet size and data into the block to send
-    std::memcpy(&blockToSend[0], &packetSize, sizeof(packetSize));
-    if (size > 0)
-        std::memcpy(&blockToSend[0] + sizeof(packetSize), data, size);
-
-    // Send the data block
-    return send(&blockToSend[0], blockToSend.size());
+
+    // Send the size and the data
+    int sent = priv::SocketImpl::send(getHandle(), &packetSize, sizeof(packetSize), data, size);
+    if (sent < 0)
+        return priv::SocketImpl::getErrorStatus();
+
+    // The system may not have taken everything at once, send the rest
+    std::size_t sentSize = static_cast<std::size_t>(sent);
+    if (sentSize < sizeof(packetSize))
+    {
+        Status status = send(reinterpret_cast<const char*>(&packetSize) + sentSize, sizeof(packetSize) - sentSize);
+        if (status != Done)
+            return status;
+
+        sentSize = sizeof(packetSize);
+    }
+
+    if (sentSize < sizeof(packetSize) + size)
+        return send(static_cast<const char*>(data) + sentSize - sizeof(packetSize), sizeof(packetSize) + size - sentSize);
+
+    return Done;
 }
 
 
@@ -339,31 +348,34 @@ Socket::Status TcpSocket::receive(Packet& packet)
         packetSize = ntohl(m_pendingPacket.Size);
     }
 
-    // Loop until we receive all the packet data
-    char buffer[1024];
-    while (m_pendingPacket.Data.size() < packetSize)
+    // Loop until we receive all the packet data, directly into the buffer
+    // of the pending packet. The buffer grows with the received data rather
+    // than with the announced size, which is not trusted
+    Packet& pending = m_pendingPacket.Data;
+    while (pending.m_size < packetSize)
     {
         // Receive a chunk of data
-        std::size_t sizeToGet = std::min(static_cast<std::size_t>(packetSize - m_pendingPacket.Data.size()), sizeof(buffer));
-        Status status = receive(buffer, sizeToGet, received);
+        std::size_t sizeToGet = std::min(static_cast<std::size_t>(packetSize - pending.m_size), static_cast<std::size_t>(65536));
+        Status status = receive(pending.reserve(sizeToGet), sizeToGet, received);
         if (status != Done)
             return status;
 
-        // Append it into the packet
-        if (received > 0)
-        {
-            m_pendingPacket.Data.resize(m_pendingPacket.Data.size() + received);
-            char* begin = &m_pendingPacket.Data[0] + m_pendingPacket.Data.size() - received;
-            std::memcpy(begin, buffer, received);
-        }
+        pending.m_size += received;
     }
 
-    // We have received all the packet data: we can copy it to the user packet
-    if (!m_pendingPacket.Data.empty())
-        packet.onReceive(&m_pendingPacket.Data[0], m_pendingPacket.Data.size());
+    // We have received all the packet data: give it to the user packet, which
+    // takes the buffer of the pending packet unless onReceive is overridden
+    if (pending.m_size > 0)
+    {
+        packet.m_incoming = pending.m_buffer;
+        packet.onReceive(pending.getData(), pending.m_size);
+        packet.m_incoming = NULL;
+    }
 
-    // Clear the pending packet data
-    m_pendingPacket = PendingPacket();
+    // Clear the pending packet data, keeping its buffer if it was not taken
+    m_pendingPacket.Size = 0;
+    m_pendingPacket.SizeReceived = 0;
+    pending.clear();
 
     return Done;
 }
@@ -117,6 +117,47 @@ Socket::Status UdpSocket::send(const void* data, std::size_t size, const IpAddre
 }
 
 
+////////////////////////////////////////////////////////////
+Socket::Status UdpSocket::send(const void* data, std::size_t size, const std::vector<Peer>& peers)
+{
+    // Create the internal socket if it doesn't exist
+    create();
+
+    // Make sure that all the data will fit in one datagram
+    if (size > MaxDatagramSize)
+    {
+        err() << "Cannot send data over the network "
+              << "(the number of bytes to send is greater than sf::UdpSocket::MaxDatagramSize)" << std::endl;
+        return Error;
+    }
+
+    // Build the target addresses by blocks, so that no memory is allocated
+    sockaddr_in addresses[64];
+    Status status = Done;
+    std::size_t first = 0;
+    while (first < peers.size())
+    {
+        std::size_t count = std::min<std::size_t>(peers.size() - first, 64);
+        for (std::size_t i = 0; i < count; ++i)
+            addresses[i] = priv::SocketImpl::createAddress(peers[first + i].address.toInteger(), peers[first + i].port);
+
+        int sent = priv::SocketImpl::sendTo(getHandle(), data, size, addresses, count);
+        if (sent < static_cast<int>(count))
+        {
+            // Skip the peer that failed and go on with the next ones
+            status = priv::SocketImpl::getErrorStatus();
+            first += (sent > 0 ? sent : 0) + 1;
+        }
+        else
+        {
+            first += count;
+        }
+    }
+
+    return status;
+}
+
+
 ////////////////////////////////////////////////////////////
 Socket::Status UdpSocket::receive(void* data, std::size_t size, std::size_t& received, IpAddress& remoteAddress, unsigned short& remotePort)
 {
@@ -26,8 +26,10 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Network/Unix/SocketImpl.hpp>
+#include <sys/uio.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <algorithm>
 #include <cstring>
 
 
@@ -73,6 +75,78 @@ void SocketImpl::setBlocking(SocketHandle sock, bool block)
 }
 
 
+////////////////////////////////////////////////////////////
+int SocketImpl::send(SocketHandle sock, const void* header, std::size_t headerSize, const void* data, std::size_t size)
+{
+    iovec buffers[2];
+    buffers[0].iov_base = const_cast<void*>(header);
+    buffers[0].iov_len  = headerSize;
+    buffers[1].iov_base = const_cast<void*>(data);
+    buffers[1].iov_len  = size;
+
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov    = buffers;
+    message.msg_iovlen = (size > 0) ? 2 : 1;
+
+    // Don't raise SIGPIPE if the connection was closed, when possible
+    #ifdef MSG_NOSIGNAL
+        return static_cast<int>(sendmsg(sock, &message, MSG_NOSIGNAL));
+    #else
+        return static_cast<int>(sendmsg(sock, &message, 0));
+    #endif
+}
+
+
+////////////////////////////////////////////////////////////
+int SocketImpl::sendTo(SocketHandle sock, const void* data, std::size_t size, const sockaddr_in* addresses, std::size_t count)
+{
+#if defined(SFML_SYSTEM_LINUX)
+
+    // Send the datagrams by blocks, with a single system call per block
+    iovec buffer;
+    buffer.iov_base = const_cast<void*>(data);
+    buffer.iov_len  = size;
+
+    mmsghdr messages[64];
+    std::size_t sent = 0;
+    while (sent < count)
+    {
+        std::size_t blockSize = std::min<std::size_t>(count - sent, 64);
+        std::memset(messages, 0, blockSize * sizeof(mmsghdr));
+        for (std::size_t i = 0; i < blockSize; ++i)
+        {
+            messages[i].msg_hdr.msg_name    = const_cast<sockaddr_in*>(&addresses[sent + i]);
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov     = &buffer;
+            messages[i].msg_hdr.msg_iovlen  = 1;
+        }
+
+        int result = sendmmsg(sock, messages, static_cast<unsigned int>(blockSize), 0);
+        if (result < 0)
+            return (sent > 0) ? static_cast<int>(sent) : -1;
+
+        sent += result;
+        if (static_cast<std::size_t>(result) < blockSize)
+            break;
+    }
+
+    return static_cast<int>(sent);
+
+#else
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (sendto(sock, data, size, 0, reinterpret_cast<const sockaddr*>(&addresses[i]), sizeof(sockaddr_in)) < 0)
+            return (i > 0) ? static_cast<int>(i) : -1;
+    }
+
+    return static_cast<int>(count);
+
+#endif
+}
+
+
 ////////////////////////////////////////////////////////////
 Socket::Status SocketImpl::getErrorStatus()
 {
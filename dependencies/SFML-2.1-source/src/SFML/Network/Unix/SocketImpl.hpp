@@ -92,6 +92,36 @@ public :
     ////////////////////////////////////////////////////////////
     static void setBlocking(SocketHandle sock, bool block);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Send a header and data in a single call, without
+    ///        copying them into a single block
+    ///
+    /// \param sock       Handle of the socket
+    /// \param header     Pointer to the header to send
+    /// \param headerSize Size of the header, in bytes
+    /// \param data       Pointer to the data to send after the header
+    /// \param size       Size of the data, in bytes
+    ///
+    /// \return Number of bytes sent, or -1 on error
+    ///
+    ////////////////////////////////////////////////////////////
+    static int send(SocketHandle sock, const void* header, std::size_t headerSize, const void* data, std::size_t size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Send the same datagram to several addresses
+    ///
+    /// \param sock      Handle of the socket
+    /// \param data      Pointer to the datagram
+    /// \param size      Size of the datagram, in bytes
+    /// \param addresses Addresses to send the datagram to
+    /// \param count     Number of addresses
+    ///
+    /// \return Number of datagrams sent before the first error,
+    ///         or -1 if the first one failed
+    ///
+    ////////////////////////////////////////////////////////////
+    static int sendTo(SocketHandle sock, const void* data, std::size_t size, const sockaddr_in* addresses, std::size_t count);
+
     ////////////////////////////////////////////////////////////
     /// Get the last socket error status
     ///
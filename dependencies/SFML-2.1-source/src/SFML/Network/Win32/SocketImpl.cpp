@@ -68,6 +68,36 @@ void SocketImpl::setBlocking(SocketHandle sock, bool block)
 }
 
 
+////////////////////////////////////////////////////////////
+int SocketImpl::send(SocketHandle sock, const void* header, std::size_t headerSize, const void* data, std::size_t size)
+{
+    WSABUF buffers[2];
+    buffers[0].buf = static_cast<char*>(const_cast<void*>(header));
+    buffers[0].len = static_cast<u_long>(headerSize);
+    buffers[1].buf = static_cast<char*>(const_cast<void*>(data));
+    buffers[1].len = static_cast<u_long>(size);
+
+    DWORD sent = 0;
+    if (WSASend(sock, buffers, (size > 0) ? 2 : 1, &sent, 0, NULL, NULL) != 0)
+        return -1;
+
+    return static_cast<int>(sent);
+}
+
+
+////////////////////////////////////////////////////////////
+int SocketImpl::sendTo(SocketHandle sock, const void* data, std::size_t size, const sockaddr_in* addresses, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (sendto(sock, static_cast<const char*>(data), static_cast<int>(size), 0, reinterpret_cast<const sockaddr*>(&addresses[i]), sizeof(sockaddr_in)) < 0)
+            return (i > 0) ? static_cast<int>(i) : -1;
+    }
+
+    return static_cast<int>(count);
+}
+
+
 ////////////////////////////////////////////////////////////
 Socket::Status SocketImpl::getErrorStatus()
 {
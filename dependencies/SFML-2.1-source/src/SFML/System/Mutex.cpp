@@ -29,17 +29,29 @@
 
 #if defined(SFML_SYSTEM_WINDOWS)
     #include <SFML/System/Win32/MutexImpl.hpp>
+    #include <SFML/System/Win32/ClockImpl.hpp>
 #else
     #include <SFML/System/Unix/MutexImpl.hpp>
+    #include <SFML/System/Unix/ClockImpl.hpp>
 #endif
 
 
+namespace
+{
+    // Global switch for the contention statistics
+    bool profilingEnabled = false;
+}
+
+
 namespace sf
 {
 ////////////////////////////////////////////////////////////
-Mutex::Mutex()
+Mutex::Mutex(Type type) :
+m_lockDepth  (0),
+m_acquireTime(Time::Zero)
 {
-    m_mutexImpl = new priv::MutexImpl;
+    m_mutexImpl = new priv::MutexImpl(type == Recursive);
+    resetContentionStats();
 }
 
 
@@ -53,14 +65,71 @@ Mutex::~Mutex()
 ////////////////////////////////////////////////////////////
 void Mutex::lock()
 {
-    m_mutexImpl->lock();
+    if (!profilingEnabled)
+    {
+        m_mutexImpl->lock();
+        ++m_lockDepth;
+        return;
+    }
+
+    // Only measure the wait if the mutex is actually taken
+    Time waitTime = Time::Zero;
+    bool contended = !m_mutexImpl->tryLock();
+    if (contended)
+    {
+        Time start = priv::ClockImpl::getCurrentTime();
+        m_mutexImpl->lock();
+        waitTime = priv::ClockImpl::getCurrentTime() - start;
+    }
+
+    // The statistics are protected by the mutex itself
+    if (m_lockDepth++ == 0)
+    {
+        m_stats.lockCount++;
+        if (contended)
+        {
+            m_stats.contentionCount++;
+            m_stats.waitTime += waitTime;
+        }
+        m_acquireTime = priv::ClockImpl::getCurrentTime();
+    }
 }
 
 
 ////////////////////////////////////////////////////////////
 void Mutex::unlock()
 {
+    if ((--m_lockDepth == 0) && (m_acquireTime != Time::Zero))
+    {
+        m_stats.holdTime += priv::ClockImpl::getCurrentTime() - m_acquireTime;
+        m_acquireTime = Time::Zero;
+    }
+
     m_mutexImpl->unlock();
 }
 
+
+////////////////////////////////////////////////////////////
+Mutex::ContentionStats Mutex::getContentionStats() const
+{
+    return m_stats;
+}
+
+
+////////////////////////////////////////////////////////////
+void Mutex::resetContentionStats()
+{
+    m_stats.lockCount       = 0;
+    m_stats.contentionCount = 0;
+    m_stats.waitTime        = Time::Zero;
+    m_stats.holdTime        = Time::Zero;
+}
+
+
+////////////////////////////////////////////////////////////
+void Mutex::setProfilingEnabled(bool enabled)
+{
+    profilingEnabled = enabled;
+}
+
 } // namespace sf
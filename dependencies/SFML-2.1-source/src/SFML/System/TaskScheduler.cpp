@@ -0,0 +1,522 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/TaskScheduler.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <SFML/System/ThreadLocal.hpp>
+
+#if defined(SFML_SYSTEM_WINDOWS)
+    #include <SFML/System/Win32/SemaphoreImpl.hpp>
+#else
+    #include <SFML/System/Unix/SemaphoreImpl.hpp>
+    #include <unistd.h>
+#endif
+
+
+namespace
+{
+    // Add a value to an integer shared between threads, and get the result
+    long atomicAdd(volatile long* value, long increment)
+    {
+    #if defined(SFML_SYSTEM_WINDOWS)
+        return InterlockedExchangeAdd(value, increment) + increment;
+    #else
+        return __sync_add_and_fetch(value, increment);
+    #endif
+    }
+
+    // Read an integer shared between threads, with a full memory barrier
+    long atomicLoad(volatile long* value)
+    {
+        return atomicAdd(value, 0);
+    }
+
+    // Write an integer shared between threads, with a full memory barrier
+    void atomicStore(volatile long* value, long newValue)
+    {
+    #if defined(SFML_SYSTEM_WINDOWS)
+        InterlockedExchange(value, newValue);
+    #else
+        __sync_lock_test_and_set(value, newValue);
+        __sync_synchronize();
+    #endif
+    }
+
+    // Get the number of processor cores available to the process
+    unsigned int getProcessorCount()
+    {
+    #if defined(SFML_SYSTEM_WINDOWS)
+
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        long count = static_cast<long>(info.dwNumberOfProcessors);
+
+    #else
+
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    #endif
+
+        return count > 0 ? static_cast<unsigned int>(count) : 1;
+    }
+
+    // Worker running in the current thread, whatever its scheduler
+    sf::ThreadLocal& getWorkerSlot()
+    {
+        static sf::ThreadLocal* slot = new sf::ThreadLocal;
+        return *slot;
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+struct TaskState
+{
+    enum Status
+    {
+        Waiting, ///< Some dependencies are not done yet
+        Queued,  ///< Waiting in a queue for a thread to run it
+        Running, ///< Being run by a worker or a waiting thread
+        Done     ///< The function has returned
+    };
+
+    TaskState(TaskScheduler* owner, ThreadFunc* entryPoint) :
+    scheduler      (owner),
+    function       (entryPoint),
+    refCount       (2),
+    status         (Waiting),
+    dependencyCount(1),
+    running        (Mutex::NonRecursive)
+    {
+    }
+
+    void release()
+    {
+        if (atomicAdd(&refCount, -1) == 0)
+            delete this;
+    }
+
+    TaskScheduler*          scheduler;       ///< Scheduler running the task
+    ThreadFunc*             function;        ///< Function to run, destroyed once run
+    volatile long           refCount;        ///< Number of handles, plus one for the scheduler until the task is done
+    volatile long           status;          ///< Progress of the task
+    volatile long           dependencyCount; ///< Unfinished dependencies, plus one while they are being registered
+    std::vector<TaskState*> continuations;   ///< Tasks depending on this one, protected by the scheduler's graph mutex
+    Mutex                   running;         ///< Locked during the whole run
+};
+
+} // namespace priv
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler::Task::Task() :
+m_state(NULL)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler::Task::Task(priv::TaskState* state) :
+m_state(state)
+{
+    // The reference was already added when the task was created
+}
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler::Task::Task(const Task& copy) :
+m_state(copy.m_state)
+{
+    if (m_state)
+        atomicAdd(&m_state->refCount, 1);
+}
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler::Task::~Task()
+{
+    if (m_state)
+        m_state->release();
+}
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler::Task& TaskScheduler::Task::operator =(const Task& right)
+{
+    if (right.m_state)
+        atomicAdd(&right.m_state->refCount, 1);
+    if (m_state)
+        m_state->release();
+
+    m_state = right.m_state;
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TaskScheduler::Task::isValid() const
+{
+    return m_state != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TaskScheduler::Task::isDone() const
+{
+    return m_state && (atomicLoad(&m_state->status) == priv::TaskState::Done);
+}
+
+
+////////////////////////////////////////////////////////////
+void TaskScheduler::Task::wait() const
+{
+    if (m_state)
+        m_state->scheduler->wait(m_state);
+}
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler::Worker::Worker(TaskScheduler* owner, std::size_t position) :
+scheduler(owner),
+index    (position),
+thread   (&Worker::run, this),
+mutex    (Mutex::NonRecursive),
+tasks    ()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void TaskScheduler::Worker::run()
+{
+    scheduler->runWorker(*this);
+}
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler::TaskScheduler(unsigned int workerCount) :
+m_workers      (),
+m_mutex        (Mutex::NonRecursive),
+m_tasks        (),
+m_graphMutex   (Mutex::NonRecursive),
+m_sleepMutex   (Mutex::NonRecursive),
+m_semaphore    (new priv::SemaphoreImpl),
+m_sleepingCount(0),
+m_stopping     (false),
+m_queuedCount  (0),
+m_activeCount  (0)
+{
+    if (workerCount == 0)
+        workerCount = getProcessorCount();
+
+    // Create the thread-local slot before the workers race for it
+    getWorkerSlot();
+
+    // All the workers must exist before any of them tries to steal from the others
+    for (unsigned int i = 0; i < workerCount; ++i)
+        m_workers.push_back(new Worker(this, i));
+    for (std::vector<Worker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+        (*it)->thread.launch();
+}
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler::~TaskScheduler()
+{
+    waitAll();
+
+    {
+        Lock lock(m_sleepMutex);
+        m_stopping = true;
+        m_semaphore->post(m_sleepingCount);
+        m_sleepingCount = 0;
+    }
+
+    for (std::vector<Worker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+    {
+        (*it)->thread.wait();
+        delete *it;
+    }
+
+    delete m_semaphore;
+}
+
+
+////////////////////////////////////////////////////////////
+void TaskScheduler::waitAll()
+{
+    Worker* worker = getCurrentWorker();
+
+    while (atomicLoad(&m_activeCount) > 0)
+    {
+        if (priv::TaskState* task = takeTask(worker))
+            execute(task);
+        else
+            sleep(microseconds(100));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+unsigned int TaskScheduler::getWorkerCount() const
+{
+    return static_cast<unsigned int>(m_workers.size());
+}
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler& TaskScheduler::getDefault()
+{
+    // Never destroyed: the program may exit while tasks are still queued
+    static TaskScheduler* scheduler = new TaskScheduler;
+    return *scheduler;
+}
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler::Task TaskScheduler::submit(priv::ThreadFunc* function, const Task* dependencies, std::size_t dependencyCount)
+{
+    // One reference is owned by the returned handle, the other one
+    // by the scheduler until the task has run
+    priv::TaskState* task = new priv::TaskState(this, function);
+    atomicAdd(&m_activeCount, 1);
+
+    for (std::size_t i = 0; i < dependencyCount; ++i)
+    {
+        priv::TaskState* dependency = dependencies[i].m_state;
+        if (!dependency)
+            continue;
+
+        Lock lock(dependency->scheduler->m_graphMutex);
+        if (dependency->status != priv::TaskState::Done)
+        {
+            dependency->continuations.push_back(task);
+            atomicAdd(&task->dependencyCount, 1);
+        }
+    }
+
+    // Remove the extra dependency which prevented the task from being
+    // queued before all its dependencies were registered; if they are
+    // all done already, nobody else will queue it
+    if (atomicAdd(&task->dependencyCount, -1) == 0)
+        enqueue(task);
+
+    return Task(task);
+}
+
+
+////////////////////////////////////////////////////////////
+void TaskScheduler::enqueue(priv::TaskState* task)
+{
+    atomicStore(&task->status, priv::TaskState::Queued);
+
+    // Tasks added by a task stay on the same worker, the others are shared
+    if (Worker* worker = getCurrentWorker())
+    {
+        Lock lock(worker->mutex);
+        worker->tasks.push_back(task);
+    }
+    else
+    {
+        Lock lock(m_mutex);
+        m_tasks.push_back(task);
+    }
+    atomicAdd(&m_queuedCount, 1);
+
+    // Wake up an idle worker, if any
+    Lock lock(m_sleepMutex);
+    if (m_sleepingCount > 0)
+    {
+        m_sleepingCount--;
+        m_semaphore->post(1);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+priv::TaskState* TaskScheduler::takeTask(Worker* worker)
+{
+    if (atomicLoad(&m_queuedCount) <= 0)
+        return NULL;
+
+    priv::TaskState* task = NULL;
+
+    // The newest task of our own queue
+    if (worker)
+    {
+        Lock lock(worker->mutex);
+        if (!worker->tasks.empty())
+        {
+            task = worker->tasks.back();
+            worker->tasks.pop_back();
+        }
+    }
+
+    // The oldest task added from outside the pool
+    if (!task)
+    {
+        Lock lock(m_mutex);
+        if (!m_tasks.empty())
+        {
+            task = m_tasks.front();
+            m_tasks.pop_front();
+        }
+    }
+
+    // The oldest task of another worker, starting with the next one
+    // so that thieves don't all pick the same victim
+    std::size_t count = m_workers.size();
+    std::size_t first = worker ? worker->index + 1 : 0;
+    for (std::size_t i = 0; (i < count) && !task; ++i)
+    {
+        Worker* victim = m_workers[(first + i) % count];
+        if (victim == worker)
+            continue;
+
+        Lock lock(victim->mutex);
+        if (!victim->tasks.empty())
+        {
+            task = victim->tasks.front();
+            victim->tasks.pop_front();
+        }
+    }
+
+    if (task)
+        atomicAdd(&m_queuedCount, -1);
+
+    return task;
+}
+
+
+////////////////////////////////////////////////////////////
+void TaskScheduler::execute(priv::TaskState* task)
+{
+    task->running.lock();
+    atomicStore(&task->status, priv::TaskState::Running);
+
+    task->function->run();
+    delete task->function;
+    task->function = NULL;
+
+    std::vector<priv::TaskState*> continuations;
+    {
+        Lock lock(m_graphMutex);
+        atomicStore(&task->status, priv::TaskState::Done);
+        continuations.swap(task->continuations);
+    }
+
+    // Wake up the threads blocked in wait()
+    task->running.unlock();
+
+    for (std::vector<priv::TaskState*>::iterator it = continuations.begin(); it != continuations.end(); ++it)
+    {
+        if (atomicAdd(&(*it)->dependencyCount, -1) == 0)
+            (*it)->scheduler->enqueue(*it);
+    }
+
+    // Drop the reference owned by the scheduler
+    atomicAdd(&m_activeCount, -1);
+    task->release();
+}
+
+
+////////////////////////////////////////////////////////////
+void TaskScheduler::wait(priv::TaskState* task)
+{
+    Worker* worker = getCurrentWorker();
+
+    while (atomicLoad(&task->status) != priv::TaskState::Done)
+    {
+        // Make progress on other tasks rather than blocking
+        if (priv::TaskState* other = takeTask(worker))
+        {
+            execute(other);
+        }
+        else if (atomicLoad(&task->status) == priv::TaskState::Running)
+        {
+            // The thread running it holds this mutex until it is done
+            task->running.lock();
+            task->running.unlock();
+        }
+        else
+        {
+            // Its dependencies are running in other threads, or a
+            // worker is just about to start it: check again shortly
+            sleep(microseconds(100));
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TaskScheduler::runWorker(Worker& worker)
+{
+    getWorkerSlot().setValue(&worker);
+
+    for (;;)
+    {
+        if (priv::TaskState* task = takeTask(&worker))
+        {
+            execute(task);
+            continue;
+        }
+
+        {
+            Lock lock(m_sleepMutex);
+
+            if (m_stopping)
+                break;
+
+            // A task queued after takeTask gave up didn't see this
+            // worker as idle, so nobody would wake it up for it
+            if (atomicLoad(&m_queuedCount) > 0)
+                continue;
+
+            m_sleepingCount++;
+        }
+
+        m_semaphore->wait();
+    }
+
+    getWorkerSlot().setValue(NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+TaskScheduler::Worker* TaskScheduler::getCurrentWorker() const
+{
+    Worker* worker = static_cast<Worker*>(getWorkerSlot().getValue());
+    return (worker && (worker->scheduler == this)) ? worker : NULL;
+}
+
+} // namespace sf
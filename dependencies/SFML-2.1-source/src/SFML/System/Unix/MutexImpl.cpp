@@ -27,26 +27,69 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/System/Unix/MutexImpl.hpp>
 
+#if defined(SFML_SYSTEM_LINUX)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+
+namespace
+{
+#if defined(SFML_SYSTEM_LINUX)
+
+    // Number of attempts to take a contended mutex before sleeping
+    const int spinCount = 100;
+
+    void futexWait(volatile int* address, int value)
+    {
+        syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+    }
+
+    void futexWake(volatile int* address)
+    {
+        syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+
+#endif
+}
+
 
 namespace sf
 {
 namespace priv
 {
 ////////////////////////////////////////////////////////////
-MutexImpl::MutexImpl()
+MutexImpl::MutexImpl(bool recursive)
+#if defined(SFML_SYSTEM_LINUX)
+    : m_recursive(recursive),
+      m_state    (0)
+#endif
 {
-    // Make it recursive to follow the expected behaviour
+#if defined(SFML_SYSTEM_LINUX)
+    // Non-recursive mutexes are implemented directly on top of a futex
+    if (!recursive)
+        return;
+#endif
+
+    // Recursive unless requested otherwise, to follow the expected behaviour
     pthread_mutexattr_t attributes;
     pthread_mutexattr_init(&attributes);
-    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutexattr_settype(&attributes, recursive ? PTHREAD_MUTEX_RECURSIVE : PTHREAD_MUTEX_NORMAL);
 
     pthread_mutex_init(&m_mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
 }
 
 
 ////////////////////////////////////////////////////////////
 MutexImpl::~MutexImpl()
 {
+#if defined(SFML_SYSTEM_LINUX)
+    if (!m_recursive)
+        return;
+#endif
+
     pthread_mutex_destroy(&m_mutex);
 }
 
@@ -54,13 +97,70 @@ MutexImpl::~MutexImpl()
 ////////////////////////////////////////////////////////////
 void MutexImpl::lock()
 {
+#if defined(SFML_SYSTEM_LINUX)
+    if (!m_recursive)
+    {
+        // Fast path: the mutex is free
+        int state = __sync_val_compare_and_swap(&m_state, 0, 1);
+        if (state == 0)
+            return;
+
+        // The owner is likely to release it soon, try again a few times before sleeping
+        for (int i = 0; i < spinCount; ++i)
+        {
+            if (m_state == 0)
+            {
+                state = __sync_val_compare_and_swap(&m_state, 0, 1);
+                if (state == 0)
+                    return;
+            }
+        }
+
+        // Mark the mutex as contended, so that unlock() wakes us up, and sleep
+        // (this is the "mutex3" algorithm from Ulrich Drepper's "Futexes Are Tricky")
+        if (state != 2)
+            state = __sync_lock_test_and_set(&m_state, 2);
+        while (state != 0)
+        {
+            futexWait(&m_state, 2);
+            state = __sync_lock_test_and_set(&m_state, 2);
+        }
+        return;
+    }
+#endif
+
     pthread_mutex_lock(&m_mutex);
 }
 
 
+////////////////////////////////////////////////////////////
+bool MutexImpl::tryLock()
+{
+#if defined(SFML_SYSTEM_LINUX)
+    if (!m_recursive)
+        return __sync_val_compare_and_swap(&m_state, 0, 1) == 0;
+#endif
+
+    return pthread_mutex_trylock(&m_mutex) == 0;
+}
+
+
 ////////////////////////////////////////////////////////////
 void MutexImpl::unlock()
 {
+#if defined(SFML_SYSTEM_LINUX)
+    if (!m_recursive)
+    {
+        // Only make a system call if another thread may be waiting
+        if (__sync_fetch_and_sub(&m_state, 1) != 1)
+        {
+            __sync_lock_release(&m_state);
+            futexWake(&m_state);
+        }
+        return;
+    }
+#endif
+
     pthread_mutex_unlock(&m_mutex);
 }
 
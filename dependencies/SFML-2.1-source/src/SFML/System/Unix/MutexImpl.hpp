@@ -28,6 +28,7 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
+#include <SFML/Config.hpp>
 #include <SFML/System/NonCopyable.hpp>
 #include <pthread.h>
 
@@ -46,8 +47,10 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
+    /// \param recursive Whether the mutex can be locked several times by the same thread
+    ///
     ////////////////////////////////////////////////////////////
-    MutexImpl();
+    MutexImpl(bool recursive);
 
     ////////////////////////////////////////////////////////////
     /// \brief Destructor
@@ -61,6 +64,14 @@ public :
     ////////////////////////////////////////////////////////////
     void lock();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Lock the mutex if it is available
+    ///
+    /// \return True if the mutex was locked
+    ///
+    ////////////////////////////////////////////////////////////
+    bool tryLock();
+
     ////////////////////////////////////////////////////////////
     /// \brief Unlock the mutex
     ///
@@ -72,7 +83,11 @@ private :
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    pthread_mutex_t m_mutex; ///< pthread handle of the mutex
+    pthread_mutex_t m_mutex;     ///< pthread handle of the mutex
+#if defined(SFML_SYSTEM_LINUX)
+    bool            m_recursive; ///< Use the pthread mutex rather than the futex
+    volatile int    m_state;     ///< Futex word: 0 unlocked, 1 locked, 2 locked with waiters
+#endif
 };
 
 } // namespace priv
@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/Unix/SharedMutexImpl.hpp>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+SharedMutexImpl::SharedMutexImpl()
+{
+    pthread_rwlockattr_t attributes;
+    pthread_rwlockattr_init(&attributes);
+
+#if defined(__GLIBC__)
+    // glibc prefers readers by default, which can starve the writers
+    pthread_rwlockattr_setkind_np(&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+
+    pthread_rwlock_init(&m_lock, &attributes);
+    pthread_rwlockattr_destroy(&attributes);
+}
+
+
+////////////////////////////////////////////////////////////
+SharedMutexImpl::~SharedMutexImpl()
+{
+    pthread_rwlock_destroy(&m_lock);
+}
+
+
+////////////////////////////////////////////////////////////
+void SharedMutexImpl::lock()
+{
+    pthread_rwlock_wrlock(&m_lock);
+}
+
+
+////////////////////////////////////////////////////////////
+void SharedMutexImpl::unlock()
+{
+    pthread_rwlock_unlock(&m_lock);
+}
+
+
+////////////////////////////////////////////////////////////
+void SharedMutexImpl::lockShared()
+{
+    pthread_rwlock_rdlock(&m_lock);
+}
+
+
+////////////////////////////////////////////////////////////
+void SharedMutexImpl::unlockShared()
+{
+    pthread_rwlock_unlock(&m_lock);
+}
+
+} // namespace priv
+
+} // namespace sf
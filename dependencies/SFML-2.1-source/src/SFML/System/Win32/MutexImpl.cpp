@@ -33,9 +33,14 @@ namespace sf
 namespace priv
 {
 ////////////////////////////////////////////////////////////
-MutexImpl::MutexImpl()
+MutexImpl::MutexImpl(bool recursive)
 {
-    InitializeCriticalSection(&m_mutex);
+    // Critical sections are always recursive; for the mutexes
+    // that don't need it, spin a little before sleeping
+    if (recursive)
+        InitializeCriticalSection(&m_mutex);
+    else
+        InitializeCriticalSectionAndSpinCount(&m_mutex, 4000);
 }
 
 
@@ -53,6 +58,13 @@ void MutexImpl::lock()
 }
 
 
+////////////////////////////////////////////////////////////
+bool MutexImpl::tryLock()
+{
+    return TryEnterCriticalSection(&m_mutex) != FALSE;
+}
+
+
 ////////////////////////////////////////////////////////////
 void MutexImpl::unlock()
 {
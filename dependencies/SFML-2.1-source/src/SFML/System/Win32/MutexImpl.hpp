@@ -46,8 +46,10 @@ public :
     ////////////////////////////////////////////////////////////
     /// \brief Default constructor
     ///
+    /// \param recursive Whether the mutex can be locked several times by the same thread
+    ///
     ////////////////////////////////////////////////////////////
-    MutexImpl();
+    MutexImpl(bool recursive);
 
     ////////////////////////////////////////////////////////////
     /// \brief Destructor
@@ -61,6 +63,14 @@ public :
     ////////////////////////////////////////////////////////////
     void lock();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Lock the mutex if it is available
+    ///
+    /// \return True if the mutex was locked
+    ///
+    ////////////////////////////////////////////////////////////
+    bool tryLock();
+
     ////////////////////////////////////////////////////////////
     /// \brief Unlock the mutex
     ///
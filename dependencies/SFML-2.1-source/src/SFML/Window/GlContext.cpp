@@ -40,16 +40,24 @@
 
     #include <SFML/Window/Win32/WglContext.hpp>
     typedef sf::priv::WglContext ContextType;
+    typedef sf::priv::WglContext HeadlessContextType;
 
 #elif defined(SFML_SYSTEM_LINUX) || defined(SFML_SYSTEM_FREEBSD)
 
     #include <SFML/Window/Linux/GlxContext.hpp>
     typedef sf::priv::GlxContext ContextType;
+    #if defined(SFML_USE_EGL)
+        #include <SFML/Window/Linux/EglContext.hpp>
+        typedef sf::priv::EglContext HeadlessContextType;
+    #else
+        typedef sf::priv::GlxContext HeadlessContextType;
+    #endif
 
 #elif defined(SFML_SYSTEM_MACOS)
 
     #include <SFML/Window/OSX/SFContext.hpp>
     typedef sf::priv::SFContext ContextType;
+    typedef sf::priv::SFContext HeadlessContextType;
 
 #endif
 
@@ -60,12 +68,34 @@ namespace
     sf::ThreadLocalPtr<sf::priv::GlContext> currentContext(NULL);
 
     // The hidden, inactive context that will be shared with all other contexts
-    ContextType* sharedContext = NULL;
+    sf::priv::GlContext* sharedContext = NULL;
+
+    // Are contexts created without a display? (see EglContext)
+    bool headless = false;
+
+    // Create a context of the given type, shared with the shared context
+    template <typename T>
+    sf::priv::GlContext* createContext()
+    {
+        return new T(static_cast<T*>(sharedContext));
+    }
+
+    template <typename T>
+    sf::priv::GlContext* createContext(const sf::ContextSettings& settings, const sf::priv::WindowImpl* owner, unsigned int bitsPerPixel)
+    {
+        return new T(static_cast<T*>(sharedContext), settings, owner, bitsPerPixel);
+    }
+
+    template <typename T>
+    sf::priv::GlContext* createContext(const sf::ContextSettings& settings, unsigned int width, unsigned int height)
+    {
+        return new T(static_cast<T*>(sharedContext), settings, width, height);
+    }
 
     // Internal contexts
     sf::ThreadLocalPtr<sf::priv::GlContext> internalContext(NULL);
     std::set<sf::priv::GlContext*> internalContexts;
-    sf::Mutex internalContextsMutex;
+    sf::Mutex internalContextsMutex(sf::Mutex::NonRecursive);
 
     // Check if the internal context of the current thread is valid
     bool hasInternalContext()
@@ -101,8 +131,13 @@ namespace priv
 ////////////////////////////////////////////////////////////
 void GlContext::globalInit()
 {
+#if (defined(SFML_SYSTEM_LINUX) || defined(SFML_SYSTEM_FREEBSD)) && defined(SFML_USE_EGL)
+    // Without an X server, render offscreen with EGL
+    headless = HeadlessContextType::isHeadless();
+#endif
+
     // Create the shared context
-    sharedContext = new ContextType(NULL);
+    sharedContext = headless ? createContext<HeadlessContextType>() : createContext<ContextType>();
     sharedContext->initialize();
 
     // This call makes sure that:
@@ -139,7 +174,7 @@ void GlContext::ensureContext()
 ////////////////////////////////////////////////////////////
 GlContext* GlContext::create()
 {
-    GlContext* context = new ContextType(sharedContext);
+    GlContext* context = headless ? createContext<HeadlessContextType>() : createContext<ContextType>();
     context->initialize();
 
     return context;
@@ -153,7 +188,7 @@ GlContext* GlContext::create(const ContextSettings& settings, const WindowImpl*
     ensureContext();
 
     // Create the context
-    GlContext* context = new ContextType(sharedContext, settings, owner, bitsPerPixel);
+    GlContext* context = headless ? createContext<HeadlessContextType>(settings, owner, bitsPerPixel) : createContext<ContextType>(settings, owner, bitsPerPixel);
     context->initialize();
 
     return context;
@@ -167,7 +202,7 @@ GlContext* GlContext::create(const ContextSettings& settings, unsigned int width
     ensureContext();
 
     // Create the context
-    GlContext* context = new ContextType(sharedContext, settings, width, height);
+    GlContext* context = headless ? createContext<HeadlessContextType>(settings, width, height) : createContext<ContextType>(settings, width, height);
     context->initialize();
 
     return context;
@@ -232,6 +267,14 @@ bool GlContext::setActive(bool active)
 }
 
 
+////////////////////////////////////////////////////////////
+bool GlContext::setAdaptiveVerticalSyncEnabled(bool)
+{
+    // Not supported by default
+    return false;
+}
+
+
 ////////////////////////////////////////////////////////////
 GlContext::GlContext()
 {
@@ -173,6 +173,21 @@ public :
     ////////////////////////////////////////////////////////////
     virtual void setVerticalSyncEnabled(bool enabled) = 0;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable adaptive vertical synchronization
+    ///
+    /// With adaptive v-sync, the buffers are swapped on the next
+    /// vertical blank as usual, but a frame that misses it is
+    /// displayed immediately instead of waiting for the following
+    /// one, which trades a bit of tearing for half the stutter.
+    ///
+    /// \param enabled True to enable adaptive v-sync, false to deactivate v-sync
+    ///
+    /// \return True if adaptive v-sync is supported by the driver
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool setAdaptiveVerticalSyncEnabled(bool enabled);
+
 protected :
 
     ////////////////////////////////////////////////////////////
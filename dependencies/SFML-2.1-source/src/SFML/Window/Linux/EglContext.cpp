@@ -0,0 +1,313 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Window/Linux/EglContext.hpp>
+#include <SFML/Window/WindowImpl.hpp>
+#include <SFML/System/Err.hpp>
+#include <EGL/eglext.h>
+#include <X11/Xlib.h>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+    #define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+
+namespace
+{
+    // The display shared by all the contexts, and its reference counter
+    EGLDisplay sharedDisplay = EGL_NO_DISPLAY;
+    unsigned int referenceCount = 0;
+
+    // Check if an EGL extension is supported (client extensions if display is EGL_NO_DISPLAY)
+    bool hasExtension(EGLDisplay display, const char* name)
+    {
+        const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+        return extensions && std::strstr(extensions, name);
+    }
+
+    EGLDisplay openDisplay()
+    {
+        if (referenceCount == 0)
+        {
+            // Mesa's surfaceless platform needs neither an X server nor a GPU,
+            // it falls back to software rendering; otherwise use the default platform
+            if (hasExtension(EGL_NO_DISPLAY, "EGL_MESA_platform_surfaceless"))
+            {
+                PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+                if (eglGetPlatformDisplayEXT)
+                    sharedDisplay = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+            }
+            if (sharedDisplay == EGL_NO_DISPLAY)
+                sharedDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+            if (!eglInitialize(sharedDisplay, NULL, NULL))
+            {
+                sf::err() << "Failed to initialize the EGL display" << std::endl;
+                sharedDisplay = EGL_NO_DISPLAY;
+            }
+        }
+
+        referenceCount++;
+        return sharedDisplay;
+    }
+
+    void closeDisplay()
+    {
+        referenceCount--;
+        if ((referenceCount == 0) && (sharedDisplay != EGL_NO_DISPLAY))
+        {
+            eglTerminate(sharedDisplay);
+            sharedDisplay = EGL_NO_DISPLAY;
+        }
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+EglContext::EglContext(EglContext* shared) :
+m_display(EGL_NO_DISPLAY),
+m_surface(EGL_NO_SURFACE),
+m_context(EGL_NO_CONTEXT)
+{
+    m_display = openDisplay();
+
+    // Create the context, with a dummy buffer
+    createContext(shared, 1, 1, 32, ContextSettings());
+}
+
+
+////////////////////////////////////////////////////////////
+EglContext::EglContext(EglContext* shared, const ContextSettings& settings, const WindowImpl* owner, unsigned int bitsPerPixel) :
+m_display(EGL_NO_DISPLAY),
+m_surface(EGL_NO_SURFACE),
+m_context(EGL_NO_CONTEXT)
+{
+    m_display = openDisplay();
+
+    // The window can't be rendered to, give the context a buffer of the same size
+    err() << "Headless OpenGL contexts can't render to windows, rendering offscreen instead" << std::endl;
+    Vector2u size = owner->getSize();
+
+    // Create the context
+    createContext(shared, size.x, size.y, bitsPerPixel, settings);
+}
+
+
+////////////////////////////////////////////////////////////
+EglContext::EglContext(EglContext* shared, const ContextSettings& settings, unsigned int width, unsigned int height) :
+m_display(EGL_NO_DISPLAY),
+m_surface(EGL_NO_SURFACE),
+m_context(EGL_NO_CONTEXT)
+{
+    m_display = openDisplay();
+
+    // Create the context
+    createContext(shared, width, height, 32, settings);
+}
+
+
+////////////////////////////////////////////////////////////
+EglContext::~EglContext()
+{
+    if (m_display != EGL_NO_DISPLAY)
+    {
+        // Destroy the context
+        if (m_context != EGL_NO_CONTEXT)
+        {
+            if (eglGetCurrentContext() == m_context)
+                eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext(m_display, m_context);
+        }
+
+        // Destroy the offscreen buffer
+        if (m_surface != EGL_NO_SURFACE)
+            eglDestroySurface(m_display, m_surface);
+    }
+
+    closeDisplay();
+}
+
+
+////////////////////////////////////////////////////////////
+bool EglContext::makeCurrent()
+{
+    return (m_context != EGL_NO_CONTEXT) && eglMakeCurrent(m_display, m_surface, m_surface, m_context);
+}
+
+
+////////////////////////////////////////////////////////////
+void EglContext::display()
+{
+    // Nothing to do
+}
+
+
+////////////////////////////////////////////////////////////
+void EglContext::setVerticalSyncEnabled(bool)
+{
+    // Nothing to do
+}
+
+
+////////////////////////////////////////////////////////////
+bool EglContext::isHeadless()
+{
+    if (std::getenv("SFML_HEADLESS"))
+        return true;
+
+    // Try to reach the X server
+    ::Display* display = XOpenDisplay(NULL);
+    if (!display)
+        return true;
+
+    XCloseDisplay(display);
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+void EglContext::createContext(EglContext* shared, unsigned int width, unsigned int height, unsigned int bitsPerPixel, const ContextSettings& settings)
+{
+    // Save the creation settings
+    m_settings = settings;
+
+    if (m_display == EGL_NO_DISPLAY)
+        return;
+
+    // Desktop OpenGL is wanted, not OpenGL ES (this is a per-thread setting)
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        err() << "Failed to create an OpenGL context, EGL doesn't support desktop OpenGL" << std::endl;
+        return;
+    }
+
+    // Select a config that matches the requested context settings
+    EGLint configAttributes[] =
+    {
+        EGL_DEPTH_SIZE, static_cast<EGLint>(settings.depthBits),
+        EGL_STENCIL_SIZE, static_cast<EGLint>(settings.stencilBits),
+        EGL_SAMPLE_BUFFERS, settings.antialiasingLevel > 0,
+        EGL_SAMPLES, static_cast<EGLint>(settings.antialiasingLevel),
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, bitsPerPixel == 32 ? 8 : 0,
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint nbConfigs = 0;
+    if (!eglChooseConfig(m_display, configAttributes, &config, 1, &nbConfigs) || (nbConfigs == 0))
+    {
+        err() << "Failed to create an OpenGL context, no EGL config matches the requested settings" << std::endl;
+        return;
+    }
+
+    // Create the offscreen buffer
+    EGLint surfaceAttributes[] =
+    {
+        EGL_WIDTH, static_cast<EGLint>(width),
+        EGL_HEIGHT, static_cast<EGLint>(height),
+        EGL_NONE
+    };
+    m_surface = eglCreatePbufferSurface(m_display, config, surfaceAttributes);
+    if (m_surface == EGL_NO_SURFACE)
+    {
+        err() << "Failed to create the offscreen buffer of an OpenGL context" << std::endl;
+        return;
+    }
+
+    // Get the context to share display lists with
+    EGLContext toShare = shared ? shared->m_context : EGL_NO_CONTEXT;
+
+    // Create the OpenGL context -- first try context versions >= 3.0 if it is requested (they require special code)
+    if ((m_settings.majorVersion >= 3) && hasExtension(m_display, "EGL_KHR_create_context"))
+    {
+        while ((m_context == EGL_NO_CONTEXT) && (m_settings.majorVersion >= 3))
+        {
+            EGLint attributes[] =
+            {
+                EGL_CONTEXT_MAJOR_VERSION_KHR, static_cast<EGLint>(m_settings.majorVersion),
+                EGL_CONTEXT_MINOR_VERSION_KHR, static_cast<EGLint>(m_settings.minorVersion),
+                EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT_KHR,
+                EGL_NONE
+            };
+            m_context = eglCreateContext(m_display, config, toShare, attributes);
+
+            // If we couldn't create the context, lower the version number and try again -- stop at 3.0
+            if (m_context == EGL_NO_CONTEXT)
+            {
+                if (m_settings.minorVersion > 0)
+                {
+                    m_settings.minorVersion--;
+                }
+                else
+                {
+                    m_settings.majorVersion--;
+                    m_settings.minorVersion = 9;
+                }
+            }
+        }
+    }
+
+    // If the OpenGL >= 3.0 context failed or if we don't want one, create a regular OpenGL 1.x/2.x context
+    if (m_context == EGL_NO_CONTEXT)
+    {
+        // set the context version to 2.0 (arbitrary)
+        m_settings.majorVersion = 2;
+        m_settings.minorVersion = 0;
+
+        m_context = eglCreateContext(m_display, config, toShare, NULL);
+        if (m_context == EGL_NO_CONTEXT)
+        {
+            err() << "Failed to create an offscreen OpenGL context" << std::endl;
+            return;
+        }
+    }
+
+    // Update the creation settings from the chosen config
+    EGLint depth, stencil, multiSampling, samples;
+    eglGetConfigAttrib(m_display, config, EGL_DEPTH_SIZE,     &depth);
+    eglGetConfigAttrib(m_display, config, EGL_STENCIL_SIZE,   &stencil);
+    eglGetConfigAttrib(m_display, config, EGL_SAMPLE_BUFFERS, &multiSampling);
+    eglGetConfigAttrib(m_display, config, EGL_SAMPLES,        &samples);
+    m_settings.depthBits         = static_cast<unsigned int>(depth);
+    m_settings.stencilBits       = static_cast<unsigned int>(stencil);
+    m_settings.antialiasingLevel = multiSampling ? samples : 0;
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2013 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_EGLCONTEXT_HPP
+#define SFML_EGLCONTEXT_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Window/GlContext.hpp>
+#include <EGL/egl.h>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// \brief Linux (EGL) implementation of offscreen OpenGL contexts
+///
+/// These contexts don't need an X server: they are used
+/// instead of GLX contexts by programs that only render
+/// offscreen, on machines without a display.
+///
+////////////////////////////////////////////////////////////
+class EglContext : public GlContext
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a new default context
+    ///
+    /// \param shared Context to share the new one with (can be NULL)
+    ///
+    ////////////////////////////////////////////////////////////
+    EglContext(EglContext* shared);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a new context attached to a window
+    ///
+    /// EGL contexts can't draw to X windows: the context renders
+    /// to an offscreen buffer of the size of the window instead.
+    ///
+    /// \param shared       Context to share the new one with
+    /// \param settings     Creation parameters
+    /// \param owner        Pointer to the owner window
+    /// \param bitsPerPixel Pixel depth, in bits per pixel
+    ///
+    ////////////////////////////////////////////////////////////
+    EglContext(EglContext* shared, const ContextSettings& settings, const WindowImpl* owner, unsigned int bitsPerPixel);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a new context that embeds its own rendering target
+    ///
+    /// \param shared   Context to share the new one with
+    /// \param settings Creation parameters
+    /// \param width    Back buffer width, in pixels
+    /// \param height   Back buffer height, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    EglContext(EglContext* shared, const ContextSettings& settings, unsigned int width, unsigned int height);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~EglContext();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Activate the context as the current target for rendering
+    ///
+    /// \return True on success, false if any error happened
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool makeCurrent();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Display what has been rendered to the context so far
+    ///
+    /// Offscreen buffers are never displayed: this does nothing.
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void display();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable vertical synchronization
+    ///
+    /// Offscreen buffers are never displayed: this does nothing.
+    ///
+    /// \param enabled True to enable v-sync, false to deactivate
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void setVerticalSyncEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether contexts must be created with EGL
+    ///
+    /// This is the case when no X server can be reached, or when
+    /// the SFML_HEADLESS environment variable is set (to get the
+    /// same contexts on every machine, for example).
+    ///
+    /// \return True if EGL contexts must be used instead of GLX ones
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isHeadless();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the context and its offscreen buffer
+    ///
+    /// \param shared       Context to share the new one with (can be NULL)
+    /// \param width        Width of the offscreen buffer, in pixels
+    /// \param height       Height of the offscreen buffer, in pixels
+    /// \param bitsPerPixel Pixel depth, in bits per pixel
+    /// \param settings     Creation parameters
+    ///
+    ////////////////////////////////////////////////////////////
+    void createContext(EglContext* shared, unsigned int width, unsigned int height, unsigned int bitsPerPixel, const ContextSettings& settings);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    EGLDisplay m_display; ///< EGL display, shared by all the contexts
+    EGLSurface m_surface; ///< Offscreen buffer (pbuffer) the context renders to
+    EGLContext m_context; ///< OpenGL context
+};
+
+} // namespace priv
+
+} // namespace sf
+
+#endif // SFML_EGLCONTEXT_HPP
@@ -32,6 +32,7 @@
 #include <SFML/OpenGL.hpp>
 #include <SFML/Window/glext/glxext.h>
 #include <SFML/System/Err.hpp>
+#include <cstring>
 
 
 namespace sf
@@ -157,6 +158,24 @@ void GlxContext::setVerticalSyncEnabled(bool enabled)
 }
 
 
+////////////////////////////////////////////////////////////
+bool GlxContext::setAdaptiveVerticalSyncEnabled(bool enabled)
+{
+    // A negative swap interval requests adaptive v-sync (GLX_EXT_swap_control_tear)
+    const char* extensions = glXQueryExtensionsString(m_display, DefaultScreen(m_display));
+    if (!extensions || !std::strstr(extensions, "GLX_EXT_swap_control_tear"))
+        return false;
+
+    const GLubyte* name = reinterpret_cast<const GLubyte*>("glXSwapIntervalEXT");
+    PFNGLXSWAPINTERVALEXTPROC glXSwapIntervalEXT = reinterpret_cast<PFNGLXSWAPINTERVALEXTPROC>(glXGetProcAddress(name));
+    if (!glXSwapIntervalEXT || !m_window)
+        return false;
+
+    glXSwapIntervalEXT(m_display, m_window, enabled ? -1 : 0);
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 XVisualInfo GlxContext::selectBestVisual(::Display* display, unsigned int bitsPerPixel, const ContextSettings& settings)
 {
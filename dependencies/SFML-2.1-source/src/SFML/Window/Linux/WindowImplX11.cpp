@@ -31,6 +31,8 @@
 #include <SFML/Window/Linux/Display.hpp>
 #include <SFML/System/Utf.hpp>
 #include <SFML/System/Err.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
 #include <X11/Xutil.h>
 #include <X11/keysym.h>
 #include <X11/extensions/Xrandr.h>
@@ -38,6 +40,8 @@
 #include <cstring>
 #include <sstream>
 #include <vector>
+#include <deque>
+#include <map>
 #include <string>
 #include <iterator>
 
@@ -52,11 +56,59 @@ namespace
                                                 PointerMotionMask | KeyPressMask | KeyReleaseMask | StructureNotifyMask |
                                                 EnterWindowMask | LeaveWindowMask;
 
-    // Filter the events received by windows (only allow those matching a specific window)
-    Bool checkEvent(::Display*, XEvent* event, XPointer userData)
+    // Events read from the X connection, waiting to be processed by their window
+    typedef std::map< ::Window, std::deque<XEvent> > WindowEventMap;
+    WindowEventMap& getWindowEvents()
     {
-        // Just check if the event matches the window
-        return event->xany.window == reinterpret_cast< ::Window >(userData);
+        // Never destroyed, so that windows can safely outlive static objects
+        static WindowEventMap* windowEvents = new WindowEventMap;
+        return *windowEvents;
+    }
+
+    // Protects the map above, windows may process their events in different threads
+    sf::Mutex& getWindowEventsMutex()
+    {
+        static sf::Mutex* mutex = new sf::Mutex;
+        return *mutex;
+    }
+
+    // Read all the events available on the connection in one go, and hand them
+    // to their window, rather than searching the X queue once per event.
+    // Must be called with the window events mutex locked.
+    void readEvents(::Display* display, int mode)
+    {
+        WindowEventMap& windowEvents = getWindowEvents();
+        std::vector<XEvent> unknownEvents;
+
+        int count = XEventsQueued(display, mode);
+        for (int i = 0; i < count; ++i)
+        {
+            XEvent event;
+            XNextEvent(display, &event);
+
+            WindowEventMap::iterator it = windowEvents.find(event.xany.window);
+            if (it != windowEvents.end())
+                it->second.push_back(event);
+            else
+                unknownEvents.push_back(event);
+        }
+
+        // Leave the events of windows that are not registered (yet) in the X queue,
+        // in their original order, like XCheckIfEvent used to
+        for (std::vector<XEvent>::reverse_iterator it = unknownEvents.rbegin(); it != unknownEvents.rend(); ++it)
+            XPutBackEvent(display, &*it);
+    }
+
+    // Read the pending events and move those of a window to the end of the given queue
+    void takeEvents(::Display* display, ::Window window, int mode, std::deque<XEvent>& events)
+    {
+        sf::Lock lock(getWindowEventsMutex());
+
+        readEvents(display, mode);
+
+        std::deque<XEvent>& windowEvents = getWindowEvents()[window];
+        events.insert(events.end(), windowEvents.begin(), windowEvents.end());
+        windowEvents.clear();
     }
 
     // Find the name of the current executable
@@ -272,6 +324,12 @@ WindowImplX11::~WindowImplX11()
     // Cleanup graphical resources
     cleanup();
 
+    // Drop the events that were not processed
+    {
+        sf::Lock lock(getWindowEventsMutex());
+        getWindowEvents().erase(m_window);
+    }
+
     // Destroy the cursor
     if (m_hiddenCursor)
         XFreeCursor(m_display, m_hiddenCursor);
@@ -306,9 +364,44 @@ WindowHandle WindowImplX11::getSystemHandle() const
 ////////////////////////////////////////////////////////////
 void WindowImplX11::processEvents()
 {
-    XEvent event;
-    while (XCheckIfEvent(m_display, &event, &checkEvent, reinterpret_cast<XPointer>(m_window)))
+    std::deque<XEvent> events;
+    takeEvents(m_display, m_window, QueuedAfterFlush, events);
+
+    while (!events.empty())
     {
+        XEvent event = events.front();
+        events.pop_front();
+
+        // This implements a workaround to properly discard repeated key
+        // events when necessary. The problem is that the system's key events
+        // policy doesn't match SFML's one: X server will generate both repeated
+        // KeyPress and KeyRelease events when maintaining a key down, while
+        // SFML only wants repeated KeyPress events. Thus, we have to:
+        // - Discard duplicated KeyRelease events when KeyRepeatEnabled is true
+        // - Discard both duplicated KeyPress and KeyRelease events when KeyRepeatEnabled is false
+        // (code shamelessly taken from SDL)
+        if ((event.type == KeyRelease) && events.empty())
+        {
+            // The matching KeyPress may have arrived in the meantime
+            takeEvents(m_display, m_window, QueuedAfterReading, events);
+        }
+        if ((event.type == KeyRelease) && !events.empty())
+        {
+            // Check if the next event is a matching KeyPress
+            const XEvent& nextEvent = events.front();
+            if ((nextEvent.type == KeyPress) &&
+                (nextEvent.xkey.keycode == event.xkey.keycode) &&
+                (nextEvent.xkey.time - event.xkey.time < 2))
+            {
+                // If we don't want repeated events, remove the next KeyPress as well
+                if (!m_keyRepeat)
+                    events.pop_front();
+
+                // This KeyRelease is a repeated event and we don't want it
+                continue;
+            }
+        }
+
         processEvent(event);
     }
 }
@@ -517,6 +610,12 @@ void WindowImplX11::switchToFullscreen(const VideoMode& mode)
 ////////////////////////////////////////////////////////////
 void WindowImplX11::initialize()
 {
+    // Register the window so that it receives the events read by other windows
+    {
+        sf::Lock lock(getWindowEventsMutex());
+        getWindowEvents()[m_window];
+    }
+
     // Get the atom defining the close event
     m_atomClose = XInternAtom(m_display, "WM_DELETE_WINDOW", false);
     XSetWMProtocols(m_display, m_window, &m_atomClose, 1);
@@ -603,41 +702,6 @@ void WindowImplX11::cleanup()
 ////////////////////////////////////////////////////////////
 bool WindowImplX11::processEvent(XEvent windowEvent)
 {
-    // This function implements a workaround to properly discard
-    // repeated key events when necessary. The problem is that the
-    // system's key events policy doesn't match SFML's one: X server will generate
-    // both repeated KeyPress and KeyRelease events when maintaining a key down, while
-    // SFML only wants repeated KeyPress events. Thus, we have to:
-    // - Discard duplicated KeyRelease events when KeyRepeatEnabled is true
-    // - Discard both duplicated KeyPress and KeyRelease events when KeyRepeatEnabled is false
-
-    // Detect repeated key events
-    // (code shamelessly taken from SDL)
-    if (windowEvent.type == KeyRelease)
-    {
-        // Check if there's a matching KeyPress event in the queue
-        XEvent nextEvent;
-        if (XPending(m_display))
-        {
-            // Grab it but don't remove it from the queue, it still needs to be processed :)
-            XPeekEvent(m_display, &nextEvent);
-            if (nextEvent.type == KeyPress)
-            {
-                // Check if it is a duplicated event (same timestamp as the KeyRelease event)
-                if ((nextEvent.xkey.keycode == windowEvent.xkey.keycode) &&
-                    (nextEvent.xkey.time - windowEvent.xkey.time < 2))
-                {
-                    // If we don't want repeated events, remove the next KeyPress from the queue
-                    if (!m_keyRepeat)
-                        XNextEvent(m_display, &nextEvent);
-
-                    // This KeyRelease is a repeated event and we don't want it
-                    return false;
-                }
-            }
-        }
-    }
-
     // Convert the X11 event to a sf::Event
     switch (windowEvent.type)
     {
@@ -31,6 +31,7 @@
 #include <SFML/System/Lock.hpp>
 #include <SFML/System/Mutex.hpp>
 #include <SFML/System/Err.hpp>
+#include <cstring>
 
 
 namespace sf
@@ -144,6 +145,24 @@ void WglContext::setVerticalSyncEnabled(bool enabled)
 }
 
 
+////////////////////////////////////////////////////////////
+bool WglContext::setAdaptiveVerticalSyncEnabled(bool enabled)
+{
+    // A negative swap interval requests adaptive v-sync (WGL_EXT_swap_control_tear)
+    PFNWGLGETEXTENSIONSSTRINGARBPROC wglGetExtensionsStringARB = reinterpret_cast<PFNWGLGETEXTENSIONSSTRINGARBPROC>(wglGetProcAddress("wglGetExtensionsStringARB"));
+    const char* extensions = wglGetExtensionsStringARB ? wglGetExtensionsStringARB(m_deviceContext) : NULL;
+    if (!extensions || !std::strstr(extensions, "WGL_EXT_swap_control_tear"))
+        return false;
+
+    PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT = reinterpret_cast<PFNWGLSWAPINTERVALEXTPROC>(wglGetProcAddress("wglSwapIntervalEXT"));
+    if (!wglSwapIntervalEXT)
+        return false;
+
+    wglSwapIntervalEXT(enabled ? -1 : 0);
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 void WglContext::createContext(WglContext* shared, unsigned int bitsPerPixel, const ContextSettings& settings)
 {
@@ -30,11 +30,19 @@
 #include <SFML/Window/WindowImpl.hpp>
 #include <SFML/System/Sleep.hpp>
 #include <SFML/System/Err.hpp>
+#include <algorithm>
 
 
 namespace
 {
     const sf::Window* fullscreenWindow = NULL;
+
+    // Number of recent frame times kept for the percentile
+    const std::size_t frameHistorySize = 128;
+
+    // Bounds of the time spun instead of slept before a frame deadline
+    const sf::Time minSleepMargin = sf::microseconds(250);
+    const sf::Time maxSleepMargin = sf::milliseconds(2);
 }
 
 
@@ -42,10 +50,17 @@ namespace sf
 {
 ////////////////////////////////////////////////////////////
 Window::Window() :
-m_impl          (NULL),
-m_context       (NULL),
-m_frameTimeLimit(Time::Zero),
-m_size          (0, 0)
+m_impl           (NULL),
+m_context        (NULL),
+m_frameTimeLimit (Time::Zero),
+m_frameDeadline  (Time::Zero),
+m_lastFrame      (Time::Zero),
+m_sleepMargin    (milliseconds(2)),
+m_frameTimes     (),
+m_frameTimeSum   (Time::Zero),
+m_frameCount     (0),
+m_missedDeadlines(0),
+m_size           (0, 0)
 {
 
 }
@@ -53,10 +68,17 @@ m_size          (0, 0)
 
 ////////////////////////////////////////////////////////////
 Window::Window(VideoMode mode, const String& title, Uint32 style, const ContextSettings& settings) :
-m_impl          (NULL),
-m_context       (NULL),
-m_frameTimeLimit(Time::Zero),
-m_size          (0, 0)
+m_impl           (NULL),
+m_context        (NULL),
+m_frameTimeLimit (Time::Zero),
+m_frameDeadline  (Time::Zero),
+m_lastFrame      (Time::Zero),
+m_sleepMargin    (milliseconds(2)),
+m_frameTimes     (),
+m_frameTimeSum   (Time::Zero),
+m_frameCount     (0),
+m_missedDeadlines(0),
+m_size           (0, 0)
 {
     create(mode, title, style, settings);
 }
@@ -64,10 +86,17 @@ m_size          (0, 0)
 
 ////////////////////////////////////////////////////////////
 Window::Window(WindowHandle handle, const ContextSettings& settings) :
-m_impl          (NULL),
-m_context       (NULL),
-m_frameTimeLimit(Time::Zero),
-m_size          (0, 0)
+m_impl           (NULL),
+m_context        (NULL),
+m_frameTimeLimit (Time::Zero),
+m_frameDeadline  (Time::Zero),
+m_lastFrame      (Time::Zero),
+m_sleepMargin    (milliseconds(2)),
+m_frameTimes     (),
+m_frameTimeSum   (Time::Zero),
+m_frameCount     (0),
+m_missedDeadlines(0),
+m_size           (0, 0)
 {
     create(handle, settings);
 }
@@ -194,6 +223,25 @@ bool Window::pollEvent(Event& event)
 }
 
 
+////////////////////////////////////////////////////////////
+std::size_t Window::pollEvents(Event* events, std::size_t maxCount)
+{
+    if (!m_impl)
+        return 0;
+
+    // Keep the events accepted by the filter, in order
+    std::size_t count = m_impl->popEvents(events, maxCount);
+    std::size_t accepted = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (filterEvent(events[i]))
+            events[accepted++] = events[i];
+    }
+
+    return accepted;
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Window::waitEvent(Event& event)
 {
@@ -270,6 +318,17 @@ void Window::setVerticalSyncEnabled(bool enabled)
 }
 
 
+////////////////////////////////////////////////////////////
+void Window::setAdaptiveVerticalSyncEnabled(bool enabled)
+{
+    if (setActive())
+    {
+        if (!m_context->setAdaptiveVerticalSyncEnabled(enabled))
+            m_context->setVerticalSyncEnabled(enabled);
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 void Window::setMouseCursorVisible(bool visible)
 {
@@ -290,9 +349,43 @@ void Window::setKeyRepeatEnabled(bool enabled)
 void Window::setFramerateLimit(unsigned int limit)
 {
     if (limit > 0)
-        m_frameTimeLimit = seconds(1.f / limit);
+        m_frameTimeLimit = microseconds(1000000 / limit);
     else
         m_frameTimeLimit = Time::Zero;
+
+    // Start scheduling from the current frame
+    m_frameDeadline = m_lastFrame;
+}
+
+
+////////////////////////////////////////////////////////////
+Window::FrameStats Window::getFrameStats() const
+{
+    FrameStats stats;
+    stats.frameCount      = m_frameCount;
+    stats.missedDeadlines = m_missedDeadlines;
+    stats.meanFrameTime   = m_frameCount ? m_frameTimeSum / static_cast<Int64>(m_frameCount) : Time::Zero;
+    stats.p99FrameTime    = Time::Zero;
+
+    if (!m_frameTimes.empty())
+    {
+        std::vector<Time> sorted(m_frameTimes);
+        std::vector<Time>::iterator percentile = sorted.begin() + (sorted.size() - 1) * 99 / 100;
+        std::nth_element(sorted.begin(), percentile, sorted.end());
+        stats.p99FrameTime = *percentile;
+    }
+
+    return stats;
+}
+
+
+////////////////////////////////////////////////////////////
+void Window::resetFrameStats()
+{
+    m_frameTimes.clear();
+    m_frameTimeSum    = Time::Zero;
+    m_frameCount      = 0;
+    m_missedDeadlines = 0;
 }
 
 
@@ -331,14 +424,13 @@ void Window::display()
 {
     // Display the backbuffer on screen
     if (setActive())
-        m_context->display();
-
-    // Limit the framerate if needed
-    if (m_frameTimeLimit != Time::Zero)
     {
-        sleep(m_frameTimeLimit - m_clock.getElapsedTime());
-        m_clock.restart();
+        m_context->display();
+        onDisplay();
     }
+
+    // Limit the framerate if needed, and measure the frame
+    paceFrame();
 }
 
 
@@ -363,6 +455,13 @@ void Window::onResize()
 }
 
 
+////////////////////////////////////////////////////////////
+void Window::onDisplay()
+{
+    // Nothing by default
+}
+
+
 ////////////////////////////////////////////////////////////
 bool Window::filterEvent(const Event& event)
 {
@@ -395,6 +494,8 @@ void Window::initialize()
 
     // Reset frame time
     m_clock.restart();
+    m_frameDeadline = Time::Zero;
+    m_lastFrame = Time::Zero;
 
     // Activate the window
     setActive();
@@ -403,4 +504,58 @@ void Window::initialize()
     onCreate();
 }
 
+
+////////////////////////////////////////////////////////////
+void Window::paceFrame()
+{
+    Time now = m_clock.getElapsedTime();
+
+    if (m_frameTimeLimit != Time::Zero)
+    {
+        m_frameDeadline += m_frameTimeLimit;
+
+        if (now > m_frameDeadline)
+        {
+            // Too late: restart from now rather than catching up with a burst of short frames
+            ++m_missedDeadlines;
+            m_frameDeadline = now;
+        }
+        else
+        {
+            // Sleep while the deadline is far enough, the scheduler may wake us up late
+            Time overshoot = Time::Zero;
+            while (m_frameDeadline - now > m_sleepMargin)
+            {
+                Time request = m_frameDeadline - now - m_sleepMargin;
+                sleep(request);
+                Time woken = m_clock.getElapsedTime();
+
+                overshoot = std::max(overshoot, woken - now - request);
+                now = woken;
+            }
+
+            // Spin for the remaining time
+            while (now < m_frameDeadline)
+                now = m_clock.getElapsedTime();
+
+            // Once per frame, keep the margin above the recent oversleeps and shrink it back
+            // slowly; the cap keeps a single long oversleep from turning sleeps into spins
+            m_sleepMargin = std::max(overshoot + minSleepMargin, m_sleepMargin - m_sleepMargin / Int64(16));
+            m_sleepMargin = std::min(m_sleepMargin, maxSleepMargin);
+        }
+    }
+
+    // Record the frame time
+    Time frameTime = now - m_lastFrame;
+    m_lastFrame = now;
+
+    if (m_frameTimes.size() < frameHistorySize)
+        m_frameTimes.push_back(frameTime);
+    else
+        m_frameTimes[m_frameCount % frameHistorySize] = frameTime;
+
+    m_frameTimeSum += frameTime;
+    ++m_frameCount;
+}
+
 } // namespace sf
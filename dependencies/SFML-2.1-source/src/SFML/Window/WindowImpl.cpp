@@ -50,6 +50,13 @@
 #endif
 
 
+namespace
+{
+    // Initial capacity of the event ring buffer, enough for a few frames of input
+    const std::size_t initialEventCapacity = 256;
+}
+
+
 namespace sf
 {
 namespace priv
@@ -70,6 +77,9 @@ WindowImpl* WindowImpl::create(WindowHandle handle)
 
 ////////////////////////////////////////////////////////////
 WindowImpl::WindowImpl() :
+m_events      (initialEventCapacity),
+m_firstEvent  (0),
+m_eventCount  (0),
 m_joyThreshold(0.1f)
 {
     // Get the initial joystick states
@@ -97,7 +107,7 @@ void WindowImpl::setJoystickThreshold(float threshold)
 bool WindowImpl::popEvent(Event& event, bool block)
 {
     // If the event queue is empty, let's first check if new events are available from the OS
-    if (m_events.empty())
+    if (m_eventCount == 0)
     {
         if (!block)
         {
@@ -112,7 +122,7 @@ bool WindowImpl::popEvent(Event& event, bool block)
             // Here we use a manual wait loop instead of the optimized
             // wait-event provided by the OS, so that we don't skip joystick
             // events (which require polling)
-            while (m_events.empty())
+            while (m_eventCount == 0)
             {
                 processJoystickEvents();
                 processEvents();
@@ -122,10 +132,11 @@ bool WindowImpl::popEvent(Event& event, bool block)
     }
 
     // Pop the first event of the queue, if it is not empty
-    if (!m_events.empty())
+    if (m_eventCount > 0)
     {
-        event = m_events.front();
-        m_events.pop();
+        event = m_events[m_firstEvent];
+        m_firstEvent = (m_firstEvent + 1) % m_events.size();
+        --m_eventCount;
 
         return true;
     }
@@ -134,10 +145,44 @@ bool WindowImpl::popEvent(Event& event, bool block)
 }
 
 
+////////////////////////////////////////////////////////////
+std::size_t WindowImpl::popEvents(Event* events, std::size_t maxCount)
+{
+    // If the event queue is empty, let's first check if new events are available from the OS
+    if (m_eventCount == 0)
+    {
+        processJoystickEvents();
+        processEvents();
+    }
+
+    // Copy the events in at most two contiguous parts
+    std::size_t count = std::min(maxCount, m_eventCount);
+    std::size_t first = std::min(count, m_events.size() - m_firstEvent);
+    std::copy(m_events.begin() + m_firstEvent, m_events.begin() + m_firstEvent + first, events);
+    std::copy(m_events.begin(), m_events.begin() + (count - first), events + first);
+
+    m_firstEvent = (m_firstEvent + count) % m_events.size();
+    m_eventCount -= count;
+
+    return count;
+}
+
+
 ////////////////////////////////////////////////////////////
 void WindowImpl::pushEvent(const Event& event)
 {
-    m_events.push(event);
+    // Grow the ring buffer if it is full, unrolling it so that the oldest event is first
+    if (m_eventCount == m_events.size())
+    {
+        std::vector<Event> events(m_events.size() * 2);
+        std::copy(m_events.begin() + m_firstEvent, m_events.end(), events.begin());
+        std::copy(m_events.begin(), m_events.begin() + m_firstEvent, events.begin() + (m_events.size() - m_firstEvent));
+        m_events.swap(events);
+        m_firstEvent = 0;
+    }
+
+    m_events[(m_firstEvent + m_eventCount) % m_events.size()] = event;
+    ++m_eventCount;
 }
 
 
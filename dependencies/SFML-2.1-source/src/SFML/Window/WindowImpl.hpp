@@ -37,8 +37,8 @@
 #include <SFML/Window/VideoMode.hpp>
 #include <SFML/Window/WindowHandle.hpp>
 #include <SFML/Window/ContextSettings.hpp>
-#include <queue>
 #include <set>
+#include <vector>
 
 namespace sf
 {
@@ -110,6 +110,20 @@ public :
     ////////////////////////////////////////////////////////////
     bool popEvent(Event& event, bool block);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Return all the window events available, up to a maximum
+    ///
+    /// If there's no event available, this function calls the
+    /// window's internal event processing function. It never blocks.
+    ///
+    /// \param events   Array to fill with the events
+    /// \param maxCount Size of the \a events array
+    ///
+    /// \return Number of events written to \a events
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t popEvents(Event* events, std::size_t maxCount);
+
     ////////////////////////////////////////////////////////////
     /// \brief Get the OS-specific handle of the window
     ///
@@ -229,9 +243,11 @@ private :
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    std::queue<Event> m_events;                     ///< Queue of available events
-    JoystickState     m_joyStates[Joystick::Count]; ///< Previous state of the joysticks
-    float             m_joyThreshold;               ///< Joystick threshold (minimum motion for MOVE event to be generated)
+    std::vector<Event> m_events;                     ///< Ring buffer of available events
+    std::size_t        m_firstEvent;                 ///< Index of the oldest event in the ring buffer
+    std::size_t        m_eventCount;                 ///< Number of events in the ring buffer
+    JoystickState      m_joyStates[Joystick::Count]; ///< Previous state of the joysticks
+    float              m_joyThreshold;               ///< Joystick threshold (minimum motion for MOVE event to be generated)
 };
 
 } // namespace priv
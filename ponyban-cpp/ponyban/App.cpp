@@ -24,53 +24,188 @@
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 
+#if defined(_MSC_VER)
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#else
+#   include <dirent.h>
+#endif
+
 #include <Overlay.hpp>
+#include <RenderThread.hpp>
+#include <SpectatorClient.hpp>
+#include <SpectatorServer.hpp>
+#include <TextureResource.hpp>
+
+// ----------------------------------------------------------------------------
+// textures decoded in parallel on start-up
+
+namespace {
+    const char* textureDirectories[] = {
+        "assets/textures",
+        "assets/buttons"
+    };
+
+    /*!
+     * @brief Checks if a file is an image that can be loaded as a texture
+     */
+    bool isImageFile( const std::string& fileName )
+    {
+        const char* extensions[] = { ".png", ".jpg", ".jpeg", ".gif", ".bmp", ".tga", ".psd", ".hdr", ".pic" };
+        std::string::size_type dot = fileName.rfind( '.' );
+        if( dot == std::string::npos )
+            return false;
+        std::string extension = fileName.substr( dot );
+        std::transform( extension.begin(), extension.end(), extension.begin(), ::tolower );
+        for( std::size_t i = 0; i != sizeof(extensions)/sizeof(*extensions); ++i )
+            if( extension == extensions[i] )
+                return true;
+        return false;
+    }
+
+    /*!
+     * @brief Appends the path of every image file in a directory to a list
+     * Sub-directories aren't searched.
+     */
+    void listImageFiles( const std::string& directory, std::vector<std::string>& fileNames )
+    {
+#if defined(_MSC_VER)
+        WIN32_FIND_DATAA entry;
+        HANDLE handle = FindFirstFileA( (directory + "/*").c_str(), &entry );
+        if( handle == INVALID_HANDLE_VALUE )
+            return;
+        do
+        {
+            if( !(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && isImageFile(entry.cFileName) )
+                fileNames.push_back( directory + "/" + entry.cFileName );
+        } while( FindNextFileA(handle, &entry) );
+        FindClose( handle );
+#else
+        DIR* dir = opendir( directory.c_str() );
+        if( !dir )
+            return;
+        while( dirent* entry = readdir(dir) )
+        {
+            if( entry->d_name[0] != '.' && isImageFile(entry->d_name) )
+                fileNames.push_back( directory + "/" + entry->d_name );
+        }
+        closedir( dir );
+#endif
+    }
+
+    // size of the window, and of the offscreen target of headless applications
+    const unsigned int screenWidth = 800;
+    const unsigned int screenHeight = 600;
+}
 
 // ----------------------------------------------------------------------------
-App::App( void ) :
+App::App( const bool& threadedRenderer, const bool& headless ) :
     m_Window( 0 ),
+    m_RenderTexture( 0 ),
+    m_RenderThread( 0 ),
     m_EventDispatcher( 0 ),
     m_Shutdown( false ),
-    m_Game( 0 )
+    m_Game( 0 ),
+    m_SpectatorServer( 0 ),
+    m_SpectatorClient( 0 ),
+    m_CollectionFileName( "collections/ksokoban-original.sok" ),
+    m_LevelName( "Level #1" )
 {
-    m_Window = new sf::RenderWindow( sf::VideoMode(800,600), "Ponyban" );
+
+    // headless applications have no window and no events, everything is drawn
+    // into a texture. Without an X server, SFML creates its OpenGL contexts
+    // with EGL instead of GLX, so this works on build machines too.
+    if( headless )
+    {
+        m_RenderTexture = new sf::RenderTexture();
+        if( !m_RenderTexture->create( screenWidth, screenHeight ) )
+        {
+            std::cerr << "[App::App] Unable to create the offscreen render target" << std::endl;
+            delete m_RenderTexture;
+            m_RenderTexture = 0;
+        }
+        return;
+    }
+
+    m_Window = new sf::RenderWindow( sf::VideoMode(screenWidth,screenHeight), "Ponyban" );
+    m_Window->setAdaptiveVerticalSyncEnabled( true );
     m_Window->clear( sf::Color::Black );
     m_Window->display();
 
     m_EventDispatcher = new EventDispatcher( m_Window );
-    m_EventDispatcher->registerListener( this );
+    m_EventDispatcher->subscribe( EventDispatcher::Shutdown, this );
+
+    if( threadedRenderer )
+        m_RenderThread = new RenderThread( m_Window );
 }
 
 // ----------------------------------------------------------------------------
 App::~App( void )
 {
+    this->destroyGame();
+    delete m_SpectatorServer;
+    delete m_SpectatorClient;
+    delete m_RenderThread;
     delete m_EventDispatcher;
     delete m_Window;
+    delete m_RenderTexture;
 }
 
 // ----------------------------------------------------------------------------
-void App::go( void )
+bool App::hostSpectators( const unsigned short& port )
 {
+    if( !m_SpectatorServer )
+        m_SpectatorServer = new SpectatorServer();
+    return m_SpectatorServer->listen( port );
+}
 
-    m_Game = new Game();
-    m_Game->setScreenResolution( m_Window->getSize().x, m_Window->getSize().y );
-    m_EventDispatcher->registerListener( m_Game );
+// ----------------------------------------------------------------------------
+bool App::spectate( const std::string& address, const unsigned short& port )
+{
+    if( !m_SpectatorClient )
+        m_SpectatorClient = new SpectatorClient();
+    return m_SpectatorClient->connect( sf::IpAddress(address), port );
+}
 
-    try
+// ----------------------------------------------------------------------------
+void App::setLevel( const std::string& collection, const std::string& level )
+{
+    m_CollectionFileName = collection;
+    m_LevelName = level;
+}
+
+// ----------------------------------------------------------------------------
+void App::go( void )
+{
+    if( !m_Window )
     {
-        m_Game->loadCollection("collections/ksokoban-original.sok");
-        m_Game->loadLevel("Level #1");
+        std::cerr << "[App::go] Headless applications can't be played" << std::endl;
+        return;
     }
-    catch( const std::exception& e )
-    {
 
-    }
+    this->createGame( m_Window->getSize() );
+    m_EventDispatcher->subscribe( EventDispatcher::Update, m_Game );
+    m_EventDispatcher->subscribe( EventDispatcher::KeyPress, m_Game );
+
+    // spectators follow the levels loaded from now on, viewers get theirs
+    // from the player they watch
+    m_Game->setSpectatorServer( m_SpectatorServer );
+    m_Game->spectate( m_SpectatorClient );
+    m_Game->setRenderThread( m_RenderThread );
+
+    if( !m_SpectatorClient )
+        this->loadLevel();
 /*
     Overlay test( 0, 0, 800, 600 );
     test.createButton( "my_button", "assets/buttons/test.png");*/
 
+    if( m_RenderThread )
+        m_RenderThread->start();
+
     sf::Clock clock;
     clock.restart();
     while( !m_Shutdown )
@@ -84,15 +219,99 @@ void App::go( void )
         m_EventDispatcher->dispatchUpdate( elapsed );
 
         // render everything
-        m_Game->render( m_Window );
-        //test.render( m_Window );
+        if( m_RenderThread )
+        {
+            m_Game->render( &m_RenderThread->beginFrame() );
+            m_RenderThread->endFrame();
+        }
+        else
+        {
+            m_Game->render( m_Window );
+            //test.render( m_Window );
 
-        m_Window->display();
+            m_Window->display();
+        }
 
     }
 
     // clean up
-    delete m_Game;
+    m_EventDispatcher->unregisterListener( m_Game );
+    m_Game->spectate( 0 );
+    if( m_RenderThread )
+    {
+        m_RenderThread->stop();
+        m_Window->setActive( true );
+    }
+    m_Game->setRenderThread( 0 );
+    this->destroyGame();
+}
+
+// ----------------------------------------------------------------------------
+bool App::renderToFile( const std::string& fileName )
+{
+    if( !m_RenderTexture )
+    {
+        std::cerr << "[App::renderToFile] Only headless applications render offscreen" << std::endl;
+        return false;
+    }
+
+    this->createGame( m_RenderTexture->getSize() );
+    bool saved = false;
+    if( this->loadLevel() )
+    {
+        m_RenderTexture->clear( sf::Color::Black );
+        m_Game->render( m_RenderTexture );
+        m_RenderTexture->display();
+        saved = m_RenderTexture->getTexture().copyToImage().saveToFile( fileName );
+    }
+
+    this->destroyGame();
+    return saved;
+}
+
+// ----------------------------------------------------------------------------
+bool App::benchmark( const unsigned int& frames )
+{
+    if( !m_RenderTexture )
+    {
+        std::cerr << "[App::benchmark] Only headless applications render offscreen" << std::endl;
+        return false;
+    }
+
+    this->createGame( m_RenderTexture->getSize() );
+    if( !this->loadLevel() )
+    {
+        this->destroyGame();
+        return false;
+    }
+
+    // one frame up front so first use costs of the driver aren't measured
+    m_RenderTexture->clear( sf::Color::Black );
+    m_Game->render( m_RenderTexture );
+    m_RenderTexture->display();
+
+    sf::Clock clock;
+    for( unsigned int i = 0; i != frames; ++i )
+    {
+        m_RenderTexture->clear( sf::Color::Black );
+        m_Game->render( m_RenderTexture );
+        m_RenderTexture->display();
+    }
+
+    // the driver may still be drawing the queued frames, reading the pixels
+    // back waits until it's done
+    m_RenderTexture->getTexture().copyToImage();
+    sf::Time elapsed = clock.getElapsedTime();
+
+    const sf::GlStateTracker::Statistics& stats = m_RenderTexture->getGlStateTracker().getFrameStatistics();
+    float seconds = elapsed.asSeconds();
+    std::cout << "frames: " << frames
+              << ", mean: " << (frames ? elapsed.asMicroseconds() / frames : 0) << "us"
+              << ", frames/sec: " << (seconds > 0.f ? frames / seconds : 0.f)
+              << ", gl calls per frame: " << stats.callsMade << " (" << stats.callsElided << " elided)" << std::endl;
+
+    this->destroyGame();
+    return true;
 }
 
 // ----------------------------------------------------------------------------
@@ -101,3 +320,46 @@ void App::onShutdown( void )
     m_Shutdown = true;
 }
 
+// ----------------------------------------------------------------------------
+void App::createGame( const sf::Vector2u& resolution )
+{
+
+    // decode all textures up front, using every core
+    std::vector<std::string> textureFiles;
+    for( std::size_t i = 0; i != sizeof(textureDirectories)/sizeof(*textureDirectories); ++i )
+        listImageFiles( textureDirectories[i], textureFiles );
+    std::sort( textureFiles.begin(), textureFiles.end() );
+    TextureResource::preloadTexturesFromFiles( textureFiles, m_PreloadedTextures );
+
+    m_Game = new Game();
+    m_Game->setScreenResolution( resolution );
+}
+
+// ----------------------------------------------------------------------------
+void App::destroyGame( void )
+{
+    delete m_Game;
+    m_Game = 0;
+
+    // textures no longer used by the game are freed along with these
+    for( std::vector<TextureResource*>::iterator it = m_PreloadedTextures.begin(); it != m_PreloadedTextures.end(); ++it )
+        delete (*it);
+    m_PreloadedTextures.clear();
+}
+
+// ----------------------------------------------------------------------------
+bool App::loadLevel( void )
+{
+    try
+    {
+        m_Game->loadCollection( m_CollectionFileName );
+        m_Game->loadLevel( m_LevelName );
+    }
+    catch( const std::exception& e )
+    {
+        std::cerr << "[App::loadLevel] Unable to load \"" << m_LevelName << "\" from \"" << m_CollectionFileName << "\": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
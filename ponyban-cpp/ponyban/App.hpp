@@ -18,16 +18,25 @@
 // ----------------------------------------------------------------------------
 // include files
 
+#include <SFML/System/Vector2.hpp>
 #include <EventDispatcher.hpp>
 
+#include <string>
+#include <vector>
+
 // ----------------------------------------------------------------------------
 // forward declarations
 
 namespace sf {
+    class RenderTexture;
     class RenderWindow;
 }
 
 class Game;
+class RenderThread;
+class TextureResource;
+class SpectatorClient;
+class SpectatorServer;
 
 /*!
  * @brief Application object for this game
@@ -39,14 +48,64 @@ public:
 
     /*!
      * @brief Default constructor
+     * @param threadedRenderer If true, frames are recorded by the main thread
+     * and drawn by a separate render thread. See RenderThread.
+     * @param headless If true, no window is opened and frames are drawn into
+     * an offscreen texture instead, which also works on machines without a
+     * display. See renderToFile() and benchmark(). Headless applications
+     * never use a render thread.
      */
-    App( void );
+    App( const bool& threadedRenderer = false, const bool& headless = false );
 
     /*!
      * @brief Default destructor
      */
     ~App( void );
 
+    /*!
+     * @brief Streams the game to spectators
+     * Must be called before go().
+     * @param port The UDP port viewers connect to
+     * @return Returns false if the port couldn't be bound
+     */
+    bool hostSpectators( const unsigned short& port );
+
+    /*!
+     * @brief Watches a game streamed by someone else instead of playing
+     * Must be called before go().
+     * @param address The address of the player hosting spectators
+     * @param port The UDP port of the player hosting spectators
+     * @return Returns false if no local port could be bound
+     */
+    bool spectate( const std::string& address, const unsigned short& port );
+
+    /*!
+     * @brief Sets the level to play or render
+     * Must be called before go(), renderToFile() or benchmark(). The default is
+     * the first level of the original KSokoban collection.
+     * @param collection The file name of the collection
+     * @param level The name of the level in the collection
+     */
+    void setLevel( const std::string& collection, const std::string& level );
+
+    /*!
+     * @brief Renders a single frame of the level and saves it
+     * Only works on headless applications.
+     * @param fileName The image file to write, its extension selects the format
+     * @return Returns false if the level couldn't be loaded or the image
+     * couldn't be saved
+     */
+    bool renderToFile( const std::string& fileName );
+
+    /*!
+     * @brief Renders the level repeatedly and prints the frame rate
+     * Only works on headless applications. Nothing is updated between frames,
+     * so only the cost of rendering is measured.
+     * @param frames The number of frames to render
+     * @return Returns false if the level couldn't be loaded
+     */
+    bool benchmark( const unsigned int& frames );
+
     /*!
      * @brief Launches the application
      */
@@ -59,10 +118,36 @@ private:
      */
     void onShutdown( void );
 
+    /*!
+     * @brief Decodes all textures and creates the game
+     * @param resolution The size of the render target
+     */
+    void createGame( const sf::Vector2u& resolution );
+
+    /*!
+     * @brief Deletes the game and releases the preloaded textures
+     */
+    void destroyGame( void );
+
+    /*!
+     * @brief Loads the level set with setLevel() into the game
+     * @return Returns false and prints why if the level couldn't be loaded
+     */
+    bool loadLevel( void );
+
     sf::RenderWindow* m_Window;
+    sf::RenderTexture* m_RenderTexture;
+    RenderThread* m_RenderThread;
 
     EventDispatcher* m_EventDispatcher;
     Game* m_Game;
+    std::vector<TextureResource*> m_PreloadedTextures;
+
+    SpectatorServer* m_SpectatorServer;
+    SpectatorClient* m_SpectatorClient;
+
+    std::string m_CollectionFileName;
+    std::string m_LevelName;
 
     bool m_Shutdown;
 };
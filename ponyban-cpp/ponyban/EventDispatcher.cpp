@@ -25,8 +25,16 @@
 
 // ----------------------------------------------------------------------------
 EventDispatcher::EventDispatcher( sf::RenderWindow* window ) :
-    m_Window( window )
+    m_Window( window ),
+    m_DispatchDepth( 0 ),
+    m_HasRemovedSubscribers( false ),
+    m_LatencySum( 0 )
 {
+    m_QueueStats.depth = 0;
+    m_QueueStats.maxDepth = 0;
+    m_QueueStats.meanLatency = sf::Time::Zero;
+    m_QueueStats.maxLatency = sf::Time::Zero;
+    m_QueueStats.dispatched = 0;
 }
 
 // ----------------------------------------------------------------------------
@@ -37,92 +45,274 @@ EventDispatcher::~EventDispatcher( void )
 // ----------------------------------------------------------------------------
 void EventDispatcher::processEventLoop( void )
 {
-    sf::Event event;
-    while( m_Window->pollEvent( event ) )
+    // fetch the pending events in batches rather than one at a time
+    sf::Event events[32];
+    std::size_t count;
+    while( (count = m_Window->pollEvents( events, 32 )) > 0 )
     {
-        switch( event.type )
+        for( std::size_t i = 0; i != count; ++i )
         {
+            sf::Event& event = events[i];
+            switch( event.type )
+            {
 
-            // window close event
-            case sf::Event::Closed :
-                this->dispatchShutdown();
-            break;
+                // window close event
+                case sf::Event::Closed :
+                    this->dispatchShutdown();
+                break;
 
-            // keypresses
-            case sf::Event::KeyPressed :
+                // keypresses
+                case sf::Event::KeyPressed :
 
-                // shutdown with escape key
-                if( event.key.code == sf::Keyboard::Escape )
-                    this->dispatchShutdown();
+                    // shutdown with escape key
+                    if( event.key.code == sf::Keyboard::Escape )
+                        this->dispatchShutdown();
+
+                    // dispatch key event
+                    this->dispatchKeyPress( event );
+
+                break;
+
+                // key releases
+                case sf::Event::KeyReleased :
+                    this->dispatchKeyRelease( event );
+                break;
+
+                default:break;
+            }
+
+        }
+    }
 
-                // dispatch key event
-                this->dispatchKeyPress( event );
+    // events posted from other threads
+    this->processEventQueue();
+}
+
+// ----------------------------------------------------------------------------
+void EventDispatcher::postEvent( const QueuedEvent& event )
+{
+    m_EventQueue.push( event );
+}
 
+// ----------------------------------------------------------------------------
+const EventDispatcher::QueueStats& EventDispatcher::getQueueStats( void ) const
+{
+    return m_QueueStats;
+}
+
+// ----------------------------------------------------------------------------
+void EventDispatcher::processEventQueue( void )
+{
+    std::size_t depth = 0;
+
+    QueuedEvent event;
+    while( m_EventQueue.pop(event) )
+    {
+        sf::Time latency = sf::microseconds( m_EventQueue.getTime() - event.postTime );
+        if( latency > m_QueueStats.maxLatency )
+            m_QueueStats.maxLatency = latency;
+        m_LatencySum += latency.asMicroseconds();
+        ++depth;
+
+        switch( event.type )
+        {
+            case QueuedEvent::Shutdown :
+                this->dispatchShutdown();
             break;
 
-            // key releases
-            case sf::Event::KeyReleased :
-                this->dispatchKeyRelease( event );
+            case QueuedEvent::KeyPress :
+                this->dispatchKeyPress( event.event );
+            break;
+
+            case QueuedEvent::KeyRelease :
+                this->dispatchKeyRelease( event.event );
+            break;
+
+            case QueuedEvent::PlayerMove :
+                this->dispatchPlayerMove( event.direction );
             break;
 
             default:break;
         }
-
     }
+
+    m_QueueStats.depth = depth;
+    if( depth > m_QueueStats.maxDepth )
+        m_QueueStats.maxDepth = depth;
+    m_QueueStats.dispatched += depth;
+    if( m_QueueStats.dispatched )
+        m_QueueStats.meanLatency = sf::microseconds( m_LatencySum / static_cast<sf::Int64>(m_QueueStats.dispatched) );
 }
 
 // ----------------------------------------------------------------------------
-bool EventDispatcher::registerListener( EventDispatcherListener* listener )
+bool EventDispatcher::subscribe( const EventType& type, EventDispatcherListener* listener, const int& priority )
 {
-    for( std::vector<EventDispatcherListener*>::iterator it = m_EventListeners.begin(); it != m_EventListeners.end(); ++it )
-        if( listener == *it ) return false;
-    m_EventListeners.push_back( listener );
+    std::vector<Subscriber>& subscribers = m_Subscribers[type];
+    for( std::vector<Subscriber>::iterator it = subscribers.begin(); it != subscribers.end(); ++it )
+        if( it->listener == listener ) return false;
+    for( std::vector<PendingSubscription>::iterator it = m_PendingSubscriptions.begin(); it != m_PendingSubscriptions.end(); ++it )
+        if( it->type == type && it->subscriber.listener == listener ) return false;
+
+    Subscriber subscriber;
+    subscriber.listener = listener;
+    subscriber.priority = priority;
+
+    // the subscriber arrays can't change while they're being iterated
+    if( m_DispatchDepth )
+    {
+        PendingSubscription pending;
+        pending.type = type;
+        pending.subscriber = subscriber;
+        m_PendingSubscriptions.push_back( pending );
+        return true;
+    }
+
+    this->insertSubscriber( type, subscriber );
     return true;
 }
 
 // ----------------------------------------------------------------------------
-bool EventDispatcher::unregisterListener( EventDispatcherListener* listener )
+bool EventDispatcher::unsubscribe( const EventType& type, EventDispatcherListener* listener )
 {
-    for( std::vector<EventDispatcherListener*>::iterator it = m_EventListeners.begin(); it != m_EventListeners.end(); ++it )
-        if( listener == *it )
+    for( std::vector<PendingSubscription>::iterator it = m_PendingSubscriptions.begin(); it != m_PendingSubscriptions.end(); ++it )
+        if( it->type == type && it->subscriber.listener == listener )
+        {
+            m_PendingSubscriptions.erase( it );
+            return true;
+        }
+
+    std::vector<Subscriber>& subscribers = m_Subscribers[type];
+    for( std::vector<Subscriber>::iterator it = subscribers.begin(); it != subscribers.end(); ++it )
+        if( it->listener == listener )
         {
-            m_EventListeners.erase( it );
+            // during a dispatch, only clear the entry so the arrays don't move
+            if( m_DispatchDepth )
+            {
+                it->listener = 0;
+                m_HasRemovedSubscribers = true;
+            }
+            else
+                subscribers.erase( it );
             return true;
         }
+
     return false;
 }
 
+// ----------------------------------------------------------------------------
+bool EventDispatcher::registerListener( EventDispatcherListener* listener, const int& priority )
+{
+    bool subscribed = true;
+    for( int type = 0; type != EventTypeCount; ++type )
+        subscribed = this->subscribe( static_cast<EventType>(type), listener, priority ) && subscribed;
+    return subscribed;
+}
+
+// ----------------------------------------------------------------------------
+bool EventDispatcher::unregisterListener( EventDispatcherListener* listener )
+{
+    bool unsubscribed = false;
+    for( int type = 0; type != EventTypeCount; ++type )
+        unsubscribed = this->unsubscribe( static_cast<EventType>(type), listener ) || unsubscribed;
+    return unsubscribed;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t EventDispatcher::getSubscriberCount( const EventType& type ) const
+{
+    std::size_t count = 0;
+    for( std::vector<Subscriber>::const_iterator it = m_Subscribers[type].begin(); it != m_Subscribers[type].end(); ++it )
+        if( it->listener ) ++count;
+    return count;
+}
+
+// ----------------------------------------------------------------------------
+void EventDispatcher::insertSubscriber( const EventType& type, const Subscriber& subscriber )
+{
+    std::vector<Subscriber>& subscribers = m_Subscribers[type];
+    std::vector<Subscriber>::iterator it = subscribers.begin();
+    while( it != subscribers.end() && it->priority >= subscriber.priority )
+        ++it;
+    subscribers.insert( it, subscriber );
+}
+
+// ----------------------------------------------------------------------------
+void EventDispatcher::beginDispatch( void )
+{
+    ++m_DispatchDepth;
+}
+
+// ----------------------------------------------------------------------------
+void EventDispatcher::endDispatch( void )
+{
+    if( --m_DispatchDepth ) return;
+
+    // remove the entries that were cleared during the dispatch
+    if( m_HasRemovedSubscribers )
+    {
+        for( int type = 0; type != EventTypeCount; ++type )
+        {
+            std::vector<Subscriber>& subscribers = m_Subscribers[type];
+            std::vector<Subscriber>::iterator end = subscribers.begin();
+            for( std::vector<Subscriber>::iterator it = subscribers.begin(); it != subscribers.end(); ++it )
+                if( it->listener ) *end++ = *it;
+            subscribers.erase( end, subscribers.end() );
+        }
+        m_HasRemovedSubscribers = false;
+    }
+
+    // add the subscriptions made during the dispatch
+    for( std::vector<PendingSubscription>::iterator it = m_PendingSubscriptions.begin(); it != m_PendingSubscriptions.end(); ++it )
+        this->insertSubscriber( it->type, it->subscriber );
+    m_PendingSubscriptions.clear();
+}
+
 // ----------------------------------------------------------------------------
 void EventDispatcher::dispatchUpdate( const sf::Time& delta )
 {
-    for( std::vector<EventDispatcherListener*>::iterator it = m_EventListeners.begin(); it != m_EventListeners.end(); ++it )
-        (*it)->onUpdate( delta );
+    std::vector<Subscriber>& subscribers = m_Subscribers[Update];
+    this->beginDispatch();
+    for( std::vector<Subscriber>::iterator it = subscribers.begin(); it != subscribers.end(); ++it )
+        if( it->listener ) it->listener->onUpdate( delta );
+    this->endDispatch();
 }
 
 // ----------------------------------------------------------------------------
 void EventDispatcher::dispatchShutdown( void )
 {
-    for( std::vector<EventDispatcherListener*>::iterator it = m_EventListeners.begin(); it != m_EventListeners.end(); ++it )
-        (*it)->onShutdown();
+    std::vector<Subscriber>& subscribers = m_Subscribers[Shutdown];
+    this->beginDispatch();
+    for( std::vector<Subscriber>::iterator it = subscribers.begin(); it != subscribers.end(); ++it )
+        if( it->listener ) it->listener->onShutdown();
+    this->endDispatch();
 }
 
 // ----------------------------------------------------------------------------
 void EventDispatcher::dispatchKeyPress( sf::Event& event )
 {
-    for( std::vector<EventDispatcherListener*>::iterator it = m_EventListeners.begin(); it != m_EventListeners.end(); ++it )
-        (*it)->onKeyPress( event );
+    std::vector<Subscriber>& subscribers = m_Subscribers[KeyPress];
+    this->beginDispatch();
+    for( std::vector<Subscriber>::iterator it = subscribers.begin(); it != subscribers.end(); ++it )
+        if( it->listener ) it->listener->onKeyPress( event );
+    this->endDispatch();
 }
 
 // ----------------------------------------------------------------------------
 void EventDispatcher::dispatchKeyRelease( sf::Event& event )
 {
-    for( std::vector<EventDispatcherListener*>::iterator it = m_EventListeners.begin(); it != m_EventListeners.end(); ++it )
-        (*it)->onKeyRelease( event );
+    std::vector<Subscriber>& subscribers = m_Subscribers[KeyRelease];
+    this->beginDispatch();
+    for( std::vector<Subscriber>::iterator it = subscribers.begin(); it != subscribers.end(); ++it )
+        if( it->listener ) it->listener->onKeyRelease( event );
+    this->endDispatch();
 }
 
 // ----------------------------------------------------------------------------
 void EventDispatcher::dispatchPlayerMove( const char direction )
 {
-    for( std::vector<EventDispatcherListener*>::iterator it = m_EventListeners.begin(); it != m_EventListeners.end(); ++it )
-        (*it)->onPlayerMove( direction );
+    std::vector<Subscriber>& subscribers = m_Subscribers[PlayerMove];
+    this->beginDispatch();
+    for( std::vector<Subscriber>::iterator it = subscribers.begin(); it != subscribers.end(); ++it )
+        if( it->listener ) it->listener->onPlayerMove( direction );
+    this->endDispatch();
 }
@@ -21,6 +21,8 @@
 // ----------------------------------------------------------------------------
 // include files
 
+#include <EventQueue.hpp>
+
 #include <vector>
 
 // ----------------------------------------------------------------------------
@@ -72,11 +74,48 @@ public:
 
 /*!
  * @brief Handles dispatching events to registered classes
+ * Listeners subscribe to the event types they handle, so dispatching an
+ * event only calls its subscribers. Subscribers with a higher priority are
+ * called first, subscribers with the same priority in subscription order.
+ *
+ * Listeners can subscribe and unsubscribe while an event is being dispatched.
+ * An unsubscribed listener isn't called anymore, but new subscriptions only
+ * take effect once the dispatch is complete.
+ *
+ * Window events are dispatched from the thread calling processEventLoop().
+ * Other threads can post events with postEvent(), they are dispatched in the
+ * next call to processEventLoop(), in the order they were posted.
  */
 class EventDispatcher
 {
 public:
 
+    /*!
+     * @brief Event types listeners can subscribe to
+     */
+    enum EventType
+    {
+        Update,
+        Shutdown,
+        KeyPress,
+        KeyRelease,
+        PlayerMove,
+
+        EventTypeCount
+    };
+
+    /*!
+     * @brief Statistics of the posted events
+     */
+    struct QueueStats
+    {
+        std::size_t depth;          // events dispatched by the last processEventLoop
+        std::size_t maxDepth;       // largest depth so far
+        sf::Time meanLatency;       // average time between posting and dispatching
+        sf::Time maxLatency;        // largest time between posting and dispatching
+        sf::Uint64 dispatched;      // total number of posted events dispatched
+    };
+
     /*!
      * @brief Default constructor
      */
@@ -88,21 +127,56 @@ public:
     ~EventDispatcher( void );
 
     /*!
-     * @brief Registers a listener
-     *
+     * @brief Subscribes a listener to an event type
+     * @param type The event type to listen to
+     * @param listener The listener to call
+     * @param priority Listeners with a higher priority are called first
+     * @return Returns false if the listener is already subscribed to this type
      */
-    bool registerListener( EventDispatcherListener* listener );
+    bool subscribe( const EventType& type, EventDispatcherListener* listener, const int& priority = 0 );
 
     /*!
-     * @brief Unregisters a listener
+     * @brief Unsubscribes a listener from an event type
+     * @return Returns false if the listener isn't subscribed to this type
+     */
+    bool unsubscribe( const EventType& type, EventDispatcherListener* listener );
+
+    /*!
+     * @brief Subscribes a listener to all event types
+     * Prefer subscribe() with the types the listener actually handles,
+     * every subscription costs a call per dispatched event.
+     * @return Returns false if the listener is already subscribed to any type
+     */
+    bool registerListener( EventDispatcherListener* listener, const int& priority = 0 );
+
+    /*!
+     * @brief Unsubscribes a listener from all event types
+     * @return Returns false if the listener wasn't subscribed to any type
      */
     bool unregisterListener( EventDispatcherListener* listener );
 
+    /*!
+     * @brief Gets the number of listeners subscribed to an event type
+     */
+    std::size_t getSubscriberCount( const EventType& type ) const;
+
     /*!
      * @brief Processes the event loop and dispatches messages
+     * Posted events are dispatched after the window events.
      */
     void processEventLoop( void );
 
+    /*!
+     * @brief Posts an event to be dispatched by the next processEventLoop
+     * This is lock-free and can be called from any thread.
+     */
+    void postEvent( const QueuedEvent& event );
+
+    /*!
+     * @brief Gets the statistics of the posted events
+     */
+    const QueueStats& getQueueStats( void ) const;
+
     /*!
      * @brief Dispatches the update signal
      */
@@ -130,8 +204,50 @@ public:
 
 private:
 
+    /*!
+     * @brief Dispatches all posted events
+     */
+    void processEventQueue( void );
+
+    /*!
+     * @brief Marks the start of a dispatch, subscriptions are deferred until
+     * the matching endDispatch()
+     */
+    void beginDispatch( void );
+
+    /*!
+     * @brief Marks the end of a dispatch, applies the deferred subscriptions
+     * once the outermost dispatch is complete
+     */
+    void endDispatch( void );
+
+    struct Subscriber
+    {
+        EventDispatcherListener* listener;  // null once unsubscribed during a dispatch
+        int priority;
+    };
+
+    struct PendingSubscription
+    {
+        EventType type;
+        Subscriber subscriber;
+    };
+
+    /*!
+     * @brief Inserts a subscriber after the ones with the same or a higher priority
+     */
+    void insertSubscriber( const EventType& type, const Subscriber& subscriber );
+
     sf::RenderWindow* m_Window;
-    std::vector<EventDispatcherListener*> m_EventListeners;
+
+    std::vector<Subscriber> m_Subscribers[EventTypeCount];
+    std::vector<PendingSubscription> m_PendingSubscriptions;
+    int m_DispatchDepth;
+    bool m_HasRemovedSubscribers;
+
+    EventQueue m_EventQueue;
+    QueueStats m_QueueStats;
+    sf::Int64 m_LatencySum;
 
 };
 
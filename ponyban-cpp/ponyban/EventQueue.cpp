@@ -0,0 +1,150 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <EventQueue.hpp>
+
+#if defined(_MSC_VER)
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// atomic operations
+// C++03 has no atomics, so these map to the compiler's intrinsics
+
+namespace {
+    template <class T>
+    T* exchangePointer( T* volatile* target, T* value )
+    {
+#if defined(_MSC_VER)
+        return static_cast<T*>( InterlockedExchangePointer(reinterpret_cast<void* volatile*>(target), value) );
+#else
+        // __sync_lock_test_and_set is only an acquire barrier
+        __sync_synchronize();
+        return __sync_lock_test_and_set( target, value );
+#endif
+    }
+
+    template <class T>
+    T* loadAcquire( T* volatile* source )
+    {
+        T* value = *source;
+#if defined(_MSC_VER)
+        _ReadWriteBarrier();
+#else
+        __sync_synchronize();
+#endif
+        return value;
+    }
+
+    template <class T>
+    void storeRelease( T* volatile* target, T* value )
+    {
+#if defined(_MSC_VER)
+        _ReadWriteBarrier();
+#else
+        __sync_synchronize();
+#endif
+        *target = value;
+    }
+}
+
+// ----------------------------------------------------------------------------
+EventQueue::EventQueue( void ) :
+    m_Head( &m_Stub ),
+    m_Tail( &m_Stub )
+{
+    m_Stub.next = 0;
+}
+
+// ----------------------------------------------------------------------------
+EventQueue::~EventQueue( void )
+{
+    QueuedEvent event;
+    while( this->pop(event) );
+}
+
+// ----------------------------------------------------------------------------
+void EventQueue::push( const QueuedEvent& event )
+{
+    Node* node = new Node;
+    node->event = event;
+    node->event.postTime = this->getTime();
+    this->pushNode( node );
+}
+
+// ----------------------------------------------------------------------------
+void EventQueue::pushNode( Node* node )
+{
+    node->next = 0;
+
+    // between the exchange and the link, the list is briefly cut in two,
+    // pop() treats this as an empty queue
+    Node* previous = exchangePointer( &m_Head, node );
+    storeRelease( &previous->next, node );
+}
+
+// ----------------------------------------------------------------------------
+bool EventQueue::pop( QueuedEvent& event )
+{
+    Node* tail = m_Tail;
+    Node* next = loadAcquire( &tail->next );
+
+    // skip the stub node
+    if( tail == &m_Stub )
+    {
+        if( !next )
+            return false;
+        m_Tail = next;
+        tail = next;
+        next = loadAcquire( &next->next );
+    }
+
+    if( next )
+    {
+        m_Tail = next;
+        event = tail->event;
+        delete tail;
+        return true;
+    }
+
+    // a producer is between its exchange and its link
+    if( tail != loadAcquire(&m_Head) )
+        return false;
+
+    // the tail is the last node, put the stub back behind it so it can be popped
+    this->pushNode( &m_Stub );
+    next = loadAcquire( &tail->next );
+    if( next )
+    {
+        m_Tail = next;
+        event = tail->event;
+        delete tail;
+        return true;
+    }
+
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+sf::Int64 EventQueue::getTime( void ) const
+{
+    return m_Clock.getElapsedTime().asMicroseconds();
+}
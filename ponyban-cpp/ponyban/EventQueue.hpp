@@ -0,0 +1,114 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __EVENT_QUEUE_HPP__
+#define __EVENT_QUEUE_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <SFML/Window/Event.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+/*!
+ * @brief An event posted to the event dispatcher from any thread
+ */
+struct QueuedEvent
+{
+    enum Type
+    {
+        Shutdown,
+        KeyPress,
+        KeyRelease,
+        PlayerMove
+    };
+
+    Type type;
+    sf::Event event;        // KeyPress, KeyRelease
+    char direction;         // PlayerMove: 'u', 'd', 'l' or 'r'
+    sf::Int64 postTime;     // set by EventQueue::push, in microseconds
+};
+
+/*!
+ * @brief Lock-free multiple producer, single consumer event queue
+ * Any number of threads can push events concurrently, but only one thread
+ * may pop them. Pushing takes a single atomic exchange and never waits for
+ * the consumer or for other producers.
+ *
+ * The queue is an intrusive linked list (Dmitry Vyukov's MPSC queue): the
+ * producers swap themselves in at the head, the consumer follows the links
+ * from the tail.
+ */
+class EventQueue :
+    public sf::NonCopyable
+{
+public:
+
+    /*!
+     * @brief Default constructor
+     */
+    EventQueue( void );
+
+    /*!
+     * @brief Default destructor
+     * Discards the events that were not popped.
+     */
+    ~EventQueue( void );
+
+    /*!
+     * @brief Pushes an event, can be called from any thread
+     * The post time of the event is set to the current time of the queue's
+     * clock.
+     */
+    void push( const QueuedEvent& event );
+
+    /*!
+     * @brief Pops the oldest event, can only be called from one thread
+     * @param event Receives the event
+     * @return Returns false if the queue is empty, or if the next event is
+     * still being pushed by another thread.
+     */
+    bool pop( QueuedEvent& event );
+
+    /*!
+     * @brief Gets the current time of the clock used to stamp the events
+     * @return The time in microseconds
+     */
+    sf::Int64 getTime( void ) const;
+
+private:
+
+    struct Node
+    {
+        Node* volatile next;
+        QueuedEvent event;
+    };
+
+    /*!
+     * @brief Links a node at the head of the list
+     */
+    void pushNode( Node* node );
+
+    Node* volatile m_Head;  // most recently pushed node, shared by the producers
+    Node* m_Tail;           // oldest node, only used by the consumer
+    Node m_Stub;
+
+    sf::Clock m_Clock;
+};
+
+#endif // __EVENT_QUEUE_HPP__
@@ -20,17 +20,62 @@
 
 #include <Game.hpp>
 #include <AnimatedSprite.hpp>
+#include <RenderThread.hpp>
+#include <SpectatorServer.hpp>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Window/Event.hpp>
 
 #include <ChocobunInterface.hpp>
 
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+// sprite sorting
+
+namespace {
+    bool compareTexture( const AnimatedSprite* a, const AnimatedSprite* b )
+    {
+        return a->getSprite().getTexture() < b->getSprite().getTexture();
+    }
+}
+
+// ----------------------------------------------------------------------------
+// streamed collection names
+
+namespace {
+    // spectators only load collections from this directory
+    const std::string collectionDirectory = "collections/";
+
+    // strips the directories from a path
+    std::string getFileName( const std::string& path )
+    {
+        std::string::size_type slash = path.find_last_of( "/\\" );
+        return slash == std::string::npos ? path : path.substr( slash + 1 );
+    }
+
+    // true if the name can't refer to anything outside of the directory
+    bool isBareFileName( const std::string& name )
+    {
+        if( name.empty() || name == "." || name == ".." )
+            return false;
+        for( std::string::const_iterator it = name.begin(); it != name.end(); ++it )
+        {
+            if( *it == '/' || *it == '\\' || *it == ':' || static_cast<unsigned char>(*it) < 0x20 )
+                return false;
+        }
+        return true;
+    }
+}
+
 // ----------------------------------------------------------------------------
 Game::Game( void ) :
     m_Collection( 0 ),
     m_ScreenResolution( 0, 0 ),
-    m_Player( 0 )
+    m_Player( 0 ),
+    m_SpectatorServer( 0 ),
+    m_SpectatorClient( 0 ),
+    m_RenderThread( 0 )
 {
 }
 
@@ -59,6 +104,7 @@ void Game::loadCollection( const std::string& fileName )
     if( m_Collection )
         this->unload();
     m_Collection = new Chocobun::Collection( fileName );
+    m_CollectionFileName = fileName;
     m_Collection->initialise();
     m_Collection->addLevelListener( this );
 }
@@ -70,6 +116,10 @@ void Game::unload( void )
     // removing ourselves as a listener is taken care of automatically when the
     // collection is deleted
 
+    // frames still queued for drawing refer to the textures of the sprites
+    if( m_RenderThread )
+        m_RenderThread->finish();
+
     // delete all sprites
     if( m_Player ){ delete m_Player; m_Player = 0; }
     for( std::vector<AnimatedSprite*>::iterator it = m_Boxes.begin(); it != m_Boxes.end(); ++it )
@@ -101,6 +151,10 @@ void Game::loadLevel( const std::string& levelName )
     m_Collection->setActiveLevel( levelName );
     m_Collection->validateLevel();
 
+    // viewers look the collection up in their own collections directory
+    if( m_SpectatorServer )
+        m_SpectatorServer->setLevel( getFileName(m_CollectionFileName), levelName );
+
     // prerequisits
     m_TileSize = m_ScreenResolution.x / static_cast<float>(m_Collection->getSizeX());
     if( m_TileSize > m_ScreenResolution.y / static_cast<float>(m_Collection->getSizeY()) )
@@ -138,6 +192,10 @@ void Game::loadLevel( const std::string& levelName )
         }
     }
 
+    // static tiles never overlap, so they can be drawn in any order. Group
+    // them by texture so the sprite batch draws them with one call per texture.
+    std::stable_sort( m_StaticMap.begin(), m_StaticMap.end(), compareTexture );
+
     // set up dynamic tiles
     // dynamic tiles are tiles that can be moved, and draw over static tiles.
     for( std::size_t y = 0; y != m_Collection->getSizeY(); ++y )
@@ -171,37 +229,115 @@ void Game::loadLevel( const std::string& levelName )
 // ----------------------------------------------------------------------------
 void Game::render( sf::RenderTarget* target )
 {
+    m_SpriteBatch.clear();
+
     for( std::vector<AnimatedSprite*>::iterator it = m_StaticMap.begin(); it != m_StaticMap.end(); ++it )
-        target->draw( (*it)->getSprite() );
+        m_SpriteBatch.add( (*it)->getSprite() );
 
     for( std::vector<AnimatedSprite*>::iterator it = m_Boxes.begin(); it != m_Boxes.end(); ++it )
-        target->draw( (*it)->getSprite() );
+        m_SpriteBatch.add( (*it)->getSprite() );
 
     if( m_Player )
-        target->draw( m_Player->getSprite() );
+        m_SpriteBatch.add( m_Player->getSprite() );
+
+    target->draw( m_SpriteBatch );
 }
 
 // ----------------------------------------------------------------------------
-void Game::onUpdate( const sf::Time& delta )
+void Game::setSpectatorServer( SpectatorServer* server )
+{
+    m_SpectatorServer = server;
+}
+
+// ----------------------------------------------------------------------------
+void Game::spectate( SpectatorClient* client )
+{
+    if( m_SpectatorClient )
+        m_SpectatorClient->setListener( 0 );
+    m_SpectatorClient = client;
+    if( m_SpectatorClient )
+        m_SpectatorClient->setListener( this );
+}
+
+// ----------------------------------------------------------------------------
+void Game::setRenderThread( RenderThread* renderThread )
 {
+    m_RenderThread = renderThread;
+}
 
+// ----------------------------------------------------------------------------
+void Game::onUpdate( const sf::Time& delta )
+{
+    if( m_SpectatorServer )
+        m_SpectatorServer->update();
+    if( m_SpectatorClient )
+        m_SpectatorClient->update();
 }
 
 // ----------------------------------------------------------------------------
 void Game::onKeyPress( sf::Event& event )
 {
-    if( !m_Collection ) return;
+    if( !m_Collection || m_SpectatorClient ) return;
 
+    char move = 0;
     if( event.key.code == sf::Keyboard::Up )
-        m_Collection->moveUp();
+        move = 'u';
     if( event.key.code == sf::Keyboard::Down )
-        m_Collection->moveDown();
+        move = 'd';
     if( event.key.code == sf::Keyboard::Left )
-        m_Collection->moveLeft();
+        move = 'l';
     if( event.key.code == sf::Keyboard::Right )
-        m_Collection->moveRight();
+        move = 'r';
     if( event.key.code == sf::Keyboard::Z )
-        m_Collection->undo();
+        move = 'z';
+    if( !move ) return;
+
+    this->applyMove( move );
+    if( m_SpectatorServer )
+        m_SpectatorServer->recordMove( move );
+}
+
+// ----------------------------------------------------------------------------
+void Game::applyMove( const char& move )
+{
+    if( !m_Collection ) return;
+
+    switch( move )
+    {
+        case 'u' : m_Collection->moveUp(); break;
+        case 'd' : m_Collection->moveDown(); break;
+        case 'l' : m_Collection->moveLeft(); break;
+        case 'r' : m_Collection->moveRight(); break;
+        case 'z' : m_Collection->undo(); break;
+        default : break;
+    }
+}
+
+// ----------------------------------------------------------------------------
+void Game::onSpectatorLevel( const std::string& collection, const std::string& level )
+{
+    // the name comes from the network, don't let it open any other file
+    if( !isBareFileName(collection) )
+    {
+        std::cerr << "[Game::onSpectatorLevel] Refusing to load the streamed collection \"" << collection << "\", it isn't a file name" << std::endl;
+        return;
+    }
+
+    try
+    {
+        this->loadCollection( collectionDirectory + collection );
+        this->loadLevel( level );
+    }
+    catch( const std::exception& e )
+    {
+        std::cerr << "[Game::onSpectatorLevel] Unable to load the streamed level: " << e.what() << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------
+void Game::onSpectatorMove( const char& move )
+{
+    this->applyMove( move );
 }
 
 // ----------------------------------------------------------------------------
@@ -22,7 +22,9 @@
 // include files
 
 #include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/SpriteBatch.hpp>
 #include <EventDispatcher.hpp>
+#include <SpectatorClient.hpp>
 
 #include <ChocobunInterface.hpp>
 
@@ -40,10 +42,13 @@ namespace sf {
 }
 
 class AnimatedSprite;
+class RenderThread;
+class SpectatorServer;
 
 class Game :
     public EventDispatcherListener,
-    public Chocobun::LevelListener
+    public Chocobun::LevelListener,
+    public SpectatorListener
 {
 public:
 
@@ -111,6 +116,30 @@ public:
      */
     void render( sf::RenderTarget* target );
 
+    /*!
+     * @brief Streams the game to spectators
+     * The server is told about every level loaded from now on, and receives
+     * every move of the player. It is updated by the game.
+     * @param server The server to stream to, or 0 to stop streaming
+     */
+    void setSpectatorServer( SpectatorServer* server );
+
+    /*!
+     * @brief Watches a game streamed by someone else
+     * The levels and moves received by the client replace the keyboard, which
+     * is ignored until spectating stops. The client is updated by the game.
+     * @param client The client receiving the game, or 0 to stop spectating
+     */
+    void spectate( SpectatorClient* client );
+
+    /*!
+     * @brief Sets the render thread drawing the frames of the game
+     * Sprites and their textures are only destroyed once the render thread
+     * has finished drawing every frame that might still use them.
+     * @param renderThread The render thread, or 0 if rendering isn't threaded
+     */
+    void setRenderThread( RenderThread* renderThread );
+
 private:
 
     /*!
@@ -133,14 +162,40 @@ private:
      */
     void onMoveTile( const std::size_t& oldX, const std::size_t& oldY, const std::size_t& newX, const std::size_t& newY );
 
+    /*!
+     * @brief Spectator level listener
+     * The collection must be a bare file name, it is loaded from the
+     * collections directory. Anything else is refused.
+     */
+    void onSpectatorLevel( const std::string& collection, const std::string& level );
+
+    /*!
+     * @brief Spectator move listener
+     */
+    void onSpectatorMove( const char& move );
+
+    /*!
+     * @brief Makes a move on the active level
+     * @param move One of 'u', 'd', 'l', 'r', or 'z' for undo
+     */
+    void applyMove( const char& move );
+
     Chocobun::Collection* m_Collection;
+    std::string m_CollectionFileName;
 
     std::vector<AnimatedSprite*> m_StaticMap;
     std::vector<AnimatedSprite*> m_Boxes;
     AnimatedSprite* m_Player;
 
+    // all tiles are drawn through one batch, refilled every frame
+    sf::SpriteBatch m_SpriteBatch;
+
     sf::Vector2u m_ScreenResolution;
     float m_TileSize;
+
+    SpectatorServer* m_SpectatorServer;
+    SpectatorClient* m_SpectatorClient;
+    RenderThread* m_RenderThread;
 };
 
 #endif // __GAME_HPP__
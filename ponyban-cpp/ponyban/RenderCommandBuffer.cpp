@@ -0,0 +1,134 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <RenderCommandBuffer.hpp>
+
+// ----------------------------------------------------------------------------
+// view comparison
+
+namespace {
+    bool isSameView( const sf::View& a, const sf::View& b )
+    {
+        return a.getCenter() == b.getCenter() &&
+               a.getSize() == b.getSize() &&
+               a.getRotation() == b.getRotation() &&
+               a.getViewport() == b.getViewport();
+    }
+}
+
+// ----------------------------------------------------------------------------
+RenderCommandBuffer::RenderCommandBuffer( void ) :
+    m_Size( 0, 0 )
+{
+}
+
+// ----------------------------------------------------------------------------
+RenderCommandBuffer::~RenderCommandBuffer( void )
+{
+}
+
+// ----------------------------------------------------------------------------
+void RenderCommandBuffer::reset( const sf::Vector2u& size )
+{
+    m_Size = size;
+    m_Commands.clear();
+    m_Vertices.clear();
+    m_Views.clear();
+
+    // sets up the default view for the new size
+    this->initialize();
+}
+
+// ----------------------------------------------------------------------------
+void RenderCommandBuffer::clear( const sf::Color& color )
+{
+    Command command;
+    command.type = Command::Clear;
+    command.color = color;
+    command.firstVertex = 0;
+    command.vertexCount = 0;
+    command.primitiveType = sf::Points;
+    command.view = 0;
+    m_Commands.push_back( command );
+}
+
+// ----------------------------------------------------------------------------
+void RenderCommandBuffer::draw( const sf::Vertex* vertices, unsigned int vertexCount, sf::PrimitiveType type, const sf::RenderStates& states )
+{
+    if( !vertices || !vertexCount ) return;
+
+    // only store the view when it changes
+    if( m_Views.empty() || !isSameView(m_Views.back(), this->getView()) )
+        m_Views.push_back( this->getView() );
+
+    Command command;
+    command.type = Command::Draw;
+    command.firstVertex = m_Vertices.size();
+    command.vertexCount = vertexCount;
+    command.primitiveType = type;
+    command.states = states;
+    command.view = m_Views.size()-1;
+    m_Commands.push_back( command );
+
+    m_Vertices.insert( m_Vertices.end(), vertices, vertices + vertexCount );
+}
+
+// ----------------------------------------------------------------------------
+sf::Vector2u RenderCommandBuffer::getSize( void ) const
+{
+    return m_Size;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t RenderCommandBuffer::getCommandCount( void ) const
+{
+    return m_Commands.size();
+}
+
+// ----------------------------------------------------------------------------
+void RenderCommandBuffer::replay( sf::RenderTarget& target ) const
+{
+    sf::View previousView = target.getView();
+    std::size_t currentView = m_Views.size();
+
+    for( std::vector<Command>::const_iterator it = m_Commands.begin(); it != m_Commands.end(); ++it )
+    {
+        if( it->type == Command::Clear )
+        {
+            target.clear( it->color );
+            continue;
+        }
+
+        if( it->view != currentView )
+        {
+            target.setView( m_Views[it->view] );
+            currentView = it->view;
+        }
+        target.draw( &m_Vertices[it->firstVertex], static_cast<unsigned int>(it->vertexCount), it->primitiveType, it->states );
+    }
+
+    target.setView( previousView );
+}
+
+// ----------------------------------------------------------------------------
+bool RenderCommandBuffer::activate( bool )
+{
+    return false;
+}
@@ -0,0 +1,134 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RENDER_COMMAND_BUFFER_HPP__
+#define __RENDER_COMMAND_BUFFER_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/View.hpp>
+
+#include <vector>
+
+/*!
+ * @brief Records draw commands so they can be replayed later, in another thread
+ * This is a render target: anything that can be drawn to a window can be
+ * drawn to a command buffer. The vertices of every draw call are copied along
+ * with their render states, so the drawables can be modified or destroyed as
+ * soon as they are drawn. Textures and shaders are referenced, not copied, and
+ * must live until the commands are replayed.
+ *
+ * Example code:
+ * @code
+ * RenderCommandBuffer buffer;
+ * buffer.reset( window.getSize() );
+ * buffer.clear( sf::Color::Black );
+ * buffer.draw( sprite );
+ *
+ * // later, in the thread owning the window's context
+ * buffer.replay( window );
+ * window.display();
+ * @endcode
+ */
+class RenderCommandBuffer :
+    public sf::RenderTarget
+{
+public:
+
+    /*!
+     * @brief Default constructor
+     */
+    RenderCommandBuffer( void );
+
+    /*!
+     * @brief Default destructor
+     */
+    ~RenderCommandBuffer( void );
+
+    /*!
+     * @brief Removes all recorded commands
+     * The memory is kept so recording the next frame doesn't allocate.
+     * @param size The size of the target the commands will be replayed on.
+     * The view is reset to the default view of this size.
+     */
+    void reset( const sf::Vector2u& size );
+
+    /*!
+     * @brief Records a clear command
+     */
+    void clear( const sf::Color& color = sf::Color( 0, 0, 0, 255 ) );
+
+    /*!
+     * @brief Records a draw command
+     * The vertices are copied, along with the current view.
+     */
+    void draw( const sf::Vertex* vertices, unsigned int vertexCount, sf::PrimitiveType type, const sf::RenderStates& states = sf::RenderStates::Default );
+    using sf::RenderTarget::draw;
+
+    /*!
+     * @brief Gets the size of the target the commands are recorded for
+     */
+    sf::Vector2u getSize( void ) const;
+
+    /*!
+     * @brief Gets the number of recorded commands
+     */
+    std::size_t getCommandCount( void ) const;
+
+    /*!
+     * @brief Executes all recorded commands on a render target
+     * The view of the target is restored afterwards.
+     * @param target The render target to replay the commands on
+     */
+    void replay( sf::RenderTarget& target ) const;
+
+private:
+
+    /*!
+     * @brief Does nothing, a command buffer has no OpenGL context
+     */
+    bool activate( bool active );
+
+    struct Command
+    {
+        enum Type
+        {
+            Clear,
+            Draw
+        };
+
+        Type type;
+        sf::Color color;            // clear colour
+        std::size_t firstVertex;    // draw: index of the first vertex
+        std::size_t vertexCount;    // draw: number of vertices
+        sf::PrimitiveType primitiveType;
+        sf::RenderStates states;
+        std::size_t view;           // draw: index of the view
+    };
+
+    sf::Vector2u m_Size;
+
+    std::vector<Command> m_Commands;
+    std::vector<sf::Vertex> m_Vertices;
+    std::vector<sf::View> m_Views;
+};
+
+#endif // __RENDER_COMMAND_BUFFER_HPP__
@@ -0,0 +1,149 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <RenderThread.hpp>
+
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/System/Lock.hpp>
+
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+RenderThread::RenderThread( sf::RenderWindow* window ) :
+    m_Window( window ),
+    m_Thread( &RenderThread::run, this ),
+    m_FrameReady( 0 ),
+    m_Idle( 0 ),
+    m_WriteIndex( 0 ),
+    m_PendingIndex( 1 ),
+    m_ReadIndex( 2 ),
+    m_HasPending( false ),
+    m_Rendering( false ),
+    m_WaitingForIdle( false ),
+    m_Running( false )
+{
+}
+
+// ----------------------------------------------------------------------------
+RenderThread::~RenderThread( void )
+{
+    this->stop();
+}
+
+// ----------------------------------------------------------------------------
+void RenderThread::start( void )
+{
+    if( m_Running ) return;
+
+    // a context can only be active in one thread at a time
+    m_Window->setActive( false );
+    m_Running = true;
+    m_Thread.launch();
+}
+
+// ----------------------------------------------------------------------------
+void RenderThread::stop( void )
+{
+    if( !m_Running ) return;
+
+    // draw the last submitted frame, then wake the render thread up so it
+    // notices. This leaves both semaphores at zero, as before start().
+    this->finish();
+    {
+        sf::Lock lock( m_Mutex );
+        m_Running = false;
+    }
+    m_FrameReady.post();
+    m_Thread.wait();
+}
+
+// ----------------------------------------------------------------------------
+RenderCommandBuffer& RenderThread::beginFrame( void )
+{
+    RenderCommandBuffer& buffer = m_Buffers[m_WriteIndex];
+    buffer.reset( m_Window->getSize() );
+    return buffer;
+}
+
+// ----------------------------------------------------------------------------
+void RenderThread::endFrame( void )
+{
+    bool wake;
+    {
+        sf::Lock lock( m_Mutex );
+
+        // a frame still pending is stale, it is recorded over next
+        std::swap( m_WriteIndex, m_PendingIndex );
+        wake = !m_HasPending;
+        m_HasPending = true;
+    }
+
+    // one post per frame that becomes pending, never more
+    if( wake )
+        m_FrameReady.post();
+}
+
+// ----------------------------------------------------------------------------
+void RenderThread::finish( void )
+{
+    {
+        sf::Lock lock( m_Mutex );
+        if( !m_Running || (!m_HasPending && !m_Rendering) )
+            return;
+        m_WaitingForIdle = true;
+    }
+    m_Idle.wait();
+}
+
+// ----------------------------------------------------------------------------
+void RenderThread::run( void )
+{
+    m_Window->setActive( true );
+
+    for(;;)
+    {
+
+        // sleep until a frame is submitted or stop() is called
+        m_FrameReady.wait();
+        {
+            sf::Lock lock( m_Mutex );
+            if( !m_Running )
+                break;
+            std::swap( m_ReadIndex, m_PendingIndex );
+            m_HasPending = false;
+            m_Rendering = true;
+        }
+
+        m_Buffers[m_ReadIndex].replay( *m_Window );
+        m_Window->display();
+
+        {
+            sf::Lock lock( m_Mutex );
+            m_Rendering = false;
+            if( m_WaitingForIdle && !m_HasPending )
+            {
+                m_WaitingForIdle = false;
+                m_Idle.post();
+            }
+        }
+    }
+
+    m_Window->setActive( false );
+}
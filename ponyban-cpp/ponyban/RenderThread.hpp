@@ -0,0 +1,142 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RENDER_THREAD_HPP__
+#define __RENDER_THREAD_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <RenderCommandBuffer.hpp>
+
+#include <SFML/System/Thread.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Semaphore.hpp>
+
+// ----------------------------------------------------------------------------
+// forward declarations
+
+namespace sf {
+    class RenderWindow;
+}
+
+/*!
+ * @brief Submits frames to the GPU on a separate thread
+ * The main thread records each frame into a command buffer, and the render
+ * thread, which owns the window's OpenGL context, replays it and waits for
+ * the buffer swap. This way the game logic of the next frame runs while the
+ * current one is being drawn.
+ *
+ * There are three command buffers: one being recorded, one pending and one
+ * being replayed. endFrame() never waits for the render thread: it swaps the
+ * recorded buffer with the pending one, so when the GPU falls behind the
+ * stale pending frame is dropped in favour of the newer one, and input and
+ * game updates keep running at their own rate. The render thread sleeps on a
+ * semaphore until a frame is pending.
+ *
+ * Recorded frames refer to textures and shaders by pointer. Call finish()
+ * before destroying any resource that may have been drawn.
+ *
+ * Example code:
+ * @code
+ * RenderThread renderThread( window );
+ * renderThread.start();
+ * while( running )
+ * {
+ *     RenderCommandBuffer& frame = renderThread.beginFrame();
+ *     frame.clear();
+ *     frame.draw( sprite );
+ *     renderThread.endFrame();
+ * }
+ * renderThread.stop();
+ * @endcode
+ */
+class RenderThread
+{
+public:
+
+    /*!
+     * @brief Default constructor
+     * @param window The window to render to. Its context is taken over by the
+     * render thread between start() and stop().
+     */
+    RenderThread( sf::RenderWindow* window );
+
+    /*!
+     * @brief Default destructor
+     * Stops the render thread if it is still running.
+     */
+    ~RenderThread( void );
+
+    /*!
+     * @brief Deactivates the window's context and launches the render thread
+     */
+    void start( void );
+
+    /*!
+     * @brief Waits for the render thread to finish
+     * The window's context is inactive afterwards, call setActive() on the
+     * window before using it in the calling thread again.
+     */
+    void stop( void );
+
+    /*!
+     * @brief Gets an empty command buffer to record the next frame into
+     */
+    RenderCommandBuffer& beginFrame( void );
+
+    /*!
+     * @brief Hands the recorded frame over to the render thread
+     * Never blocks. If the render thread hasn't picked up the previously
+     * submitted frame yet, that frame is replaced and never drawn.
+     */
+    void endFrame( void );
+
+    /*!
+     * @brief Waits until the render thread has drawn the pending frame
+     * This is the only call that blocks. Afterwards no recorded frame refers
+     * to any resource anymore, so they can safely be destroyed.
+     */
+    void finish( void );
+
+private:
+
+    /*!
+     * @brief Render thread entry point
+     */
+    void run( void );
+
+    sf::RenderWindow* m_Window;
+    sf::Thread m_Thread;
+    sf::Mutex m_Mutex;
+
+    sf::Semaphore m_FrameReady;    // posted when a frame becomes pending
+    sf::Semaphore m_Idle;          // posted when finish() waits and the render thread goes idle
+
+    RenderCommandBuffer m_Buffers[3];
+    unsigned int m_WriteIndex;    // recorded by the main thread
+    unsigned int m_PendingIndex;  // submitted, not yet picked up
+    unsigned int m_ReadIndex;     // replayed by the render thread
+
+    // guarded by m_Mutex
+    bool m_HasPending;
+    bool m_Rendering;
+    bool m_WaitingForIdle;
+    bool m_Running;
+};
+
+#endif // __RENDER_THREAD_HPP__
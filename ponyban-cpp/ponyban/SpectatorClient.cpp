@@ -0,0 +1,246 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <SpectatorClient.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// timing
+
+namespace {
+    // Join packets double as keep-alive
+    const sf::Time joinInterval = sf::seconds( 1.0f );
+
+    // the keep-alive is spread over 0.75 to 1.25 times the interval, so
+    // that viewers started together don't flood the server every second
+    sf::Time nextJoin( const sf::Time& now )
+    {
+        return now + joinInterval * (0.75f + 0.5f * std::rand() / static_cast<float>(RAND_MAX));
+    }
+
+    // minimum time between two keyframe requests
+    const sf::Time resyncInterval = sf::milliseconds( 250 );
+}
+
+// ----------------------------------------------------------------------------
+SpectatorClient::SpectatorClient( void ) :
+    m_Listener( 0 ),
+    m_ServerPort( 0 ),
+    m_Connected( false ),
+    m_Cookie( 0 ),
+    m_Synchronised( false ),
+    m_Epoch( 0 ),
+    m_MoveCount( 0 ),
+    m_ResyncCount( 0 ),
+    m_SimulatedPacketLoss( 0.0f )
+{
+    m_Socket.setBlocking( false );
+}
+
+// ----------------------------------------------------------------------------
+SpectatorClient::~SpectatorClient( void )
+{
+    this->disconnect();
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorClient::setListener( SpectatorListener* listener )
+{
+    m_Listener = listener;
+}
+
+// ----------------------------------------------------------------------------
+bool SpectatorClient::connect( const sf::IpAddress& address, const unsigned short& port )
+{
+    this->disconnect();
+
+    if( m_Socket.bind(sf::Socket::AnyPort) != sf::Socket::Done )
+        return false;
+
+    m_ServerAddress = address;
+    m_ServerPort = port;
+    m_Connected = true;
+    m_Cookie = 0;
+    m_Synchronised = false;
+
+    this->send( SpectatorProtocol::Join );
+    m_NextJoin = nextJoin( m_Clock.getElapsedTime() );
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorClient::disconnect( void )
+{
+    if( !m_Connected )
+        return;
+
+    this->send( SpectatorProtocol::Leave );
+    m_Socket.unbind();
+    m_Connected = false;
+    m_Synchronised = false;
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorClient::update( void )
+{
+    if( !m_Connected )
+        return;
+
+    // handle everything that has arrived
+    char buffer[sf::UdpSocket::MaxDatagramSize];
+    std::size_t received;
+    sf::IpAddress address;
+    unsigned short port;
+    while( m_Socket.receive(buffer, sizeof(buffer), received, address, port) == sf::Socket::Done )
+    {
+        if( address != m_ServerAddress || port != m_ServerPort )
+            continue;
+        if( m_SimulatedPacketLoss > 0.0f && std::rand() < m_SimulatedPacketLoss * RAND_MAX )
+            continue;
+        this->receive( buffer, received );
+    }
+
+    // keep-alive, also retries joining if the first packets were lost
+    sf::Time now = m_Clock.getElapsedTime();
+    if( now >= m_NextJoin )
+    {
+        this->send( SpectatorProtocol::Join );
+        m_NextJoin = nextJoin( now );
+    }
+
+    // ask for a keyframe if we lost track of the game, or never had it. The
+    // server ignores viewers that haven't joined, so join again first in case
+    // the handshake was lost.
+    if( !m_Synchronised && now - m_LastResync >= resyncInterval )
+    {
+        this->send( SpectatorProtocol::Join );
+        if( m_Cookie )
+            this->send( SpectatorProtocol::Resync );
+        m_LastResync = now;
+        ++m_ResyncCount;
+    }
+}
+
+// ----------------------------------------------------------------------------
+bool SpectatorClient::isSynchronised( void ) const
+{
+    return m_Synchronised;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t SpectatorClient::getMoveCount( void ) const
+{
+    return m_MoveCount;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t SpectatorClient::getResyncCount( void ) const
+{
+    return m_ResyncCount;
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorClient::setSimulatedPacketLoss( const float& ratio )
+{
+    m_SimulatedPacketLoss = ratio;
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorClient::receive( const char* data, const std::size_t& size )
+{
+    SpectatorProtocol::Packet packet;
+    if( !SpectatorProtocol::read(data, size, packet) )
+        return;
+
+    if( packet.type == SpectatorProtocol::Challenge )
+    {
+        // complete the handshake right away
+        if( packet.cookie && packet.cookie != m_Cookie )
+        {
+            m_Cookie = packet.cookie;
+            this->send( SpectatorProtocol::Join );
+        }
+    }
+    else if( packet.type == SpectatorProtocol::Keyframe )
+    {
+        // a new level starts over
+        if( packet.epoch != m_Epoch )
+        {
+            m_Epoch = packet.epoch;
+            m_MoveCount = 0;
+            if( m_Listener )
+                m_Listener->onSpectatorLevel( packet.collection, packet.level );
+        }
+
+        // an older keyframe, overtaken by deltas, is ignored
+        if( packet.moveCount >= m_MoveCount )
+        {
+            this->applyMoves( packet.moves, 0 );
+            m_Synchronised = true;
+        }
+    }
+    else if( packet.type == SpectatorProtocol::Delta )
+    {
+        // deltas of another level are useless until its keyframe arrives
+        if( packet.epoch != m_Epoch )
+        {
+            m_Synchronised = false;
+            return;
+        }
+
+        // the move count is truncated to 16 bits, it is always close to ours
+        sf::Int16 ahead = static_cast<sf::Int16>( static_cast<sf::Uint16>(packet.moveCount) - static_cast<sf::Uint16>(m_MoveCount) );
+        sf::Int32 last = static_cast<sf::Int32>( m_MoveCount ) + ahead;
+        sf::Int32 first = last - static_cast<sf::Int32>( packet.moves.size() );
+
+        if( first > static_cast<sf::Int32>(m_MoveCount) )
+        {
+            // too many moves were lost
+            m_Synchronised = false;
+        }
+        else if( last > static_cast<sf::Int32>(m_MoveCount) )
+        {
+            this->applyMoves( packet.moves, first );
+            m_Synchronised = true;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorClient::applyMoves( const std::string& moves, const sf::Uint32& first )
+{
+    for( std::size_t i = m_MoveCount - first; i < moves.size(); ++i )
+    {
+        ++m_MoveCount;
+        if( m_Listener )
+            m_Listener->onSpectatorMove( moves[i] );
+    }
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorClient::send( const SpectatorProtocol::PacketType& type )
+{
+    std::vector<char> packet;
+    SpectatorProtocol::writeControl( packet, type, m_Cookie );
+    m_Socket.send( &packet[0], packet.size(), m_ServerAddress, m_ServerPort );
+}
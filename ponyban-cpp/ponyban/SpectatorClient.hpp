@@ -0,0 +1,175 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SPECTATOR_CLIENT_HPP__
+#define __SPECTATOR_CLIENT_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <SpectatorProtocol.hpp>
+
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/UdpSocket.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include <string>
+
+/*!
+ * @brief Allows any inheriting class to follow a game streamed by a
+ * SpectatorServer
+ */
+class SpectatorListener
+{
+public:
+
+    /*!
+     * @brief When the streamed game starts a level
+     * This is also called when the viewer joins, or when it has to start over
+     * after losing track of the game; the moves made so far follow.
+     * @param collection The file name of the collection the level is from
+     * @param level The name of the level
+     */
+    virtual void onSpectatorLevel( const std::string& collection, const std::string& level ){}
+
+    /*!
+     * @brief When the player of the streamed game makes a move
+     * @param move One of 'u', 'd', 'l', 'r', or 'z' for undo
+     */
+    virtual void onSpectatorMove( const char& move ){}
+};
+
+/*!
+ * @brief Receives a game streamed by a SpectatorServer
+ * Moves arrive in order and exactly once: duplicates sent for redundancy are
+ * skipped, and when a gap can't be filled the client asks the server for a
+ * keyframe and waits for it.
+ *
+ * Joining takes a handshake with the server, see SpectatorProtocol. It is
+ * handled by update().
+ *
+ * Example code:
+ * @code
+ * SpectatorClient client;
+ * client.setListener( &game );
+ * client.connect( "192.168.1.10", SpectatorProtocol::DefaultPort );
+ * while( running )
+ *     client.update();
+ * client.disconnect();
+ * @endcode
+ */
+class SpectatorClient
+{
+public:
+
+    /*!
+     * @brief Default constructor
+     */
+    SpectatorClient( void );
+
+    /*!
+     * @brief Default destructor
+     * Leaves the server if still connected.
+     */
+    ~SpectatorClient( void );
+
+    /*!
+     * @brief Sets the listener receiving the level and the moves
+     */
+    void setListener( SpectatorListener* listener );
+
+    /*!
+     * @brief Joins a server
+     * @return Returns false if no local port could be bound
+     */
+    bool connect( const sf::IpAddress& address, const unsigned short& port );
+
+    /*!
+     * @brief Leaves the server
+     */
+    void disconnect( void );
+
+    /*!
+     * @brief Receives the pending packets and passes the moves to the listener
+     * This should be called every frame.
+     */
+    void update( void );
+
+    /*!
+     * @brief Returns true if the client is following the game
+     * This is false until the first keyframe arrives, and while waiting for
+     * a keyframe after losing too many packets.
+     */
+    bool isSynchronised( void ) const;
+
+    /*!
+     * @brief Gets the number of moves received so far in the current level
+     */
+    std::size_t getMoveCount( void ) const;
+
+    /*!
+     * @brief Gets the number of keyframes requested after losing packets
+     */
+    std::size_t getResyncCount( void ) const;
+
+    /*!
+     * @brief Drops a fraction of the received packets, for testing
+     * @param ratio Between 0 (the default, nothing dropped) and 1
+     */
+    void setSimulatedPacketLoss( const float& ratio );
+
+private:
+
+    /*!
+     * @brief Handles a packet from the server
+     */
+    void receive( const char* data, const std::size_t& size );
+
+    /*!
+     * @brief Passes new moves to the listener
+     * @param moves The moves of the packet
+     * @param first The index of the first move of the packet in the game
+     */
+    void applyMoves( const std::string& moves, const sf::Uint32& first );
+
+    /*!
+     * @brief Sends a control packet to the server
+     * Join packets carry the cookie received from the server.
+     */
+    void send( const SpectatorProtocol::PacketType& type );
+
+    SpectatorListener* m_Listener;
+
+    sf::UdpSocket m_Socket;
+    sf::IpAddress m_ServerAddress;
+    unsigned short m_ServerPort;
+    bool m_Connected;
+    sf::Uint32 m_Cookie;        // 0 until the server sent its challenge
+
+    sf::Clock m_Clock;
+    sf::Time m_NextJoin;
+    sf::Time m_LastResync;
+
+    bool m_Synchronised;
+    unsigned char m_Epoch;
+    sf::Uint32 m_MoveCount;
+    std::size_t m_ResyncCount;
+
+    float m_SimulatedPacketLoss;
+};
+
+#endif // __SPECTATOR_CLIENT_HPP__
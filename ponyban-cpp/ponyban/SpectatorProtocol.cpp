@@ -0,0 +1,187 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <SpectatorProtocol.hpp>
+
+#include <cstring>
+
+// ----------------------------------------------------------------------------
+// move alphabet
+
+namespace {
+    const char moveSymbols[] = "udlrz";
+
+    int moveToDigit( const char& move )
+    {
+        const char* symbol = std::strchr( moveSymbols, move );
+        return (move && symbol) ? static_cast<int>(symbol - moveSymbols) : -1;
+    }
+}
+
+// ----------------------------------------------------------------------------
+const unsigned short SpectatorProtocol::DefaultPort;
+const std::size_t SpectatorProtocol::MaxDeltaMoves;
+
+// ----------------------------------------------------------------------------
+bool SpectatorProtocol::isMove( const char& move )
+{
+    return moveToDigit( move ) >= 0;
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorProtocol::writeDelta( std::vector<char>& packet, const unsigned char& epoch, const std::string& history, const std::size_t& count )
+{
+    sf::Uint16 moveCount = static_cast<sf::Uint16>( history.size() );
+
+    packet.clear();
+    packet.push_back( static_cast<char>((Delta << 5) | count) );
+    packet.push_back( static_cast<char>(epoch) );
+    packet.push_back( static_cast<char>(moveCount >> 8) );
+    packet.push_back( static_cast<char>(moveCount & 0xFF) );
+    packMoves( packet, history, history.size() - count, history.size() );
+}
+
+// ----------------------------------------------------------------------------
+bool SpectatorProtocol::writeKeyframe( std::vector<char>& packet, const unsigned char& epoch, const std::string& collection, const std::string& level, const std::string& history )
+{
+    if( collection.size() > 255 || level.size() > 255 )
+        return false;
+
+    sf::Uint32 moveCount = static_cast<sf::Uint32>( history.size() );
+
+    packet.clear();
+    packet.push_back( static_cast<char>(Keyframe << 5) );
+    packet.push_back( static_cast<char>(epoch) );
+    for( int shift = 24; shift >= 0; shift -= 8 )
+        packet.push_back( static_cast<char>((moveCount >> shift) & 0xFF) );
+    packet.push_back( static_cast<char>(collection.size()) );
+    packet.insert( packet.end(), collection.begin(), collection.end() );
+    packet.push_back( static_cast<char>(level.size()) );
+    packet.insert( packet.end(), level.begin(), level.end() );
+    packMoves( packet, history, 0, history.size() );
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorProtocol::writeControl( std::vector<char>& packet, const PacketType& type, const sf::Uint32& cookie )
+{
+    packet.clear();
+    packet.push_back( static_cast<char>(type << 5) );
+    if( type == Join || type == Challenge )
+    {
+        for( int shift = 24; shift >= 0; shift -= 8 )
+            packet.push_back( static_cast<char>((cookie >> shift) & 0xFF) );
+    }
+}
+
+// ----------------------------------------------------------------------------
+bool SpectatorProtocol::read( const char* data, const std::size_t& size, Packet& packet )
+{
+    if( size < 1 )
+        return false;
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>( data );
+    packet.type = static_cast<PacketType>( bytes[0] >> 5 );
+    packet.moves.clear();
+
+    switch( packet.type )
+    {
+        case Delta:
+        {
+            if( size < 4 )
+                return false;
+            packet.epoch = bytes[1];
+            packet.moveCount = (bytes[2] << 8) | bytes[3];
+            return unpackMoves( data + 4, size - 4, bytes[0] & 0x1F, packet.moves );
+        }
+
+        case Keyframe:
+        {
+            if( size < 7 )
+                return false;
+            packet.epoch = bytes[1];
+            packet.moveCount = (static_cast<sf::Uint32>(bytes[2]) << 24) | (bytes[3] << 16) | (bytes[4] << 8) | bytes[5];
+
+            // level names
+            std::size_t offset = 6;
+            std::size_t length = bytes[offset++];
+            if( offset + length + 1 > size )
+                return false;
+            packet.collection.assign( data + offset, length );
+            offset += length;
+            length = bytes[offset++];
+            if( offset + length > size )
+                return false;
+            packet.level.assign( data + offset, length );
+            offset += length;
+
+            return unpackMoves( data + offset, size - offset, packet.moveCount, packet.moves );
+        }
+
+        case Join:
+        case Challenge:
+        {
+            if( size < 5 )
+                return false;
+            packet.cookie = (static_cast<sf::Uint32>(bytes[1]) << 24) | (bytes[2] << 16) | (bytes[3] << 8) | bytes[4];
+            return true;
+        }
+
+        case Resync:
+        case Leave:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorProtocol::packMoves( std::vector<char>& packet, const std::string& history, const std::size_t& begin, const std::size_t& end )
+{
+    for( std::size_t i = begin; i < end; i += 3 )
+    {
+        int value = 0;
+        for( std::size_t j = i + 3; j-- > i; )
+            value = value * 5 + (j < end ? moveToDigit(history[j]) : 0);
+        packet.push_back( static_cast<char>(value) );
+    }
+}
+
+// ----------------------------------------------------------------------------
+bool SpectatorProtocol::unpackMoves( const char* data, const std::size_t& size, const std::size_t& count, std::string& moves )
+{
+    if( size != (count + 2) / 3 )
+        return false;
+
+    moves.reserve( moves.size() + count );
+    for( std::size_t i = 0; i < count; ++i )
+    {
+        int value = static_cast<unsigned char>( data[i/3] );
+        if( value >= 125 )
+            return false;
+        for( std::size_t j = i % 3; j > 0; --j )
+            value /= 5;
+        moves.push_back( moveSymbols[value % 5] );
+    }
+
+    return true;
+}
@@ -0,0 +1,160 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SPECTATOR_PROTOCOL_HPP__
+#define __SPECTATOR_PROTOCOL_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <SFML/Config.hpp>
+
+#include <string>
+#include <vector>
+
+/*!
+ * @brief Binary encoding of the packets exchanged with spectators
+ * A game is streamed as its level followed by the list of moves made by the
+ * player. Moves use the characters 'u', 'd', 'l' and 'r' like the other
+ * listeners, plus 'z' for undoing the previous move. Replaying the moves on
+ * the same level gives the same game, so nothing else needs to be sent.
+ *
+ * Moves are packed three to a byte (5^3 = 125 combinations fit in 8 bits).
+ * A delta packet carries the last few moves of the game, after a 4 byte
+ * header holding the packet type, the number of moves, the level epoch and
+ * the low 16 bits of the move count after the last move:
+ * @code
+ * [type:3|count:5][epoch][moveCount:16][moves packed 3 per byte...]
+ * @endcode
+ * A keyframe carries everything a viewer needs to start from scratch:
+ * @code
+ * [type:3|0][epoch][moveCount:32][length][collection][length][level][moves...]
+ * @endcode
+ * Viewers send single byte packets: Resync to ask for a keyframe, and Leave.
+ *
+ * Joining takes a handshake, so that a forged source address can't be used
+ * to make the server send keyframes to someone else. The viewer sends a Join
+ * with a cookie of 0, the server answers with a Challenge holding the cookie
+ * of the viewer's address, and the viewer sends the Join again with that
+ * cookie. Both packets are the same size, so the server never answers with
+ * more data than it received from an unverified address:
+ * @code
+ * [type:3|0][cookie:32]
+ * @endcode
+ * The server only keeps the viewers that completed the handshake. They keep
+ * sending the Join with their cookie as keep-alive.
+ */
+class SpectatorProtocol
+{
+public:
+
+    /*!
+     * @brief Types of packets
+     */
+    enum PacketType
+    {
+        Delta = 1,
+        Keyframe = 2,
+        Join = 3,
+        Resync = 4,
+        Leave = 5,
+        Challenge = 6
+    };
+
+    /*!
+     * @brief A decoded packet
+     */
+    struct Packet
+    {
+        PacketType type;
+        unsigned char epoch;        // incremented every time the level changes
+        sf::Uint32 moveCount;       // number of moves after the last one in the packet (16 bits in deltas)
+        std::string collection;     // keyframes only
+        std::string level;          // keyframes only
+        std::string moves;
+        sf::Uint32 cookie;          // Join and Challenge only
+    };
+
+    /*!
+     * @brief Port used when none is specified
+     */
+    static const unsigned short DefaultPort = 41500;
+
+    /*!
+     * @brief Maximum number of moves in a delta packet
+     */
+    static const std::size_t MaxDeltaMoves = 31;
+
+    /*!
+     * @brief Returns true if the character is one of the moves "udlrz"
+     */
+    static bool isMove( const char& move );
+
+    /*!
+     * @brief Writes a delta packet holding the last moves of a game
+     * @param packet The buffer to write the packet to. Its previous content
+     * is replaced.
+     * @param epoch The epoch of the current level
+     * @param history All of the moves of the game
+     * @param count The number of moves to include, counting back from the
+     * last one. Must not exceed MaxDeltaMoves or the size of the history.
+     */
+    static void writeDelta( std::vector<char>& packet, const unsigned char& epoch, const std::string& history, const std::size_t& count );
+
+    /*!
+     * @brief Writes a keyframe holding the level and all of the moves of a game
+     * @param packet The buffer to write the packet to. Its previous content
+     * is replaced.
+     * @param epoch The epoch of the current level
+     * @param collection The file name of the collection
+     * @param level The name of the level
+     * @param history All of the moves of the game
+     * @return Returns false if the names are longer than 255 characters
+     */
+    static bool writeKeyframe( std::vector<char>& packet, const unsigned char& epoch, const std::string& collection, const std::string& level, const std::string& history );
+
+    /*!
+     * @brief Writes a control packet
+     * @param packet The buffer to write the packet to. Its previous content
+     * is replaced.
+     * @param type One of Join, Resync, Leave or Challenge
+     * @param cookie The handshake cookie, only written in Join and Challenge
+     * packets
+     */
+    static void writeControl( std::vector<char>& packet, const PacketType& type, const sf::Uint32& cookie = 0 );
+
+    /*!
+     * @brief Decodes a packet
+     * @return Returns false if the packet is malformed
+     */
+    static bool read( const char* data, const std::size_t& size, Packet& packet );
+
+private:
+
+    /*!
+     * @brief Packs moves three to a byte and appends them to a packet
+     */
+    static void packMoves( std::vector<char>& packet, const std::string& history, const std::size_t& begin, const std::size_t& end );
+
+    /*!
+     * @brief Unpacks a number of moves
+     * @return Returns false if there isn't enough data or if it is invalid
+     */
+    static bool unpackMoves( const char* data, const std::size_t& size, const std::size_t& count, std::string& moves );
+};
+
+#endif // __SPECTATOR_PROTOCOL_HPP__
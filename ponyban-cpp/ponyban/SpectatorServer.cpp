@@ -0,0 +1,310 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <SpectatorServer.hpp>
+
+#include <SFML/Network/IpAddress.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+// ----------------------------------------------------------------------------
+// timing
+
+namespace {
+    // viewers that haven't sent a Join for this long are dropped
+    const sf::Time viewerTimeout = sf::seconds( 5.0f );
+
+    // minimum time between two keyframes sent to the same viewer on request
+    const sf::Time resyncInterval = sf::milliseconds( 100 );
+
+    // keyframes sent on request, to all viewers together: the rate at which
+    // the budget refills, and its maximum
+    const float requestedKeyframeRate = 500.0f;
+    const float requestedKeyframeBurst = 1000.0f;
+
+    // time without new moves after which the last delta is sent again
+    const sf::Time repeatDelay = sf::milliseconds( 100 );
+}
+
+// ----------------------------------------------------------------------------
+SpectatorServer::SpectatorServer( void ) :
+    m_MaxViewers( 1024 ),
+    m_Epoch( 0 ),
+    m_SentCount( 0 ),
+    m_Redundancy( 4 ),
+    m_KeyframeInterval( sf::seconds(2.0f) ),
+    m_DeltaRepeats( 0 ),
+    m_KeyframeBudget( requestedKeyframeBurst ),
+    m_BytesSent( 0 )
+{
+    m_Socket.setBlocking( false );
+
+    // the cookies only have to be unpredictable from the outside
+    m_Secret = static_cast<sf::Uint32>( std::time(0) ) ^ static_cast<sf::Uint32>( std::rand() << 16 ) ^ static_cast<sf::Uint32>( std::rand() );
+}
+
+// ----------------------------------------------------------------------------
+SpectatorServer::~SpectatorServer( void )
+{
+}
+
+// ----------------------------------------------------------------------------
+bool SpectatorServer::listen( const unsigned short& port )
+{
+    m_Socket.unbind();
+    return m_Socket.bind( port ) == sf::Socket::Done;
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorServer::setLevel( const std::string& collection, const std::string& level )
+{
+    m_Collection = collection;
+    m_Level = level;
+
+    // epoch 0 means "no level" to the viewers
+    if( ++m_Epoch == 0 )
+        ++m_Epoch;
+    m_History.clear();
+    m_SentCount = 0;
+    m_DeltaStarts.clear();
+    m_DeltaRepeats = m_Redundancy;
+
+    if( !SpectatorProtocol::writeKeyframe(m_Packet, m_Epoch, m_Collection, m_Level, m_History) )
+    {
+        std::cerr << "[SpectatorServer::setLevel] The name of the level or of its collection is too long to be streamed" << std::endl;
+        m_Packet.clear();
+    }
+    this->broadcast();
+    m_LastKeyframe = m_Clock.getElapsedTime();
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorServer::recordMove( const char& move )
+{
+    if( SpectatorProtocol::isMove(move) )
+        m_History.push_back( move );
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorServer::update( void )
+{
+    sf::Time now = m_Clock.getElapsedTime();
+
+    m_KeyframeBudget = std::min( m_KeyframeBudget + (now - m_LastUpdate).asSeconds() * requestedKeyframeRate, requestedKeyframeBurst );
+    m_LastUpdate = now;
+
+    // handle the packets from the viewers
+    char buffer[16];
+    std::size_t received;
+    sf::IpAddress address;
+    unsigned short port;
+    while( m_Socket.receive(buffer, sizeof(buffer), received, address, port) == sf::Socket::Done )
+        this->receive( buffer, received, address, port );
+
+    // drop silent viewers
+    for( std::size_t i = 0; i < m_Viewers.size(); )
+    {
+        if( now - m_Viewers[i].lastHeard > viewerTimeout )
+            this->removeViewer( i );
+        else
+            ++i;
+    }
+
+    if( m_Level.empty() )
+        return;
+
+    std::size_t newMoves = m_History.size() - m_SentCount;
+    if( newMoves > SpectatorProtocol::MaxDeltaMoves || now - m_LastKeyframe >= m_KeyframeInterval )
+    {
+        // too many moves for a delta, or time for a keyframe
+        if( SpectatorProtocol::writeKeyframe(m_Packet, m_Epoch, m_Collection, m_Level, m_History) )
+            this->broadcast();
+        m_LastKeyframe = now;
+        m_SentCount = m_History.size();
+        m_DeltaRepeats = m_Redundancy;
+    }
+    else if( newMoves > 0 )
+    {
+        // the new moves, plus those of the previous deltas for redundancy
+        m_DeltaStarts.push_back( m_SentCount );
+        while( m_DeltaStarts.size() > m_Redundancy )
+            m_DeltaStarts.pop_front();
+        std::size_t count = std::min( m_History.size() - m_DeltaStarts.front(), SpectatorProtocol::MaxDeltaMoves );
+        SpectatorProtocol::writeDelta( m_Packet, m_Epoch, m_History, count );
+        this->broadcast();
+        m_SentCount = m_History.size();
+        m_LastDelta = now;
+        m_DeltaRepeats = 1;
+    }
+    else if( m_DeltaRepeats < m_Redundancy && now - m_LastDelta >= repeatDelay )
+    {
+        // the player stopped moving: the last moves won't be repeated by the
+        // next deltas, which may be far away, so send the last delta again
+        this->broadcast();
+        m_LastDelta = now;
+        ++m_DeltaRepeats;
+    }
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorServer::setRedundancy( const std::size_t& redundancy )
+{
+    m_Redundancy = std::max<std::size_t>( redundancy, 1 );
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorServer::setKeyframeInterval( const sf::Time& interval )
+{
+    m_KeyframeInterval = interval;
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorServer::setMaxViewers( const std::size_t& maxViewers )
+{
+    m_MaxViewers = maxViewers;
+}
+
+// ----------------------------------------------------------------------------
+std::size_t SpectatorServer::getViewerCount( void ) const
+{
+    return m_Viewers.size();
+}
+
+// ----------------------------------------------------------------------------
+sf::Uint64 SpectatorServer::getBytesSent( void ) const
+{
+    return m_BytesSent;
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorServer::receive( const char* data, const std::size_t& size, const sf::IpAddress& address, const unsigned short& port )
+{
+    SpectatorProtocol::Packet packet;
+    if( !SpectatorProtocol::read(data, size, packet) )
+        return;
+
+    sf::Time now = m_Clock.getElapsedTime();
+    ViewerKey key( address.toInteger(), port );
+    std::map<ViewerKey, std::size_t>::iterator it = m_ViewerIndex.find( key );
+
+    if( it == m_ViewerIndex.end() )
+    {
+        if( packet.type != SpectatorProtocol::Join )
+            return;
+
+        // the source address may be forged: answer with its cookie, which
+        // only the real owner of the address receives
+        sf::Uint32 cookie = this->getCookie( key );
+        if( packet.cookie != cookie )
+        {
+            std::vector<char> challenge;
+            SpectatorProtocol::writeControl( challenge, SpectatorProtocol::Challenge, cookie );
+            m_Socket.send( &challenge[0], challenge.size(), address, port );
+            m_BytesSent += challenge.size();
+            return;
+        }
+
+        if( m_Viewers.size() >= m_MaxViewers )
+            return;
+
+        // new viewer
+        Viewer viewer;
+        viewer.lastHeard = now;
+        viewer.lastKeyframe = sf::Time::Zero;
+        m_ViewerIndex[key] = m_Viewers.size();
+        m_Viewers.push_back( viewer );
+        m_Peers.push_back( sf::UdpSocket::Peer(address, port) );
+        this->sendKeyframe( m_Viewers.size() - 1 );
+    }
+    else
+    {
+        std::size_t viewer = it->second;
+        m_Viewers[viewer].lastHeard = now;
+
+        if( packet.type == SpectatorProtocol::Resync && now - m_Viewers[viewer].lastKeyframe >= resyncInterval )
+            this->sendKeyframe( viewer );
+        else if( packet.type == SpectatorProtocol::Leave )
+            this->removeViewer( viewer );
+    }
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorServer::sendKeyframe( const std::size_t& viewer )
+{
+    if( m_Level.empty() || m_KeyframeBudget < 1.0f )
+        return;
+
+    // use a separate buffer, m_Packet may hold the last delta
+    std::vector<char> keyframe;
+    if( !SpectatorProtocol::writeKeyframe(keyframe, m_Epoch, m_Collection, m_Level, m_History) )
+        return;
+
+    m_Socket.send( &keyframe[0], keyframe.size(), m_Peers[viewer].address, m_Peers[viewer].port );
+    m_BytesSent += keyframe.size();
+    m_Viewers[viewer].lastKeyframe = m_Clock.getElapsedTime();
+    m_KeyframeBudget -= 1.0f;
+}
+
+// ----------------------------------------------------------------------------
+sf::Uint32 SpectatorServer::getCookie( const ViewerKey& key ) const
+{
+    // FNV-1a over the secret, the address and the port
+    sf::Uint32 values[3] = { m_Secret, key.first, key.second };
+    sf::Uint32 hash = 2166136261u;
+    for( std::size_t i = 0; i != 3; ++i )
+    {
+        for( int shift = 0; shift < 32; shift += 8 )
+        {
+            hash ^= (values[i] >> shift) & 0xFF;
+            hash *= 16777619u;
+        }
+    }
+    return hash ? hash : 1;
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorServer::broadcast( void )
+{
+    if( m_Packet.empty() || m_Peers.empty() )
+        return;
+
+    // one call for all viewers, failures are covered by redundancy
+    m_Socket.send( &m_Packet[0], m_Packet.size(), m_Peers );
+    m_BytesSent += m_Packet.size() * m_Peers.size();
+}
+
+// ----------------------------------------------------------------------------
+void SpectatorServer::removeViewer( const std::size_t& viewer )
+{
+    std::size_t last = m_Viewers.size() - 1;
+
+    m_ViewerIndex.erase( ViewerKey(m_Peers[viewer].address.toInteger(), m_Peers[viewer].port) );
+    if( viewer != last )
+    {
+        m_Viewers[viewer] = m_Viewers[last];
+        m_Peers[viewer] = m_Peers[last];
+        m_ViewerIndex[ViewerKey(m_Peers[viewer].address.toInteger(), m_Peers[viewer].port)] = viewer;
+    }
+    m_Viewers.pop_back();
+    m_Peers.pop_back();
+}
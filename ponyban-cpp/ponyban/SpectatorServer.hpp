@@ -0,0 +1,215 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SPECTATOR_SERVER_HPP__
+#define __SPECTATOR_SERVER_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <SpectatorProtocol.hpp>
+
+#include <SFML/Network/UdpSocket.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+/*!
+ * @brief Streams a game to spectators over UDP
+ * Viewers join with a handshake (see SpectatorProtocol): the server answers
+ * the first Join with a cookie derived from the viewer's address and a secret,
+ * and only accepts a viewer whose Join carries that cookie. This way nothing
+ * larger than the request is ever sent to an address that didn't prove it
+ * receives the server's packets. The number of viewers is capped, and a
+ * viewer that has been silent for 5 seconds is dropped. A new viewer
+ * receives a keyframe straight away.
+ *
+ * Keyframes sent on request, to new viewers or to those asking for a resync,
+ * are limited per viewer and in total. Viewers that don't get one catch up
+ * with the next periodic keyframe.
+ *
+ * Every update, the moves recorded since the previous update are sent as a
+ * single delta packet to all viewers at once (see sf::UdpSocket::send). Each
+ * delta also repeats the moves of the deltas before it, up to the redundancy,
+ * so a viewer missing a few packets can fill the gap from the next one. When
+ * the player stops moving, the last delta is sent again until its moves have
+ * been sent as many times, and keyframes are sent periodically. A viewer that
+ * falls too far behind asks for a keyframe.
+ *
+ * Example code:
+ * @code
+ * SpectatorServer server;
+ * server.listen( SpectatorProtocol::DefaultPort );
+ * server.setLevel( "collections/ksokoban-original.sok", "Level #1" );
+ * while( running )
+ * {
+ *     if( playerMovedUp )
+ *         server.recordMove( 'u' );
+ *     server.update();
+ * }
+ * @endcode
+ */
+class SpectatorServer
+{
+public:
+
+    /*!
+     * @brief Default constructor
+     */
+    SpectatorServer( void );
+
+    /*!
+     * @brief Default destructor
+     * Viewers are not notified, they time out by themselves.
+     */
+    ~SpectatorServer( void );
+
+    /*!
+     * @brief Starts accepting viewers on a port
+     * @return Returns false if the port couldn't be bound
+     */
+    bool listen( const unsigned short& port );
+
+    /*!
+     * @brief Starts streaming a new level
+     * The move history is cleared and all viewers receive a keyframe.
+     * @param collection The file name of the collection the level is from,
+     * without its directory
+     * @param level The name of the level
+     */
+    void setLevel( const std::string& collection, const std::string& level );
+
+    /*!
+     * @brief Records a move of the player
+     * The move is sent to the viewers by the next update.
+     * @param move One of 'u', 'd', 'l', 'r', or 'z' for undo
+     */
+    void recordMove( const char& move );
+
+    /*!
+     * @brief Handles the viewers' packets and sends the new moves
+     * This should be called every frame.
+     */
+    void update( void );
+
+    /*!
+     * @brief Sets the number of delta packets each move is sent in
+     * A viewer can lose up to redundancy-1 consecutive packets without having
+     * to ask for a keyframe, as long as they fit in a delta. The default is 4.
+     */
+    void setRedundancy( const std::size_t& redundancy );
+
+    /*!
+     * @brief Sets the time between two keyframes sent to all viewers
+     * The default is 2 seconds.
+     */
+    void setKeyframeInterval( const sf::Time& interval );
+
+    /*!
+     * @brief Sets the maximum number of viewers
+     * Viewers joining when the server is full are ignored. Viewers already
+     * watching stay when the limit is lowered. The default is 1024.
+     */
+    void setMaxViewers( const std::size_t& maxViewers );
+
+    /*!
+     * @brief Gets the number of viewers currently watching
+     */
+    std::size_t getViewerCount( void ) const;
+
+    /*!
+     * @brief Gets the number of bytes of packet payload sent so far
+     * This is the total for all viewers, without the UDP and IP headers.
+     */
+    sf::Uint64 getBytesSent( void ) const;
+
+private:
+
+    /*!
+     * @brief Per-viewer state
+     */
+    struct Viewer
+    {
+        sf::Time lastHeard;
+        sf::Time lastKeyframe;
+    };
+
+    typedef std::pair<sf::Uint32, unsigned short> ViewerKey;
+
+    /*!
+     * @brief Handles a packet from a viewer
+     */
+    void receive( const char* data, const std::size_t& size, const sf::IpAddress& address, const unsigned short& port );
+
+    /*!
+     * @brief Sends a keyframe to a single viewer
+     * Does nothing if the keyframe budget is spent.
+     */
+    void sendKeyframe( const std::size_t& viewer );
+
+    /*!
+     * @brief Computes the handshake cookie of an address
+     * @return A value that is never 0
+     */
+    sf::Uint32 getCookie( const ViewerKey& key ) const;
+
+    /*!
+     * @brief Sends the content of m_Packet to all viewers
+     */
+    void broadcast( void );
+
+    /*!
+     * @brief Removes a viewer by moving the last one in its place
+     */
+    void removeViewer( const std::size_t& viewer );
+
+    sf::UdpSocket m_Socket;
+    sf::Clock m_Clock;
+
+    // viewers, in the same order in both lists; the peers are passed as they
+    // are to the batched send
+    std::vector<sf::UdpSocket::Peer> m_Peers;
+    std::vector<Viewer> m_Viewers;
+    std::map<ViewerKey, std::size_t> m_ViewerIndex;
+    std::size_t m_MaxViewers;
+    sf::Uint32 m_Secret;        // mixed into the handshake cookies
+
+    std::string m_Collection;
+    std::string m_Level;
+    unsigned char m_Epoch;
+    std::string m_History;
+    std::size_t m_SentCount;    // moves already sent in a delta
+    std::deque<std::size_t> m_DeltaStarts;  // first new move of the last deltas
+
+    std::size_t m_Redundancy;
+    sf::Time m_KeyframeInterval;
+    sf::Time m_LastKeyframe;
+    sf::Time m_LastDelta;
+    std::size_t m_DeltaRepeats;
+
+    // keyframes that can still be sent on request, refilled over time
+    float m_KeyframeBudget;
+    sf::Time m_LastUpdate;
+
+    std::vector<char> m_Packet;
+    sf::Uint64 m_BytesSent;
+};
+
+#endif // __SPECTATOR_SERVER_HPP__
@@ -21,7 +21,44 @@
 #include <ChocobunInterface.hpp>
 #include <TextureResource.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/ImageDecoder.hpp>
 #include <iostream>
+#include <fstream>
+
+// ----------------------------------------------------------------------------
+// pre-baked textures
+
+namespace {
+
+    /*!
+     * @brief Tries to load the GPU compressed version of a texture
+     * The texture compressor tool bakes "file.png" into "file.png.ktx". The
+     * baked file is only used if it exists and the graphics driver supports
+     * its format, in which case image decoding is skipped entirely.
+     */
+    bool loadBakedTexture( sf::Texture& texture, const std::string& fileName )
+    {
+        std::string bakedFileName = fileName + ".ktx";
+        if( !std::ifstream( bakedFileName.c_str() ) )
+            return false;
+        return texture.loadFromCompressedFile( bakedFileName );
+    }
+
+    /*!
+     * @brief Sets up filtering for a freshly loaded texture
+     * Tiles are drawn scaled down to the tile size of the level, which is
+     * often a fraction of the texture size. Mipmapping keeps minified
+     * tiles from aliasing and lets the GPU sample the smaller levels.
+     * Baked textures bring their own mipmap levels, if any.
+     */
+    void setupTexture( sf::Texture& texture )
+    {
+        texture.setSmooth( true );
+        if( !texture.isCompressed() )
+            texture.generateMipmap();
+    }
+}
 
 std::vector<TextureResource*> TextureResource::m_TextureResourceList;
 std::map<std::string, sf::Texture*> TextureResource::m_TextureMap;
@@ -40,15 +77,17 @@ TextureResource::~TextureResource( void )
     // erase from texture resource list and check if texture
     // is referenced by any other texture resources
     bool doErase = true;
-    for( std::vector<TextureResource*>::iterator it = m_TextureResourceList.begin(); it != m_TextureResourceList.end(); ++it )
+    for( std::vector<TextureResource*>::iterator it = m_TextureResourceList.begin(); it != m_TextureResourceList.end(); )
     {
         if( (*it) == this )
+        {
             it = m_TextureResourceList.erase( it );
-        if( it == m_TextureResourceList.end() )
-            break;
+            continue;
+        }
 
         if( (*it)->getTexturePtr() == m_Texture )
             doErase = false;
+        ++it;
     }
 
     // erase texture from list if it is not referenced any more
@@ -74,12 +113,12 @@ bool TextureResource::loadTextureFromFile( const std::string& fileName )
     if( textureIt == m_TextureMap.end() )
     {
         m_Texture = new sf::Texture();
-        if( !m_Texture->loadFromFile(fileName) )
+        if( !loadBakedTexture(*m_Texture, fileName) && !m_Texture->loadFromFile(fileName) )
         {
             delete m_Texture;
                 return false;
         }
-        m_Texture->setSmooth( true );
+        setupTexture( *m_Texture );
         m_TextureMap[fileName] = m_Texture;
         std::cout << "loaded texture " << fileName << std::endl;
     }else
@@ -91,6 +130,73 @@ bool TextureResource::loadTextureFromFile( const std::string& fileName )
     return true;
 }
 
+// ----------------------------------------------------------------------------
+std::size_t TextureResource::preloadTexturesFromFiles( const std::vector<std::string>& fileNames, std::vector<TextureResource*>& resources )
+{
+
+    // only decode what isn't already loaded, and doesn't have a baked version
+    std::vector<std::string> toLoad;
+    std::size_t loaded = 0;
+    for( std::vector<std::string>::const_iterator it = fileNames.begin(); it != fileNames.end(); ++it )
+    {
+        std::map<std::string, sf::Texture*>::iterator textureIt = m_TextureMap.find( *it );
+        if( textureIt != m_TextureMap.end() )
+        {
+            TextureResource* resource = new TextureResource();
+            resource->m_Texture = textureIt->second;
+            resources.push_back( resource );
+            continue;
+        }
+
+        sf::Texture* texture = new sf::Texture();
+        if( loadBakedTexture(*texture, *it) )
+        {
+            setupTexture( *texture );
+            m_TextureMap[*it] = texture;
+            TextureResource* resource = new TextureResource();
+            resource->m_Texture = texture;
+            resources.push_back( resource );
+            std::cout << "preloaded baked texture " << *it << std::endl;
+            ++loaded;
+        }
+        else
+        {
+            delete texture;
+            toLoad.push_back( *it );
+        }
+    }
+
+    // decoding runs on the worker threads of the task scheduler shared with
+    // the rest of the game, the textures have to be uploaded
+    // here because this thread owns the GL context. Each image is recycled
+    // once uploaded so the next decode can re-use its pixel buffer.
+    sf::ImageDecoder decoder;
+    std::vector<sf::ImageDecoder::Future> futures = decoder.loadFromFiles( toLoad );
+    sf::Image image;
+    for( std::size_t i = 0; i != futures.size(); ++i )
+    {
+        if( !futures[i].get( image ) )
+            continue;
+
+        sf::Texture* texture = new sf::Texture();
+        if( !texture->loadFromImage( image ) )
+        {
+            delete texture;
+            continue;
+        }
+        setupTexture( *texture );
+        m_TextureMap[toLoad[i]] = texture;
+        TextureResource* resource = new TextureResource();
+        resource->m_Texture = texture;
+        resources.push_back( resource );
+        decoder.recycle( image );
+        std::cout << "preloaded texture " << toLoad[i] << std::endl;
+        ++loaded;
+    }
+
+    return loaded;
+}
+
 // ----------------------------------------------------------------------------
 const sf::Texture* TextureResource::getTexturePtr( void ) const
 {
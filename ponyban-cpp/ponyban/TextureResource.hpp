@@ -54,10 +54,28 @@ public:
      */
     virtual ~TextureResource( void );
 
+    /*!
+     * @brief Loads a batch of textures ahead of time
+     * The image files are decoded in parallel on all available processor
+     * cores, and the resulting textures are added to the shared texture map,
+     * so later calls to @a loadTextureFromFile with the same file names
+     * re-use them instead of hitting the disk. Textures that fail to load
+     * are skipped, they will be loaded (and fail) on demand as usual.
+     * @note This must be called from the thread owning the OpenGL context.
+     * @param fileNames The file names of the textures to load
+     * @param resources Receives a texture resource referencing each texture
+     * loaded. Like any other resource, these keep their texture in memory
+     * until they are deleted by the caller.
+     * @return Returns the number of textures that were loaded
+     */
+    static std::size_t preloadTexturesFromFiles( const std::vector<std::string>& fileNames, std::vector<TextureResource*>& resources );
+
 protected:
 
     /*!
      * @brief Loads a texture from a given file
+     * If a GPU compressed version baked by the texture compressor tool
+     * (fileName + ".ktx") exists and is supported, it is used instead.
      * @param fileName The file name of the texture to load
      * @return Returns true if the texture could be loaded, false if otherwise
      */
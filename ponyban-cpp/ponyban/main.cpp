@@ -19,17 +19,89 @@
 // include files
 
 #include <App.hpp>
+#include <SpectatorProtocol.hpp>
+
+#include <cstdlib>
 #include <exception>
 #include <iostream>
+#include <string>
 
 // ----------------------------------------------------------------------------
 // main entry point
 int main( int argc, char** argv )
 {
 
-    App* theApp = new App();
+    // --threaded-renderer draws frames on a separate thread
+    // --host-spectators streams the game to anyone who connects
+    // --spectate <address> watches the game streamed by someone else
+    // --spectator-port <port> overrides the default spectator port
+    // --collection <file> and --level <name> choose the level to play or render
+    // --render <image> renders the level offscreen to an image file and exits
+    // --benchmark <frames> renders the level offscreen and prints the frame rate
+    bool threadedRenderer = false;
+    bool hostSpectators = false;
+    std::string spectateAddress;
+    unsigned short spectatorPort = SpectatorProtocol::DefaultPort;
+    std::string collection = "collections/ksokoban-original.sok";
+    std::string level = "Level #1";
+    std::string renderFile;
+    unsigned int benchmarkFrames = 0;
+    for( int i = 1; i < argc; ++i )
+    {
+        std::string argument = argv[i];
+        if( argument == "--threaded-renderer" )
+            threadedRenderer = true;
+        if( argument == "--host-spectators" )
+            hostSpectators = true;
+        if( argument == "--spectate" && i+1 < argc )
+            spectateAddress = argv[++i];
+        if( argument == "--spectator-port" && i+1 < argc )
+            spectatorPort = static_cast<unsigned short>( std::atoi(argv[++i]) );
+        if( argument == "--collection" && i+1 < argc )
+            collection = argv[++i];
+        if( argument == "--level" && i+1 < argc )
+            level = argv[++i];
+        if( argument == "--render" && i+1 < argc )
+            renderFile = argv[++i];
+        if( argument == "--benchmark" && i+1 < argc )
+        {
+            char* end;
+            long frames = std::strtol( argv[++i], &end, 10 );
+            if( *end != '\0' || frames <= 0 )
+            {
+                std::cerr << "--benchmark expects a positive number of frames, not \"" << argv[i] << "\"" << std::endl;
+                return 1;
+            }
+            benchmarkFrames = static_cast<unsigned int>( frames );
+        }
+    }
+
+    // rendering offscreen doesn't need a window, nor a display
+    bool headless = !renderFile.empty() || benchmarkFrames;
+    if( headless && (hostSpectators || !spectateAddress.empty()) )
+    {
+        std::cerr << "--host-spectators and --spectate can't be combined with --render or --benchmark" << std::endl;
+        return 1;
+    }
+    App* theApp = new App( threadedRenderer, headless );
+    theApp->setLevel( collection, level );
+
+    if( headless )
+    {
+        bool success = true;
+        if( !renderFile.empty() )
+            success = theApp->renderToFile( renderFile ) && success;
+        if( benchmarkFrames )
+            success = theApp->benchmark( benchmarkFrames ) && success;
+        delete theApp;
+        return success ? 0 : 1;
+    }
 
     try {
+        if( hostSpectators && !theApp->hostSpectators(spectatorPort) )
+            std::cerr << "Unable to host spectators on port " << spectatorPort << std::endl;
+        if( !spectateAddress.empty() && !theApp->spectate(spectateAddress, spectatorPort) )
+            std::cerr << "Unable to spectate " << spectateAddress << std::endl;
         theApp->go();
     }catch( std::exception& e ){
         std::cerr << "Exception caught: " << e.what() << std::endl;
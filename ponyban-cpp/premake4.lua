@@ -29,14 +29,50 @@ if os.get() == "windows" then
 		"chocobun-core_d",
 		"sfml-system-d",
 		"sfml-window-d",
-		"sfml-graphics-d"
+		"sfml-graphics-d",
+		"sfml-network-d"
 	}
 	linklibs_ponyban_release = {
 		"chocobun-core",
+		"sfml-system",
+		"sfml-window",
+		"sfml-graphics",
+		"sfml-network"
+	}
+	linklibs_texturecompressor_debug = {
+		"sfml-system-d",
+		"sfml-graphics-d"
+	}
+	linklibs_texturecompressor_release = {
+		"sfml-system",
+		"sfml-graphics"
+	}
+	linklibs_spectatorstress_debug = {
+		"sfml-system-d",
+		"sfml-network-d"
+	}
+	linklibs_spectatorstress_release = {
+		"sfml-system",
+		"sfml-network"
+	}
+	linklibs_dispatchbenchmark_debug = {
+		"sfml-system-d",
+		"sfml-window-d",
+		"sfml-graphics-d"
+	}
+	linklibs_dispatchbenchmark_release = {
 		"sfml-system",
 		"sfml-window",
 		"sfml-graphics"
 	}
+	linklibs_mixerbenchmark_debug = {
+		"sfml-system-d",
+		"sfml-audio-d"
+	}
+	linklibs_mixerbenchmark_release = {
+		"sfml-system",
+		"sfml-audio"
+	}
 
 elseif os.get() == "linux" then
 
@@ -62,14 +98,50 @@ elseif os.get() == "linux" then
 		"chocobun-core_d",
 		"sfml-system",
 		"sfml-window",
-		"sfml-graphics"
+		"sfml-graphics",
+		"sfml-network"
 	}
 	linklibs_ponyban_release = {
 		"chocobun-core",
+		"sfml-system",
+		"sfml-window",
+		"sfml-graphics",
+		"sfml-network"
+	}
+	linklibs_texturecompressor_debug = {
+		"sfml-system",
+		"sfml-graphics"
+	}
+	linklibs_texturecompressor_release = {
+		"sfml-system",
+		"sfml-graphics"
+	}
+	linklibs_spectatorstress_debug = {
+		"sfml-system",
+		"sfml-network"
+	}
+	linklibs_spectatorstress_release = {
+		"sfml-system",
+		"sfml-network"
+	}
+	linklibs_dispatchbenchmark_debug = {
 		"sfml-system",
 		"sfml-window",
 		"sfml-graphics"
 	}
+	linklibs_dispatchbenchmark_release = {
+		"sfml-system",
+		"sfml-window",
+		"sfml-graphics"
+	}
+	linklibs_mixerbenchmark_debug = {
+		"sfml-system",
+		"sfml-audio"
+	}
+	linklibs_mixerbenchmark_release = {
+		"sfml-system",
+		"sfml-audio"
+	}
 	
 -- MAAAC
 elseif os.get() == "macosx" then
@@ -95,14 +167,50 @@ elseif os.get() == "macosx" then
 		"chocobun-core_d",
 		"sfml-system",
 		"sfml-window",
-		"sfml-graphics"
+		"sfml-graphics",
+		"sfml-network"
 	}
 	linklibs_ponyban_release = {
 		"chocobun-core",
+		"sfml-system",
+		"sfml-window",
+		"sfml-graphics",
+		"sfml-network"
+	}
+	linklibs_texturecompressor_debug = {
+		"sfml-system",
+		"sfml-graphics"
+	}
+	linklibs_texturecompressor_release = {
+		"sfml-system",
+		"sfml-graphics"
+	}
+	linklibs_spectatorstress_debug = {
+		"sfml-system",
+		"sfml-network"
+	}
+	linklibs_spectatorstress_release = {
+		"sfml-system",
+		"sfml-network"
+	}
+	linklibs_dispatchbenchmark_debug = {
+		"sfml-system",
+		"sfml-window",
+		"sfml-graphics"
+	}
+	linklibs_dispatchbenchmark_release = {
 		"sfml-system",
 		"sfml-window",
 		"sfml-graphics"
 	}
+	linklibs_mixerbenchmark_debug = {
+		"sfml-system",
+		"sfml-audio"
+	}
+	linklibs_mixerbenchmark_release = {
+		"sfml-system",
+		"sfml-audio"
+	}
 
 -- OS couldn't be determined
 else
@@ -209,4 +317,158 @@ solution "Ponyban"
 				"Optimize"
 			}
 			libdirs (libSearchDirs)
-			links (linklibs_ponyban_release)	
+			links (linklibs_ponyban_release)
+
+	-------------------------------------------------------------------
+	-- Texture compressor
+	-------------------------------------------------------------------
+
+	project "texture-compressor"
+		kind "ConsoleApp"
+		language "C++"
+		files {
+			"tools/texture-compressor/**.cpp",
+			"tools/texture-compressor/**.hpp"
+		}
+
+		includedirs (headerSearchDirs)
+		includedirs {
+			"tools/texture-compressor"
+		}
+
+		configuration "Debug"
+			targetdir "bin/debug"
+			defines {
+				"DEBUG",
+				"_DEBUG"
+			}
+			flags {
+				"Symbols"
+			}
+			libdirs (libSearchDirs)
+			links (linklibs_texturecompressor_debug)
+
+		configuration "Release"
+			targetdir "bin/release"
+			defines {
+				"NDEBUG"
+			}
+			flags {
+				"Optimize"
+			}
+			libdirs (libSearchDirs)
+			links (linklibs_texturecompressor_release)
+
+	-------------------------------------------------------------------
+	-- Spectator stress test
+	-------------------------------------------------------------------
+
+	project "spectator-stress"
+		kind "ConsoleApp"
+		language "C++"
+		files {
+			"tools/spectator-stress/**.cpp",
+			"ponyban/Spectator*.cpp",
+			"ponyban/Spectator*.hpp"
+		}
+
+		includedirs (headerSearchDirs)
+
+		configuration "Debug"
+			targetdir "bin/debug"
+			defines {
+				"DEBUG",
+				"_DEBUG"
+			}
+			flags {
+				"Symbols"
+			}
+			libdirs (libSearchDirs)
+			links (linklibs_spectatorstress_debug)
+
+		configuration "Release"
+			targetdir "bin/release"
+			defines {
+				"NDEBUG"
+			}
+			flags {
+				"Optimize"
+			}
+			libdirs (libSearchDirs)
+			links (linklibs_spectatorstress_release)
+
+	-------------------------------------------------------------------
+	-- Dispatch benchmark
+	-------------------------------------------------------------------
+
+	project "dispatch-benchmark"
+		kind "ConsoleApp"
+		language "C++"
+		files {
+			"tools/dispatch-benchmark/**.cpp",
+			"ponyban/EventDispatcher.cpp",
+			"ponyban/EventDispatcher.hpp",
+			"ponyban/EventQueue.cpp",
+			"ponyban/EventQueue.hpp"
+		}
+
+		includedirs (headerSearchDirs)
+
+		configuration "Debug"
+			targetdir "bin/debug"
+			defines {
+				"DEBUG",
+				"_DEBUG"
+			}
+			flags {
+				"Symbols"
+			}
+			libdirs (libSearchDirs)
+			links (linklibs_dispatchbenchmark_debug)
+
+		configuration "Release"
+			targetdir "bin/release"
+			defines {
+				"NDEBUG"
+			}
+			flags {
+				"Optimize"
+			}
+			libdirs (libSearchDirs)
+			links (linklibs_dispatchbenchmark_release)
+
+	-------------------------------------------------------------------
+	-- Mixer benchmark
+	-------------------------------------------------------------------
+
+	project "mixer-benchmark"
+		kind "ConsoleApp"
+		language "C++"
+		files {
+			"tools/mixer-benchmark/**.cpp"
+		}
+
+		includedirs (headerSearchDirs)
+
+		configuration "Debug"
+			targetdir "bin/debug"
+			defines {
+				"DEBUG",
+				"_DEBUG"
+			}
+			flags {
+				"Symbols"
+			}
+			libdirs (libSearchDirs)
+			links (linklibs_mixerbenchmark_debug)
+
+		configuration "Release"
+			targetdir "bin/release"
+			defines {
+				"NDEBUG"
+			}
+			flags {
+				"Optimize"
+			}
+			libdirs (libSearchDirs)
+			links (linklibs_mixerbenchmark_release)
@@ -0,0 +1,179 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <EventDispatcher.hpp>
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// usage
+
+namespace {
+    void printUsage( void )
+    {
+        std::cout << "usage: dispatch-benchmark [-l listeners] [-d dispatches]" << std::endl
+                  << "  Measures the cost of dispatching update events while only some of" << std::endl
+                  << "  the listeners are subscribed to them. The rest are subscribed to" << std::endl
+                  << "  key presses, and shouldn't cost anything." << std::endl
+                  << "  -l  total number of listeners (default: 1000)" << std::endl
+                  << "  -d  number of update events dispatched per run (default: 100000)" << std::endl;
+    }
+
+    // counts the updates it receives, so the calls can't be optimised away
+    class Counter :
+        public EventDispatcherListener
+    {
+    public:
+        Counter( void ) : updates( 0 ) {}
+
+        void onUpdate( const sf::Time& delta )
+        {
+            ++updates;
+        }
+
+        std::size_t updates;
+    };
+
+    // subscribes another listener in the middle of every update
+    class Subscriber :
+        public EventDispatcherListener
+    {
+    public:
+        Subscriber( EventDispatcher& dispatcher, Counter& counter ) :
+            m_Dispatcher( dispatcher ),
+            m_Counter( counter )
+        {
+        }
+
+        void onUpdate( const sf::Time& delta )
+        {
+            m_Dispatcher.unsubscribe( EventDispatcher::Update, &m_Counter );
+            m_Dispatcher.subscribe( EventDispatcher::Update, &m_Counter );
+        }
+
+    private:
+        EventDispatcher& m_Dispatcher;
+        Counter& m_Counter;
+    };
+
+    // dispatches update events and returns the time per dispatch in nanoseconds
+    double measure( EventDispatcher& dispatcher, const std::size_t& dispatchCount )
+    {
+        const sf::Time delta = sf::milliseconds( 16 );
+        sf::Clock clock;
+        for( std::size_t i = 0; i != dispatchCount; ++i )
+            dispatcher.dispatchUpdate( delta );
+        return clock.getElapsedTime().asMicroseconds() * 1000.0 / dispatchCount;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// main entry point
+int main( int argc, char** argv )
+{
+    std::size_t listenerCount = 1000;
+    std::size_t dispatchCount = 100000;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        std::string argument = argv[i];
+        if( argument == "-h" || argument == "--help" || i+1 >= argc )
+        {
+            printUsage();
+            return 0;
+        }
+        if( argument == "-l" )
+            listenerCount = std::atoi( argv[++i] );
+        else if( argument == "-d" )
+            dispatchCount = std::atoi( argv[++i] );
+    }
+    if( !listenerCount || !dispatchCount )
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<Counter> counters( listenerCount );
+    std::size_t expectedUpdates = 0;
+
+    // listeners subscribed to everything, which is what every listener used
+    // to cost before subscriptions existed
+    {
+        EventDispatcher dispatcher( 0 );
+        for( std::size_t i = 0; i != listenerCount; ++i )
+            dispatcher.registerListener( &counters[i] );
+        double ns = measure( dispatcher, dispatchCount );
+        expectedUpdates += listenerCount * dispatchCount;
+        std::cout << "all " << listenerCount << " listeners registered: " << ns << " ns per dispatch" << std::endl;
+    }
+
+    // only a fraction subscribed to updates, the cost should follow them
+    for( std::size_t subscribed = listenerCount; subscribed > 0; subscribed /= 10 )
+    {
+        EventDispatcher dispatcher( 0 );
+        for( std::size_t i = 0; i != listenerCount; ++i )
+        {
+            if( i < subscribed )
+                dispatcher.subscribe( EventDispatcher::Update, &counters[i] );
+            else
+                dispatcher.subscribe( EventDispatcher::KeyPress, &counters[i] );
+        }
+        double ns = measure( dispatcher, dispatchCount );
+        expectedUpdates += subscribed * dispatchCount;
+        std::cout << subscribed << "/" << listenerCount << " listeners subscribed: " << ns << " ns per dispatch, "
+                  << ns / subscribed << " ns per subscriber" << std::endl;
+    }
+
+    // a subscription changing during every dispatch is deferred to its end.
+    // The listener is unsubscribed before its turn every time, so it must
+    // never be called.
+    Counter resubscribed;
+    {
+        EventDispatcher dispatcher( 0 );
+        Subscriber subscriber( dispatcher, resubscribed );
+        dispatcher.subscribe( EventDispatcher::Update, &subscriber, 1 );
+        dispatcher.subscribe( EventDispatcher::Update, &resubscribed );
+        double ns = measure( dispatcher, dispatchCount );
+        std::cout << "resubscribing during dispatch: " << ns << " ns per dispatch" << std::endl;
+    }
+
+    // make sure every subscriber was called exactly once per dispatch
+    std::size_t updates = 0;
+    for( std::size_t i = 0; i != listenerCount; ++i )
+        updates += counters[i].updates;
+    if( updates != expectedUpdates )
+    {
+        std::cerr << "Expected " << expectedUpdates << " updates, got " << updates << std::endl;
+        return 1;
+    }
+    if( resubscribed.updates )
+    {
+        std::cerr << "A listener unsubscribed during dispatch was called " << resubscribed.updates << " times" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Audio/SoundMixer.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// usage
+
+namespace {
+    const unsigned int sampleRate = 44100;
+    const std::size_t chunkFrames = 1024;
+
+    void printUsage( void )
+    {
+        std::cout << "usage: mixer-benchmark [-v voices] [-s seconds]" << std::endl
+                  << "  Checks sf::SoundMixer on the null device, then measures how long" << std::endl
+                  << "  it takes to mix many voices. No audio hardware is used." << std::endl
+                  << "  -v  number of voices playing at the same time (default: 64)" << std::endl
+                  << "  -s  seconds of audio to mix (default: 10)" << std::endl;
+    }
+
+    // fills a buffer with a sine wave
+    bool makeTone( sf::SoundBuffer& buffer, const float& frequency, const float& seconds, const unsigned int& channelCount )
+    {
+        std::vector<sf::Int16> samples( static_cast<std::size_t>(seconds * sampleRate) * channelCount );
+        for( std::size_t i = 0; i != samples.size(); ++i )
+        {
+            float t = static_cast<float>(i / channelCount) / sampleRate;
+            samples[i] = static_cast<sf::Int16>( 8000.0f * std::sin(6.2831853f * frequency * t) );
+        }
+        return buffer.loadFromSamples( &samples[0], samples.size(), channelCount, sampleRate );
+    }
+
+    // mixes one chunk and returns its peak amplitude
+    int mixPeak( sf::SoundMixer& mixer )
+    {
+        sf::Int16 samples[chunkFrames * 2];
+        mixer.mix( samples, chunkFrames );
+        int peak = 0;
+        for( std::size_t i = 0; i != chunkFrames * 2; ++i )
+            peak = std::max( peak, std::abs(static_cast<int>(samples[i])) );
+        return peak;
+    }
+
+    bool check( const bool& condition, const char* what )
+    {
+        std::cout << (condition ? "ok      " : "FAILED  ") << what << std::endl;
+        return condition;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// main entry point
+int main( int argc, char** argv )
+{
+    unsigned int voiceCount = 64;
+    float seconds = 10.0f;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        std::string argument = argv[i];
+        if( argument == "-h" || argument == "--help" || i+1 >= argc )
+        {
+            printUsage();
+            return 0;
+        }
+        if( argument == "-v" )
+            voiceCount = std::atoi( argv[++i] );
+        else if( argument == "-s" )
+            seconds = static_cast<float>( std::atof(argv[++i]) );
+    }
+    if( !voiceCount || seconds <= 0.0f )
+    {
+        printUsage();
+        return 1;
+    }
+
+    sf::SoundBuffer mono, stereo;
+    if( !makeTone(mono, 440.0f, 1.0f, 1) || !makeTone(stereo, 660.0f, 1.5f, 2) )
+    {
+        std::cerr << "Failed to create the test sounds" << std::endl;
+        return 1;
+    }
+
+    bool passed = true;
+
+    // behaviour
+    {
+        sf::SoundMixer mixer( 2, sampleRate );
+        passed &= check( mixer.open(sf::SoundMixer::NullDevice), "the null device opens" );
+        passed &= check( mixPeak(mixer) == 0, "silence without voices" );
+
+        sf::SoundMixer::VoiceId low = mixer.play( mono, 0 );
+        sf::SoundMixer::VoiceId high = mixer.play( stereo, 5 );
+        passed &= check( low != sf::SoundMixer::InvalidVoice && high != sf::SoundMixer::InvalidVoice, "voices start" );
+        passed &= check( mixPeak(mixer) > 0, "playing voices are mixed" );
+
+        passed &= check( mixer.play(mono, -1) == sf::SoundMixer::InvalidVoice, "a lower priority sound is dropped" );
+        passed &= check( mixer.play(mono, 1) != sf::SoundMixer::InvalidVoice && !mixer.isPlaying(low), "a higher priority sound steals the weakest voice" );
+        passed &= check( mixer.isPlaying(high), "the stronger voice keeps playing" );
+
+        mixer.stopAll();
+        passed &= check( mixPeak(mixer) == 0, "stopped voices are silent" );
+
+        // the mixer reads the samples of the buffer, replacing or destroying
+        // it must stop its voices rather than leave them dangling
+        sf::SoundBuffer* temporary = new sf::SoundBuffer( mono );
+        sf::SoundMixer::VoiceId voice = mixer.play( *temporary );
+        makeTone( *temporary, 220.0f, 0.5f, 1 );
+        passed &= check( !mixer.isPlaying(voice), "reloading a buffer stops its voices" );
+        voice = mixer.play( *temporary );
+        delete temporary;
+        passed &= check( !mixer.isPlaying(voice) && mixPeak(mixer) == 0, "destroying a buffer stops its voices" );
+
+        // a buffer may outlive the mixer playing it
+        sf::SoundBuffer survivor( mono );
+        sf::SoundMixer* shortLived = new sf::SoundMixer( 1, sampleRate );
+        shortLived->play( survivor );
+        delete shortLived;
+        survivor = stereo;
+        passed &= check( survivor.getChannelCount() == 2, "a buffer outlives the mixer playing it" );
+    }
+
+    // performance
+    {
+        sf::SoundMixer mixer( voiceCount, sampleRate );
+        mixer.open( sf::SoundMixer::NullDevice );
+
+        std::vector<sf::Int16> samples( chunkFrames * 2 );
+        std::size_t chunkCount = static_cast<std::size_t>( seconds * sampleRate / chunkFrames );
+        std::srand( 1 );
+        for( std::size_t chunk = 0; chunk != chunkCount; ++chunk )
+        {
+
+            // keep every voice busy, with varying pitches and positions
+            while( mixer.getMixerStats().activeVoices < voiceCount )
+            {
+                float pitch = 0.5f + (std::rand() % 100) / 66.0f;
+                float pan = (std::rand() % 201) / 100.0f - 1.0f;
+                if( !mixer.play((std::rand() % 2) ? mono : stereo, 0, 50.0f, pan, pitch) )
+                {
+                    std::cerr << "Failed to start a voice" << std::endl;
+                    return 1;
+                }
+            }
+            mixer.mix( &samples[0], chunkFrames );
+        }
+
+        sf::SoundMixer::MixerStats stats = mixer.getMixerStats();
+        double audioSeconds = static_cast<double>(stats.mixedFrames) / sampleRate;
+        std::cout << voiceCount << " voices, " << audioSeconds << "s of audio mixed in "
+                  << stats.mixTime.asMilliseconds() << "ms (" << audioSeconds / stats.mixTime.asSeconds() << "x real time), "
+                  << stats.startedVoices << " sounds started" << std::endl;
+    }
+
+    return passed ? 0 : 1;
+}
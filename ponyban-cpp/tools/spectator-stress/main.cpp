@@ -0,0 +1,206 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <SpectatorClient.hpp>
+#include <SpectatorServer.hpp>
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// usage
+
+namespace {
+    void printUsage( void )
+    {
+        std::cout << "usage: spectator-stress [-v viewers] [-m moves] [-f moves-per-frame] [-l loss] [-p port]" << std::endl
+                  << "  Streams random moves from a spectator server to many viewers over" << std::endl
+                  << "  loopback, all in this thread, and checks that every viewer ends up" << std::endl
+                  << "  with the same game." << std::endl
+                  << "  -v  number of viewers (default: 1000)" << std::endl
+                  << "  -m  number of moves to play (default: 10000)" << std::endl
+                  << "  -f  moves recorded between two server updates (default: 1)" << std::endl
+                  << "  -l  fraction of packets dropped by each viewer (default: 0)" << std::endl
+                  << "  -p  server port (default: " << SpectatorProtocol::DefaultPort << ")" << std::endl;
+    }
+
+    // records what a viewer receives
+    class Recorder :
+        public SpectatorListener
+    {
+    public:
+        Recorder( void ) : levelCount( 0 ) {}
+
+        void onSpectatorLevel( const std::string& collection, const std::string& level )
+        {
+            moves.clear();
+            ++levelCount;
+        }
+
+        void onSpectatorMove( const char& move )
+        {
+            moves.push_back( move );
+        }
+
+        std::string moves;
+        std::size_t levelCount;
+    };
+}
+
+// ----------------------------------------------------------------------------
+// main entry point
+int main( int argc, char** argv )
+{
+    std::size_t viewerCount = 1000;
+    std::size_t moveCount = 10000;
+    std::size_t movesPerFrame = 1;
+    float loss = 0.0f;
+    unsigned short port = SpectatorProtocol::DefaultPort;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        std::string argument = argv[i];
+        if( argument == "-h" || argument == "--help" || i+1 >= argc )
+        {
+            printUsage();
+            return 0;
+        }
+        if( argument == "-v" )
+            viewerCount = std::atoi( argv[++i] );
+        else if( argument == "-m" )
+            moveCount = std::atoi( argv[++i] );
+        else if( argument == "-f" )
+            movesPerFrame = std::max( std::atoi(argv[++i]), 1 );
+        else if( argument == "-l" )
+            loss = static_cast<float>( std::atof(argv[++i]) );
+        else if( argument == "-p" )
+            port = static_cast<unsigned short>( std::atoi(argv[++i]) );
+    }
+
+    SpectatorServer server;
+    if( !server.listen(port) )
+    {
+        std::cerr << "Failed to bind port " << port << std::endl;
+        return 1;
+    }
+    server.setMaxViewers( viewerCount );
+    server.setLevel( "ksokoban-original.sok", "Level #1" );
+
+    std::vector<SpectatorClient*> viewers( viewerCount );
+    std::vector<Recorder> recorders( viewerCount );
+    for( std::size_t i = 0; i != viewerCount; ++i )
+    {
+        viewers[i] = new SpectatorClient();
+        viewers[i]->setListener( &recorders[i] );
+        if( !viewers[i]->connect(sf::IpAddress::LocalHost, port) )
+        {
+            std::cerr << "Failed to create viewer " << i << std::endl;
+            return 1;
+        }
+    }
+
+    // wait for everyone to join
+    sf::Clock timeout;
+    std::size_t synchronised = 0;
+    while( synchronised < viewerCount && timeout.getElapsedTime() < sf::seconds(10.0f) )
+    {
+        server.update();
+        synchronised = 0;
+        for( std::size_t i = 0; i != viewerCount; ++i )
+        {
+            viewers[i]->update();
+            synchronised += viewers[i]->isSynchronised() ? 1 : 0;
+        }
+    }
+    std::cout << server.getViewerCount() << " viewers joined, " << synchronised << " synchronised" << std::endl;
+
+    // the simulated loss starts now, so that joining doesn't take forever
+    for( std::size_t i = 0; i != viewerCount; ++i )
+        viewers[i]->setSimulatedPacketLoss( loss );
+
+    // play
+    const char symbols[] = "udlrz";
+    std::string played;
+    sf::Uint64 bytesBefore = server.getBytesSent();
+    sf::Time serverTime, viewerTime;
+    std::size_t frames = 0;
+    std::srand( 1 );
+    while( played.size() < moveCount )
+    {
+        for( std::size_t i = 0; i != movesPerFrame && played.size() < moveCount; ++i )
+        {
+            char move = symbols[std::rand() % 5];
+            played.push_back( move );
+            server.recordMove( move );
+        }
+
+        sf::Clock clock;
+        server.update();
+        serverTime += clock.restart();
+        for( std::size_t i = 0; i != viewerCount; ++i )
+            viewers[i]->update();
+        viewerTime += clock.getElapsedTime();
+        ++frames;
+    }
+    sf::Uint64 bytes = server.getBytesSent() - bytesBefore;
+
+    // let the viewers catch up on what they lost
+    timeout.restart();
+    std::size_t complete = 0;
+    while( timeout.getElapsedTime() < sf::seconds(5.0f) )
+    {
+        server.update();
+        complete = 0;
+        for( std::size_t i = 0; i != viewerCount; ++i )
+        {
+            viewers[i]->update();
+            complete += (viewers[i]->getMoveCount() == played.size()) ? 1 : 0;
+        }
+        if( complete == viewerCount )
+            break;
+        sf::sleep( sf::milliseconds(1) );
+    }
+
+    // report
+    std::size_t matching = 0, resyncs = 0;
+    for( std::size_t i = 0; i != viewerCount; ++i )
+    {
+        matching += (recorders[i].moves == played) ? 1 : 0;
+        resyncs += viewers[i]->getResyncCount();
+    }
+
+    std::cout << played.size() << " moves in " << frames << " frames, " << viewerCount << " viewers, " << loss * 100.0f << "% loss" << std::endl
+              << "server:  " << serverTime.asMicroseconds() / static_cast<float>(frames) << " us per frame ("
+              << viewerCount * frames / serverTime.asSeconds() << " packets/s)" << std::endl
+              << "viewers: " << viewerTime.asMicroseconds() / static_cast<float>(frames) << " us per frame for all of them" << std::endl
+              << "payload: " << bytes / static_cast<double>(viewerCount) / played.size() << " bytes per move per viewer, keyframes included" << std::endl
+              << "result:  " << matching << "/" << viewerCount << " viewers have the full game, " << resyncs << " keyframe requests" << std::endl;
+
+    for( std::size_t i = 0; i != viewerCount; ++i )
+        delete viewers[i];
+
+    return matching == viewerCount ? 0 : 1;
+}
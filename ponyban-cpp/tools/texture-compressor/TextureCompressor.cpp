@@ -0,0 +1,531 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <TextureCompressor.hpp>
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <fstream>
+
+// ----------------------------------------------------------------------------
+// format constants and lookup tables
+
+namespace {
+
+    // OpenGL internal formats, as stored in the KTX header
+    const sf::Uint32 GL_RGB_ID = 0x1907;
+    const sf::Uint32 GL_RGBA_ID = 0x1908;
+    const sf::Uint32 GL_DXT1_ID = 0x83F0;
+    const sf::Uint32 GL_DXT5_ID = 0x83F3;
+    const sf::Uint32 GL_ETC2_RGB_ID = 0x9274;
+    const sf::Uint32 GL_ETC2_RGBA_ID = 0x9278;
+
+    // ETC1 intensity modifier tables (small and large magnitude)
+    const int ETCModifiers[8][2] = {
+        {  2,   8 }, {  5,  17 }, {  9,  29 }, { 13,  42 },
+        { 18,  60 }, { 24,  80 }, { 33, 106 }, { 47, 183 }
+    };
+
+    // EAC alpha modifier tables
+    const int EACModifiers[16][8] = {
+        { -3, -6,  -9, -15, 2, 5, 8, 14 },
+        { -3, -7, -10, -13, 2, 6, 9, 12 },
+        { -2, -5,  -8, -13, 1, 4, 7, 12 },
+        { -2, -4,  -6, -13, 1, 3, 5, 12 },
+        { -3, -6,  -8, -12, 2, 5, 7, 11 },
+        { -3, -7,  -9, -11, 2, 6, 8, 10 },
+        { -4, -7,  -8, -11, 3, 6, 7, 10 },
+        { -3, -5,  -8, -11, 2, 4, 7, 10 },
+        { -2, -6,  -8, -10, 1, 5, 7,  9 },
+        { -2, -5,  -8, -10, 1, 4, 7,  9 },
+        { -2, -4,  -8, -10, 1, 3, 7,  9 },
+        { -2, -5,  -7, -10, 1, 4, 6,  9 },
+        { -3, -4,  -7, -10, 2, 3, 6,  9 },
+        { -1, -2,  -3, -10, 0, 1, 2,  9 },
+        { -4, -6,  -8,  -9, 3, 5, 7,  8 },
+        { -3, -5,  -7,  -9, 2, 4, 6,  8 }
+    };
+
+    int clampByte( const int& value )
+    {
+        return value < 0 ? 0 : (value > 255 ? 255 : value);
+    }
+
+    int square( const int& value )
+    {
+        return value * value;
+    }
+
+    // packs an 8 bit colour into 5:6:5
+    sf::Uint16 packRGB565( const int* colour )
+    {
+        return static_cast<sf::Uint16>( ((colour[0] * 31 + 127) / 255) << 11 |
+                                        ((colour[1] * 63 + 127) / 255) << 5 |
+                                        ((colour[2] * 31 + 127) / 255) );
+    }
+
+    // expands a 5:6:5 colour back to 8 bits per channel
+    void unpackRGB565( const sf::Uint16& packed, int* colour )
+    {
+        int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+        colour[0] = (r << 3) | (r >> 2);
+        colour[1] = (g << 2) | (g >> 4);
+        colour[2] = (b << 3) | (b >> 2);
+    }
+
+    void writeUint32( std::ofstream& file, const sf::Uint32& value )
+    {
+        file.write( reinterpret_cast<const char*>(&value), sizeof(value) );
+    }
+}
+
+// ----------------------------------------------------------------------------
+TextureCompressor::TextureCompressor( const Format& format ) :
+    m_Format( format ),
+    m_GenerateMipmaps( false ),
+    m_Width( 0 ),
+    m_Height( 0 )
+{
+}
+
+// ----------------------------------------------------------------------------
+TextureCompressor::~TextureCompressor( void )
+{
+}
+
+// ----------------------------------------------------------------------------
+void TextureCompressor::setGenerateMipmaps( const bool& generate )
+{
+    m_GenerateMipmaps = generate;
+}
+
+// ----------------------------------------------------------------------------
+bool TextureCompressor::compress( const sf::Image& image )
+{
+    m_Levels.clear();
+    m_Width = image.getSize().x;
+    m_Height = image.getSize().y;
+    if( !m_Width || !m_Height )
+        return false;
+
+    this->compressLevel( image );
+    if( !m_GenerateMipmaps )
+        return true;
+
+    // halve until both dimensions reach 1
+    sf::Image level = image;
+    while( level.getSize().x > 1 || level.getSize().y > 1 )
+    {
+        sf::Image smaller;
+        downsample( level, smaller );
+        this->compressLevel( smaller );
+        level = smaller;
+    }
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+bool TextureCompressor::saveToFile( const std::string& fileName ) const
+{
+    if( m_Levels.empty() )
+        return false;
+
+    std::ofstream file( fileName.c_str(), std::ios_base::binary );
+    if( !file )
+        return false;
+
+    sf::Uint32 internalFormat = GL_DXT1_ID, baseFormat = GL_RGB_ID;
+    if( m_Format == DXT5 ){ internalFormat = GL_DXT5_ID; baseFormat = GL_RGBA_ID; }
+    if( m_Format == ETC2_RGB ){ internalFormat = GL_ETC2_RGB_ID; baseFormat = GL_RGB_ID; }
+    if( m_Format == ETC2_RGBA ){ internalFormat = GL_ETC2_RGBA_ID; baseFormat = GL_RGBA_ID; }
+
+    // KTX 1.1 header, written in native byte order (the endianness field
+    // tells the loader whether it has to swap)
+    static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    file.write( reinterpret_cast<const char*>(identifier), sizeof(identifier) );
+    writeUint32( file, 0x04030201 );     // endianness
+    writeUint32( file, 0 );              // glType, 0 for compressed data
+    writeUint32( file, 1 );              // glTypeSize
+    writeUint32( file, 0 );              // glFormat, 0 for compressed data
+    writeUint32( file, internalFormat );
+    writeUint32( file, baseFormat );
+    writeUint32( file, m_Width );
+    writeUint32( file, m_Height );
+    writeUint32( file, 0 );              // depth
+    writeUint32( file, 0 );              // array elements
+    writeUint32( file, 1 );              // faces
+    writeUint32( file, static_cast<sf::Uint32>(m_Levels.size()) );
+    writeUint32( file, 0 );              // key/value data
+
+    // blocks are 8 or 16 bytes, so every level is already 4 byte aligned
+    for( std::vector< std::vector<sf::Uint8> >::const_iterator it = m_Levels.begin(); it != m_Levels.end(); ++it )
+    {
+        writeUint32( file, static_cast<sf::Uint32>(it->size()) );
+        file.write( reinterpret_cast<const char*>(&(*it)[0]), it->size() );
+    }
+
+    return file.good();
+}
+
+// ----------------------------------------------------------------------------
+bool TextureCompressor::hasAlpha( const sf::Image& image )
+{
+    const sf::Uint8* pixels = image.getPixelsPtr();
+    std::size_t count = image.getSize().x * image.getSize().y;
+    for( std::size_t i = 0; i != count; ++i )
+        if( pixels[i*4+3] != 255 )
+            return true;
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+void TextureCompressor::compressLevel( const sf::Image& image )
+{
+    unsigned int width = image.getSize().x;
+    unsigned int height = image.getSize().y;
+    unsigned int blocksX = (width + 3) / 4;
+    unsigned int blocksY = (height + 3) / 4;
+    std::size_t blockSize = (m_Format == DXT1 || m_Format == ETC2_RGB) ? 8 : 16;
+
+    m_Levels.push_back( std::vector<sf::Uint8>(blocksX * blocksY * blockSize) );
+    sf::Uint8* out = &m_Levels.back()[0];
+    const sf::Uint8* source = image.getPixelsPtr();
+
+    for( unsigned int by = 0; by != blocksY; ++by )
+    {
+        for( unsigned int bx = 0; bx != blocksX; ++bx )
+        {
+
+            // gather the 4x4 block, clamping at the edges of the image
+            sf::Uint8 block[64];
+            for( unsigned int y = 0; y != 4; ++y )
+            {
+                for( unsigned int x = 0; x != 4; ++x )
+                {
+                    unsigned int sx = bx*4 + x; if( sx >= width ) sx = width - 1;
+                    unsigned int sy = by*4 + y; if( sy >= height ) sy = height - 1;
+                    for( unsigned int c = 0; c != 4; ++c )
+                        block[(y*4+x)*4+c] = source[(sy*width+sx)*4+c];
+                }
+            }
+
+            // alpha blocks come first
+            switch( m_Format )
+            {
+                case DXT1 : this->encodeDXTColourBlock( block, out ); break;
+                case DXT5 : this->encodeDXTAlphaBlock( block, out ); this->encodeDXTColourBlock( block, out+8 ); break;
+                case ETC2_RGB : this->encodeETCColourBlock( block, out ); break;
+                case ETC2_RGBA : this->encodeEACAlphaBlock( block, out ); this->encodeETCColourBlock( block, out+8 ); break;
+            }
+            out += blockSize;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+void TextureCompressor::encodeDXTColourBlock( const sf::Uint8* pixels, sf::Uint8* out ) const
+{
+
+    // use the bounding box of the colours, inset a little to reduce the error
+    // of the extremes, as the end points
+    int low[3] = { 255, 255, 255 }, high[3] = { 0, 0, 0 };
+    for( int i = 0; i != 16; ++i )
+    {
+        for( int c = 0; c != 3; ++c )
+        {
+            if( pixels[i*4+c] < low[c] ) low[c] = pixels[i*4+c];
+            if( pixels[i*4+c] > high[c] ) high[c] = pixels[i*4+c];
+        }
+    }
+    for( int c = 0; c != 3; ++c )
+    {
+        int inset = (high[c] - low[c]) / 16;
+        high[c] -= inset;
+        low[c] += inset;
+    }
+
+    // the first end point must be greater to select the 4 colour mode
+    sf::Uint16 colour0 = packRGB565( high ), colour1 = packRGB565( low );
+    if( colour0 < colour1 )
+    {
+        sf::Uint16 temp = colour0; colour0 = colour1; colour1 = temp;
+    }
+
+    int palette[4][3];
+    unpackRGB565( colour0, palette[0] );
+    unpackRGB565( colour1, palette[1] );
+    for( int c = 0; c != 3; ++c )
+    {
+        palette[2][c] = (2*palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2*palette[1][c]) / 3;
+    }
+
+    // pick the closest palette entry for every pixel. If both end points are
+    // equal, the block is in 3 colour mode and index 0 is the only safe one.
+    sf::Uint32 indices = 0;
+    if( colour0 != colour1 )
+    {
+        for( int i = 0; i != 16; ++i )
+        {
+            int best = 0, bestError = 0x7FFFFFFF;
+            for( int p = 0; p != 4; ++p )
+            {
+                int error = square(pixels[i*4+0] - palette[p][0]) +
+                            square(pixels[i*4+1] - palette[p][1]) +
+                            square(pixels[i*4+2] - palette[p][2]);
+                if( error < bestError ){ bestError = error; best = p; }
+            }
+            indices |= static_cast<sf::Uint32>(best) << (i*2);
+        }
+    }
+
+    // little endian end points followed by the 2 bit indices
+    out[0] = colour0 & 0xFF; out[1] = colour0 >> 8;
+    out[2] = colour1 & 0xFF; out[3] = colour1 >> 8;
+    for( int i = 0; i != 4; ++i )
+        out[4+i] = (indices >> (i*8)) & 0xFF;
+}
+
+// ----------------------------------------------------------------------------
+void TextureCompressor::encodeDXTAlphaBlock( const sf::Uint8* pixels, sf::Uint8* out ) const
+{
+    int alpha0 = 0, alpha1 = 255;
+    for( int i = 0; i != 16; ++i )
+    {
+        if( pixels[i*4+3] > alpha0 ) alpha0 = pixels[i*4+3];
+        if( pixels[i*4+3] < alpha1 ) alpha1 = pixels[i*4+3];
+    }
+
+    // alpha0 > alpha1 selects the 8 value mode, 6 values are interpolated
+    int palette[8] = { alpha0, alpha1 };
+    for( int p = 1; p != 7; ++p )
+        palette[p+1] = ((7-p)*alpha0 + p*alpha1) / 7;
+
+    sf::Uint64 indices = 0;
+    if( alpha0 != alpha1 )
+    {
+        for( int i = 0; i != 16; ++i )
+        {
+            int best = 0, bestError = 0x7FFFFFFF;
+            for( int p = 0; p != 8; ++p )
+            {
+                int error = square(pixels[i*4+3] - palette[p]);
+                if( error < bestError ){ bestError = error; best = p; }
+            }
+            indices |= static_cast<sf::Uint64>(best) << (i*3);
+        }
+    }
+
+    out[0] = static_cast<sf::Uint8>(alpha0);
+    out[1] = static_cast<sf::Uint8>(alpha1);
+    for( int i = 0; i != 6; ++i )
+        out[2+i] = (indices >> (i*8)) & 0xFF;
+}
+
+// ----------------------------------------------------------------------------
+void TextureCompressor::encodeETCColourBlock( const sf::Uint8* pixels, sf::Uint8* out ) const
+{
+
+    // try both ways of splitting the block into two sub-blocks (side by side
+    // or on top of each other) and keep the one with the lowest error
+    sf::Uint32 bestHigh = 0, bestLow = 0;
+    int bestError = 0x7FFFFFFF;
+    for( int flip = 0; flip != 2; ++flip )
+    {
+        sf::Uint32 high = flip, low = 0;
+        int totalError = 0;
+        for( int sub = 0; sub != 2; ++sub )
+        {
+
+            // sub-block pixels, as x,y coordinates
+            int coords[8][2];
+            for( int i = 0; i != 8; ++i )
+            {
+                int a = i / 4 + sub*2, b = i % 4;
+                coords[i][0] = flip ? b : a;
+                coords[i][1] = flip ? a : b;
+            }
+
+            // the base colour of individual mode is 4 bits per channel
+            int sum[3] = { 0, 0, 0 }, base4[3], base[3];
+            for( int i = 0; i != 8; ++i )
+                for( int c = 0; c != 3; ++c )
+                    sum[c] += pixels[(coords[i][1]*4+coords[i][0])*4+c];
+            for( int c = 0; c != 3; ++c )
+            {
+                base4[c] = ((sum[c] / 8) * 15 + 127) / 255;
+                base[c] = base4[c] * 17;
+            }
+
+            // find the modifier table giving the lowest error
+            int bestTable = 0, bestTableError = 0x7FFFFFFF;
+            int bestIndices[8] = { 0 };
+            for( int table = 0; table != 8; ++table )
+            {
+                const int modifiers[4] = { ETCModifiers[table][0], ETCModifiers[table][1], -ETCModifiers[table][0], -ETCModifiers[table][1] };
+                int tableError = 0, indices[8];
+                for( int i = 0; i != 8; ++i )
+                {
+                    const sf::Uint8* pixel = &pixels[(coords[i][1]*4+coords[i][0])*4];
+                    int bestPixelError = 0x7FFFFFFF;
+                    for( int m = 0; m != 4; ++m )
+                    {
+                        int error = square(pixel[0] - clampByte(base[0] + modifiers[m])) +
+                                    square(pixel[1] - clampByte(base[1] + modifiers[m])) +
+                                    square(pixel[2] - clampByte(base[2] + modifiers[m]));
+                        if( error < bestPixelError ){ bestPixelError = error; indices[i] = m; }
+                    }
+                    tableError += bestPixelError;
+                }
+                if( tableError < bestTableError )
+                {
+                    bestTableError = tableError;
+                    bestTable = table;
+                    for( int i = 0; i != 8; ++i ) bestIndices[i] = indices[i];
+                }
+            }
+            totalError += bestTableError;
+
+            // base colours and table, sub-block 1 in the high nibbles
+            int shift = sub ? 0 : 4;
+            high |= static_cast<sf::Uint32>(base4[0]) << (24 + shift);
+            high |= static_cast<sf::Uint32>(base4[1]) << (16 + shift);
+            high |= static_cast<sf::Uint32>(base4[2]) << (8 + shift);
+            high |= static_cast<sf::Uint32>(bestTable) << (sub ? 2 : 5);
+
+            // pixel indices are stored column by column, most significant
+            // bits in the upper half
+            for( int i = 0; i != 8; ++i )
+            {
+                int bit = coords[i][0]*4 + coords[i][1];
+                low |= static_cast<sf::Uint32>(bestIndices[i] >> 1) << (16 + bit);
+                low |= static_cast<sf::Uint32>(bestIndices[i] & 1) << bit;
+            }
+        }
+
+        if( totalError < bestError )
+        {
+            bestError = totalError;
+            bestHigh = high;
+            bestLow = low;
+        }
+    }
+
+    // the differential bit stays 0 (individual mode), which ETC2 decodes
+    // exactly like ETC1. Blocks are big endian.
+    for( int i = 0; i != 4; ++i )
+    {
+        out[i] = (bestHigh >> (24 - i*8)) & 0xFF;
+        out[4+i] = (bestLow >> (24 - i*8)) & 0xFF;
+    }
+}
+
+// ----------------------------------------------------------------------------
+void TextureCompressor::encodeEACAlphaBlock( const sf::Uint8* pixels, sf::Uint8* out ) const
+{
+    int minAlpha = 255, maxAlpha = 0;
+    for( int i = 0; i != 16; ++i )
+    {
+        if( pixels[i*4+3] < minAlpha ) minAlpha = pixels[i*4+3];
+        if( pixels[i*4+3] > maxAlpha ) maxAlpha = pixels[i*4+3];
+    }
+
+    // uniform alpha: table 13 has a zero modifier at index 4
+    int bestBase = minAlpha, bestMultiplier = 1, bestTable = 13;
+    int bestIndices[16] = { 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4 };
+
+    if( minAlpha != maxAlpha )
+    {
+
+        // brute force the tables and multipliers around the middle of the range
+        int bestError = 0x7FFFFFFF;
+        int middle = (minAlpha + maxAlpha) / 2;
+        for( int base = middle - 4; base <= middle + 4; ++base )
+        {
+            if( base < 0 || base > 255 ) continue;
+            for( int multiplier = 1; multiplier != 16; ++multiplier )
+            {
+                for( int table = 0; table != 16; ++table )
+                {
+                    int error = 0, indices[16];
+                    for( int i = 0; i != 16 && error < bestError; ++i )
+                    {
+                        int bestPixelError = 0x7FFFFFFF;
+                        for( int m = 0; m != 8; ++m )
+                        {
+                            int pixelError = square(pixels[i*4+3] - clampByte(base + EACModifiers[table][m]*multiplier));
+                            if( pixelError < bestPixelError ){ bestPixelError = pixelError; indices[i] = m; }
+                        }
+                        error += bestPixelError;
+                    }
+                    if( error < bestError )
+                    {
+                        bestError = error;
+                        bestBase = base;
+                        bestMultiplier = multiplier;
+                        bestTable = table;
+                        for( int i = 0; i != 16; ++i ) bestIndices[i] = indices[i];
+                    }
+                }
+            }
+        }
+    }
+
+    // 3 bit indices, column by column, first pixel in the most significant bits
+    sf::Uint64 bits = 0;
+    for( int x = 0; x != 4; ++x )
+        for( int y = 0; y != 4; ++y )
+            bits = (bits << 3) | static_cast<sf::Uint64>(bestIndices[y*4+x]);
+
+    out[0] = static_cast<sf::Uint8>(bestBase);
+    out[1] = static_cast<sf::Uint8>((bestMultiplier << 4) | bestTable);
+    for( int i = 0; i != 6; ++i )
+        out[2+i] = (bits >> (40 - i*8)) & 0xFF;
+}
+
+// ----------------------------------------------------------------------------
+void TextureCompressor::downsample( const sf::Image& source, sf::Image& target )
+{
+    unsigned int width = source.getSize().x, height = source.getSize().y;
+    unsigned int newWidth = width > 1 ? width / 2 : 1;
+    unsigned int newHeight = height > 1 ? height / 2 : 1;
+
+    std::vector<sf::Uint8> pixels( newWidth * newHeight * 4 );
+    const sf::Uint8* src = source.getPixelsPtr();
+    for( unsigned int y = 0; y != newHeight; ++y )
+    {
+        for( unsigned int x = 0; x != newWidth; ++x )
+        {
+
+            // average the 2x2 footprint, clamped for 1 pixel wide images
+            unsigned int x0 = x*2, x1 = (x*2+1 < width) ? x*2+1 : x*2;
+            unsigned int y0 = y*2, y1 = (y*2+1 < height) ? y*2+1 : y*2;
+            for( unsigned int c = 0; c != 4; ++c )
+            {
+                unsigned int sum = src[(y0*width+x0)*4+c] + src[(y0*width+x1)*4+c] +
+                                   src[(y1*width+x0)*4+c] + src[(y1*width+x1)*4+c];
+                pixels[(y*newWidth+x)*4+c] = static_cast<sf::Uint8>((sum + 2) / 4);
+            }
+        }
+    }
+
+    target.create( newWidth, newHeight, &pixels[0] );
+}
@@ -0,0 +1,149 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TEXTURE_COMPRESSOR_HPP__
+#define __TEXTURE_COMPRESSOR_HPP__
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <SFML/Config.hpp>
+
+#include <string>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+// forward declarations
+
+namespace sf {
+    class Image;
+}
+
+/*!
+ * @brief Bakes images into GPU block-compressed KTX files
+ * The compressed files can be loaded with sf::Texture::loadFromCompressedFile,
+ * which uploads the blocks as they are. This skips image decoding entirely
+ * when the game starts, and the textures take 4 to 8 times less video memory.
+ *
+ * Example code:
+ * @code
+ * sf::Image image;
+ * image.loadFromFile( "assets/textures/wall.png" );
+ *
+ * TextureCompressor compressor( TextureCompressor::DXT1 );
+ * compressor.setGenerateMipmaps( true );
+ * compressor.compress( image );
+ * compressor.saveToFile( "assets/textures/wall.png.ktx" );
+ * @endcode
+ */
+class TextureCompressor
+{
+public:
+
+    /*!
+     * @brief Supported block compression formats
+     * These match sf::Texture::CompressedFormat.
+     */
+    enum Format
+    {
+        DXT1,       // 4 bits per pixel, opaque
+        DXT5,       // 8 bits per pixel, interpolated alpha
+        ETC2_RGB,   // 4 bits per pixel, opaque
+        ETC2_RGBA   // 8 bits per pixel, EAC alpha
+    };
+
+    /*!
+     * @brief Default constructor
+     * @param format The format to compress to
+     */
+    TextureCompressor( const Format& format );
+
+    /*!
+     * @brief Default destructor
+     */
+    ~TextureCompressor( void );
+
+    /*!
+     * @brief Sets whether a full mipmap chain should be generated
+     * Each level is made by box filtering the previous one, down to 1x1.
+     * Default is false.
+     */
+    void setGenerateMipmaps( const bool& generate );
+
+    /*!
+     * @brief Compresses an image
+     * Any previously compressed image is discarded.
+     * @param image The image to compress
+     * @return Returns false if the image is empty
+     */
+    bool compress( const sf::Image& image );
+
+    /*!
+     * @brief Writes the compressed levels into a KTX file
+     * @param fileName The file name of the KTX file to write
+     * @return Returns true if the file was written, false if otherwise
+     */
+    bool saveToFile( const std::string& fileName ) const;
+
+    /*!
+     * @brief Checks if an image has any pixel that isn't fully opaque
+     * Used to choose between the opaque and alpha variant of a format.
+     */
+    static bool hasAlpha( const sf::Image& image );
+
+private:
+
+    /*!
+     * @brief Compresses a single mipmap level and appends it to the level list
+     */
+    void compressLevel( const sf::Image& image );
+
+    /*!
+     * @brief Encodes 16 RGBA pixels (row-major) into an 8 byte DXT colour block
+     */
+    void encodeDXTColourBlock( const sf::Uint8* pixels, sf::Uint8* out ) const;
+
+    /*!
+     * @brief Encodes the alpha of 16 RGBA pixels into an 8 byte DXT5 alpha block
+     */
+    void encodeDXTAlphaBlock( const sf::Uint8* pixels, sf::Uint8* out ) const;
+
+    /*!
+     * @brief Encodes 16 RGBA pixels into an 8 byte ETC2 colour block
+     * Only the ETC1 compatible individual mode is used.
+     */
+    void encodeETCColourBlock( const sf::Uint8* pixels, sf::Uint8* out ) const;
+
+    /*!
+     * @brief Encodes the alpha of 16 RGBA pixels into an 8 byte EAC block
+     */
+    void encodeEACAlphaBlock( const sf::Uint8* pixels, sf::Uint8* out ) const;
+
+    /*!
+     * @brief Halves an image using a 2x2 box filter
+     */
+    static void downsample( const sf::Image& source, sf::Image& target );
+
+    Format m_Format;
+    bool m_GenerateMipmaps;
+
+    unsigned int m_Width;
+    unsigned int m_Height;
+    std::vector< std::vector<sf::Uint8> > m_Levels;
+};
+
+#endif // __TEXTURE_COMPRESSOR_HPP__
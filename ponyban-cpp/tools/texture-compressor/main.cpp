@@ -0,0 +1,108 @@
+/*
+ * This file is part of Ponyban.
+ *
+ * Ponyban is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Ponyban is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Ponyban.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ----------------------------------------------------------------------------
+// include files
+
+#include <TextureCompressor.hpp>
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <iostream>
+#include <string>
+
+// ----------------------------------------------------------------------------
+// usage
+
+namespace {
+    void printUsage( void )
+    {
+        std::cout << "usage: texture-compressor [-f dxt|etc2] [-m] <image>..." << std::endl
+                  << "  Bakes each image into <image>.ktx, which the game loads instead" << std::endl
+                  << "  of the original file when the graphics driver supports the format." << std::endl
+                  << "  -f  block compression family (default: dxt). Images with transparent" << std::endl
+                  << "      pixels use DXT5 or ETC2 RGBA, opaque images DXT1 or ETC2 RGB." << std::endl
+                  << "  -m  generate a full mipmap chain" << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// main entry point
+int main( int argc, char** argv )
+{
+    bool useETC = false;
+    bool mipmaps = false;
+    int failures = 0, converted = 0;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        std::string argument = argv[i];
+
+        // options
+        if( argument == "-h" || argument == "--help" )
+        {
+            printUsage();
+            return 0;
+        }
+        if( argument == "-m" )
+        {
+            mipmaps = true;
+            continue;
+        }
+        if( argument == "-f" && i+1 < argc )
+        {
+            std::string family = argv[++i];
+            if( family != "dxt" && family != "etc2" )
+            {
+                std::cerr << "Unknown format family \"" << family << "\"" << std::endl;
+                return 1;
+            }
+            useETC = (family == "etc2");
+            continue;
+        }
+
+        // images
+        sf::Image image;
+        if( !image.loadFromFile(argument) )
+        {
+            ++failures;
+            continue;
+        }
+
+        bool alpha = TextureCompressor::hasAlpha( image );
+        TextureCompressor::Format format = useETC ? (alpha ? TextureCompressor::ETC2_RGBA : TextureCompressor::ETC2_RGB)
+                                                  : (alpha ? TextureCompressor::DXT5 : TextureCompressor::DXT1);
+        TextureCompressor compressor( format );
+        compressor.setGenerateMipmaps( mipmaps );
+
+        std::string outFile = argument + ".ktx";
+        if( !compressor.compress(image) || !compressor.saveToFile(outFile) )
+        {
+            std::cerr << "Failed to write \"" << outFile << "\"" << std::endl;
+            ++failures;
+            continue;
+        }
+
+        std::cout << "baked " << outFile << std::endl;
+        ++converted;
+    }
+
+    if( !converted && !failures )
+        printUsage();
+
+    return failures ? 1 : 0;
+}